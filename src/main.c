@@ -22,19 +22,31 @@
 #include <ytv-entry.h>
 
 #include <ytv-soup-feed-fetch-strategy.h>
+#include <ytv-gconf-proxy.h>
 #include <ytv-json-feed-parse-strategy.h>
 #include <ytv-youtube-uri-builder.h>
 #include <ytv-base-feed.h>
+#include <ytv-entry-store.h>
 #include <ytv-error.h>
 #include <ytv-shell.h>
 #include <ytv-gtk-browser.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
+#include <ytv-watchdog.h>
 
 #include <gtk/gtk.h>
 
+#include <errno.h>
+#include <signal.h>
+
 #define ENTRYNUM 5
 
 static gboolean horizontal = FALSE;
 static gboolean vertical = FALSE;
+static gboolean list = FALSE;
+static gchar* trace_file = NULL;
+static gint watchdog = -1;
+static gchar* stats_file = NULL;
         
 static const GOptionEntry entries[] =
 {
@@ -42,6 +54,17 @@ static const GOptionEntry entries[] =
           "horizontal layout (default", NULL },
         { "vertical", 'v', 0, G_OPTION_ARG_NONE, &vertical,
           "vertical layout", NULL },
+        { "list", 'l', 0, G_OPTION_ARG_NONE, &list,
+          "scrolling list browser, for long feeds", NULL },
+        { "trace", 't', 0, G_OPTION_ARG_FILENAME, &trace_file,
+          "write a chrome://tracing JSON file at exit "
+          "(or set " YTV_TRACE_ENV ")", "FILE" },
+        { "watchdog", 'w', 0, G_OPTION_ARG_INT, &watchdog,
+          "report main loop stalls longer than MS milliseconds "
+          "(or set " YTV_WATCHDOG_ENV "), SIGUSR2 dumps the summary", "MS" },
+        { "stats", 's', 0, G_OPTION_ARG_FILENAME, &stats_file,
+          "write the statistics as JSON in FILE at exit and on SIGUSR1 "
+          "(stderr by default)", "FILE" },
         { NULL }
 };
 
@@ -86,6 +109,43 @@ app_fetch_feed (App* app)
 }
 
 
+/* the entries kept under the user's data directory, or NULL */
+static YtvEntryStore*
+app_open_store (void)
+{
+        YtvEntryStore* store;
+        GError* err;
+        gchar* dir;
+        gchar* path;
+
+        store = NULL;
+        err = NULL;
+
+        dir = g_build_filename (g_get_user_data_dir (), "ytv", NULL);
+        path = g_build_filename (dir, "entries", NULL);
+
+        if (g_mkdir_with_parents (dir, 0700) != 0)
+        {
+                g_warning ("Could not create %s - %s", dir,
+                           g_strerror (errno));
+                goto beach;
+        }
+
+        store = ytv_entry_store_new (path, &err);
+
+        if (store == NULL)
+        {
+                g_warning ("%s", err->message);
+                g_error_free (err);
+        }
+
+beach:
+        g_free (path);
+        g_free (dir);
+
+        return store;
+}
+
 static App*
 app_new (void)
 {
@@ -93,6 +153,8 @@ app_new (void)
         YtvFeedFetchStrategy* fetchst;
         YtvFeedParseStrategy* parsest; 
         YtvUriBuilder* ub;
+        YtvEntryStore* store;
+        gchar* proxy;
 
         app = g_slice_new (App);
 
@@ -104,6 +166,10 @@ app_new (void)
         fetchst = ytv_soup_feed_fetch_strategy_new ();
         parsest = ytv_json_feed_parse_strategy_new ();
         ub = ytv_youtube_uri_builder_new ();
+
+        proxy = ytv_gconf_proxy_get_uri ();
+        g_object_set (G_OBJECT (fetchst), "proxy-uri", proxy, NULL);
+        g_free (proxy);
         
         g_object_set (G_OBJECT (ub),
                       "max-results", ENTRYNUM,
@@ -119,6 +185,15 @@ app_new (void)
         g_object_unref (parsest);
         g_object_unref (ub);
 
+        /* without a store the feed is just fetched from the network */
+        store = app_open_store ();
+
+        if (store != NULL)
+        {
+                g_object_set (G_OBJECT (app->feed), "store", store, NULL);
+                g_object_unref (store);
+        }
+
         /* initial feed to show */
         /* ytv_feed_standard (app->feed, YTV_YOUTUBE_STD_FEED_MOST_RECENT); */
         ytv_feed_standard (app->feed, YTV_YOUTUBE_STD_FEED_MOST_VIEWED);
@@ -156,7 +231,8 @@ app_create_ui (App* app)
 
         box = gtk_hbox_new (FALSE, 0);
 
-        app->shell = ytv_shell_new ();
+        app->shell = GTK_WIDGET (g_object_new (YTV_TYPE_SHELL,
+                                               "list-browser", list, NULL));
         g_signal_connect (app->shell, "error-raised",
                           G_CALLBACK (error_raised_cb), app);
         gtk_box_pack_start (GTK_BOX (box), app->shell, TRUE, TRUE, 0);
@@ -193,6 +269,29 @@ parse_options (App* app, gint* argc, gchar*** argv)
                 app->orientation = YTV_ORIENTATION_VERTICAL;
         }
 
+        if (trace_file != NULL)
+        {
+                ytv_trace_init (trace_file);
+                g_free (trace_file);
+                trace_file = NULL;
+        }
+        else
+        {
+                ytv_trace_init_from_env ();
+        }
+
+        if (watchdog >= 0)
+        {
+                ytv_watchdog_enable (watchdog > 0 ?
+                                     watchdog : YTV_WATCHDOG_DEFAULT_THRESHOLD);
+        }
+        else
+        {
+                ytv_watchdog_enable_from_env ();
+        }
+
+        ytv_stats_dump_on_signal (SIGUSR1, stats_file);
+
         g_option_context_free (context);
         
         return TRUE;
@@ -221,6 +320,20 @@ main (gint argc, gchar** argv)
 
 beach:
         app_free (app);
+
+        if (ytv_watchdog_is_enabled ())
+        {
+                ytv_watchdog_dump (stderr);
+                ytv_watchdog_disable ();
+        }
+
+        if (stats_file != NULL)
+        {
+                ytv_stats_dump (stats_file);
+                g_free (stats_file);
+        }
+
+        ytv_trace_shutdown ();
         
         return 0;
 }
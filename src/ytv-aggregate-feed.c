@@ -0,0 +1,1049 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-aggregate-feed.c - A feed which merges several feeds
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-aggregate-feed
+ * @title: YtvAggregateFeed
+ * @short_description: merges several feeds in one
+ *
+ * The #YtvAggregateFeed shows the entries of several children feeds, for
+ * example the uploads of a dozen users and a search, as a single feed
+ * sorted by #YtvAggregateFeed:order. Every child must already be
+ * configured, with ytv_feed_user() and friends, sorted by the same key,
+ * and must have its own #YtvUriBuilder, because its "start-index" is
+ * moved to fetch its next pages.
+ *
+ * The children are fetched concurrently and their pages are merged with a
+ * heap keyed by the first pending entry of each child. An entry can only
+ * be taken while every child still has pending entries, so a child is
+ * asked for its next page as soon as it runs out. The requested page is
+ * delivered as soon as enough leading entries are known, without waiting
+ * for the children which are not needed for it. The entries whose id was
+ * already merged are dropped.
+ *
+ * The page to deliver is set with the #YtvAggregateFeed:start-index and
+ * #YtvAggregateFeed:max-results properties. The merged entries are kept,
+ * so going back to a previous page does not fetch anything.
+ */
+
+/**
+ * YtvAggregateFeed:
+ *
+ * A #YtvFeed which merges the entries of several feeds
+ *
+ * free-function: g_object_unref
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include <ytv-aggregate-feed.h>
+
+#include <ytv-entry.h>
+#include <ytv-error.h>
+#include <ytv-feed-fetch-strategy.h>
+#include <ytv-feed-parse-strategy.h>
+#include <ytv-iterator.h>
+#include <ytv-list.h>
+#include <ytv-simple-list.h>
+#include <ytv-uri-builder.h>
+#include <ytv-trace.h>
+
+enum _YtvAggregateFeedProp
+{
+        PROP_0,
+        PROP_ORDER,
+        PROP_START_INDEX,
+        PROP_MAX_RESULTS
+};
+
+typedef struct _YtvAggregateFeedPriv YtvAggregateFeedPriv;
+
+struct _YtvAggregateFeedPriv
+{
+        YtvFeedFetchStrategy* fetchst;
+        YtvFeedParseStrategy* parsest;
+        YtvUriBuilder* uribuild;
+
+        YtvAggregateOrder order;
+        gint start_index;         /* of the page, from zero */
+        gint max_results;
+
+        GPtrArray* sources;       /* of YtvAggregateSource */
+        GPtrArray* heap;          /* the sources with pending entries */
+        guint starving;           /* live sources without pending entries */
+        GPtrArray* merged;        /* of YtvEntry, in order */
+        GHashTable* seen;         /* ids of the merged entries */
+        guint serial;             /* discards the pages fetched before reset */
+
+        YtvGetEntriesCallback cb; /* of the request waiting for entries */
+        gpointer user_data;
+        GError* error;            /* the first one of a child */
+};
+
+/* an entry with its sort keys */
+typedef struct _YtvAggregateItem YtvAggregateItem;
+
+struct _YtvAggregateItem
+{
+        YtvEntry* entry;
+        gchar* id;
+        gchar* published;
+        guint views;
+};
+
+/* a child feed */
+typedef struct _YtvAggregateSource YtvAggregateSource;
+
+struct _YtvAggregateSource
+{
+        YtvAggregateFeed* self;
+        YtvFeed* feed;
+        GQueue* items;            /* fetched but not merged yet */
+        gint first_start;         /* start-index of its first page */
+        gint next_start;          /* start-index of its next page */
+        gboolean fetching;
+        gboolean exhausted;
+};
+
+typedef struct _YtvAggregateRequest YtvAggregateRequest;
+
+struct _YtvAggregateRequest
+{
+        YtvAggregateSource* src;
+        guint serial;
+};
+
+#define YTV_AGGREGATE_FEED_GET_PRIVATE(obj)     \
+        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_AGGREGATE_FEED, YtvAggregateFeedPriv))
+
+#define DEFAULT_MAX_RESULTS 25
+
+static void ytv_feed_init (YtvFeedIface* klass);
+
+G_DEFINE_TYPE_EXTENDED (YtvAggregateFeed, ytv_aggregate_feed,
+                        G_TYPE_OBJECT, 0,
+                        G_IMPLEMENT_INTERFACE (YTV_TYPE_FEED,
+                                               ytv_feed_init))
+
+static YtvAggregateItem*
+item_new (YtvEntry* entry)
+{
+        YtvAggregateItem* item;
+
+        item = g_slice_new (YtvAggregateItem);
+        item->entry = g_object_ref (entry);
+        g_object_get (G_OBJECT (entry), "id", &item->id,
+                      "published", &item->published,
+                      "views", &item->views, NULL);
+
+        return item;
+}
+
+static void
+item_free (YtvAggregateItem* item)
+{
+        g_object_unref (item->entry);
+        g_free (item->id);
+        g_free (item->published);
+        g_slice_free (YtvAggregateItem, item);
+
+        return;
+}
+
+/* negative if a goes before b */
+static gint
+item_compare (YtvAggregateOrder order, YtvAggregateItem* a,
+              YtvAggregateItem* b)
+{
+        if (order == YTV_AGGREGATE_ORDER_VIEWCOUNT)
+        {
+                if (a->views == b->views)
+                {
+                        return 0;
+                }
+
+                return a->views > b->views ? -1 : 1;
+        }
+
+        /* ISO 8601 timestamps sort as strings; a missing one goes last */
+        if (a->published == NULL || b->published == NULL)
+        {
+                return (a->published == NULL) - (b->published == NULL);
+        }
+
+        return -strcmp (a->published, b->published);
+}
+
+static gboolean
+heap_less (YtvAggregateFeedPriv* priv, guint i, guint j)
+{
+        YtvAggregateSource* a = g_ptr_array_index (priv->heap, i);
+        YtvAggregateSource* b = g_ptr_array_index (priv->heap, j);
+
+        return item_compare (priv->order,
+                             g_queue_peek_head (a->items),
+                             g_queue_peek_head (b->items)) < 0;
+}
+
+static void
+heap_swap (YtvAggregateFeedPriv* priv, guint i, guint j)
+{
+        gpointer tmp;
+
+        tmp = priv->heap->pdata[i];
+        priv->heap->pdata[i] = priv->heap->pdata[j];
+        priv->heap->pdata[j] = tmp;
+
+        return;
+}
+
+static void
+heap_sift_down (YtvAggregateFeedPriv* priv, guint i)
+{
+        guint child;
+
+        while ((child = 2 * i + 1) < priv->heap->len)
+        {
+                if (child + 1 < priv->heap->len &&
+                    heap_less (priv, child + 1, child))
+                {
+                        child++;
+                }
+
+                if (!heap_less (priv, child, i))
+                {
+                        break;
+                }
+
+                heap_swap (priv, i, child);
+                i = child;
+        }
+
+        return;
+}
+
+static void
+heap_push (YtvAggregateFeedPriv* priv, YtvAggregateSource* src)
+{
+        guint i;
+
+        g_ptr_array_add (priv->heap, src);
+
+        for (i = priv->heap->len - 1; i > 0; i = (i - 1) / 2)
+        {
+                if (!heap_less (priv, i, (i - 1) / 2))
+                {
+                        break;
+                }
+
+                heap_swap (priv, i, (i - 1) / 2);
+        }
+
+        return;
+}
+
+static void
+heap_pop (YtvAggregateFeedPriv* priv)
+{
+        heap_swap (priv, 0, priv->heap->len - 1);
+        g_ptr_array_remove_index (priv->heap, priv->heap->len - 1);
+        heap_sift_down (priv, 0);
+
+        return;
+}
+
+static void
+source_clear (YtvAggregateSource* src)
+{
+        g_queue_foreach (src->items, (GFunc) item_free, NULL);
+        g_queue_clear (src->items);
+        src->next_start = src->first_start;
+        src->exhausted = FALSE;
+
+        return;
+}
+
+/* takes entries from the heap until the requested page is complete;
+ * returns FALSE if a child must be fetched first */
+static gboolean
+merge (YtvAggregateFeed* self)
+{
+        YtvAggregateFeedPriv* priv;
+        YtvAggregateSource* src;
+        YtvAggregateItem* item;
+        guint wanted;
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+        wanted = priv->start_index + priv->max_results;
+
+        while (priv->merged->len < wanted)
+        {
+                if (priv->starving > 0)
+                {
+                        return FALSE; /* it could have the next entry */
+                }
+
+                if (priv->heap->len == 0)
+                {
+                        return TRUE; /* every child is exhausted */
+                }
+
+                src = g_ptr_array_index (priv->heap, 0);
+                item = g_queue_pop_head (src->items);
+
+                if (item->id != NULL &&
+                    g_hash_table_lookup (priv->seen, item->id) == NULL)
+                {
+                        g_hash_table_insert (priv->seen, g_strdup (item->id),
+                                             GINT_TO_POINTER (TRUE));
+                        g_ptr_array_add (priv->merged,
+                                         g_object_ref (item->entry));
+                }
+
+                item_free (item);
+
+                if (g_queue_is_empty (src->items))
+                {
+                        heap_pop (priv);
+                        priv->starving++;
+                }
+                else
+                {
+                        heap_sift_down (priv, 0);
+                }
+        }
+
+        return TRUE;
+}
+
+static void
+deliver (YtvAggregateFeed* self)
+{
+        YtvAggregateFeedPriv* priv;
+        YtvGetEntriesCallback cb;
+        gpointer user_data;
+        YtvList* list;
+        GError* err = NULL;
+        guint i;
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        cb = priv->cb;
+        user_data = priv->user_data;
+        priv->cb = NULL;
+        priv->user_data = NULL;
+
+        /* nothing to show because of the errors */
+        if (priv->merged->len <= (guint) priv->start_index &&
+            priv->error != NULL)
+        {
+                err = priv->error;
+                priv->error = NULL;
+                cb (YTV_FEED (self), FALSE, NULL, &err, user_data);
+                return;
+        }
+
+        list = ytv_simple_list_new ();
+
+        for (i = priv->start_index;
+             i < priv->merged->len &&
+                     i < (guint) (priv->start_index + priv->max_results);
+             i++)
+        {
+                ytv_list_append (list,
+                                 G_OBJECT (g_ptr_array_index (priv->merged,
+                                                              i)));
+        }
+
+        cb (YTV_FEED (self), FALSE, list, &err, user_data);
+
+        return;
+}
+
+static void fetch_source (YtvAggregateSource* src);
+
+static void
+fetch_starving (YtvAggregateFeed* self)
+{
+        YtvAggregateFeedPriv* priv;
+        guint i;
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        /* a response may arrive synchronously, from the history of a child,
+         * and deliver the page meanwhile */
+        for (i = 0; i < priv->sources->len; i++)
+        {
+                YtvAggregateSource* src = g_ptr_array_index (priv->sources, i);
+
+                if (!src->exhausted && g_queue_is_empty (src->items))
+                {
+                        fetch_source (src);
+                }
+        }
+
+        return;
+}
+
+static void
+run (YtvAggregateFeed* self)
+{
+        if (merge (self))
+        {
+                deliver (self);
+        }
+        else
+        {
+                fetch_starving (self);
+        }
+
+        return;
+}
+
+static void
+source_cb (YtvFeed* feed, gboolean cancelled, YtvList* list, GError **err,
+           gpointer user_data)
+{
+        YtvAggregateRequest* req;
+        YtvAggregateSource* src;
+        YtvAggregateFeed* self;
+        YtvAggregateFeedPriv* priv;
+        YtvIterator* iter;
+        gint count;
+
+        req = (YtvAggregateRequest*) user_data;
+        src = req->src;
+        self = src->self;
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        src->fetching = FALSE;
+
+        if (req->serial != priv->serial || cancelled)
+        {
+                /* fetched before a reset */
+                if (err != NULL && *err != NULL)
+                {
+                        g_error_free (*err);
+                        *err = NULL;
+                }
+
+                if (list != NULL)
+                {
+                        g_object_unref (list);
+                }
+
+                if (priv->cb != NULL)
+                {
+                        fetch_starving (self);
+                }
+
+                goto beach;
+        }
+
+        YTV_TRACE_BEGIN ("aggregate", "source_cb");
+
+        priv->starving--;
+
+        if (err != NULL && *err != NULL)
+        {
+                /* past its last page, or broken: the others go on */
+                if (ytv_error_get_code (*err) != YTV_PARSE_ERROR_BAD_FORMAT &&
+                    priv->error == NULL)
+                {
+                        priv->error = *err;
+                }
+                else
+                {
+                        g_error_free (*err);
+                }
+
+                *err = NULL;
+                src->exhausted = TRUE;
+
+                if (list != NULL)
+                {
+                        g_object_unref (list);
+                }
+        }
+        else
+        {
+                count = 0;
+
+                if (list != NULL)
+                {
+                        iter = ytv_list_create_iterator (list);
+
+                        while (!ytv_iterator_is_done (iter))
+                        {
+                                GObject* entry;
+
+                                entry = ytv_iterator_get_current (iter);
+                                g_queue_push_tail
+                                        (src->items,
+                                         item_new (YTV_ENTRY (entry)));
+                                g_object_unref (entry);
+
+                                count++;
+                                ytv_iterator_next (iter);
+                        }
+
+                        g_object_unref (iter);
+                        g_object_unref (list);
+                }
+
+                src->next_start += count;
+
+                if (count == 0)
+                {
+                        src->exhausted = TRUE;
+                }
+                else
+                {
+                        heap_push (priv, src);
+                }
+        }
+
+        if (priv->cb != NULL)
+        {
+                run (self);
+        }
+
+        YTV_TRACE_END ("aggregate", "source_cb");
+
+beach:
+        g_slice_free (YtvAggregateRequest, req);
+        g_object_unref (self);
+
+        return;
+}
+
+static void
+fetch_source (YtvAggregateSource* src)
+{
+        YtvAggregateFeedPriv* priv;
+        YtvAggregateRequest* req;
+        YtvUriBuilder* ub;
+
+        if (src->fetching || src->exhausted)
+        {
+                return;
+        }
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (src->self);
+
+        /* the query set in the child is rebuilt with the new start-index */
+        ub = ytv_feed_get_uri_builder (src->feed);
+        g_object_set (G_OBJECT (ub), "start-index", src->next_start, NULL);
+        g_object_unref (ub);
+
+        req = g_slice_new (YtvAggregateRequest);
+        req->src = src;
+        req->serial = priv->serial;
+
+        src->fetching = TRUE;
+        g_object_ref (src->self);
+
+        ytv_feed_get_entries_async (src->feed, source_cb, req);
+
+        return;
+}
+
+static YtvFeedFetchStrategy*
+ytv_aggregate_feed_get_fetch_strategy (YtvFeed* self)
+{
+        YtvAggregateFeedPriv* priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        return priv->fetchst != NULL ? g_object_ref (priv->fetchst) : NULL;
+}
+
+static void
+ytv_aggregate_feed_set_fetch_strategy (YtvFeed* self,
+                                       YtvFeedFetchStrategy* st)
+{
+        YtvAggregateFeedPriv* priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        if (priv->fetchst != NULL)
+        {
+                g_object_unref (priv->fetchst);
+        }
+
+        priv->fetchst = g_object_ref (st);
+
+        return;
+}
+
+static YtvFeedParseStrategy*
+ytv_aggregate_feed_get_parse_strategy (YtvFeed* self)
+{
+        YtvAggregateFeedPriv* priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        return priv->parsest != NULL ? g_object_ref (priv->parsest) : NULL;
+}
+
+static void
+ytv_aggregate_feed_set_parse_strategy (YtvFeed* self,
+                                       YtvFeedParseStrategy* st)
+{
+        YtvAggregateFeedPriv* priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        if (priv->parsest != NULL)
+        {
+                g_object_unref (priv->parsest);
+        }
+
+        priv->parsest = g_object_ref (st);
+
+        return;
+}
+
+static YtvUriBuilder*
+ytv_aggregate_feed_get_uri_builder (YtvFeed* self)
+{
+        YtvAggregateFeedPriv* priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        return priv->uribuild != NULL ? g_object_ref (priv->uribuild) : NULL;
+}
+
+static void
+ytv_aggregate_feed_set_uri_builder (YtvFeed* self, YtvUriBuilder* ub)
+{
+        YtvAggregateFeedPriv* priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        if (priv->uribuild != NULL)
+        {
+                g_object_unref (priv->uribuild);
+        }
+
+        priv->uribuild = g_object_ref (ub);
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_standard (YtvFeed* self, guint type)
+{
+        g_warning ("The queries are set in the children of an aggregate feed");
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_search (YtvFeed* self, const gchar* query)
+{
+        ytv_aggregate_feed_standard (self, 0);
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_user (YtvFeed* self, const gchar* user)
+{
+        ytv_aggregate_feed_standard (self, 0);
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_keywords (YtvFeed* self, const gchar* category,
+                             const gchar* keywords)
+{
+        ytv_aggregate_feed_standard (self, 0);
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_related (YtvFeed* self, const gchar* vid)
+{
+        ytv_aggregate_feed_standard (self, 0);
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_get_entries_async (YtvFeed* self,
+                                      YtvGetEntriesCallback callback,
+                                      gpointer user_data)
+{
+        YtvAggregateFeedPriv* priv;
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        g_return_if_fail (callback != NULL);
+
+        if (priv->cb != NULL)
+        {
+                /* only the last request is answered */
+                GError* err = NULL;
+
+                priv->cb (self, TRUE, NULL, &err, priv->user_data);
+        }
+
+        priv->cb = callback;
+        priv->user_data = user_data;
+
+        run (YTV_AGGREGATE_FEED (self));
+
+        return;
+}
+
+static void
+ytv_feed_init (YtvFeedIface* klass)
+{
+        klass->get_fetch_strategy = ytv_aggregate_feed_get_fetch_strategy;
+        klass->set_fetch_strategy = ytv_aggregate_feed_set_fetch_strategy;
+        klass->get_parse_strategy = ytv_aggregate_feed_get_parse_strategy;
+        klass->set_parse_strategy = ytv_aggregate_feed_set_parse_strategy;
+        klass->get_uri_builder = ytv_aggregate_feed_get_uri_builder;
+        klass->set_uri_builder = ytv_aggregate_feed_set_uri_builder;
+
+        klass->standard = ytv_aggregate_feed_standard;
+        klass->search = ytv_aggregate_feed_search;
+        klass->user = ytv_aggregate_feed_user;
+        klass->keywords = ytv_aggregate_feed_keywords;
+        klass->related = ytv_aggregate_feed_related;
+
+        klass->get_entries_async = ytv_aggregate_feed_get_entries_async;
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_set_property (GObject* object, guint prop_id,
+                                 const GValue* value, GParamSpec* spec)
+{
+        YtvAggregateFeedPriv* priv;
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_ORDER:
+                priv->order = g_value_get_enum (value);
+                break;
+        case PROP_START_INDEX:
+                priv->start_index = g_value_get_int (value);
+                break;
+        case PROP_MAX_RESULTS:
+                priv->max_results = g_value_get_int (value);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_get_property (GObject* object, guint prop_id,
+                                 GValue* value, GParamSpec* spec)
+{
+        YtvAggregateFeedPriv* priv;
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_ORDER:
+                g_value_set_enum (value, priv->order);
+                break;
+        case PROP_START_INDEX:
+                g_value_set_int (value, priv->start_index);
+                break;
+        case PROP_MAX_RESULTS:
+                g_value_set_int (value, priv->max_results);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_dispose (GObject* object)
+{
+        YtvAggregateFeedPriv* priv;
+        guint i;
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (object);
+
+        /* no request is in flight: each one keeps a reference */
+        for (i = 0; i < priv->sources->len; i++)
+        {
+                YtvAggregateSource* src = g_ptr_array_index (priv->sources, i);
+
+                source_clear (src);
+                g_queue_free (src->items);
+                g_object_unref (src->feed);
+                g_slice_free (YtvAggregateSource, src);
+        }
+
+        g_ptr_array_set_size (priv->sources, 0);
+        g_ptr_array_set_size (priv->heap, 0);
+
+        g_ptr_array_foreach (priv->merged, (GFunc) g_object_unref, NULL);
+        g_ptr_array_set_size (priv->merged, 0);
+
+        if (priv->fetchst != NULL)
+        {
+                g_object_unref (priv->fetchst);
+                priv->fetchst = NULL;
+        }
+
+        if (priv->parsest != NULL)
+        {
+                g_object_unref (priv->parsest);
+                priv->parsest = NULL;
+        }
+
+        if (priv->uribuild != NULL)
+        {
+                g_object_unref (priv->uribuild);
+                priv->uribuild = NULL;
+        }
+
+        (*G_OBJECT_CLASS (ytv_aggregate_feed_parent_class)->dispose) (object);
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_finalize (GObject* object)
+{
+        YtvAggregateFeedPriv* priv;
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (object);
+
+        g_ptr_array_free (priv->sources, TRUE);
+        g_ptr_array_free (priv->heap, TRUE);
+        g_ptr_array_free (priv->merged, TRUE);
+        g_hash_table_destroy (priv->seen);
+
+        if (priv->error != NULL)
+        {
+                g_error_free (priv->error);
+        }
+
+        (*G_OBJECT_CLASS (ytv_aggregate_feed_parent_class)->finalize) (object);
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_class_init (YtvAggregateFeedClass* klass)
+{
+        GObjectClass* g_klass;
+
+        g_klass = G_OBJECT_CLASS (klass);
+
+        g_type_class_add_private (g_klass, sizeof (YtvAggregateFeedPriv));
+
+        g_klass->set_property = ytv_aggregate_feed_set_property;
+        g_klass->get_property = ytv_aggregate_feed_get_property;
+        g_klass->dispose      = ytv_aggregate_feed_dispose;
+        g_klass->finalize     = ytv_aggregate_feed_finalize;
+
+        g_object_class_install_property
+                (g_klass, PROP_ORDER,
+                 g_param_spec_enum
+                 ("order", "order", "The key which sorts the children feeds",
+                  YTV_TYPE_AGGREGATE_ORDER, YTV_AGGREGATE_ORDER_PUBLISHED,
+                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+        g_object_class_install_property
+                (g_klass, PROP_START_INDEX,
+                 g_param_spec_int
+                 ("start-index", "startindex",
+                  "Position of the first merged entry of the page, from zero",
+                  0, G_MAXINT, 0, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (g_klass, PROP_MAX_RESULTS,
+                 g_param_spec_int
+                 ("max-results", "maxresults",
+                  "The number of merged entries of a page", 1, G_MAXINT,
+                  DEFAULT_MAX_RESULTS, G_PARAM_READWRITE));
+
+        return;
+}
+
+static void
+ytv_aggregate_feed_init (YtvAggregateFeed* self)
+{
+        YtvAggregateFeedPriv* priv;
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        priv->fetchst     = NULL;
+        priv->parsest     = NULL;
+        priv->uribuild    = NULL;
+        priv->order       = YTV_AGGREGATE_ORDER_PUBLISHED;
+        priv->start_index = 0;
+        priv->max_results = DEFAULT_MAX_RESULTS;
+        priv->sources     = g_ptr_array_new ();
+        priv->heap        = g_ptr_array_new ();
+        priv->starving    = 0;
+        priv->merged      = g_ptr_array_new ();
+        priv->seen        = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                   g_free, NULL);
+        priv->serial      = 0;
+        priv->cb          = NULL;
+        priv->user_data   = NULL;
+        priv->error       = NULL;
+
+        return;
+}
+
+/**
+ * ytv_aggregate_order_get_type:
+ *
+ * GType system helper function
+ *
+ * returns: a #GType
+ */
+GType
+ytv_aggregate_order_get_type (void)
+{
+        static GType type = 0;
+
+        if (G_UNLIKELY (type == 0))
+        {
+                static const GEnumValue values[] = {
+                        { YTV_AGGREGATE_ORDER_PUBLISHED,
+                          "YTV_AGGREGATE_ORDER_PUBLISHED", "published" },
+                        { YTV_AGGREGATE_ORDER_VIEWCOUNT,
+                          "YTV_AGGREGATE_ORDER_VIEWCOUNT", "viewcount" },
+                        { 0, NULL, NULL }
+                };
+
+                type = g_enum_register_static ("YtvAggregateOrderType",
+                                               values);
+        }
+
+        return type;
+}
+
+/**
+ * ytv_aggregate_feed_new:
+ * @order: the #YtvAggregateOrder which sorts the children feeds
+ *
+ * Creates an empty aggregate feed. The children are added with
+ * ytv_aggregate_feed_add_feed().
+ *
+ * returns: (not-null) (caller-owns): a new #YtvAggregateFeed
+ */
+YtvFeed*
+ytv_aggregate_feed_new (YtvAggregateOrder order)
+{
+        return YTV_FEED (g_object_new (YTV_TYPE_AGGREGATE_FEED,
+                                       "order", order, NULL));
+}
+
+/**
+ * ytv_aggregate_feed_add_feed:
+ * @self: (not-null): a #YtvAggregateFeed
+ * @child: (not-null): a #YtvFeed with its query already set
+ *
+ * Adds @child to the merged feeds. @child must be sorted by the
+ * #YtvAggregateFeed:order of @self, and it must not share its
+ * #YtvUriBuilder. The entries already merged are forgotten.
+ */
+void
+ytv_aggregate_feed_add_feed (YtvFeed* self, YtvFeed* child)
+{
+        YtvAggregateFeedPriv* priv;
+        YtvAggregateSource* src;
+        YtvUriBuilder* ub;
+        gint start;
+
+        g_assert (YTV_IS_AGGREGATE_FEED (self));
+        g_assert (YTV_IS_FEED (child));
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        ytv_aggregate_feed_reset (self);
+
+        src = g_slice_new (YtvAggregateSource);
+        src->self = YTV_AGGREGATE_FEED (self);
+        src->feed = g_object_ref (child);
+        src->items = g_queue_new ();
+
+        ub = ytv_feed_get_uri_builder (child);
+        g_object_get (G_OBJECT (ub), "start-index", &start, NULL);
+        g_object_unref (ub);
+
+        src->first_start = MAX (start, 1);
+        src->next_start = src->first_start;
+        src->fetching = FALSE;
+        src->exhausted = FALSE;
+
+        g_ptr_array_add (priv->sources, src);
+        priv->starving++;
+
+        return;
+}
+
+/**
+ * ytv_aggregate_feed_reset:
+ * @self: (not-null): a #YtvAggregateFeed
+ *
+ * Forgets the merged entries, so the children are fetched again from
+ * their first page. The pages still in flight are discarded.
+ */
+void
+ytv_aggregate_feed_reset (YtvFeed* self)
+{
+        YtvAggregateFeedPriv* priv;
+        guint i;
+
+        g_assert (YTV_IS_AGGREGATE_FEED (self));
+
+        priv = YTV_AGGREGATE_FEED_GET_PRIVATE (self);
+
+        priv->serial++;
+
+        for (i = 0; i < priv->sources->len; i++)
+        {
+                source_clear (g_ptr_array_index (priv->sources, i));
+        }
+
+        priv->starving = priv->sources->len;
+        g_ptr_array_set_size (priv->heap, 0);
+
+        g_ptr_array_foreach (priv->merged, (GFunc) g_object_unref, NULL);
+        g_ptr_array_set_size (priv->merged, 0);
+        g_hash_table_remove_all (priv->seen);
+
+        if (priv->error != NULL)
+        {
+                g_error_free (priv->error);
+                priv->error = NULL;
+        }
+
+        return;
+}
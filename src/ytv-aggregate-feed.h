@@ -0,0 +1,86 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_AGGREGATE_FEED_H_
+#define _YTV_AGGREGATE_FEED_H_
+
+/* ytv-aggregate-feed.h - A feed which merges several feeds
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib-object.h>
+
+#include <ytv-feed.h>
+
+G_BEGIN_DECLS
+
+#define YTV_TYPE_AGGREGATE_FEED                 \
+        (ytv_aggregate_feed_get_type ())
+#define YTV_AGGREGATE_FEED(obj)                                         \
+        (G_TYPE_CHECK_INSTANCE_CAST ((obj), YTV_TYPE_AGGREGATE_FEED, YtvAggregateFeed))
+#define YTV_AGGREGATE_FEED_CLASS(klass)                                 \
+        (G_TYPE_CHECK_CLASS_CAST ((klass), YTV_TYPE_AGGREGATE_FEED, YtvAggregateFeedClass))
+#define YTV_IS_AGGREGATE_FEED(obj)                                      \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), YTV_TYPE_AGGREGATE_FEED))
+#define YTV_IS_AGGREGATE_FEED_CLASS(klass)                              \
+        (G_TYPE_CHECK_CLASS_TYPE ((klass), YTV_TYPE_AGGREGATE_FEED))
+#define YTV_AGGREGATE_FEED_GET_CLASS(obj)                               \
+        (G_TYPE_INSTANCE_GET_CLASS ((obj), YTV_TYPE_AGGREGATE_FEED, YtvAggregateFeedClass))
+
+#define YTV_TYPE_AGGREGATE_ORDER (ytv_aggregate_order_get_type ())
+
+/**
+ * YtvAggregateOrder:
+ *
+ * The key shared by the children feeds, which must be sorted by it
+ */
+enum _YtvAggregateOrder
+{
+        YTV_AGGREGATE_ORDER_PUBLISHED, /* the newest first */
+        YTV_AGGREGATE_ORDER_VIEWCOUNT  /* the most viewed first */
+};
+
+typedef enum _YtvAggregateOrder YtvAggregateOrder;
+
+typedef struct _YtvAggregateFeed YtvAggregateFeed;
+typedef struct _YtvAggregateFeedClass YtvAggregateFeedClass;
+
+/**
+ * YtvAggregateFeed:
+ *
+ * A #YtvFeed which merges the entries of several feeds
+ */
+struct _YtvAggregateFeed
+{
+        GObject parent;
+};
+
+struct _YtvAggregateFeedClass
+{
+        GObjectClass parent_class;
+};
+
+GType ytv_aggregate_order_get_type (void);
+GType ytv_aggregate_feed_get_type (void);
+
+YtvFeed* ytv_aggregate_feed_new (YtvAggregateOrder order);
+void ytv_aggregate_feed_add_feed (YtvFeed* self, YtvFeed* child);
+void ytv_aggregate_feed_reset (YtvFeed* self);
+
+G_END_DECLS
+
+#endif /* _YTV_AGGREGATE_FEED_H_ */
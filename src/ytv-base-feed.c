@@ -27,6 +27,28 @@
  *
  * This is an implementation of the #YtvFeed interface for the a basic feed
  * extractor
+ *
+ * The last delivered pages are kept in a history, keyed by their URI, so
+ * going back to a page already seen is answered from memory, without
+ * fetching nor parsing it again. The history is bounded by
+ * #YtvBaseFeed:history-size pages and #YtvBaseFeed:history-max-age
+ * seconds, and it may be emptied with ytv_base_feed_invalidate_history().
+ *
+ * The last delivered page is remembered too, so ytv_feed_refresh() fetches
+ * it again, skipping the history, and signals only the entries which were
+ * added, removed or changed since then.
+ *
+ * If a #YtvEntryIndex is set in #YtvBaseFeed:index, every parsed page is
+ * added to it, so a #YtvIndexFeed can search the fetched entries. Likewise,
+ * if a #YtvEntryStore is set in #YtvBaseFeed:store, every parsed page is
+ * kept on disk.
+ *
+ * With #YtvBaseFeed:stale-while-revalidate set, a page older than
+ * #YtvBaseFeed:history-max-age is still delivered from the history, or
+ * from the store if it is not in the history, without waiting for the
+ * network. Then it is fetched again in the background and, if it changed,
+ * the differences are signaled as on ytv_feed_refresh(), followed by
+ * #YtvFeed::entries-revalidated.
  */
 
 /**
@@ -41,50 +63,412 @@
 #include <config.h>
 #endif
 
+#include <time.h>
+
 #include <ytv-error.h>
 #include <ytv-base-feed.h>
 
 #include <ytv-feed-parse-strategy.h>
 #include <ytv-feed-fetch-strategy.h>
 #include <ytv-uri-builder.h>
+#include <ytv-list.h>
+#include <ytv-iterator.h>
+#include <ytv-entry.h>
+#include <ytv-entry-index.h>
+#include <ytv-entry-store.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
 
 enum _YtvBaseFeedProp
 {
         PROP_O,
-        PROP_URI
+        PROP_URI,
+        PROP_HISTORY_SIZE,
+        PROP_HISTORY_MAX_AGE,
+        PROP_INDEX,
+        PROP_STORE,
+        PROP_STALE_WHILE_REVALIDATE
 };
 
 typedef struct _YtvBaseFeedPriv YtvBaseFeedPriv;
 struct _YtvBaseFeedPriv
 {
-        YtvGetEntriesCallback cb;
         gchar* uri;
+
+        GHashTable* history; /* uri -> YtvHistoryItem */
+        GQueue* lru;         /* of YtvHistoryItem, the most recent first */
+        guint history_size;
+        guint history_max_age;
+
+        gchar* last_uri;     /* the last delivered page, to refresh it */
+        YtvList* last;
+
+        GList* pending;      /* of YtvFeedRequest, to cancel them */
+
+        YtvEntryIndex* index; /* fed with every parsed page */
+        YtvEntryStore* store; /* likewise */
+
+        gboolean swr;        /* delivers stale pages, then fetches them */
+};
+
+/* a page already delivered */
+typedef struct _YtvHistoryItem YtvHistoryItem;
+struct _YtvHistoryItem
+{
+        gchar* uri;
+        YtvList* list;
+        time_t stamp;
+        GList* link; /* in the lru queue */
+};
+
+/* every request keeps its own callback, so they may overlap */
+typedef struct _YtvFeedRequest YtvFeedRequest;
+struct _YtvFeedRequest
+{
+        YtvBaseFeed* self;
+        gchar* uri;
+        YtvGetEntriesCallback cb;
         gpointer user_data;
+        gboolean refresh;
+        gboolean revalidate; /* of a stale page already delivered */
 };
 
+#define HISTORY_SIZE    8
+#define HISTORY_MAX_AGE 300 /* seconds */
+
 #define YTV_BASE_FEED_GET_PRIVATE(obj)  \
         (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_BASE_FEED, YtvBaseFeedPriv))
 
+static void
+history_remove (YtvBaseFeedPriv* priv, YtvHistoryItem* item)
+{
+        g_hash_table_remove (priv->history, item->uri);
+        g_queue_delete_link (priv->lru, item->link);
+
+        g_object_unref (item->list);
+        g_free (item->uri);
+        g_slice_free (YtvHistoryItem, item);
+
+        return;
+}
+
+/* drops the least recently used pages over the size */
+static void
+history_trim (YtvBaseFeedPriv* priv)
+{
+        while (g_queue_get_length (priv->lru) > priv->history_size)
+        {
+                history_remove (priv,
+                                (YtvHistoryItem*) g_queue_peek_tail (priv->lru));
+        }
+
+        return;
+}
+
+static void
+history_add (YtvBaseFeedPriv* priv, const gchar* uri, YtvList* list)
+{
+        YtvHistoryItem* item;
+
+        if (priv->history_size == 0)
+        {
+                return;
+        }
+
+        item = g_hash_table_lookup (priv->history, uri);
+
+        if (item != NULL)
+        {
+                history_remove (priv, item);
+        }
+
+        item = g_slice_new (YtvHistoryItem);
+        item->uri = g_strdup (uri);
+        item->list = ytv_list_copy (list); /* the caller owns the original */
+        item->stamp = time (NULL);
+
+        g_queue_push_head (priv->lru, item);
+        item->link = g_queue_peek_head_link (priv->lru);
+        g_hash_table_insert (priv->history, item->uri, item);
+
+        history_trim (priv);
+
+        return;
+}
+
+/* returns a new copy of the page, or NULL if it is not fresh in the
+ * history; if stale pages are delivered, they are returned and flagged */
+static YtvList*
+history_lookup (YtvBaseFeedPriv* priv, const gchar* uri, gboolean* stale)
+{
+        YtvHistoryItem* item;
+
+        item = g_hash_table_lookup (priv->history, uri);
+
+        if (item == NULL)
+        {
+                return NULL;
+        }
+
+        *stale = (priv->history_max_age > 0 &&
+                  time (NULL) - item->stamp > (time_t) priv->history_max_age);
+
+        if (*stale && !priv->swr)
+        {
+                history_remove (priv, item);
+                return NULL;
+        }
+
+        g_queue_unlink (priv->lru, item->link);
+        g_queue_push_head_link (priv->lru, item->link);
+
+        return ytv_list_copy (item->list);
+}
+
+static void
+history_clear (YtvBaseFeedPriv* priv)
+{
+        while (!g_queue_is_empty (priv->lru))
+        {
+                history_remove (priv,
+                                (YtvHistoryItem*) g_queue_peek_head (priv->lru));
+        }
+
+        return;
+}
+
+static void
+last_clear (YtvBaseFeedPriv* priv)
+{
+        if (priv->last != NULL)
+        {
+                g_object_unref (priv->last);
+                priv->last = NULL;
+        }
+
+        g_free (priv->last_uri);
+        priv->last_uri = NULL;
+
+        return;
+}
+
+static void
+last_set (YtvBaseFeedPriv* priv, const gchar* uri, YtvList* list)
+{
+        last_clear (priv);
+
+        priv->last_uri = g_strdup (uri);
+        priv->last = ytv_list_copy (list); /* the caller owns the original */
+
+        return;
+}
+
+/* the entries of @list keyed by their id */
+static GHashTable*
+index_entries (YtvList* list)
+{
+        GHashTable* index;
+        YtvIterator* iter;
+
+        index = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                       g_free, g_object_unref);
+
+        iter = ytv_list_create_iterator (list);
+
+        while (!ytv_iterator_is_done (iter))
+        {
+                GObject* entry;
+                gchar* id;
+
+                entry = ytv_iterator_get_current (iter);
+                g_object_get (entry, "id", &id, NULL);
+
+                if (id != NULL)
+                {
+                        g_hash_table_replace (index, id, entry);
+                }
+                else
+                {
+                        g_object_unref (entry);
+                }
+
+                ytv_iterator_next (iter);
+        }
+
+        g_object_unref (iter);
+
+        return index;
+}
+
+/* signals the differences between the previous page and the refreshed one */
+static void
+emit_diff (YtvBaseFeed* self, YtvList* old, YtvList* new)
+{
+        GHashTable* oldidx;
+        GHashTable* newidx;
+        YtvIterator* iter;
+        GObject* entry;
+        gchar* id;
+        gint pos;
+
+        YTV_TRACE_BEGIN ("feed", "emit_diff");
+
+        oldidx = index_entries (old);
+        newidx = index_entries (new);
+
+        iter = ytv_list_create_iterator (old);
+
+        for (pos = 0; !ytv_iterator_is_done (iter); pos++)
+        {
+                entry = ytv_iterator_get_current (iter);
+                g_object_get (entry, "id", &id, NULL);
+
+                if (id != NULL && g_hash_table_lookup (newidx, id) == NULL)
+                {
+                        g_signal_emit_by_name (self, "entry-removed",
+                                               entry, pos);
+                }
+
+                g_free (id);
+                g_object_unref (entry);
+                ytv_iterator_next (iter);
+        }
+
+        g_object_unref (iter);
+
+        iter = ytv_list_create_iterator (new);
+
+        for (pos = 0; !ytv_iterator_is_done (iter); pos++)
+        {
+                GObject* prev;
+                guint fields;
+
+                entry = ytv_iterator_get_current (iter);
+                g_object_get (entry, "id", &id, NULL);
+
+                prev = (id != NULL) ? g_hash_table_lookup (oldidx, id) : NULL;
+
+                if (prev == NULL)
+                {
+                        g_signal_emit_by_name (self, "entry-added",
+                                               entry, pos);
+                }
+                else
+                {
+                        fields = ytv_entry_diff (YTV_ENTRY (prev),
+                                                 YTV_ENTRY (entry));
+
+                        if (fields != 0)
+                        {
+                                g_signal_emit_by_name (self, "entry-changed",
+                                                       entry, fields);
+                        }
+                }
+
+                g_free (id);
+                g_object_unref (entry);
+                ytv_iterator_next (iter);
+        }
+
+        g_object_unref (iter);
+
+        g_hash_table_destroy (oldidx);
+        g_hash_table_destroy (newidx);
+
+        YTV_TRACE_END ("feed", "emit_diff");
+
+        return;
+}
+
+/* whether the pages have other entries, in other order or other fields */
+static gboolean
+page_differs (YtvList* old, YtvList* new)
+{
+        YtvIterator* olditer;
+        YtvIterator* newiter;
+        GObject* oldentry;
+        GObject* newentry;
+        gchar* oldid;
+        gchar* newid;
+        gboolean retval;
+
+        if (ytv_list_get_length (old) != ytv_list_get_length (new))
+        {
+                return TRUE;
+        }
+
+        retval = FALSE;
+        olditer = ytv_list_create_iterator (old);
+        newiter = ytv_list_create_iterator (new);
+
+        while (!retval && !ytv_iterator_is_done (olditer) &&
+               !ytv_iterator_is_done (newiter))
+        {
+                oldentry = ytv_iterator_get_current (olditer);
+                newentry = ytv_iterator_get_current (newiter);
+
+                g_object_get (oldentry, "id", &oldid, NULL);
+                g_object_get (newentry, "id", &newid, NULL);
+
+                retval = g_strcmp0 (oldid, newid) != 0 ||
+                        ytv_entry_diff (YTV_ENTRY (oldentry),
+                                        YTV_ENTRY (newentry)) != 0;
+
+                g_free (oldid);
+                g_free (newid);
+                g_object_unref (oldentry);
+                g_object_unref (newentry);
+                ytv_iterator_next (olditer);
+                ytv_iterator_next (newiter);
+        }
+
+        g_object_unref (olditer);
+        g_object_unref (newiter);
+
+        return retval;
+}
+
+static void
+request_free (YtvFeedRequest* req)
+{
+        g_object_unref (req->self);
+        g_free (req->uri);
+        g_slice_free (YtvFeedRequest, req);
+
+        return;
+}
+
 static void
 fetch_feed_cb (YtvFeedFetchStrategy* st, const gchar* mime,
                const gint8* response, gssize length, GError **err,
                gpointer user_data)
 {
+        YtvFeedRequest* req;
         YtvBaseFeed* self;
         YtvBaseFeedPriv* priv;
         YtvList *feed = NULL;
         GError *tmp_error = NULL;
+        gboolean cancelled;
 
-        g_return_if_fail (YTV_IS_BASE_FEED (user_data));
+        req = (YtvFeedRequest*) user_data;
 
-        self = YTV_BASE_FEED (user_data);
+        g_return_if_fail (YTV_IS_BASE_FEED (req->self));
+
+        self = req->self;
         priv = YTV_BASE_FEED_GET_PRIVATE (self);
 
         feed = NULL;
         tmp_error = NULL;
+        cancelled = FALSE;
+
+        YTV_TRACE_BEGIN ("feed", "fetch_feed_cb");
+
+        priv->pending = g_list_remove (priv->pending, req);
 
         if (err != NULL && *err != NULL)
         {
+                cancelled = g_error_matches (*err, YTV_HTTP_ERROR,
+                                             YTV_HTTP_ERROR_CANCELLED);
                 goto beach;
         }           
 
@@ -100,19 +484,87 @@ fetch_feed_cb (YtvFeedFetchStrategy* st, const gchar* mime,
                 {
                         g_propagate_error (err, tmp_error);
                 }
+                else if (feed != NULL)
+                {
+                        history_add (priv, req->uri, feed);
+
+                        if (priv->index != NULL)
+                        {
+                                ytv_entry_index_add_list (priv->index, feed);
+                        }
+
+                        if (priv->store != NULL)
+                        {
+                                ytv_entry_store_put_list (priv->store, feed);
+                                ytv_entry_store_put_page (priv->store,
+                                                          req->uri, feed);
+                        }
+
+                        /* a refresh of a page already left is not diffed,
+                         * nor a revalidated page which did not change */
+                        if (!req->refresh)
+                        {
+                                last_set (priv, req->uri, feed);
+                        }
+                        else if (priv->last != NULL &&
+                                 g_strcmp0 (priv->last_uri, req->uri) == 0 &&
+                                 (!req->revalidate ||
+                                  page_differs (priv->last, feed)))
+                        {
+                                emit_diff (self, priv->last, feed);
+                                last_set (priv, req->uri, feed);
+
+                                if (req->revalidate)
+                                {
+                                        ytv_stats_inc (YTV_STATS_REVALIDATIONS);
+                                        g_signal_emit_by_name
+                                                (self, "entries-revalidated",
+                                                 feed);
+                                }
+                        }
+                        else if (!req->revalidate &&
+                                 g_strcmp0 (priv->last_uri, req->uri) != 0)
+                        {
+                                /* the caller would apply it to the page
+                                 * shown now, so it is reported cancelled */
+                                g_object_unref (feed);
+                                feed = NULL;
+                                cancelled = TRUE;
+                        }
+                }
         }
         else
         {
                 g_set_error (err, YTV_PARSE_ERROR, YTV_PARSE_ERROR_BAD_MIME,
                              "Bad MIME type receibed - %s", mime);
+                ytv_stats_count_error (*err);
         }
 
 beach:
-        if (priv->cb != NULL)
+        if (req->cb != NULL)
+        {
+                req->cb (YTV_FEED (self), cancelled, feed, err,
+                         req->user_data);
+        }
+        else
         {
-                priv->cb (YTV_FEED (self), FALSE, feed, err, priv->user_data);
+                /* nobody waits for a revalidation */
+                if (feed != NULL)
+                {
+                        g_object_unref (feed);
+                }
+
+                if (err != NULL && *err != NULL)
+                {
+                        g_error_free (*err);
+                        *err = NULL;
+                }
         }
 
+        request_free (req);
+
+        YTV_TRACE_END ("feed", "fetch_feed_cb");
+
         return;
 }
 
@@ -143,6 +595,29 @@ ytv_base_feed_get_fetch_strategy_default (YtvFeed* self)
         return NULL;
 }
 
+/* asks the uri builder, if it can, only for the fields the parser reads */
+static void
+sync_fields (YtvBaseFeed* self)
+{
+        const gchar* fields;
+
+        if (self->uribuild == NULL || self->parsest == NULL)
+        {
+                return;
+        }
+
+        if (g_object_class_find_property (G_OBJECT_GET_CLASS (self->uribuild),
+                                          "fields") == NULL)
+        {
+                return;
+        }
+
+        fields = ytv_feed_parse_strategy_get_fields (self->parsest);
+        g_object_set (self->uribuild, "fields", fields, NULL);
+
+        return;
+}
+
 static void
 ytv_base_feed_set_parse_strategy_default (YtvFeed* self,
                                           YtvFeedParseStrategy* st)
@@ -152,6 +627,8 @@ ytv_base_feed_set_parse_strategy_default (YtvFeed* self,
         me = YTV_BASE_FEED (self);
         me->parsest = g_object_ref (st);
 
+        sync_fields (me);
+
         return;
 }
 
@@ -193,6 +670,8 @@ ytv_base_feed_set_uri_builder_default (YtvFeed* self, YtvUriBuilder* ub)
         me = YTV_BASE_FEED (self);
         me->uribuild = g_object_ref (ub);
 
+        sync_fields (me);
+
         return;
 }
 
@@ -334,6 +813,31 @@ ytv_base_feed_related_default (YtvFeed* self, const gchar* vid)
         return;                
 }
 
+/* fetches again, in the background, a stale page already delivered */
+static void
+revalidate (YtvBaseFeed* self, gchar* uri)
+{
+        YtvBaseFeedPriv* priv;
+        YtvFeedRequest* req;
+
+        priv = YTV_BASE_FEED_GET_PRIVATE (self);
+
+        req = g_slice_new (YtvFeedRequest);
+        req->self = g_object_ref (self);
+        req->uri = uri; /* takes it */
+        req->cb = NULL;
+        req->user_data = NULL;
+        req->refresh = TRUE;
+        req->revalidate = TRUE;
+
+        priv->pending = g_list_prepend (priv->pending, req);
+
+        ytv_feed_fetch_strategy_perform (self->fetchst, req->uri,
+                                         fetch_feed_cb, req);
+
+        return;
+}
+
 static void
 ytv_base_feed_get_entries_async_default (YtvFeed* self,
                                          YtvGetEntriesCallback callback,
@@ -341,6 +845,9 @@ ytv_base_feed_get_entries_async_default (YtvFeed* self,
 {
         YtvBaseFeed* me;
         YtvBaseFeedPriv* priv;
+        YtvFeedRequest* req;
+        YtvList* list;
+        gboolean stale;
 
         me = YTV_BASE_FEED (self);
         priv = YTV_BASE_FEED_GET_PRIVATE (me);
@@ -356,19 +863,140 @@ ytv_base_feed_get_entries_async_default (YtvFeed* self,
                 g_object_notify (G_OBJECT (self), "uri");
         }
 
-        priv->cb = callback;
-        priv->user_data = user_data;
+        stale = FALSE;
+        list = history_lookup (priv, priv->uri, &stale);
+
+        if (list == NULL && priv->swr && priv->store != NULL)
+        {
+                list = ytv_entry_store_get_page (priv->store, priv->uri);
+                stale = TRUE;
+
+                if (list != NULL && ytv_list_get_length (list) == 0)
+                {
+                        g_object_unref (list);
+                        list = NULL;
+                }
+        }
+
+        if (list != NULL)
+        {
+                GError* err = NULL;
+                gchar* uri;
+
+                ytv_stats_inc (stale ?
+                               YTV_STATS_STALE_HITS : YTV_STATS_HISTORY_HITS);
+
+                uri = priv->uri;
+                priv->uri = NULL;
+
+                last_set (priv, uri, list);
+                g_object_notify (G_OBJECT (self), "uri");
+
+                if (callback != NULL)
+                {
+                        callback (self, FALSE, list, &err, user_data);
+                }
+                else
+                {
+                        g_object_unref (list);
+                }
+
+                if (stale)
+                {
+                        revalidate (me, uri);
+                }
+                else
+                {
+                        g_free (uri);
+                }
+
+                return;
+        }
+
+        req = g_slice_new (YtvFeedRequest);
+        req->self = g_object_ref (me);
+        req->uri = priv->uri; /* takes it */
+        req->cb = callback;
+        req->user_data = user_data;
+        req->refresh = FALSE;
+        req->revalidate = FALSE;
+
+        priv->uri = NULL;
+        priv->pending = g_list_prepend (priv->pending, req);
         
-        ytv_feed_fetch_strategy_perform (me->fetchst, priv->uri,
-                                         fetch_feed_cb, me);
+        ytv_feed_fetch_strategy_perform (me->fetchst, req->uri,
+                                         fetch_feed_cb, req);
 
-        /* @todo put this uri in a history ?? */
-        clean_uri (&priv->uri);
         g_object_notify (G_OBJECT (self), "uri");
        
         return;
 }
 
+static void
+ytv_base_feed_refresh_default (YtvFeed* self,
+                               YtvGetEntriesCallback callback,
+                               gpointer user_data)
+{
+        YtvBaseFeed* me;
+        YtvBaseFeedPriv* priv;
+        YtvFeedRequest* req;
+
+        me = YTV_BASE_FEED (self);
+        priv = YTV_BASE_FEED_GET_PRIVATE (me);
+
+        g_return_if_fail (me->parsest != NULL);
+        g_return_if_fail (me->fetchst != NULL);
+
+        if (priv->last_uri == NULL)
+        {
+                g_warning ("No page has been delivered to refresh");
+                return;
+        }
+
+        /* skips the history, the point is to get the fresh page */
+        req = g_slice_new (YtvFeedRequest);
+        req->self = g_object_ref (me);
+        req->uri = g_strdup (priv->last_uri);
+        req->cb = callback;
+        req->user_data = user_data;
+        req->refresh = TRUE;
+        req->revalidate = FALSE;
+
+        priv->pending = g_list_prepend (priv->pending, req);
+
+        ytv_feed_fetch_strategy_perform (me->fetchst, req->uri,
+                                         fetch_feed_cb, req);
+
+        return;
+}
+
+static void
+ytv_base_feed_cancel_default (YtvFeed* self)
+{
+        YtvBaseFeed* me;
+        YtvBaseFeedPriv* priv;
+        GList* pending;
+        GList* l;
+
+        me = YTV_BASE_FEED (self);
+        priv = YTV_BASE_FEED_GET_PRIVATE (me);
+
+        /* the callbacks may run, and free the requests, while cancelling */
+        pending = g_list_copy (priv->pending);
+
+        for (l = pending; l != NULL; l = l->next)
+        {
+                if (g_list_find (priv->pending, l->data) != NULL)
+                {
+                        ytv_feed_fetch_strategy_cancel (me->fetchst, l->data);
+                }
+        }
+
+        g_list_free (pending);
+
+        return;
+}
+
 static void
 ytv_feed_init (YtvFeedIface* klass)
 {
@@ -386,6 +1014,32 @@ ytv_feed_init (YtvFeedIface* klass)
         klass->related = ytv_base_feed_related;
 
         klass->get_entries_async = ytv_base_feed_get_entries_async;
+        klass->refresh = ytv_base_feed_refresh;
+        klass->cancel = ytv_base_feed_cancel;
+
+        return;
+}
+
+static void
+ytv_base_feed_invalidate_history_default (YtvFeed* self, const gchar* uri)
+{
+        YtvBaseFeedPriv* priv;
+        YtvHistoryItem* item;
+
+        priv = YTV_BASE_FEED_GET_PRIVATE (self);
+
+        if (uri == NULL)
+        {
+                history_clear (priv);
+                return;
+        }
+
+        item = g_hash_table_lookup (priv->history, uri);
+
+        if (item != NULL)
+        {
+                history_remove (priv, item);
+        }
 
         return;
 }
@@ -407,6 +1061,62 @@ ytv_base_feed_get_property (GObject* object, guint prop_id,
         case PROP_URI:
                 g_value_set_string (value, priv->uri);
                 break;
+        case PROP_HISTORY_SIZE:
+                g_value_set_uint (value, priv->history_size);
+                break;
+        case PROP_HISTORY_MAX_AGE:
+                g_value_set_uint (value, priv->history_max_age);
+                break;
+        case PROP_INDEX:
+                g_value_set_object (value, priv->index);
+                break;
+        case PROP_STORE:
+                g_value_set_object (value, priv->store);
+                break;
+        case PROP_STALE_WHILE_REVALIDATE:
+                g_value_set_boolean (value, priv->swr);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_base_feed_set_property (GObject* object, guint prop_id,
+                            const GValue* value, GParamSpec* spec)
+{
+        YtvBaseFeedPriv* priv;
+        priv = YTV_BASE_FEED_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_HISTORY_SIZE:
+                priv->history_size = g_value_get_uint (value);
+                history_trim (priv);
+                break;
+        case PROP_HISTORY_MAX_AGE:
+                priv->history_max_age = g_value_get_uint (value);
+                break;
+        case PROP_INDEX:
+                if (priv->index != NULL)
+                {
+                        g_object_unref (priv->index);
+                }
+                priv->index = g_value_dup_object (value);
+                break;
+        case PROP_STORE:
+                if (priv->store != NULL)
+                {
+                        g_object_unref (priv->store);
+                }
+                priv->store = g_value_dup_object (value);
+                break;
+        case PROP_STALE_WHILE_REVALIDATE:
+                priv->swr = g_value_get_boolean (value);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -419,7 +1129,25 @@ static void
 ytv_base_feed_dispose (GObject* object)
 {
         YtvBaseFeed* self;
+        YtvBaseFeedPriv* priv;
+
         self = YTV_BASE_FEED (object);
+        priv = YTV_BASE_FEED_GET_PRIVATE (self);
+
+        history_clear (priv);
+        last_clear (priv);
+
+        if (priv->index != NULL)
+        {
+                g_object_unref (priv->index);
+                priv->index = NULL;
+        }
+
+        if (priv->store != NULL)
+        {
+                g_object_unref (priv->store);
+                priv->store = NULL;
+        }
 
         (*G_OBJECT_CLASS (ytv_base_feed_parent_class)->dispose) (object);
 
@@ -457,6 +1185,9 @@ ytv_base_feed_finalize (GObject* object)
 
         clean_uri (&priv->uri);
 
+        g_hash_table_destroy (priv->history);
+        g_queue_free (priv->lru);
+
         (*G_OBJECT_CLASS (ytv_base_feed_parent_class)->finalize) (object);
 
         return;
@@ -472,6 +1203,7 @@ ytv_base_feed_class_init (YtvBaseFeedClass* klass)
         g_type_class_add_private (g_klass, sizeof (YtvBaseFeedPriv));
         
         g_klass->get_property = ytv_base_feed_get_property;
+        g_klass->set_property = ytv_base_feed_set_property;
         g_klass->dispose      = ytv_base_feed_dispose;
         g_klass->finalize     = ytv_base_feed_finalize;
 
@@ -489,11 +1221,49 @@ ytv_base_feed_class_init (YtvBaseFeedClass* klass)
         klass->related  = ytv_base_feed_related_default;
 
         klass->get_entries_async = ytv_base_feed_get_entries_async_default;
+        klass->refresh = ytv_base_feed_refresh_default;
+        klass->cancel = ytv_base_feed_cancel_default;
+        klass->invalidate_history = ytv_base_feed_invalidate_history_default;
 
         g_object_class_install_property
                 (g_klass, PROP_URI,
                  g_param_spec_string
                  ("uri", "URI", "Feed URI", NULL, G_PARAM_READABLE));
+
+        g_object_class_install_property
+                (g_klass, PROP_HISTORY_SIZE,
+                 g_param_spec_uint
+                 ("history-size", "history_size",
+                  "Number of delivered pages kept in memory, zero disables it",
+                  0, G_MAXUINT, HISTORY_SIZE, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (g_klass, PROP_HISTORY_MAX_AGE,
+                 g_param_spec_uint
+                 ("history-max-age", "history_max_age",
+                  "Seconds a page is reused from the history, zero is forever",
+                  0, G_MAXUINT, HISTORY_MAX_AGE, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (g_klass, PROP_INDEX,
+                 g_param_spec_object
+                 ("index", "index",
+                  "The index fed with the entries of every fetched page",
+                  YTV_TYPE_ENTRY_INDEX, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (g_klass, PROP_STORE,
+                 g_param_spec_object
+                 ("store", "store",
+                  "The store fed with the entries of every fetched page",
+                  YTV_TYPE_ENTRY_STORE, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (g_klass, PROP_STALE_WHILE_REVALIDATE,
+                 g_param_spec_boolean
+                 ("stale-while-revalidate", "stalewhilerevalidate",
+                  "Deliver the stale pages kept, then fetch them again",
+                  FALSE, G_PARAM_READWRITE));
         
         return;
 }
@@ -508,9 +1278,19 @@ ytv_base_feed_init (YtvBaseFeed* self)
         self->parsest = NULL;
         self->fetchst = NULL;
 
-        priv->cb = NULL;
         priv->uri = NULL;
-        priv->user_data = NULL;
+
+        priv->history = g_hash_table_new (g_str_hash, g_str_equal);
+        priv->lru = g_queue_new ();
+        priv->history_size = HISTORY_SIZE;
+        priv->history_max_age = HISTORY_MAX_AGE;
+
+        priv->last_uri = NULL;
+        priv->last = NULL;
+        priv->pending = NULL;
+        priv->index = NULL;
+        priv->store = NULL;
+        priv->swr = FALSE;
 
         return;
 }
@@ -763,6 +1543,46 @@ ytv_base_feed_get_entries_async (YtvFeed* self,
         return;        
 }
 
+/**
+ * ytv_base_feed_refresh:
+ * @self: (not-null): a #YtvFeed implementation
+ * @callback: (not-null): a #YtvGetEntriesCallback callback
+ * @user_data: (null-ok): a pointer to any user data
+ *
+ * Fetches again the last delivered page, signaling the entries which
+ * changed since it was delivered, and then executes @callback with it.
+ */
+void
+ytv_base_feed_refresh (YtvFeed* self,
+                       YtvGetEntriesCallback callback,
+                       gpointer user_data)
+{
+        g_assert (self != NULL);
+        g_assert (YTV_IS_BASE_FEED (self));
+
+        YTV_BASE_FEED_GET_CLASS (self)->refresh (self, callback, user_data);
+
+        return;
+}
+
+/**
+ * ytv_base_feed_cancel:
+ * @self: (not-null): a #YtvFeed implementation
+ *
+ * Cancels the requests in flight. Their callbacks are called with
+ * @cancelled set to %TRUE.
+ */
+void
+ytv_base_feed_cancel (YtvFeed* self)
+{
+        g_assert (self != NULL);
+        g_assert (YTV_IS_BASE_FEED (self));
+
+        YTV_BASE_FEED_GET_CLASS (self)->cancel (self);
+
+        return;
+}
+
 /**
  * ytv_base_feed_new:
  *
@@ -775,3 +1595,22 @@ ytv_base_feed_new ()
 {
         return YTV_FEED (g_object_new (YTV_TYPE_BASE_FEED, NULL));
 }
+
+/**
+ * ytv_base_feed_invalidate_history:
+ * @self: (not-null): a #YtvFeed implementation
+ * @uri: (null-ok): the URI of the page to forget
+ *
+ * Removes the page of @uri from the history, or every page if @uri is
+ * %NULL, so it is fetched again the next time it is requested.
+ */
+void
+ytv_base_feed_invalidate_history (YtvFeed* self, const gchar* uri)
+{
+        g_assert (self != NULL);
+        g_assert (YTV_IS_BASE_FEED (self));
+
+        YTV_BASE_FEED_GET_CLASS (self)->invalidate_history (self, uri);
+
+        return;
+}
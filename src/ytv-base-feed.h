@@ -78,6 +78,10 @@ struct _YtvBaseFeedClass
         void (*get_entries_async) (YtvFeed* self,
                                    YtvGetEntriesCallback callback,
                                    gpointer user_data);
+        void (*refresh) (YtvFeed* self, YtvGetEntriesCallback callback,
+                         gpointer user_data);
+        void (*cancel) (YtvFeed* self);
+        void (*invalidate_history) (YtvFeed* self, const gchar* uri);
 };
 
 GType ytv_base_feed_get_type (void);
@@ -102,6 +106,10 @@ void ytv_base_feed_related (YtvFeed* self, const gchar* vid);
 void ytv_base_feed_get_entries_async (YtvFeed* self,
                                       YtvGetEntriesCallback callback,
                                       gpointer user_data);
+void ytv_base_feed_refresh (YtvFeed* self, YtvGetEntriesCallback callback,
+                            gpointer user_data);
+void ytv_base_feed_cancel (YtvFeed* self);
+void ytv_base_feed_invalidate_history (YtvFeed* self, const gchar* uri);
 
 G_END_DECLS
 
@@ -0,0 +1,350 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-cli.c - streams the entries of a feed as JSON lines
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Crawls a feed (a search, the uploads of a user, the related videos of
+ * one, or a standard feed) with a YtvFeedCrawler and writes every entry
+ * to the standard output as a JSON object per line, in the feed order.
+ * It only links the core library: neither GTK nor GConf are loaded.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <ytv-entry.h>
+#include <ytv-soup-feed-fetch-strategy.h>
+#include <ytv-json-feed-parse-strategy.h>
+#include <ytv-youtube-uri-builder.h>
+#include <ytv-base-feed.h>
+#include <ytv-feed-crawler.h>
+#include <ytv-error.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
+
+static gchar* search = NULL;
+static gchar* user = NULL;
+static gchar* related = NULL;
+static gint standard = 0;
+static gint max_entries = 0;
+static gint max_results = 50;
+static gint parallel = 4;
+static gchar* proxy = NULL;
+static gchar* base_uri = NULL;
+static gchar* stats_file = NULL;
+
+static const GOptionEntry entries[] =
+{
+        { "search", 's', 0, G_OPTION_ARG_STRING, &search,
+          "the videos which match a query", "QUERY" },
+        { "user", 'u', 0, G_OPTION_ARG_STRING, &user,
+          "the videos uploaded by a user", "USER" },
+        { "related", 'r', 0, G_OPTION_ARG_STRING, &related,
+          "the videos related to another one", "ID" },
+        { "standard", 'S', 0, G_OPTION_ARG_INT, &standard,
+          "a standard feed, from 1 (top rated) to 9", "N" },
+        { "max-entries", 'n', 0, G_OPTION_ARG_INT, &max_entries,
+          "stop after this number of entries (all)", "N" },
+        { "max-results", 'm', 0, G_OPTION_ARG_INT, &max_results,
+          "entries per page (50)", "N" },
+        { "parallel", 'j', 0, G_OPTION_ARG_INT, &parallel,
+          "pages requested at the same time (4)", "N" },
+        { "proxy", 'p', 0, G_OPTION_ARG_STRING, &proxy,
+          "URI of the HTTP proxy (none)", "URI" },
+        { "base-uri", 0, 0, G_OPTION_ARG_STRING, &base_uri,
+          "URI prefix of the GData feeds", "URI" },
+        { "stats", 0, 0, G_OPTION_ARG_FILENAME, &stats_file,
+          "dump the statistics to a file at the end", "FILE" },
+        { NULL }
+};
+
+typedef struct _Run Run;
+
+struct _Run
+{
+        GMainLoop* loop;
+        GString* line;    /* reused for every entry */
+        gint entries;
+        gboolean failed;
+};
+
+/* appends @str as a JSON string, or null */
+static void
+append_string (GString* line, const gchar* str)
+{
+        const gchar* p;
+
+        if (str == NULL)
+        {
+                g_string_append (line, "null");
+                return;
+        }
+
+        g_string_append_c (line, '"');
+
+        for (p = str; *p != '\0'; p++)
+        {
+                switch (*p)
+                {
+                case '"':
+                        g_string_append (line, "\\\"");
+                        break;
+                case '\\':
+                        g_string_append (line, "\\\\");
+                        break;
+                case '\n':
+                        g_string_append (line, "\\n");
+                        break;
+                case '\r':
+                        g_string_append (line, "\\r");
+                        break;
+                case '\t':
+                        g_string_append (line, "\\t");
+                        break;
+                default:
+                        if ((guchar) *p < 0x20)
+                        {
+                                g_string_append_printf (line, "\\u%04x",
+                                                        (guchar) *p);
+                        }
+                        else
+                        {
+                                /* the UTF-8 sequences go as they are */
+                                g_string_append_c (line, *p);
+                        }
+                        break;
+                }
+        }
+
+        g_string_append_c (line, '"');
+
+        return;
+}
+
+static void
+entry_crawled_cb (YtvFeedCrawler* crawler, YtvEntry* entry,
+                  gpointer user_data)
+{
+        Run* run;
+        gchar *id, *author, *title, *published, *category, *tags, *desc;
+        gint duration;
+        guint views;
+        gfloat rating;
+        gchar rating_str[G_ASCII_DTOSTR_BUF_SIZE];
+
+        run = (Run*) user_data;
+
+        g_object_get (G_OBJECT (entry), "id", &id, "author", &author,
+                      "title", &title, "published", &published,
+                      "category", &category, "tags", &tags,
+                      "description", &desc, "duration", &duration,
+                      "views", &views, "rating", &rating, NULL);
+
+        g_string_truncate (run->line, 0);
+
+        g_string_append (run->line, "{\"id\":");
+        append_string (run->line, id);
+        g_string_append (run->line, ",\"author\":");
+        append_string (run->line, author);
+        g_string_append (run->line, ",\"title\":");
+        append_string (run->line, title);
+        g_string_append (run->line, ",\"published\":");
+        append_string (run->line, published);
+        g_string_append (run->line, ",\"category\":");
+        append_string (run->line, category);
+        g_string_append (run->line, ",\"tags\":");
+        append_string (run->line, tags);
+        g_string_append (run->line, ",\"description\":");
+        append_string (run->line, desc);
+
+        /* the locale must not turn the decimal point into a comma */
+        g_ascii_formatd (rating_str, sizeof (rating_str), "%.2f", rating);
+        g_string_append_printf (run->line,
+                                ",\"duration\":%d,\"views\":%u,"
+                                "\"rating\":%s}\n",
+                                duration, views, rating_str);
+
+        fwrite (run->line->str, 1, run->line->len, stdout);
+        run->entries++;
+
+        g_free (id);
+        g_free (author);
+        g_free (title);
+        g_free (published);
+        g_free (category);
+        g_free (tags);
+        g_free (desc);
+
+        return;
+}
+
+static void
+finished_cb (YtvFeedCrawler* crawler, GError* err, gpointer user_data)
+{
+        Run* run;
+
+        run = (Run*) user_data;
+
+        if (err != NULL)
+        {
+                g_printerr ("crawl failed: %s\n", ytv_error_get_message (err));
+                run->failed = TRUE;
+        }
+
+        g_main_loop_quit (run->loop);
+
+        return;
+}
+
+static YtvFeed*
+feed_new (void)
+{
+        YtvFeed* feed;
+        YtvFeedFetchStrategy* fetchst;
+        YtvFeedParseStrategy* parsest;
+        YtvUriBuilder* ub;
+
+        feed = ytv_base_feed_new ();
+        fetchst = ytv_soup_feed_fetch_strategy_new ();
+        parsest = ytv_json_feed_parse_strategy_new ();
+        ub = ytv_youtube_uri_builder_new ();
+
+        g_object_set (G_OBJECT (fetchst), "proxy-uri", proxy, NULL);
+        g_object_set (G_OBJECT (ub), "max-results", max_results, NULL);
+
+        if (base_uri != NULL)
+        {
+                g_object_set (G_OBJECT (ub), "base-uri", base_uri, NULL);
+        }
+
+        ytv_feed_set_fetch_strategy (feed, fetchst);
+        ytv_feed_set_parse_strategy (feed, parsest);
+        ytv_feed_set_uri_builder (feed, ub);
+
+        g_object_unref (fetchst);
+        g_object_unref (parsest);
+        g_object_unref (ub);
+
+        if (search != NULL)
+        {
+                ytv_feed_search (feed, search);
+        }
+        else if (user != NULL)
+        {
+                ytv_feed_user (feed, user);
+        }
+        else if (related != NULL)
+        {
+                ytv_feed_related (feed, related);
+        }
+        else
+        {
+                ytv_feed_standard (feed, standard);
+        }
+
+        return feed;
+}
+
+gint
+main (gint argc, gchar** argv)
+{
+        GError* error = NULL;
+        GOptionContext* options;
+        YtvFeed* feed;
+        YtvFeedCrawler* crawler;
+        Run run;
+
+        g_thread_init (NULL);
+        g_type_init ();
+
+        ytv_trace_init_from_env ();
+
+        options = g_option_context_new ("- stream a feed as JSON lines");
+        g_option_context_add_main_entries (options, entries, NULL);
+
+        if (!g_option_context_parse (options, &argc, &argv, &error))
+        {
+                g_printerr ("option parsing failed: %s\n", error->message);
+                g_error_free (error);
+                g_option_context_free (options);
+                return EXIT_FAILURE;
+        }
+
+        g_option_context_free (options);
+
+        if (search == NULL && user == NULL && related == NULL &&
+            (standard < YTV_YOUTUBE_STD_FEED_TOP_RATED ||
+             standard > YTV_YOUTUBE_STD_FEED_WATCH_ON_MOBILE))
+        {
+                g_printerr ("a --search, --user, --related or --standard "
+                            "feed is needed\n");
+                return EXIT_FAILURE;
+        }
+
+        if (parallel < 1 || parallel > 32 || max_results < 1 ||
+            max_entries < 0)
+        {
+                g_printerr ("--parallel must be between 1 and 32, "
+                            "--max-results positive\n");
+                return EXIT_FAILURE;
+        }
+
+        run.loop = g_main_loop_new (NULL, FALSE);
+        run.line = g_string_sized_new (1024);
+        run.entries = 0;
+        run.failed = FALSE;
+
+        feed = feed_new ();
+        crawler = ytv_feed_crawler_new (feed);
+
+        g_object_set (G_OBJECT (crawler),
+                      "max-parallel", parallel,
+                      "max-entries", max_entries,
+                      NULL);
+
+        g_signal_connect (crawler, "entry-crawled",
+                          G_CALLBACK (entry_crawled_cb), &run);
+        g_signal_connect (crawler, "finished",
+                          G_CALLBACK (finished_cb), &run);
+
+        ytv_feed_crawler_run (crawler);
+
+        if (ytv_feed_crawler_is_running (crawler))
+        {
+                g_main_loop_run (run.loop);
+        }
+
+        fflush (stdout);
+
+        if (stats_file != NULL && !ytv_stats_dump (stats_file))
+        {
+                g_printerr ("cannot write the statistics to %s\n",
+                            stats_file);
+        }
+
+        g_object_unref (crawler);
+        g_object_unref (feed);
+        g_string_free (run.line, TRUE);
+        g_main_loop_unref (run.loop);
+
+        ytv_trace_shutdown ();
+
+        return run.failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,865 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-entry-index.c - A full text index of the fetched entries
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-entry-index
+ * @title: YtvEntryIndex
+ * @short_description: searches the already fetched entries
+ *
+ * The #YtvEntryIndex keeps the entries it is fed with, usually every page
+ * parsed by a #YtvBaseFeed through its "index" property, and answers
+ * searches over them without going to the network.
+ *
+ * The title, tags, author, category and description of every entry are
+ * split in words, which are normalized: decomposed, without accents and
+ * case folded. Each word maps to the set of entries which contain it. A
+ * query matches the entries which contain, for every one of its words, a
+ * word starting by it, so a partially typed query matches too. The prefix
+ * lookups use a sorted array of the words, rebuilt only when a word was
+ * added or removed since the previous search.
+ *
+ * When an entry is added again, for example from a refresh, it replaces
+ * the previous one, and only if its text changed its words are indexed
+ * again. At most "max-entries" entries are kept; the oldest ones go first.
+ */
+
+/**
+ * YtvEntryIndex:
+ *
+ * An inverted index of the words of the entries
+ *
+ * free-function: g_object_unref
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include <ytv-entry-index.h>
+
+#include <ytv-entry.h>
+#include <ytv-iterator.h>
+#include <ytv-list.h>
+#include <ytv-simple-list.h>
+#include <ytv-trace.h>
+
+enum _YtvEntryIndexProp
+{
+        PROP_0,
+        PROP_MAX_ENTRIES
+};
+
+typedef struct _YtvEntryIndexPriv YtvEntryIndexPriv;
+
+struct _YtvEntryIndexPriv
+{
+        GHashTable* docs;     /* id -> YtvIndexDoc */
+        GHashTable* postings; /* word -> set of YtvIndexDoc */
+        GQueue* age;          /* of YtvIndexDoc, the oldest first */
+        GPtrArray* words;     /* the keys of postings, sorted */
+        gboolean dirty;       /* words must be sorted again */
+        guint max_entries;
+};
+
+/* an indexed entry */
+typedef struct _YtvIndexDoc YtvIndexDoc;
+
+struct _YtvIndexDoc
+{
+        YtvEntry* entry;
+        gchar* id;
+        gchar* published;
+        guint views;
+        gfloat rating;
+        GPtrArray* words; /* the keys of the postings it is in */
+        GList* link;      /* in the age queue */
+};
+
+#define YTV_ENTRY_INDEX_GET_PRIVATE(obj)        \
+        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_ENTRY_INDEX, YtvEntryIndexPriv))
+
+#define MAX_ENTRIES 10000
+
+/* the fields whose words are indexed */
+#define TEXT_FIELDS (YTV_ENTRY_FIELD_AUTHOR | YTV_ENTRY_FIELD_TITLE |   \
+                     YTV_ENTRY_FIELD_CATEGORY | YTV_ENTRY_FIELD_TAGS |  \
+                     YTV_ENTRY_FIELD_DESCRIPTION)
+
+G_DEFINE_TYPE (YtvEntryIndex, ytv_entry_index, G_TYPE_OBJECT)
+
+/* adds the normalized words of @text to the @words set */
+static void
+tokenize (const gchar* text, GHashTable* words)
+{
+        gchar* decomposed;
+        gchar* folded;
+        const gchar* p;
+        GString* word;
+        gunichar c;
+
+        if (text == NULL)
+        {
+                return;
+        }
+
+        /* NULL if it is not valid UTF-8 */
+        decomposed = g_utf8_normalize (text, -1, G_NORMALIZE_NFKD);
+        if (decomposed == NULL)
+        {
+                return;
+        }
+
+        folded = g_utf8_casefold (decomposed, -1);
+        g_free (decomposed);
+
+        word = g_string_new (NULL);
+
+        for (p = folded; ; p = g_utf8_next_char (p))
+        {
+                c = g_utf8_get_char (p);
+
+                if (c != 0 && g_unichar_isalnum (c))
+                {
+                        g_string_append_unichar (word, c);
+                        continue;
+                }
+
+                /* the accents, split from their letters */
+                if (c != 0 && g_unichar_type (c) == G_UNICODE_NON_SPACING_MARK)
+                {
+                        continue;
+                }
+
+                if (word->len > 0)
+                {
+                        g_hash_table_insert (words,
+                                             g_strndup (word->str, word->len),
+                                             GINT_TO_POINTER (TRUE));
+                        g_string_truncate (word, 0);
+                }
+
+                if (c == 0)
+                {
+                        break;
+                }
+        }
+
+        g_string_free (word, TRUE);
+        g_free (folded);
+
+        return;
+}
+
+static YtvIndexDoc*
+doc_new (YtvEntry* entry)
+{
+        YtvIndexDoc* doc;
+
+        doc = g_slice_new (YtvIndexDoc);
+        doc->entry = g_object_ref (entry);
+        g_object_get (G_OBJECT (entry), "id", &doc->id,
+                      "published", &doc->published, "views", &doc->views,
+                      "rating", &doc->rating, NULL);
+        doc->words = g_ptr_array_new ();
+        doc->link = NULL;
+
+        return doc;
+}
+
+static void
+doc_free (YtvIndexDoc* doc)
+{
+        g_object_unref (doc->entry);
+        g_free (doc->id);
+        g_free (doc->published);
+        g_ptr_array_free (doc->words, TRUE);
+        g_slice_free (YtvIndexDoc, doc);
+
+        return;
+}
+
+/* keeps the entry and its sort keys, not its words */
+static void
+doc_update (YtvIndexDoc* doc, YtvEntry* entry)
+{
+        g_object_unref (doc->entry);
+        g_free (doc->published);
+
+        doc->entry = g_object_ref (entry);
+        g_object_get (G_OBJECT (entry), "published", &doc->published,
+                      "views", &doc->views, "rating", &doc->rating, NULL);
+
+        return;
+}
+
+static void
+doc_link (YtvEntryIndexPriv* priv, YtvIndexDoc* doc)
+{
+        GHashTable* words;
+        GHashTableIter iter;
+        gpointer word;
+        gpointer key;
+        GHashTable* set;
+        gchar* text;
+        guint i;
+
+        static const gchar* fields[] =
+        {
+                "title", "tags", "author", "category", "description", NULL
+        };
+
+        words = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+        for (i = 0; fields[i] != NULL; i++)
+        {
+                g_object_get (G_OBJECT (doc->entry), fields[i], &text, NULL);
+                tokenize (text, words);
+                g_free (text);
+        }
+
+        g_hash_table_iter_init (&iter, words);
+
+        while (g_hash_table_iter_next (&iter, &word, NULL))
+        {
+                if (!g_hash_table_lookup_extended (priv->postings, word,
+                                                   &key, (gpointer*) &set))
+                {
+                        key = g_strdup (word);
+                        set = g_hash_table_new (g_direct_hash, g_direct_equal);
+                        g_hash_table_insert (priv->postings, key, set);
+                        priv->dirty = TRUE;
+                }
+
+                g_hash_table_insert (set, doc, doc);
+                g_ptr_array_add (doc->words, key);
+        }
+
+        g_hash_table_destroy (words);
+
+        g_hash_table_insert (priv->docs, doc->id, doc);
+        g_queue_push_tail (priv->age, doc);
+        doc->link = g_queue_peek_tail_link (priv->age);
+
+        return;
+}
+
+static void
+doc_unlink (YtvEntryIndexPriv* priv, YtvIndexDoc* doc)
+{
+        GHashTable* set;
+        gchar* word;
+        guint i;
+
+        for (i = 0; i < doc->words->len; i++)
+        {
+                word = g_ptr_array_index (doc->words, i);
+                set = g_hash_table_lookup (priv->postings, word);
+
+                g_hash_table_remove (set, doc);
+
+                /* frees the word too */
+                if (g_hash_table_size (set) == 0)
+                {
+                        g_hash_table_remove (priv->postings, word);
+                        priv->dirty = TRUE;
+                }
+        }
+
+        g_hash_table_remove (priv->docs, doc->id);
+        g_queue_delete_link (priv->age, doc->link);
+
+        doc_free (doc);
+
+        return;
+}
+
+static void
+trim (YtvEntryIndexPriv* priv)
+{
+        if (priv->max_entries == 0)
+        {
+                return;
+        }
+
+        while (g_queue_get_length (priv->age) > priv->max_entries)
+        {
+                doc_unlink (priv, g_queue_peek_head (priv->age));
+        }
+
+        return;
+}
+
+static gint
+compare_words (gconstpointer a, gconstpointer b)
+{
+        return strcmp (*(const gchar**) a, *(const gchar**) b);
+}
+
+static void
+add_word (gpointer key, gpointer value, gpointer user_data)
+{
+        g_ptr_array_add ((GPtrArray*) user_data, key);
+
+        return;
+}
+
+static void
+sort_words (YtvEntryIndexPriv* priv)
+{
+        if (!priv->dirty)
+        {
+                return;
+        }
+
+        g_ptr_array_set_size (priv->words, 0);
+        g_hash_table_foreach (priv->postings, add_word, priv->words);
+        g_ptr_array_sort (priv->words, compare_words);
+
+        priv->dirty = FALSE;
+
+        return;
+}
+
+/* the set of the entries with a word starting by @prefix */
+static GHashTable*
+lookup_prefix (YtvEntryIndexPriv* priv, const gchar* prefix)
+{
+        GHashTable* retval;
+        GHashTableIter iter;
+        gpointer doc;
+        guint lo, hi, mid;
+
+        retval = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+        /* the first word not lesser than the prefix */
+        lo = 0;
+        hi = priv->words->len;
+
+        while (lo < hi)
+        {
+                mid = lo + (hi - lo) / 2;
+
+                if (strcmp (g_ptr_array_index (priv->words, mid), prefix) < 0)
+                {
+                        lo = mid + 1;
+                }
+                else
+                {
+                        hi = mid;
+                }
+        }
+
+        for (; lo < priv->words->len &&
+                     g_str_has_prefix (g_ptr_array_index (priv->words, lo),
+                                       prefix); lo++)
+        {
+                g_hash_table_iter_init
+                        (&iter, g_hash_table_lookup
+                         (priv->postings, g_ptr_array_index (priv->words, lo)));
+
+                while (g_hash_table_iter_next (&iter, &doc, NULL))
+                {
+                        g_hash_table_insert (retval, doc, doc);
+                }
+        }
+
+        return retval;
+}
+
+/* negative if a goes before b */
+static gint
+compare_docs (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+        const YtvIndexDoc* da = *(const YtvIndexDoc**) a;
+        const YtvIndexDoc* db = *(const YtvIndexDoc**) b;
+        gint retval;
+
+        retval = 0;
+
+        switch (GPOINTER_TO_INT (user_data))
+        {
+        case YTV_ENTRY_INDEX_ORDER_VIEWCOUNT:
+                if (da->views != db->views)
+                {
+                        retval = da->views > db->views ? -1 : 1;
+                }
+                break;
+        case YTV_ENTRY_INDEX_ORDER_RATING:
+                if (da->rating != db->rating)
+                {
+                        retval = da->rating > db->rating ? -1 : 1;
+                }
+                break;
+        case YTV_ENTRY_INDEX_ORDER_PUBLISHED:
+                /* ISO 8601 timestamps sort as strings */
+                retval = -g_strcmp0 (da->published, db->published);
+                break;
+        default:
+                g_assert_not_reached ();
+        }
+
+        /* the same order in every search */
+        if (retval == 0)
+        {
+                retval = strcmp (da->id, db->id);
+        }
+
+        return retval;
+}
+
+static void
+ytv_entry_index_set_property (GObject* object, guint prop_id,
+                              const GValue* value, GParamSpec* spec)
+{
+        YtvEntryIndexPriv* priv;
+
+        priv = YTV_ENTRY_INDEX_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_MAX_ENTRIES:
+                priv->max_entries = g_value_get_uint (value);
+                trim (priv);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_entry_index_get_property (GObject* object, guint prop_id,
+                              GValue* value, GParamSpec* spec)
+{
+        YtvEntryIndexPriv* priv;
+
+        priv = YTV_ENTRY_INDEX_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_MAX_ENTRIES:
+                g_value_set_uint (value, priv->max_entries);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_entry_index_dispose (GObject* object)
+{
+        ytv_entry_index_clear (YTV_ENTRY_INDEX (object));
+
+        (*G_OBJECT_CLASS (ytv_entry_index_parent_class)->dispose) (object);
+
+        return;
+}
+
+static void
+ytv_entry_index_finalize (GObject* object)
+{
+        YtvEntryIndexPriv* priv;
+
+        priv = YTV_ENTRY_INDEX_GET_PRIVATE (object);
+
+        g_hash_table_destroy (priv->docs);
+        g_hash_table_destroy (priv->postings);
+        g_queue_free (priv->age);
+        g_ptr_array_free (priv->words, TRUE);
+
+        (*G_OBJECT_CLASS (ytv_entry_index_parent_class)->finalize) (object);
+
+        return;
+}
+
+static void
+ytv_entry_index_class_init (YtvEntryIndexClass* klass)
+{
+        GObjectClass* g_klass;
+
+        g_klass = G_OBJECT_CLASS (klass);
+
+        g_type_class_add_private (g_klass, sizeof (YtvEntryIndexPriv));
+
+        g_klass->set_property = ytv_entry_index_set_property;
+        g_klass->get_property = ytv_entry_index_get_property;
+        g_klass->dispose      = ytv_entry_index_dispose;
+        g_klass->finalize     = ytv_entry_index_finalize;
+
+        g_object_class_install_property
+                (g_klass, PROP_MAX_ENTRIES,
+                 g_param_spec_uint
+                 ("max-entries", "maxentries",
+                  "Number of entries kept, the oldest go first; zero is "
+                  "unlimited", 0, G_MAXUINT, MAX_ENTRIES, G_PARAM_READWRITE));
+
+        return;
+}
+
+static void
+ytv_entry_index_init (YtvEntryIndex* self)
+{
+        YtvEntryIndexPriv* priv;
+
+        priv = YTV_ENTRY_INDEX_GET_PRIVATE (self);
+
+        priv->docs        = g_hash_table_new (g_str_hash, g_str_equal);
+        priv->postings    = g_hash_table_new_full
+                (g_str_hash, g_str_equal, g_free,
+                 (GDestroyNotify) g_hash_table_destroy);
+        priv->age         = g_queue_new ();
+        priv->words       = g_ptr_array_new ();
+        priv->dirty       = FALSE;
+        priv->max_entries = MAX_ENTRIES;
+
+        return;
+}
+
+/**
+ * ytv_entry_index_order_get_type:
+ *
+ * GType system helper function
+ *
+ * returns: a #GType
+ */
+GType
+ytv_entry_index_order_get_type (void)
+{
+        static GType type = 0;
+
+        if (G_UNLIKELY (type == 0))
+        {
+                static const GEnumValue values[] = {
+                        { YTV_ENTRY_INDEX_ORDER_VIEWCOUNT,
+                          "YTV_ENTRY_INDEX_ORDER_VIEWCOUNT", "viewcount" },
+                        { YTV_ENTRY_INDEX_ORDER_RATING,
+                          "YTV_ENTRY_INDEX_ORDER_RATING", "rating" },
+                        { YTV_ENTRY_INDEX_ORDER_PUBLISHED,
+                          "YTV_ENTRY_INDEX_ORDER_PUBLISHED", "published" },
+                        { 0, NULL, NULL }
+                };
+
+                type = g_enum_register_static ("YtvEntryIndexOrderType",
+                                               values);
+        }
+
+        return type;
+}
+
+/**
+ * ytv_entry_index_new:
+ *
+ * Creates an empty index.
+ *
+ * returns: (not-null) (caller-owns): a new #YtvEntryIndex
+ */
+YtvEntryIndex*
+ytv_entry_index_new (void)
+{
+        return YTV_ENTRY_INDEX (g_object_new (YTV_TYPE_ENTRY_INDEX, NULL));
+}
+
+/**
+ * ytv_entry_index_add:
+ * @self: (not-null): a #YtvEntryIndex
+ * @entry: (not-null): the #YtvEntry to index
+ *
+ * Indexes @entry, replacing the entry with the same id if any.
+ */
+void
+ytv_entry_index_add (YtvEntryIndex* self, YtvEntry* entry)
+{
+        YtvEntryIndexPriv* priv;
+        YtvIndexDoc* doc;
+        gchar* id;
+
+        g_assert (YTV_IS_ENTRY_INDEX (self));
+        g_assert (YTV_IS_ENTRY (entry));
+
+        priv = YTV_ENTRY_INDEX_GET_PRIVATE (self);
+
+        g_object_get (G_OBJECT (entry), "id", &id, NULL);
+        g_return_if_fail (id != NULL);
+
+        doc = g_hash_table_lookup (priv->docs, id);
+        g_free (id);
+
+        if (doc != NULL)
+        {
+                if ((ytv_entry_diff (doc->entry, entry) & TEXT_FIELDS) == 0)
+                {
+                        /* the same words: it is just younger */
+                        doc_update (doc, entry);
+                        g_queue_unlink (priv->age, doc->link);
+                        g_queue_push_tail_link (priv->age, doc->link);
+
+                        return;
+                }
+
+                doc_unlink (priv, doc);
+        }
+
+        doc_link (priv, doc_new (entry));
+        trim (priv);
+
+        return;
+}
+
+/**
+ * ytv_entry_index_add_list:
+ * @self: (not-null): a #YtvEntryIndex
+ * @list: (not-null): a #YtvList of #YtvEntry
+ *
+ * Indexes every entry of @list.
+ */
+void
+ytv_entry_index_add_list (YtvEntryIndex* self, YtvList* list)
+{
+        YtvIterator* iter;
+        GObject* entry;
+
+        g_assert (YTV_IS_ENTRY_INDEX (self));
+        g_assert (YTV_IS_LIST (list));
+
+        YTV_TRACE_BEGIN ("index", "add_list");
+
+        iter = ytv_list_create_iterator (list);
+
+        while (!ytv_iterator_is_done (iter))
+        {
+                entry = ytv_iterator_get_current (iter);
+                ytv_entry_index_add (self, YTV_ENTRY (entry));
+                g_object_unref (entry);
+
+                ytv_iterator_next (iter);
+        }
+
+        g_object_unref (iter);
+
+        YTV_TRACE_END ("index", "add_list");
+
+        return;
+}
+
+/**
+ * ytv_entry_index_remove:
+ * @self: (not-null): a #YtvEntryIndex
+ * @id: (not-null): the id of the entry
+ *
+ * Removes the entry with @id from the index, if it is there.
+ */
+void
+ytv_entry_index_remove (YtvEntryIndex* self, const gchar* id)
+{
+        YtvEntryIndexPriv* priv;
+        YtvIndexDoc* doc;
+
+        g_assert (YTV_IS_ENTRY_INDEX (self));
+        g_assert (id != NULL);
+
+        priv = YTV_ENTRY_INDEX_GET_PRIVATE (self);
+
+        doc = g_hash_table_lookup (priv->docs, id);
+
+        if (doc != NULL)
+        {
+                doc_unlink (priv, doc);
+        }
+
+        return;
+}
+
+/**
+ * ytv_entry_index_clear:
+ * @self: (not-null): a #YtvEntryIndex
+ *
+ * Removes every entry from the index.
+ */
+void
+ytv_entry_index_clear (YtvEntryIndex* self)
+{
+        YtvEntryIndexPriv* priv;
+
+        g_assert (YTV_IS_ENTRY_INDEX (self));
+
+        priv = YTV_ENTRY_INDEX_GET_PRIVATE (self);
+
+        g_queue_foreach (priv->age, (GFunc) doc_free, NULL);
+        g_queue_clear (priv->age);
+        g_hash_table_remove_all (priv->docs);
+        g_hash_table_remove_all (priv->postings);
+        g_ptr_array_set_size (priv->words, 0);
+        priv->dirty = FALSE;
+
+        return;
+}
+
+/**
+ * ytv_entry_index_get_size:
+ * @self: (not-null): a #YtvEntryIndex
+ *
+ * Retrieves the number of indexed entries.
+ *
+ * returns: the number of entries
+ */
+guint
+ytv_entry_index_get_size (YtvEntryIndex* self)
+{
+        YtvEntryIndexPriv* priv;
+
+        g_assert (YTV_IS_ENTRY_INDEX (self));
+
+        priv = YTV_ENTRY_INDEX_GET_PRIVATE (self);
+
+        return g_hash_table_size (priv->docs);
+}
+
+/**
+ * ytv_entry_index_search:
+ * @self: (not-null): a #YtvEntryIndex
+ * @query: (not-null): the words to search
+ * @order: how the matching entries are sorted
+ * @start_index: the position of the first entry to return, from zero
+ * @max_results: the number of entries to return, or -1 for all of them
+ *
+ * Looks for the entries which contain, for every word of @query, a word
+ * starting by it, in their title, tags, author, category or description.
+ * The case and the accents are ignored.
+ *
+ * returns: (not-null) (caller-owns): a #YtvList with the page of the
+ * matching #YtvEntry, maybe empty
+ */
+YtvList*
+ytv_entry_index_search (YtvEntryIndex* self, const gchar* query,
+                        YtvEntryIndexOrder order, gint start_index,
+                        gint max_results)
+{
+        YtvEntryIndexPriv* priv;
+        YtvList* retval;
+        GHashTable* words;
+        GHashTable** sets;
+        GHashTableIter iter;
+        GPtrArray* matches;
+        gpointer word;
+        gpointer doc;
+        guint n, i, j, smallest;
+        gint end;
+
+        g_assert (YTV_IS_ENTRY_INDEX (self));
+        g_assert (query != NULL);
+
+        priv = YTV_ENTRY_INDEX_GET_PRIVATE (self);
+
+        YTV_TRACE_BEGIN ("index", "search");
+
+        retval = ytv_simple_list_new ();
+
+        words = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+        tokenize (query, words);
+
+        n = g_hash_table_size (words);
+
+        if (n == 0)
+        {
+                g_hash_table_destroy (words);
+                goto beach;
+        }
+
+        sort_words (priv);
+
+        sets = g_new (GHashTable*, n);
+        smallest = 0;
+        i = 0;
+
+        g_hash_table_iter_init (&iter, words);
+
+        while (g_hash_table_iter_next (&iter, &word, NULL))
+        {
+                sets[i] = lookup_prefix (priv, word);
+
+                if (g_hash_table_size (sets[i]) <
+                    g_hash_table_size (sets[smallest]))
+                {
+                        smallest = i;
+                }
+
+                i++;
+        }
+
+        /* walks the smallest set, checking the others */
+        matches = g_ptr_array_new ();
+        g_hash_table_iter_init (&iter, sets[smallest]);
+
+        while (g_hash_table_iter_next (&iter, &doc, NULL))
+        {
+                for (j = 0; j < n; j++)
+                {
+                        if (j != smallest &&
+                            g_hash_table_lookup (sets[j], doc) == NULL)
+                        {
+                                break;
+                        }
+                }
+
+                if (j == n)
+                {
+                        g_ptr_array_add (matches, doc);
+                }
+        }
+
+        g_ptr_array_sort_with_data (matches, compare_docs,
+                                    GINT_TO_POINTER (order));
+
+        end = matches->len;
+        if (max_results >= 0 && start_index + max_results < end)
+        {
+                end = start_index + max_results;
+        }
+
+        for (i = MAX (start_index, 0); (gint) i < end; i++)
+        {
+                ytv_list_append (retval,
+                                 G_OBJECT (((YtvIndexDoc*)
+                                            g_ptr_array_index (matches,
+                                                               i))->entry));
+        }
+
+        for (i = 0; i < n; i++)
+        {
+                g_hash_table_destroy (sets[i]);
+        }
+
+        g_free (sets);
+        g_ptr_array_free (matches, TRUE);
+        g_hash_table_destroy (words);
+
+beach:
+        YTV_TRACE_END ("index", "search");
+
+        return retval;
+}
@@ -0,0 +1,92 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_ENTRY_INDEX_H_
+#define _YTV_ENTRY_INDEX_H_
+
+/* ytv-entry-index.h - A full text index of the fetched entries
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib-object.h>
+#include <ytv-shared.h>
+
+G_BEGIN_DECLS
+
+#define YTV_TYPE_ENTRY_INDEX                    \
+        (ytv_entry_index_get_type ())
+#define YTV_ENTRY_INDEX(obj)                                            \
+        (G_TYPE_CHECK_INSTANCE_CAST ((obj), YTV_TYPE_ENTRY_INDEX, YtvEntryIndex))
+#define YTV_ENTRY_INDEX_CLASS(klass)                                    \
+        (G_TYPE_CHECK_CLASS_CAST ((klass), YTV_TYPE_ENTRY_INDEX, YtvEntryIndexClass))
+#define YTV_IS_ENTRY_INDEX(obj)                                         \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), YTV_TYPE_ENTRY_INDEX))
+#define YTV_IS_ENTRY_INDEX_CLASS(klass)                                 \
+        (G_TYPE_CHECK_CLASS_TYPE ((klass), YTV_TYPE_ENTRY_INDEX))
+#define YTV_ENTRY_INDEX_GET_CLASS(obj)                                  \
+        (G_TYPE_INSTANCE_GET_CLASS ((obj), YTV_TYPE_ENTRY_INDEX, YtvEntryIndexClass))
+
+#define YTV_TYPE_ENTRY_INDEX_ORDER (ytv_entry_index_order_get_type ())
+
+/**
+ * YtvEntryIndexOrder:
+ *
+ * How the matching entries are sorted
+ */
+enum _YtvEntryIndexOrder
+{
+        YTV_ENTRY_INDEX_ORDER_VIEWCOUNT, /* the most viewed first */
+        YTV_ENTRY_INDEX_ORDER_RATING,    /* the best rated first */
+        YTV_ENTRY_INDEX_ORDER_PUBLISHED  /* the newest first */
+};
+
+typedef enum _YtvEntryIndexOrder YtvEntryIndexOrder;
+
+typedef struct _YtvEntryIndex YtvEntryIndex;
+typedef struct _YtvEntryIndexClass YtvEntryIndexClass;
+
+/**
+ * YtvEntryIndex:
+ *
+ * An inverted index of the words of the entries
+ */
+struct _YtvEntryIndex
+{
+        GObject parent;
+};
+
+struct _YtvEntryIndexClass
+{
+        GObjectClass parent_class;
+};
+
+GType ytv_entry_index_order_get_type (void);
+GType ytv_entry_index_get_type (void);
+
+YtvEntryIndex* ytv_entry_index_new (void);
+void ytv_entry_index_add (YtvEntryIndex* self, YtvEntry* entry);
+void ytv_entry_index_add_list (YtvEntryIndex* self, YtvList* list);
+void ytv_entry_index_remove (YtvEntryIndex* self, const gchar* id);
+void ytv_entry_index_clear (YtvEntryIndex* self);
+guint ytv_entry_index_get_size (YtvEntryIndex* self);
+YtvList* ytv_entry_index_search (YtvEntryIndex* self, const gchar* query,
+                                 YtvEntryIndexOrder order, gint start_index,
+                                 gint max_results);
+
+G_END_DECLS
+
+#endif /* _YTV_ENTRY_INDEX_H_ */
@@ -0,0 +1,1847 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-entry-store.c - A persistent store of the fetched entries
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-entry-store
+ * @title: YtvEntryStore
+ * @short_description: keeps the fetched entries on disk
+ *
+ * The #YtvEntryStore keeps the entries it is fed with, usually every page
+ * parsed by a #YtvBaseFeed through its "store" property, in a file, so
+ * they are available after a restart, even without network.
+ *
+ * The file is an append-only log of binary records: a put record holds
+ * every field of an entry, a delete record just its id, and a page record
+ * the ids of the entries of a fetched page, keyed by its URI, so the page
+ * may be rebuilt with ytv_entry_store_get_page(). Only the last
+ * #YtvEntryStore:max-pages pages are kept. Each record
+ * starts with its length and a checksum, so a record torn by a crash is
+ * detected, and cut, when the file is opened. The last record of an id
+ * wins. A field which is not set is kept as such, not as an empty string.
+ *
+ * When the file is opened it is scanned once to build the indexes, which
+ * are kept in memory: the offset of the last record of every id, the ids
+ * by author and by category, and the ids sorted by publication date,
+ * built on demand. An entry is read from the file only when it is looked
+ * up.
+ *
+ * The records are appended to a buffer, which is written, and synced to
+ * the disk, when it reaches "batch-size" bytes, or "flush-interval"
+ * milliseconds after the first pending record, so a page of entries costs
+ * a single fsync. An entry equal to the stored one is not written again.
+ * When the records overwritten by newer ones take more than half of the
+ * file, the live ones are copied to a new file which replaces it.
+ */
+
+/**
+ * YtvEntryStore:
+ *
+ * An append-only log of entries kept on disk
+ *
+ * free-function: g_object_unref
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ytv-entry-store.h>
+
+#include <ytv-entry.h>
+#include <ytv-error.h>
+#include <ytv-iterator.h>
+#include <ytv-list.h>
+#include <ytv-simple-list.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
+
+enum _YtvEntryStoreProp
+{
+        PROP_0,
+        PROP_PATH,
+        PROP_BATCH_SIZE,
+        PROP_FLUSH_INTERVAL,
+        PROP_MAX_PAGES
+};
+
+typedef struct _YtvEntryStorePriv YtvEntryStorePriv;
+
+struct _YtvEntryStorePriv
+{
+        gchar* path;
+        gint fd;
+        gint64 end;            /* of the file, where the pending batch goes */
+        gint64 live;           /* bytes of the records not overwritten */
+
+        GHashTable* items;     /* id -> YtvStoreItem */
+        GHashTable* authors;   /* author -> set of YtvStoreItem */
+        GHashTable* categories;/* category -> set of YtvStoreItem */
+        GPtrArray* published;  /* of YtvStoreItem, sorted on demand */
+        gboolean dirty;        /* published must be sorted again */
+
+        GHashTable* pages;     /* uri -> YtvStoreItem */
+        GQueue* page_order;    /* of YtvStoreItem, the newest first */
+        guint max_pages;
+
+        GString* pending;      /* records not written yet */
+        GString* scratch;      /* to serialize a record */
+        guint batch_size;
+        guint flush_interval;
+        guint timer_id;
+};
+
+/* where the last record of an id lives */
+typedef struct _YtvStoreItem YtvStoreItem;
+
+struct _YtvStoreItem
+{
+        gchar* id;
+        gchar* author;
+        gchar* category;
+        gchar* published;
+        gint64 offset;
+        guint32 size;          /* of the whole record */
+        guint32 checksum;      /* of the payload */
+
+        gchar** ids;           /* of a page, whose uri is the id */
+        GList* link;           /* of a page, in the page_order queue */
+};
+
+/* a decoded record */
+typedef struct _YtvStoreRecord YtvStoreRecord;
+
+struct _YtvStoreRecord
+{
+        guint8 type;
+        gchar* id;
+        gchar* author;
+        gchar* title;
+        gchar* published;
+        gchar* category;
+        gchar* tags;
+        gchar* description;
+        gint32 duration;
+        guint32 views;
+        gfloat rating;
+        gchar** ids;           /* of a page */
+};
+
+#define YTV_ENTRY_STORE_GET_PRIVATE(obj)        \
+        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_ENTRY_STORE, YtvEntryStorePriv))
+
+#define MAGIC          "YTVSTOR"
+#define VERSION        2
+#define FILE_HEADER    8              /* the magic and the version */
+#define RECORD_HEADER  8              /* the length and the checksum */
+#define MAX_RECORD     (1024 * 1024)  /* bigger lengths are garbage */
+#define NULL_STRING    0xFFFFFFFFU    /* the length of a NULL string */
+
+#define RECORD_PUT     1
+#define RECORD_DELETE  2
+#define RECORD_PAGE    3
+
+#define BATCH_SIZE     (64 * 1024)
+#define FLUSH_INTERVAL 1000           /* ms */
+#define COMPACT_SIZE   (1024 * 1024)  /* smaller files are not compacted */
+#define MAX_PAGES      256
+
+G_DEFINE_TYPE (YtvEntryStore, ytv_entry_store, G_TYPE_OBJECT)
+
+/* FNV-1a */
+static guint32
+checksum (const guchar* data, gsize length)
+{
+        guint32 hash;
+        gsize i;
+
+        hash = 2166136261U;
+
+        for (i = 0; i < length; i++)
+        {
+                hash ^= data[i];
+                hash *= 16777619U;
+        }
+
+        return hash;
+}
+
+static void
+put_uint32 (GString* buf, guint32 value)
+{
+        value = GUINT32_TO_LE (value);
+        g_string_append_len (buf, (const gchar*) &value, sizeof (value));
+
+        return;
+}
+
+static void
+put_string (GString* buf, const gchar* str)
+{
+        guint32 length;
+
+        if (str == NULL)
+        {
+                put_uint32 (buf, NULL_STRING);
+                return;
+        }
+
+        length = strlen (str);
+
+        put_uint32 (buf, length);
+        g_string_append_len (buf, str, length);
+
+        return;
+}
+
+static gboolean
+get_uint32 (const guchar** p, const guchar* end, guint32* value)
+{
+        if (end - *p < (gint) sizeof (*value))
+        {
+                return FALSE;
+        }
+
+        memcpy (value, *p, sizeof (*value));
+        *value = GUINT32_FROM_LE (*value);
+        *p += sizeof (*value);
+
+        return TRUE;
+}
+
+static gboolean
+get_string (const guchar** p, const guchar* end, gchar** str)
+{
+        guint32 length;
+
+        if (!get_uint32 (p, end, &length))
+        {
+                return FALSE;
+        }
+
+        if (length == NULL_STRING)
+        {
+                *str = NULL;
+                return TRUE;
+        }
+
+        if ((guint32) (end - *p) < length)
+        {
+                return FALSE;
+        }
+
+        *str = g_strndup ((const gchar*) *p, length);
+        *p += length;
+
+        return TRUE;
+}
+
+static void
+record_clear (YtvStoreRecord* rec)
+{
+        g_free (rec->id);
+        g_free (rec->author);
+        g_free (rec->title);
+        g_free (rec->published);
+        g_free (rec->category);
+        g_free (rec->tags);
+        g_free (rec->description);
+        g_strfreev (rec->ids);
+        memset (rec, 0, sizeof (*rec));
+
+        return;
+}
+
+/* the payload of @entry, or of the deletion of @id if @entry is NULL */
+static void
+serialize (GString* buf, YtvEntry* entry, const gchar* id)
+{
+        YtvStoreRecord rec;
+        union { gfloat f; guint32 u; } rating;
+
+        g_string_truncate (buf, 0);
+
+        if (entry == NULL)
+        {
+                g_string_append_c (buf, RECORD_DELETE);
+                put_string (buf, id);
+
+                return;
+        }
+
+        memset (&rec, 0, sizeof (rec));
+
+        g_object_get (G_OBJECT (entry), "id", &rec.id,
+                      "author", &rec.author, "title", &rec.title,
+                      "published", &rec.published,
+                      "category", &rec.category, "tags", &rec.tags,
+                      "description", &rec.description,
+                      "duration", &rec.duration, "views", &rec.views,
+                      "rating", &rec.rating, NULL);
+
+        g_string_append_c (buf, RECORD_PUT);
+        put_string (buf, rec.id);
+        put_string (buf, rec.author);
+        put_string (buf, rec.title);
+        put_string (buf, rec.published);
+        put_string (buf, rec.category);
+        put_string (buf, rec.tags);
+        put_string (buf, rec.description);
+        put_uint32 (buf, (guint32) rec.duration);
+        put_uint32 (buf, rec.views);
+        rating.f = rec.rating;
+        put_uint32 (buf, rating.u);
+
+        record_clear (&rec);
+
+        return;
+}
+
+/* the payload of the page @uri holding the entries of @list */
+static void
+serialize_page (GString* buf, const gchar* uri, YtvList* list)
+{
+        YtvIterator* iter;
+        GObject* entry;
+        gchar* id;
+
+        g_string_truncate (buf, 0);
+        g_string_append_c (buf, RECORD_PAGE);
+        put_string (buf, uri);
+        put_uint32 (buf, ytv_list_get_length (list));
+
+        iter = ytv_list_create_iterator (list);
+
+        while (!ytv_iterator_is_done (iter))
+        {
+                entry = ytv_iterator_get_current (iter);
+                g_object_get (entry, "id", &id, NULL);
+                put_string (buf, id);
+                g_free (id);
+                g_object_unref (entry);
+
+                ytv_iterator_next (iter);
+        }
+
+        g_object_unref (iter);
+
+        return;
+}
+
+static gboolean
+deserialize (const guchar* data, gsize length, YtvStoreRecord* rec)
+{
+        const guchar* p;
+        const guchar* end;
+        guint32 duration;
+        guint32 count, i;
+        union { gfloat f; guint32 u; } rating;
+
+        memset (rec, 0, sizeof (*rec));
+
+        p = data;
+        end = data + length;
+
+        if (length < 1)
+        {
+                return FALSE;
+        }
+
+        rec->type = *p++;
+
+        if (!get_string (&p, end, &rec->id) || rec->id == NULL)
+        {
+                goto beach;
+        }
+
+        if (rec->type == RECORD_DELETE)
+        {
+                return TRUE;
+        }
+
+        if (rec->type == RECORD_PAGE)
+        {
+                /* every id takes four bytes at least */
+                if (!get_uint32 (&p, end, &count) ||
+                    count > (guint32) (end - p) / 4)
+                {
+                        goto beach;
+                }
+
+                rec->ids = g_new0 (gchar*, count + 1);
+
+                for (i = 0; i < count; i++)
+                {
+                        if (!get_string (&p, end, &rec->ids[i]) ||
+                            rec->ids[i] == NULL)
+                        {
+                                goto beach;
+                        }
+                }
+
+                return TRUE;
+        }
+
+        if (rec->type == RECORD_PUT &&
+            get_string (&p, end, &rec->author) &&
+            get_string (&p, end, &rec->title) &&
+            get_string (&p, end, &rec->published) &&
+            get_string (&p, end, &rec->category) &&
+            get_string (&p, end, &rec->tags) &&
+            get_string (&p, end, &rec->description) &&
+            get_uint32 (&p, end, &duration) &&
+            get_uint32 (&p, end, &rec->views) &&
+            get_uint32 (&p, end, &rating.u))
+        {
+                rec->duration = (gint32) duration;
+                rec->rating = rating.f;
+
+                return TRUE;
+        }
+
+beach:
+        record_clear (rec);
+
+        return FALSE;
+}
+
+static YtvEntry*
+record_to_entry (YtvStoreRecord* rec)
+{
+        return g_object_new (YTV_TYPE_ENTRY,
+                             "id", rec->id, "author", rec->author,
+                             "title", rec->title, "duration", rec->duration,
+                             "rating", rec->rating,
+                             "published", rec->published,
+                             "views", rec->views, "category", rec->category,
+                             "tags", rec->tags,
+                             "description", rec->description, NULL);
+}
+
+static gboolean
+write_all (gint fd, const gchar* data, gsize length, GError **err)
+{
+        gssize written;
+
+        while (length > 0)
+        {
+                written = write (fd, data, length);
+
+                if (written < 0)
+                {
+                        if (errno == EINTR)
+                        {
+                                continue;
+                        }
+
+                        g_set_error (err, YTV_STORE_ERROR, YTV_STORE_ERROR_IO,
+                                     "Could not write the store - %s",
+                                     g_strerror (errno));
+
+                        return FALSE;
+                }
+
+                data += written;
+                length -= written;
+        }
+
+        return TRUE;
+}
+
+static gboolean
+read_at (gint fd, guchar* data, gsize length, gint64 offset)
+{
+        gssize count;
+
+        while (length > 0)
+        {
+                count = pread (fd, data, length, offset);
+
+                if (count < 0 && errno == EINTR)
+                {
+                        continue;
+                }
+
+                if (count <= 0)
+                {
+                        return FALSE;
+                }
+
+                data += count;
+                length -= count;
+                offset += count;
+        }
+
+        return TRUE;
+}
+
+/* the payload of the record of @item, from the file or the pending batch */
+static guchar*
+read_payload (YtvEntryStorePriv* priv, YtvStoreItem* item)
+{
+        guchar* payload;
+        guint32 length;
+
+        length = item->size - RECORD_HEADER;
+
+        if (item->offset >= priv->end)
+        {
+                return g_memdup (priv->pending->str +
+                                 (item->offset - priv->end) + RECORD_HEADER,
+                                 length);
+        }
+
+        payload = g_malloc (length);
+
+        if (!read_at (priv->fd, payload, length,
+                      item->offset + RECORD_HEADER) ||
+            checksum (payload, length) != item->checksum)
+        {
+                g_warning ("Could not read the entry %s from %s",
+                           item->id, priv->path);
+                g_free (payload);
+
+                return NULL;
+        }
+
+        return payload;
+}
+
+static YtvEntry*
+item_to_entry (YtvEntryStorePriv* priv, YtvStoreItem* item)
+{
+        YtvStoreRecord rec;
+        YtvEntry* entry;
+        guchar* payload;
+
+        entry = NULL;
+        payload = read_payload (priv, item);
+
+        if (payload != NULL &&
+            deserialize (payload, item->size - RECORD_HEADER, &rec))
+        {
+                entry = record_to_entry (&rec);
+                record_clear (&rec);
+        }
+
+        g_free (payload);
+
+        return entry;
+}
+
+static void
+set_add (GHashTable* table, const gchar* key, YtvStoreItem* item)
+{
+        GHashTable* set;
+
+        if (key == NULL)
+        {
+                return;
+        }
+
+        set = g_hash_table_lookup (table, key);
+
+        if (set == NULL)
+        {
+                set = g_hash_table_new (g_direct_hash, g_direct_equal);
+                g_hash_table_insert (table, g_strdup (key), set);
+        }
+
+        g_hash_table_insert (set, item, item);
+
+        return;
+}
+
+static void
+set_remove (GHashTable* table, const gchar* key, YtvStoreItem* item)
+{
+        GHashTable* set;
+
+        if (key == NULL)
+        {
+                return;
+        }
+
+        set = g_hash_table_lookup (table, key);
+
+        if (set != NULL)
+        {
+                g_hash_table_remove (set, item);
+
+                if (g_hash_table_size (set) == 0)
+                {
+                        g_hash_table_remove (table, key);
+                }
+        }
+
+        return;
+}
+
+static void
+item_free (YtvStoreItem* item)
+{
+        g_strfreev (item->ids);
+        g_free (item->id);
+        g_free (item->author);
+        g_free (item->category);
+        g_free (item->published);
+        g_slice_free (YtvStoreItem, item);
+
+        return;
+}
+
+static void
+forget (YtvEntryStorePriv* priv, YtvStoreItem* item)
+{
+        set_remove (priv->authors, item->author, item);
+        set_remove (priv->categories, item->category, item);
+
+        priv->live -= item->size;
+        priv->dirty = TRUE;
+
+        /* its key is item->id, so it is freed after leaving the table */
+        g_hash_table_steal (priv->items, item->id);
+        item_free (item);
+
+        return;
+}
+
+static void
+forget_page (YtvEntryStorePriv* priv, YtvStoreItem* item)
+{
+        g_queue_delete_link (priv->page_order, item->link);
+        priv->live -= item->size;
+
+        /* its key is item->id, so it is freed after leaving the table */
+        g_hash_table_steal (priv->pages, item->id);
+        item_free (item);
+
+        return;
+}
+
+/* makes the page record at @offset the last one of its uri */
+static void
+apply_page (YtvEntryStorePriv* priv, YtvStoreRecord* rec, gint64 offset,
+            guint32 size, guint32 sum)
+{
+        YtvStoreItem* item;
+
+        item = g_hash_table_lookup (priv->pages, rec->id);
+
+        if (item != NULL)
+        {
+                forget_page (priv, item);
+        }
+
+        item = g_slice_new0 (YtvStoreItem);
+        item->id = g_strdup (rec->id);
+        item->ids = rec->ids; /* takes them */
+        item->offset = offset;
+        item->size = size;
+        item->checksum = sum;
+        rec->ids = NULL;
+
+        g_queue_push_head (priv->page_order, item);
+        item->link = g_queue_peek_head_link (priv->page_order);
+        g_hash_table_insert (priv->pages, item->id, item);
+
+        priv->live += size;
+
+        while (g_queue_get_length (priv->page_order) > priv->max_pages)
+        {
+                forget_page (priv, g_queue_peek_tail (priv->page_order));
+        }
+
+        return;
+}
+
+/* makes the record at @offset the last one of its id */
+static void
+apply (YtvEntryStorePriv* priv, YtvStoreRecord* rec, gint64 offset,
+       guint32 size, guint32 sum)
+{
+        YtvStoreItem* item;
+
+        if (rec->type == RECORD_PAGE)
+        {
+                apply_page (priv, rec, offset, size, sum);
+                return;
+        }
+
+        item = g_hash_table_lookup (priv->items, rec->id);
+
+        if (item != NULL)
+        {
+                forget (priv, item);
+        }
+
+        if (rec->type == RECORD_DELETE)
+        {
+                return;
+        }
+
+        item = g_slice_new0 (YtvStoreItem);
+        item->id = g_strdup (rec->id);
+        item->author = g_strdup (rec->author);
+        item->category = g_strdup (rec->category);
+        item->published = g_strdup (rec->published);
+        item->offset = offset;
+        item->size = size;
+        item->checksum = sum;
+
+        g_hash_table_insert (priv->items, item->id, item);
+        set_add (priv->authors, item->author, item);
+        set_add (priv->categories, item->category, item);
+
+        priv->live += size;
+        priv->dirty = TRUE;
+
+        return;
+}
+
+/* builds the indexes from the records, cutting a torn tail */
+static gboolean
+scan (YtvEntryStorePriv* priv, gint64 size, GError **err)
+{
+        guchar header[RECORD_HEADER];
+        GByteArray* payload;
+        YtvStoreRecord rec;
+        guint32 length, sum;
+        const guchar* p;
+        gint64 offset;
+
+        payload = g_byte_array_new ();
+        offset = FILE_HEADER;
+
+        while (offset < size)
+        {
+                if (!read_at (priv->fd, header, RECORD_HEADER, offset))
+                {
+                        break;
+                }
+
+                p = header;
+                get_uint32 (&p, header + RECORD_HEADER, &length);
+                get_uint32 (&p, header + RECORD_HEADER, &sum);
+
+                if (length == 0 || length > MAX_RECORD ||
+                    offset + RECORD_HEADER + length > size)
+                {
+                        break;
+                }
+
+                g_byte_array_set_size (payload, length);
+
+                if (!read_at (priv->fd, payload->data, length,
+                              offset + RECORD_HEADER) ||
+                    checksum (payload->data, length) != sum ||
+                    !deserialize (payload->data, length, &rec))
+                {
+                        break;
+                }
+
+                apply (priv, &rec, offset, RECORD_HEADER + length, sum);
+                record_clear (&rec);
+
+                offset += RECORD_HEADER + length;
+        }
+
+        g_byte_array_free (payload, TRUE);
+
+        if (offset < size)
+        {
+                g_warning ("Dropping %" G_GINT64_FORMAT " bytes of %s after "
+                           "a broken record", size - offset, priv->path);
+
+                if (ftruncate (priv->fd, offset) != 0)
+                {
+                        g_set_error (err, YTV_STORE_ERROR, YTV_STORE_ERROR_IO,
+                                     "Could not truncate %s - %s",
+                                     priv->path, g_strerror (errno));
+
+                        return FALSE;
+                }
+        }
+
+        priv->end = offset;
+
+        return TRUE;
+}
+
+static gboolean
+open_log (YtvEntryStorePriv* priv, GError **err)
+{
+        gchar header[FILE_HEADER];
+        struct stat st;
+
+        priv->fd = open (priv->path, O_RDWR | O_CREAT | O_APPEND, 0600);
+
+        if (priv->fd < 0 || fstat (priv->fd, &st) != 0)
+        {
+                g_set_error (err, YTV_STORE_ERROR, YTV_STORE_ERROR_IO,
+                             "Could not open %s - %s", priv->path,
+                             g_strerror (errno));
+
+                return FALSE;
+        }
+
+        memcpy (header, MAGIC, FILE_HEADER - 1);
+        header[FILE_HEADER - 1] = VERSION;
+
+        if (st.st_size == 0)
+        {
+                if (!write_all (priv->fd, header, FILE_HEADER, err) ||
+                    fsync (priv->fd) != 0)
+                {
+                        return FALSE;
+                }
+
+                priv->end = FILE_HEADER;
+
+                return TRUE;
+        }
+
+        {
+                gchar found[FILE_HEADER];
+
+                if (!read_at (priv->fd, (guchar*) found, FILE_HEADER, 0) ||
+                    memcmp (found, header, FILE_HEADER) != 0)
+                {
+                        g_set_error (err, YTV_STORE_ERROR,
+                                     YTV_STORE_ERROR_CORRUPT,
+                                     "%s is not an entry store", priv->path);
+
+                        return FALSE;
+                }
+        }
+
+        return scan (priv, st.st_size, err);
+}
+
+static gboolean
+flush_cb (gpointer user_data)
+{
+        YtvEntryStore* self;
+        YtvEntryStorePriv* priv;
+        GError* err = NULL;
+
+        self = YTV_ENTRY_STORE (user_data);
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        priv->timer_id = 0;
+
+        if (!ytv_entry_store_flush (self, &err))
+        {
+                g_warning ("%s", ytv_error_get_message (err));
+                ytv_stats_count_error (err);
+                g_error_free (err);
+        }
+
+        return FALSE;
+}
+
+/* appends the record serialized in the scratch buffer to the batch */
+static void
+push (YtvEntryStore* self, YtvStoreRecord* rec, guint32 sum)
+{
+        YtvEntryStorePriv* priv;
+        GError* err = NULL;
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        apply (priv, rec, priv->end + priv->pending->len,
+               RECORD_HEADER + priv->scratch->len, sum);
+
+        put_uint32 (priv->pending, priv->scratch->len);
+        put_uint32 (priv->pending, sum);
+        g_string_append_len (priv->pending, priv->scratch->str,
+                             priv->scratch->len);
+
+        ytv_stats_inc (YTV_STATS_STORE_RECORDS);
+
+        if (priv->pending->len >= priv->batch_size)
+        {
+                if (!ytv_entry_store_flush (self, &err))
+                {
+                        g_warning ("%s", ytv_error_get_message (err));
+                        ytv_stats_count_error (err);
+                        g_error_free (err);
+                }
+        }
+        else if (priv->timer_id == 0)
+        {
+                priv->timer_id = g_timeout_add (priv->flush_interval,
+                                                flush_cb, self);
+        }
+
+        return;
+}
+
+static void
+append (YtvEntryStore* self, YtvEntry* entry, const gchar* id)
+{
+        YtvEntryStorePriv* priv;
+        YtvStoreRecord rec;
+        YtvStoreItem* item;
+        guint32 sum;
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        serialize (priv->scratch, entry, id);
+        sum = checksum ((const guchar*) priv->scratch->str,
+                        priv->scratch->len);
+
+        deserialize ((const guchar*) priv->scratch->str, priv->scratch->len,
+                     &rec);
+
+        /* nothing new */
+        item = g_hash_table_lookup (priv->items, rec.id);
+        if ((entry != NULL && item != NULL && item->checksum == sum &&
+             item->size == RECORD_HEADER + priv->scratch->len) ||
+            (entry == NULL && item == NULL))
+        {
+                record_clear (&rec);
+                return;
+        }
+
+        push (self, &rec, sum);
+        record_clear (&rec);
+
+        return;
+}
+
+/* the live records take less than half of the file */
+static gboolean
+needs_compaction (YtvEntryStorePriv* priv)
+{
+        return priv->end >= COMPACT_SIZE &&
+                priv->live * 2 < priv->end - FILE_HEADER;
+}
+
+static gint
+compare_published (gconstpointer a, gconstpointer b)
+{
+        const YtvStoreItem* ia = *(const YtvStoreItem**) a;
+        const YtvStoreItem* ib = *(const YtvStoreItem**) b;
+        gint retval;
+
+        /* ISO 8601 timestamps sort as strings */
+        retval = g_strcmp0 (ia->published, ib->published);
+
+        if (retval == 0)
+        {
+                retval = strcmp (ia->id, ib->id);
+        }
+
+        return retval;
+}
+
+static void
+add_item (gpointer key, gpointer value, gpointer user_data)
+{
+        g_ptr_array_add ((GPtrArray*) user_data, value);
+
+        return;
+}
+
+static void
+sort_published (YtvEntryStorePriv* priv)
+{
+        if (!priv->dirty)
+        {
+                return;
+        }
+
+        g_ptr_array_set_size (priv->published, 0);
+        g_hash_table_foreach (priv->items, add_item, priv->published);
+        g_ptr_array_sort (priv->published, compare_published);
+
+        priv->dirty = FALSE;
+
+        return;
+}
+
+/* the first item published at @date or later */
+static guint
+lower_bound (GPtrArray* items, const gchar* date)
+{
+        YtvStoreItem* item;
+        guint lo, hi, mid;
+
+        lo = 0;
+        hi = items->len;
+
+        while (lo < hi)
+        {
+                mid = lo + (hi - lo) / 2;
+                item = g_ptr_array_index (items, mid);
+
+                if (g_strcmp0 (item->published, date) < 0)
+                {
+                        lo = mid + 1;
+                }
+                else
+                {
+                        hi = mid;
+                }
+        }
+
+        return lo;
+}
+
+static YtvList*
+set_to_list (YtvEntryStorePriv* priv, GHashTable* set)
+{
+        YtvList* retval;
+        GHashTableIter iter;
+        gpointer item;
+        GPtrArray* sorted;
+        YtvEntry* entry;
+        guint i;
+
+        retval = ytv_simple_list_new ();
+
+        if (set == NULL)
+        {
+                return retval;
+        }
+
+        /* the newest first, like the feeds */
+        sorted = g_ptr_array_new ();
+        g_hash_table_iter_init (&iter, set);
+
+        while (g_hash_table_iter_next (&iter, &item, NULL))
+        {
+                g_ptr_array_add (sorted, item);
+        }
+
+        g_ptr_array_sort (sorted, compare_published);
+
+        for (i = sorted->len; i > 0; i--)
+        {
+                entry = item_to_entry (priv,
+                                       g_ptr_array_index (sorted, i - 1));
+
+                if (entry != NULL)
+                {
+                        ytv_list_append (retval, G_OBJECT (entry));
+                        g_object_unref (entry);
+                }
+        }
+
+        g_ptr_array_free (sorted, TRUE);
+
+        return retval;
+}
+
+static void
+ytv_entry_store_set_property (GObject* object, guint prop_id,
+                              const GValue* value, GParamSpec* spec)
+{
+        YtvEntryStorePriv* priv;
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_PATH:
+                g_free (priv->path);
+                priv->path = g_value_dup_string (value);
+                break;
+        case PROP_BATCH_SIZE:
+                priv->batch_size = g_value_get_uint (value);
+                break;
+        case PROP_FLUSH_INTERVAL:
+                priv->flush_interval = g_value_get_uint (value);
+                break;
+        case PROP_MAX_PAGES:
+                priv->max_pages = g_value_get_uint (value);
+                while (g_queue_get_length (priv->page_order) >
+                       priv->max_pages)
+                {
+                        forget_page (priv,
+                                     g_queue_peek_tail (priv->page_order));
+                }
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_entry_store_get_property (GObject* object, guint prop_id,
+                              GValue* value, GParamSpec* spec)
+{
+        YtvEntryStorePriv* priv;
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_PATH:
+                g_value_set_string (value, priv->path);
+                break;
+        case PROP_BATCH_SIZE:
+                g_value_set_uint (value, priv->batch_size);
+                break;
+        case PROP_FLUSH_INTERVAL:
+                g_value_set_uint (value, priv->flush_interval);
+                break;
+        case PROP_MAX_PAGES:
+                g_value_set_uint (value, priv->max_pages);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_entry_store_dispose (GObject* object)
+{
+        YtvEntryStorePriv* priv;
+        GError* err = NULL;
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (object);
+
+        if (priv->fd >= 0)
+        {
+                if (!ytv_entry_store_flush (YTV_ENTRY_STORE (object), &err))
+                {
+                        g_warning ("%s", ytv_error_get_message (err));
+                        g_error_free (err);
+                }
+
+                close (priv->fd);
+                priv->fd = -1;
+        }
+
+        if (priv->timer_id != 0)
+        {
+                g_source_remove (priv->timer_id);
+                priv->timer_id = 0;
+        }
+
+        (*G_OBJECT_CLASS (ytv_entry_store_parent_class)->dispose) (object);
+
+        return;
+}
+
+static void
+ytv_entry_store_finalize (GObject* object)
+{
+        YtvEntryStorePriv* priv;
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (object);
+
+        g_hash_table_destroy (priv->authors);
+        g_hash_table_destroy (priv->categories);
+        g_hash_table_destroy (priv->items);
+        g_hash_table_destroy (priv->pages);
+        g_queue_free (priv->page_order);
+        g_ptr_array_free (priv->published, TRUE);
+        g_string_free (priv->pending, TRUE);
+        g_string_free (priv->scratch, TRUE);
+        g_free (priv->path);
+
+        (*G_OBJECT_CLASS (ytv_entry_store_parent_class)->finalize) (object);
+
+        return;
+}
+
+static void
+ytv_entry_store_class_init (YtvEntryStoreClass* klass)
+{
+        GObjectClass* g_klass;
+
+        g_klass = G_OBJECT_CLASS (klass);
+
+        g_type_class_add_private (g_klass, sizeof (YtvEntryStorePriv));
+
+        g_klass->set_property = ytv_entry_store_set_property;
+        g_klass->get_property = ytv_entry_store_get_property;
+        g_klass->dispose      = ytv_entry_store_dispose;
+        g_klass->finalize     = ytv_entry_store_finalize;
+
+        g_object_class_install_property
+                (g_klass, PROP_PATH,
+                 g_param_spec_string
+                 ("path", "path", "The file of the store", NULL,
+                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+        g_object_class_install_property
+                (g_klass, PROP_BATCH_SIZE,
+                 g_param_spec_uint
+                 ("batch-size", "batchsize",
+                  "Bytes of pending records which are written at once",
+                  0, G_MAXUINT, BATCH_SIZE, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (g_klass, PROP_FLUSH_INTERVAL,
+                 g_param_spec_uint
+                 ("flush-interval", "flushinterval",
+                  "Milliseconds a pending record waits to be written",
+                  0, G_MAXUINT, FLUSH_INTERVAL, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (g_klass, PROP_MAX_PAGES,
+                 g_param_spec_uint
+                 ("max-pages", "maxpages",
+                  "Number of fetched pages kept, the newest ones",
+                  0, G_MAXUINT, MAX_PAGES, G_PARAM_READWRITE));
+
+        return;
+}
+
+static void
+ytv_entry_store_init (YtvEntryStore* self)
+{
+        YtvEntryStorePriv* priv;
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        priv->path           = NULL;
+        priv->fd             = -1;
+        priv->end            = 0;
+        priv->live           = 0;
+        priv->items          = g_hash_table_new_full
+                (g_str_hash, g_str_equal, NULL, (GDestroyNotify) item_free);
+        priv->authors        = g_hash_table_new_full
+                (g_str_hash, g_str_equal, g_free,
+                 (GDestroyNotify) g_hash_table_destroy);
+        priv->categories     = g_hash_table_new_full
+                (g_str_hash, g_str_equal, g_free,
+                 (GDestroyNotify) g_hash_table_destroy);
+        priv->published      = g_ptr_array_new ();
+        priv->dirty          = FALSE;
+        priv->pages          = g_hash_table_new_full
+                (g_str_hash, g_str_equal, NULL, (GDestroyNotify) item_free);
+        priv->page_order     = g_queue_new ();
+        priv->max_pages      = MAX_PAGES;
+        priv->pending        = g_string_new (NULL);
+        priv->scratch        = g_string_new (NULL);
+        priv->batch_size     = BATCH_SIZE;
+        priv->flush_interval = FLUSH_INTERVAL;
+        priv->timer_id       = 0;
+
+        return;
+}
+
+/**
+ * ytv_entry_store_new:
+ * @path: (not-null): the file of the store, created if it does not exist
+ * @err: (null-ok): a #GError or NULL
+ *
+ * Opens the store kept in @path, reading its indexes.
+ *
+ * returns: (null-ok) (caller-owns): a new #YtvEntryStore, or NULL if the
+ * file could not be opened or it is not a store
+ */
+YtvEntryStore*
+ytv_entry_store_new (const gchar* path, GError **err)
+{
+        YtvEntryStore* self;
+
+        g_assert (path != NULL);
+
+        self = g_object_new (YTV_TYPE_ENTRY_STORE, "path", path, NULL);
+
+        YTV_TRACE_BEGIN ("store", "open");
+
+        if (!open_log (YTV_ENTRY_STORE_GET_PRIVATE (self), err))
+        {
+                g_object_unref (self);
+                self = NULL;
+        }
+
+        YTV_TRACE_END ("store", "open");
+
+        return self;
+}
+
+/**
+ * ytv_entry_store_put:
+ * @self: (not-null): a #YtvEntryStore
+ * @entry: (not-null): the #YtvEntry to keep
+ *
+ * Appends @entry to the store, replacing the stored one with the same id,
+ * unless they are equal. It is written with the next batch.
+ */
+void
+ytv_entry_store_put (YtvEntryStore* self, YtvEntry* entry)
+{
+        g_assert (YTV_IS_ENTRY_STORE (self));
+        g_assert (YTV_IS_ENTRY (entry));
+
+        append (self, entry, NULL);
+
+        return;
+}
+
+/**
+ * ytv_entry_store_put_list:
+ * @self: (not-null): a #YtvEntryStore
+ * @list: (not-null): a #YtvList of #YtvEntry
+ *
+ * Appends every entry of @list to the store.
+ */
+void
+ytv_entry_store_put_list (YtvEntryStore* self, YtvList* list)
+{
+        YtvIterator* iter;
+        GObject* entry;
+
+        g_assert (YTV_IS_ENTRY_STORE (self));
+        g_assert (YTV_IS_LIST (list));
+
+        YTV_TRACE_BEGIN ("store", "put_list");
+
+        iter = ytv_list_create_iterator (list);
+
+        while (!ytv_iterator_is_done (iter))
+        {
+                entry = ytv_iterator_get_current (iter);
+                append (self, YTV_ENTRY (entry), NULL);
+                g_object_unref (entry);
+
+                ytv_iterator_next (iter);
+        }
+
+        g_object_unref (iter);
+
+        YTV_TRACE_END ("store", "put_list");
+
+        return;
+}
+
+/**
+ * ytv_entry_store_remove:
+ * @self: (not-null): a #YtvEntryStore
+ * @id: (not-null): the id of the entry
+ *
+ * Removes the entry with @id from the store, if it is there.
+ */
+void
+ytv_entry_store_remove (YtvEntryStore* self, const gchar* id)
+{
+        g_assert (YTV_IS_ENTRY_STORE (self));
+        g_assert (id != NULL);
+
+        append (self, NULL, id);
+
+        return;
+}
+
+/**
+ * ytv_entry_store_put_page:
+ * @self: (not-null): a #YtvEntryStore
+ * @uri: (not-null): the URI of the fetched page
+ * @list: (not-null): a #YtvList of #YtvEntry, the entries of the page
+ *
+ * Appends @list to the store, as the entries of the page of @uri, so it
+ * may be rebuilt with ytv_entry_store_get_page(). The entries themselves
+ * must be put apart, with ytv_entry_store_put_list().
+ */
+void
+ytv_entry_store_put_page (YtvEntryStore* self, const gchar* uri,
+                          YtvList* list)
+{
+        YtvEntryStorePriv* priv;
+        YtvStoreRecord rec;
+        YtvStoreItem* item;
+        guint32 sum;
+
+        g_assert (YTV_IS_ENTRY_STORE (self));
+        g_assert (uri != NULL);
+        g_assert (YTV_IS_LIST (list));
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        if (priv->max_pages == 0)
+        {
+                return;
+        }
+
+        serialize_page (priv->scratch, uri, list);
+        sum = checksum ((const guchar*) priv->scratch->str,
+                        priv->scratch->len);
+
+        /* nothing new */
+        item = g_hash_table_lookup (priv->pages, uri);
+        if (item != NULL && item->checksum == sum &&
+            item->size == RECORD_HEADER + priv->scratch->len)
+        {
+                return;
+        }
+
+        deserialize ((const guchar*) priv->scratch->str, priv->scratch->len,
+                     &rec);
+        push (self, &rec, sum);
+        record_clear (&rec);
+
+        return;
+}
+
+/**
+ * ytv_entry_store_flush:
+ * @self: (not-null): a #YtvEntryStore
+ * @err: (null-ok): a #GError or NULL
+ *
+ * Writes the pending records and syncs them to the disk. The store is
+ * compacted afterwards if it is needed.
+ *
+ * returns: TRUE if the records are safe on the disk
+ */
+gboolean
+ytv_entry_store_flush (YtvEntryStore* self, GError **err)
+{
+        YtvEntryStorePriv* priv;
+
+        g_assert (YTV_IS_ENTRY_STORE (self));
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        if (priv->timer_id != 0)
+        {
+                g_source_remove (priv->timer_id);
+                priv->timer_id = 0;
+        }
+
+        if (priv->pending->len == 0)
+        {
+                return TRUE;
+        }
+
+        YTV_TRACE_BEGIN ("store", "flush");
+
+        /* a failed batch is kept, to be retried with the next one */
+        if (!write_all (priv->fd, priv->pending->str, priv->pending->len,
+                        err))
+        {
+                /* cuts what was written of the batch, so the retry lands
+                 * at the offsets given to its records */
+                if (ftruncate (priv->fd, priv->end) != 0)
+                {
+                        g_warning ("Could not truncate %s - %s", priv->path,
+                                   g_strerror (errno));
+                }
+
+                YTV_TRACE_END ("store", "flush");
+                return FALSE;
+        }
+
+        priv->end += priv->pending->len;
+        g_string_truncate (priv->pending, 0);
+
+        if (fsync (priv->fd) != 0)
+        {
+                g_set_error (err, YTV_STORE_ERROR, YTV_STORE_ERROR_IO,
+                             "Could not sync %s - %s", priv->path,
+                             g_strerror (errno));
+
+                YTV_TRACE_END ("store", "flush");
+                return FALSE;
+        }
+
+        ytv_stats_inc (YTV_STATS_STORE_SYNCS);
+
+        YTV_TRACE_END ("store", "flush");
+
+        if (needs_compaction (priv))
+        {
+                return ytv_entry_store_compact (self, err);
+        }
+
+        return TRUE;
+}
+
+/**
+ * ytv_entry_store_compact:
+ * @self: (not-null): a #YtvEntryStore
+ * @err: (null-ok): a #GError or NULL
+ *
+ * Replaces the file of the store with a new one holding only the live
+ * records. If it fails, the store keeps its previous file.
+ *
+ * returns: TRUE if the store was compacted
+ */
+gboolean
+ytv_entry_store_compact (YtvEntryStore* self, GError **err)
+{
+        YtvEntryStorePriv* priv;
+        YtvStoreItem* item;
+        GPtrArray* items;
+        GString* out;
+        gchar* tmppath;
+        gint64* offsets;
+        gint64 end;
+        gint fd;
+        guint i;
+        GList* l;
+        gboolean retval;
+
+        g_assert (YTV_IS_ENTRY_STORE (self));
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        if (priv->pending->len > 0 && !ytv_entry_store_flush (self, err))
+        {
+                return FALSE;
+        }
+
+        YTV_TRACE_BEGIN ("store", "compact");
+
+        retval = FALSE;
+        tmppath = g_strconcat (priv->path, ".compact", NULL);
+        fd = open (tmppath, O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0600);
+
+        if (fd < 0)
+        {
+                g_set_error (err, YTV_STORE_ERROR, YTV_STORE_ERROR_IO,
+                             "Could not create %s - %s", tmppath,
+                             g_strerror (errno));
+                g_free (tmppath);
+
+                YTV_TRACE_END ("store", "compact");
+                return FALSE;
+        }
+
+        /* in publication order, so the ranges are read sequentially,
+         * the pages after the entries */
+        sort_published (priv);
+        items = g_ptr_array_sized_new (priv->published->len +
+                                       g_queue_get_length (priv->page_order));
+
+        for (i = 0; i < priv->published->len; i++)
+        {
+                g_ptr_array_add (items, g_ptr_array_index (priv->published, i));
+        }
+
+        for (l = g_queue_peek_tail_link (priv->page_order); l != NULL;
+             l = l->prev)
+        {
+                g_ptr_array_add (items, l->data);
+        }
+
+        offsets = g_new (gint64, items->len);
+
+        out = g_string_sized_new (priv->batch_size + MAX_RECORD);
+        g_string_append_len (out, MAGIC, FILE_HEADER - 1);
+        g_string_append_c (out, VERSION);
+        end = 0;
+
+        for (i = 0; i < items->len; i++)
+        {
+                item = g_ptr_array_index (items, i);
+                offsets[i] = end + out->len;
+
+                g_string_set_size (out, out->len + item->size);
+
+                if (!read_at (priv->fd,
+                              (guchar*) out->str + out->len - item->size,
+                              item->size, item->offset))
+                {
+                        g_set_error (err, YTV_STORE_ERROR,
+                                     YTV_STORE_ERROR_IO,
+                                     "Could not read %s - %s", priv->path,
+                                     g_strerror (errno));
+                        goto beach;
+                }
+
+                if (out->len >= priv->batch_size)
+                {
+                        if (!write_all (fd, out->str, out->len, err))
+                        {
+                                goto beach;
+                        }
+
+                        end += out->len;
+                        g_string_truncate (out, 0);
+                }
+        }
+
+        if (!write_all (fd, out->str, out->len, err))
+        {
+                goto beach;
+        }
+
+        end += out->len;
+
+        if (fsync (fd) != 0 || rename (tmppath, priv->path) != 0)
+        {
+                g_set_error (err, YTV_STORE_ERROR, YTV_STORE_ERROR_IO,
+                             "Could not replace %s - %s", priv->path,
+                             g_strerror (errno));
+                goto beach;
+        }
+
+        close (priv->fd);
+        priv->fd = fd;
+        fd = -1;
+
+        for (i = 0; i < items->len; i++)
+        {
+                item = g_ptr_array_index (items, i);
+                item->offset = offsets[i];
+        }
+
+        priv->end = end;
+        retval = TRUE;
+
+beach:
+        if (fd >= 0)
+        {
+                close (fd);
+                unlink (tmppath);
+        }
+
+        g_string_free (out, TRUE);
+        g_ptr_array_free (items, TRUE);
+        g_free (offsets);
+        g_free (tmppath);
+
+        YTV_TRACE_END ("store", "compact");
+
+        return retval;
+}
+
+/**
+ * ytv_entry_store_get_size:
+ * @self: (not-null): a #YtvEntryStore
+ *
+ * Retrieves the number of stored entries.
+ *
+ * returns: the number of entries
+ */
+guint
+ytv_entry_store_get_size (YtvEntryStore* self)
+{
+        YtvEntryStorePriv* priv;
+
+        g_assert (YTV_IS_ENTRY_STORE (self));
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        return g_hash_table_size (priv->items);
+}
+
+/**
+ * ytv_entry_store_lookup:
+ * @self: (not-null): a #YtvEntryStore
+ * @id: (not-null): the id of the entry
+ *
+ * Reads the stored entry with @id.
+ *
+ * returns: (null-ok) (caller-owns): the #YtvEntry, or NULL if it is not
+ * stored
+ */
+YtvEntry*
+ytv_entry_store_lookup (YtvEntryStore* self, const gchar* id)
+{
+        YtvEntryStorePriv* priv;
+        YtvStoreItem* item;
+
+        g_assert (YTV_IS_ENTRY_STORE (self));
+        g_assert (id != NULL);
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        item = g_hash_table_lookup (priv->items, id);
+
+        if (item == NULL)
+        {
+                return NULL;
+        }
+
+        return item_to_entry (priv, item);
+}
+
+/**
+ * ytv_entry_store_get_page:
+ * @self: (not-null): a #YtvEntryStore
+ * @uri: (not-null): the URI of the page
+ *
+ * Rebuilds the page of @uri, as it was put the last time. The entries
+ * removed since then are skipped, and those put again have their newer
+ * fields.
+ *
+ * returns: (null-ok) (caller-owns): a #YtvList of #YtvEntry, or NULL if
+ * the page is not stored
+ */
+YtvList*
+ytv_entry_store_get_page (YtvEntryStore* self, const gchar* uri)
+{
+        YtvEntryStorePriv* priv;
+        YtvStoreItem* page;
+        YtvStoreItem* item;
+        YtvEntry* entry;
+        YtvList* retval;
+        gchar** id;
+
+        g_assert (YTV_IS_ENTRY_STORE (self));
+        g_assert (uri != NULL);
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        page = g_hash_table_lookup (priv->pages, uri);
+
+        if (page == NULL)
+        {
+                return NULL;
+        }
+
+        YTV_TRACE_BEGIN ("store", "get_page");
+
+        retval = ytv_simple_list_new ();
+
+        for (id = page->ids; *id != NULL; id++)
+        {
+                item = g_hash_table_lookup (priv->items, *id);
+                entry = (item != NULL) ? item_to_entry (priv, item) : NULL;
+
+                if (entry != NULL)
+                {
+                        ytv_list_append (retval, G_OBJECT (entry));
+                        g_object_unref (entry);
+                }
+        }
+
+        YTV_TRACE_END ("store", "get_page");
+
+        return retval;
+}
+
+/**
+ * ytv_entry_store_get_by_author:
+ * @self: (not-null): a #YtvEntryStore
+ * @author: (not-null): the author of the entries
+ *
+ * Reads the stored entries uploaded by @author.
+ *
+ * returns: (not-null) (caller-owns): a #YtvList of #YtvEntry, the newest
+ * first, maybe empty
+ */
+YtvList*
+ytv_entry_store_get_by_author (YtvEntryStore* self, const gchar* author)
+{
+        YtvEntryStorePriv* priv;
+
+        g_assert (YTV_IS_ENTRY_STORE (self));
+        g_assert (author != NULL);
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        return set_to_list (priv, g_hash_table_lookup (priv->authors,
+                                                       author));
+}
+
+/**
+ * ytv_entry_store_get_by_category:
+ * @self: (not-null): a #YtvEntryStore
+ * @category: (not-null): the category of the entries
+ *
+ * Reads the stored entries of @category.
+ *
+ * returns: (not-null) (caller-owns): a #YtvList of #YtvEntry, the newest
+ * first, maybe empty
+ */
+YtvList*
+ytv_entry_store_get_by_category (YtvEntryStore* self, const gchar* category)
+{
+        YtvEntryStorePriv* priv;
+
+        g_assert (YTV_IS_ENTRY_STORE (self));
+        g_assert (category != NULL);
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        return set_to_list (priv, g_hash_table_lookup (priv->categories,
+                                                       category));
+}
+
+/**
+ * ytv_entry_store_get_range:
+ * @self: (not-null): a #YtvEntryStore
+ * @since: (null-ok): the oldest publication date, in ISO 8601, or NULL
+ * @until: (null-ok): the publication date, in ISO 8601, the entries must
+ *         be older than, or NULL
+ * @max_results: the number of entries to return, or -1 for all of them
+ *
+ * Reads the stored entries published between @since and @until. Without
+ * bounds, all the stored entries are returned.
+ *
+ * returns: (not-null) (caller-owns): a #YtvList of #YtvEntry, the newest
+ * first, maybe empty
+ */
+YtvList*
+ytv_entry_store_get_range (YtvEntryStore* self, const gchar* since,
+                           const gchar* until, gint max_results)
+{
+        YtvEntryStorePriv* priv;
+        YtvList* retval;
+        YtvEntry* entry;
+        guint lo, hi;
+
+        g_assert (YTV_IS_ENTRY_STORE (self));
+
+        priv = YTV_ENTRY_STORE_GET_PRIVATE (self);
+
+        YTV_TRACE_BEGIN ("store", "get_range");
+
+        retval = ytv_simple_list_new ();
+        sort_published (priv);
+
+        lo = since != NULL ? lower_bound (priv->published, since) : 0;
+        hi = until != NULL ?
+                lower_bound (priv->published, until) : priv->published->len;
+
+        for (; hi > lo && max_results != 0; hi--)
+        {
+                entry = item_to_entry (priv, g_ptr_array_index
+                                       (priv->published, hi - 1));
+
+                if (entry != NULL)
+                {
+                        ytv_list_append (retval, G_OBJECT (entry));
+                        g_object_unref (entry);
+
+                        if (max_results > 0)
+                        {
+                                max_results--;
+                        }
+                }
+        }
+
+        YTV_TRACE_END ("store", "get_range");
+
+        return retval;
+}
@@ -0,0 +1,83 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_ENTRY_STORE_H_
+#define _YTV_ENTRY_STORE_H_
+
+/* ytv-entry-store.h - A persistent store of the fetched entries
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib-object.h>
+#include <ytv-shared.h>
+
+G_BEGIN_DECLS
+
+#define YTV_TYPE_ENTRY_STORE                    \
+        (ytv_entry_store_get_type ())
+#define YTV_ENTRY_STORE(obj)                                            \
+        (G_TYPE_CHECK_INSTANCE_CAST ((obj), YTV_TYPE_ENTRY_STORE, YtvEntryStore))
+#define YTV_ENTRY_STORE_CLASS(klass)                                    \
+        (G_TYPE_CHECK_CLASS_CAST ((klass), YTV_TYPE_ENTRY_STORE, YtvEntryStoreClass))
+#define YTV_IS_ENTRY_STORE(obj)                                         \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), YTV_TYPE_ENTRY_STORE))
+#define YTV_IS_ENTRY_STORE_CLASS(klass)                                 \
+        (G_TYPE_CHECK_CLASS_TYPE ((klass), YTV_TYPE_ENTRY_STORE))
+#define YTV_ENTRY_STORE_GET_CLASS(obj)                                  \
+        (G_TYPE_INSTANCE_GET_CLASS ((obj), YTV_TYPE_ENTRY_STORE, YtvEntryStoreClass))
+
+typedef struct _YtvEntryStore YtvEntryStore;
+typedef struct _YtvEntryStoreClass YtvEntryStoreClass;
+
+/**
+ * YtvEntryStore:
+ *
+ * An append-only log of entries kept on disk
+ */
+struct _YtvEntryStore
+{
+        GObject parent;
+};
+
+struct _YtvEntryStoreClass
+{
+        GObjectClass parent_class;
+};
+
+GType ytv_entry_store_get_type (void);
+
+YtvEntryStore* ytv_entry_store_new (const gchar* path, GError **err);
+void ytv_entry_store_put (YtvEntryStore* self, YtvEntry* entry);
+void ytv_entry_store_put_list (YtvEntryStore* self, YtvList* list);
+void ytv_entry_store_remove (YtvEntryStore* self, const gchar* id);
+void ytv_entry_store_put_page (YtvEntryStore* self, const gchar* uri,
+                               YtvList* list);
+gboolean ytv_entry_store_flush (YtvEntryStore* self, GError **err);
+gboolean ytv_entry_store_compact (YtvEntryStore* self, GError **err);
+guint ytv_entry_store_get_size (YtvEntryStore* self);
+YtvEntry* ytv_entry_store_lookup (YtvEntryStore* self, const gchar* id);
+YtvList* ytv_entry_store_get_page (YtvEntryStore* self, const gchar* uri);
+YtvList* ytv_entry_store_get_by_author (YtvEntryStore* self,
+                                        const gchar* author);
+YtvList* ytv_entry_store_get_by_category (YtvEntryStore* self,
+                                          const gchar* category);
+YtvList* ytv_entry_store_get_range (YtvEntryStore* self, const gchar* since,
+                                    const gchar* until, gint max_results);
+
+G_END_DECLS
+
+#endif /* _YTV_ENTRY_STORE_H_ */
@@ -0,0 +1,877 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-entry-text-area.c - A light weight GTK+ widget for the entry text
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-entry-text-area
+ * @short_description: custom drawn text info of an entry
+ *
+ * The #YtvEntryTextArea shows the same data as #YtvEntryTextView, but
+ * instead of a #GtkTextBuffer and a child widget per star, it keeps a
+ * #PangoLayout per field, which are reused for every entry, and paints the
+ * text and the rating stars in its expose handler. The links are
+ * hit-tested against the painted fields.
+ */
+
+#include <monetary.h>
+
+#include <ytv-entry-text-area.h>
+
+#include <gtk/gtk.h>
+
+#include <ytv-star.h>
+#include <ytv-marshal.h>
+#include <ytv-trace.h>
+
+enum _YtvEntryTextAreaProp
+{
+        PROP_0,
+        PROP_ENTRY
+};
+
+enum _YtvEntryTextAreaSignals
+{
+        LINK_CLICKED,
+        LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+enum _YtvTextItemKind
+{
+        ITEM_TITLE,
+        ITEM_DURATION,
+        ITEM_AUTHOR,
+        ITEM_VIEWS,
+        ITEM_CATEGORY,
+        ITEM_LAST
+};
+
+typedef struct _YtvTextItem YtvTextItem;
+
+struct _YtvTextItem
+{
+        PangoLayout* layout;
+        GdkRectangle rect;
+        gboolean visible;
+        gchar* param; /* link parameter, NULL if not a link */
+};
+
+typedef struct _YtvEntryTextAreaPriv YtvEntryTextAreaPriv;
+
+struct _YtvEntryTextAreaPriv
+{
+        YtvEntry* entry;
+        YtvTextItem items[ITEM_LAST];
+        gfloat rating;
+        GdkRectangle stars;
+        gint laid_width;   /* width of the last layout */
+        gint height;       /* height of the last layout */
+        gint hover;        /* item under the pointer */
+        gint pressed;      /* item under the button press */
+};
+
+#define FONTSIZE_LARGE  10 * PANGO_SCALE
+#define FONTSIZE_MEDIUM  8 * PANGO_SCALE
+#define FONTSIZE_SMALL   7 * PANGO_SCALE
+
+#define MARGIN        6
+#define SPACING       4
+#define STAR_SIZE    18
+#define DEFAULT_WIDTH 200
+
+#define YTV_ENTRY_TEXT_AREA_GET_PRIVATE(obj) \
+        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_ENTRY_TEXT_AREA, YtvEntryTextAreaPriv))
+
+G_DEFINE_TYPE (YtvEntryTextArea, ytv_entry_text_area, GTK_TYPE_DRAWING_AREA)
+
+/* the text attributes of each item, shared by all the instances */
+static PangoAttrList* item_attrs[ITEM_LAST] = { NULL, };
+
+/* the link class of each item */
+static const gchar* item_class[ITEM_LAST] = {
+        "info", NULL, "author", NULL, "category"
+};
+
+static void
+create_item_attrs (void)
+{
+        PangoAttrList* attrs;
+
+        attrs = pango_attr_list_new ();
+        pango_attr_list_insert (attrs, pango_attr_size_new (FONTSIZE_LARGE));
+        pango_attr_list_insert (attrs,
+                                pango_attr_underline_new
+                                (PANGO_UNDERLINE_SINGLE));
+        item_attrs[ITEM_TITLE] = attrs;
+
+        attrs = pango_attr_list_new ();
+        pango_attr_list_insert (attrs, pango_attr_size_new (FONTSIZE_SMALL));
+        item_attrs[ITEM_DURATION] = attrs;
+
+        attrs = pango_attr_list_new ();
+        pango_attr_list_insert (attrs, pango_attr_size_new (FONTSIZE_MEDIUM));
+        pango_attr_list_insert (attrs, pango_attr_style_new (PANGO_STYLE_ITALIC));
+        pango_attr_list_insert (attrs,
+                                pango_attr_foreground_new (0x8b8b, 0, 0));
+        pango_attr_list_insert (attrs,
+                                pango_attr_underline_new
+                                (PANGO_UNDERLINE_SINGLE));
+        item_attrs[ITEM_AUTHOR] = attrs;
+
+        attrs = pango_attr_list_new ();
+        pango_attr_list_insert (attrs, pango_attr_size_new (FONTSIZE_MEDIUM));
+        pango_attr_list_insert (attrs,
+                                pango_attr_foreground_new (0xa9a9, 0xa9a9,
+                                                           0xa9a9));
+        item_attrs[ITEM_VIEWS] = attrs;
+
+        attrs = pango_attr_list_new ();
+        pango_attr_list_insert (attrs, pango_attr_size_new (FONTSIZE_MEDIUM));
+        pango_attr_list_insert (attrs, pango_attr_foreground_new (0, 0, 0xffff));
+        pango_attr_list_insert (attrs,
+                                pango_attr_underline_new
+                                (PANGO_UNDERLINE_SINGLE));
+        item_attrs[ITEM_CATEGORY] = attrs;
+
+        return;
+}
+
+static GdkCursor*
+get_hand_cursor (void)
+{
+        static GdkCursor* hand = NULL;
+
+        if (hand == NULL)
+        {
+                hand = gdk_cursor_new (GDK_HAND2);
+        }
+
+        return hand;
+}
+
+/* places the visible items, in rows, for the given width */
+static void
+relayout (YtvEntryTextArea* self, gint width)
+{
+        YtvEntryTextAreaPriv* priv;
+        YtvTextItem* item;
+        gint avail, x, y, w, h, lineh, i, r;
+
+        /* the item ranges of every row, but the title's */
+        static const gint rows[][2] = {
+                { ITEM_DURATION, ITEM_AUTHOR },
+                { ITEM_VIEWS, ITEM_CATEGORY }
+        };
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (self);
+
+        avail = MAX (width - 2 * MARGIN, 1);
+        y = MARGIN;
+
+        /* the title wraps in as many lines as needed */
+        item = &priv->items[ITEM_TITLE];
+        if (item->visible)
+        {
+                pango_layout_set_width (item->layout, avail * PANGO_SCALE);
+                pango_layout_get_pixel_size (item->layout, &w, &h);
+
+                item->rect.x = MARGIN;
+                item->rect.y = y;
+                item->rect.width = w;
+                item->rect.height = h;
+
+                y += h + SPACING;
+        }
+
+        /* the rest flow from left to right */
+        for (r = 0; r < (gint) G_N_ELEMENTS (rows); r++)
+        {
+                x = MARGIN;
+                lineh = 0;
+
+                for (i = rows[r][0]; i <= rows[r][1]; i++)
+                {
+                        item = &priv->items[i];
+
+                        if (!item->visible)
+                        {
+                                continue;
+                        }
+
+                        pango_layout_set_width (item->layout, -1);
+                        pango_layout_get_pixel_size (item->layout, &w, &h);
+
+                        if (x > MARGIN && x + w > MARGIN + avail)
+                        {
+                                y += lineh + SPACING;
+                                x = MARGIN;
+                                lineh = 0;
+                        }
+
+                        if (w > avail)
+                        {
+                                /* ellipsized */
+                                pango_layout_set_width (item->layout,
+                                                        avail * PANGO_SCALE);
+                                pango_layout_get_pixel_size (item->layout,
+                                                             &w, &h);
+                        }
+
+                        item->rect.x = x;
+                        item->rect.y = y;
+                        item->rect.width = w;
+                        item->rect.height = h;
+
+                        x += w + SPACING;
+                        lineh = MAX (lineh, h);
+                }
+
+                if (lineh > 0)
+                {
+                        y += lineh + SPACING;
+                }
+        }
+
+        priv->stars.x = MARGIN;
+        priv->stars.y = y;
+        priv->stars.width = 5 * STAR_SIZE;
+        priv->stars.height = STAR_SIZE;
+
+        priv->height = y + STAR_SIZE + MARGIN;
+        priv->laid_width = width;
+
+        return;
+}
+
+/* lays out again and asks for a new size if the height changed */
+static void
+update_layout (YtvEntryTextArea* self)
+{
+        YtvEntryTextAreaPriv* priv;
+        GtkWidget* widget;
+        gint height;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (self);
+        widget = GTK_WIDGET (self);
+
+        height = priv->height;
+
+        relayout (self, widget->allocation.width > 1 ?
+                  widget->allocation.width : DEFAULT_WIDTH);
+
+        if (priv->height != height)
+        {
+                gtk_widget_queue_resize (widget);
+        }
+
+        gtk_widget_queue_draw (widget);
+
+        return;
+}
+
+static gint
+hit_test (YtvEntryTextArea* self, gint x, gint y)
+{
+        YtvEntryTextAreaPriv* priv;
+        GdkRectangle* rect;
+        gint i;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (self);
+
+        for (i = 0; i < ITEM_LAST; i++)
+        {
+                if (!priv->items[i].visible || priv->items[i].param == NULL)
+                {
+                        continue;
+                }
+
+                rect = &priv->items[i].rect;
+
+                if (x >= rect->x && x < rect->x + rect->width &&
+                    y >= rect->y && y < rect->y + rect->height)
+                {
+                        return i;
+                }
+        }
+
+        return -1;
+}
+
+static void
+set_hover (YtvEntryTextArea* self, gint hover)
+{
+        YtvEntryTextAreaPriv* priv;
+        GtkWidget* widget;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (self);
+        widget = GTK_WIDGET (self);
+
+        if (hover == priv->hover)
+        {
+                return;
+        }
+
+        priv->hover = hover;
+
+        if (widget->window != NULL)
+        {
+                gdk_window_set_cursor (widget->window,
+                                       hover >= 0 ? get_hand_cursor () : NULL);
+        }
+
+        return;
+}
+
+static void
+set_item (YtvTextItem* item, const gchar* text, const gchar* param)
+{
+        g_free (item->param);
+        item->param = g_strdup (param);
+
+        item->visible = (text != NULL);
+
+        if (item->visible)
+        {
+                pango_layout_set_text (item->layout, text, -1);
+        }
+
+        return;
+}
+
+static void
+update_widget (YtvEntryTextArea* self)
+{
+        YtvEntryTextAreaPriv* priv;
+        YtvTextItem* items;
+
+        gchar* title;
+        gint duration;
+        gchar* author;
+        gint views;
+        gfloat rating;
+        gchar* category;
+        gchar* id;
+
+        YTV_TRACE_BEGIN ("text-area", "update_widget");
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (self);
+        items = priv->items;
+
+        g_object_get (G_OBJECT (priv->entry),
+                      "id", &id, "title", &title, "duration", &duration,
+                      "author", &author, "views", &views,
+                      "category", &category, "rating", &rating, NULL);
+
+        set_item (&items[ITEM_TITLE], title, title != NULL ? id : NULL);
+        set_item (&items[ITEM_AUTHOR], author, author);
+        set_item (&items[ITEM_CATEGORY], category, category);
+
+        {
+                gchar* dur;
+
+                gint sec = duration % 60;
+                gint min = (duration / 60) % 60;
+                gint hou = duration / 3600;
+
+                if (hou > 0)
+                {
+                        dur = g_strdup_printf ("%02d:%02d:%02d", hou, min, sec);
+                }
+                else
+                {
+                        dur = g_strdup_printf ("%02d:%02d", min, sec);
+                }
+
+                set_item (&items[ITEM_DURATION], dur, NULL);
+                g_free (dur);
+        }
+
+        {
+                gchar nv[BUFSIZ];
+                gchar* v;
+
+                strfmon (nv, BUFSIZ - 1, "%!.0n", (gdouble) views);
+                v = g_strdup_printf ("%s views", nv);
+
+                set_item (&items[ITEM_VIEWS], v, NULL);
+                g_free (v);
+        }
+
+        priv->rating = MAX (rating, 0);
+
+        g_free (id);
+        g_free (title);
+        g_free (author);
+        g_free (category);
+
+        update_layout (self);
+
+        YTV_TRACE_END ("text-area", "update_widget");
+
+        return;
+}
+
+static gboolean
+ytv_entry_text_area_expose_event (GtkWidget* widget, GdkEventExpose* event)
+{
+        YtvEntryTextAreaPriv* priv;
+        YtvTextItem* item;
+        cairo_t* cr;
+        gint i;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (widget);
+
+        YTV_TRACE_BEGIN ("text-area", "expose");
+
+        cr = gdk_cairo_create (widget->window);
+
+        gdk_cairo_region (cr, event->region);
+        cairo_clip (cr);
+
+        gdk_cairo_set_source_color
+                (cr, &widget->style->base[GTK_WIDGET_STATE (widget)]);
+        cairo_paint (cr);
+
+        if (priv->entry == NULL)
+        {
+                goto beach;
+        }
+
+        for (i = 0; i < ITEM_LAST; i++)
+        {
+                item = &priv->items[i];
+
+                if (!item->visible)
+                {
+                        continue;
+                }
+
+                /* the items without colour attribute use the theme's */
+                gdk_cairo_set_source_color
+                        (cr, &widget->style->text[GTK_WIDGET_STATE (widget)]);
+                cairo_move_to (cr, item->rect.x, item->rect.y);
+                pango_cairo_show_layout (cr, item->layout);
+        }
+
+        for (i = 0; i < 5; i++)
+        {
+                ytv_star_paint (cr, priv->stars.x + i * STAR_SIZE,
+                                priv->stars.y, STAR_SIZE,
+                                CLAMP (priv->rating - i, 0.0, 1.0));
+        }
+
+beach:
+        cairo_destroy (cr);
+
+        YTV_TRACE_END ("text-area", "expose");
+
+        return FALSE;
+}
+
+static void
+ytv_entry_text_area_size_request (GtkWidget* widget,
+                                  GtkRequisition* requisition)
+{
+        YtvEntryTextAreaPriv* priv;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (widget);
+
+        if (priv->laid_width < 0)
+        {
+                relayout (YTV_ENTRY_TEXT_AREA (widget),
+                          widget->allocation.width > 1 ?
+                          widget->allocation.width : DEFAULT_WIDTH);
+        }
+
+        requisition->width = 5 * STAR_SIZE + 2 * MARGIN;
+        requisition->height = priv->height;
+
+        return;
+}
+
+static void
+ytv_entry_text_area_size_allocate (GtkWidget* widget,
+                                   GtkAllocation* allocation)
+{
+        YtvEntryTextAreaPriv* priv;
+        gint height;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (widget);
+
+        GTK_WIDGET_CLASS (ytv_entry_text_area_parent_class)->size_allocate
+                (widget, allocation);
+
+        /* the height depends on the width: this converges in one pass */
+        if (allocation->width != priv->laid_width)
+        {
+                height = priv->height;
+                relayout (YTV_ENTRY_TEXT_AREA (widget), allocation->width);
+
+                if (priv->height != height)
+                {
+                        gtk_widget_queue_resize (widget);
+                }
+        }
+
+        return;
+}
+
+static void
+ytv_entry_text_area_style_set (GtkWidget* widget, GtkStyle* previous)
+{
+        YtvEntryTextAreaPriv* priv;
+        gint i;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (widget);
+
+        GTK_WIDGET_CLASS (ytv_entry_text_area_parent_class)->style_set
+                (widget, previous);
+
+        for (i = 0; i < ITEM_LAST; i++)
+        {
+                pango_layout_context_changed (priv->items[i].layout);
+        }
+
+        update_layout (YTV_ENTRY_TEXT_AREA (widget));
+
+        return;
+}
+
+static gboolean
+ytv_entry_text_area_motion_notify_event (GtkWidget* widget,
+                                         GdkEventMotion* event)
+{
+        YtvEntryTextAreaPriv* priv;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (widget);
+
+        if (priv->entry != NULL)
+        {
+                set_hover (YTV_ENTRY_TEXT_AREA (widget),
+                           hit_test (YTV_ENTRY_TEXT_AREA (widget),
+                                     event->x, event->y));
+        }
+
+        gdk_window_get_pointer (widget->window, NULL, NULL, NULL);
+
+        return FALSE;
+}
+
+static gboolean
+ytv_entry_text_area_leave_notify_event (GtkWidget* widget,
+                                        GdkEventCrossing* event)
+{
+        set_hover (YTV_ENTRY_TEXT_AREA (widget), -1);
+
+        return FALSE;
+}
+
+static gboolean
+ytv_entry_text_area_button_press_event (GtkWidget* widget,
+                                        GdkEventButton* event)
+{
+        YtvEntryTextAreaPriv* priv;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (widget);
+
+        if (event->button != 1 || priv->entry == NULL)
+        {
+                return FALSE;
+        }
+
+        priv->pressed = hit_test (YTV_ENTRY_TEXT_AREA (widget),
+                                  event->x, event->y);
+
+        return priv->pressed >= 0;
+}
+
+static gboolean
+ytv_entry_text_area_button_release_event (GtkWidget* widget,
+                                          GdkEventButton* event)
+{
+        YtvEntryTextAreaPriv* priv;
+        gint item;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (widget);
+
+        if (event->button != 1 || priv->pressed < 0)
+        {
+                return FALSE;
+        }
+
+        item = hit_test (YTV_ENTRY_TEXT_AREA (widget), event->x, event->y);
+
+        /* only if released over the pressed link */
+        if (item == priv->pressed)
+        {
+                g_signal_emit (widget, signals[LINK_CLICKED], 0,
+                               item_class[item], priv->items[item].param);
+        }
+
+        priv->pressed = -1;
+
+        return TRUE;
+}
+
+static void
+ytv_entry_text_area_set_property (GObject* object, guint prop_id,
+                                  const GValue* value, GParamSpec* spec)
+{
+        switch (prop_id)
+        {
+        case PROP_ENTRY:
+                ytv_entry_text_area_set_entry (YTV_ENTRY_TEXT_AREA (object),
+                                               g_value_get_object (value));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_entry_text_area_get_property (GObject* object, guint prop_id,
+                                  GValue* value, GParamSpec* spec)
+{
+        YtvEntryTextAreaPriv* priv;
+
+        switch (prop_id)
+        {
+        case PROP_ENTRY:
+                priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (object);
+                g_value_set_object (value, priv->entry);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_entry_text_area_dispose (GObject* object)
+{
+        YtvEntryTextAreaPriv* priv;
+
+        (*G_OBJECT_CLASS (ytv_entry_text_area_parent_class)->dispose) (object);
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (object);
+
+        if (priv->entry != NULL)
+        {
+                g_object_unref (priv->entry);
+                priv->entry = NULL;
+        }
+
+        return;
+}
+
+static void
+ytv_entry_text_area_finalize (GObject* object)
+{
+        YtvEntryTextAreaPriv* priv;
+        gint i;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (object);
+
+        for (i = 0; i < ITEM_LAST; i++)
+        {
+                g_object_unref (priv->items[i].layout);
+                g_free (priv->items[i].param);
+        }
+
+        (*G_OBJECT_CLASS (ytv_entry_text_area_parent_class)->finalize) (object);
+
+        return;
+}
+
+static void
+ytv_entry_text_area_class_init (YtvEntryTextAreaClass* klass)
+{
+        GObjectClass* object_class;
+        GtkWidgetClass* widget_class;
+
+        object_class = G_OBJECT_CLASS (klass);
+        widget_class = GTK_WIDGET_CLASS (klass);
+
+        g_type_class_add_private (object_class, sizeof (YtvEntryTextAreaPriv));
+
+        object_class->get_property = ytv_entry_text_area_get_property;
+        object_class->set_property = ytv_entry_text_area_set_property;
+        object_class->dispose      = ytv_entry_text_area_dispose;
+        object_class->finalize     = ytv_entry_text_area_finalize;
+
+        widget_class->expose_event   = ytv_entry_text_area_expose_event;
+        widget_class->size_request   = ytv_entry_text_area_size_request;
+        widget_class->size_allocate  = ytv_entry_text_area_size_allocate;
+        widget_class->style_set      = ytv_entry_text_area_style_set;
+        widget_class->motion_notify_event =
+                ytv_entry_text_area_motion_notify_event;
+        widget_class->leave_notify_event =
+                ytv_entry_text_area_leave_notify_event;
+        widget_class->button_press_event =
+                ytv_entry_text_area_button_press_event;
+        widget_class->button_release_event =
+                ytv_entry_text_area_button_release_event;
+
+        create_item_attrs ();
+
+        g_object_class_install_property
+                (object_class, PROP_ENTRY,
+                 g_param_spec_object
+                 ("entry", "Entry", "The feed's entry to show",
+                  YTV_TYPE_ENTRY, G_PARAM_READWRITE));
+
+        signals[LINK_CLICKED] =
+                g_signal_new ("link-clicked",
+                              YTV_TYPE_ENTRY_TEXT_AREA,
+                              G_SIGNAL_RUN_LAST,
+                              G_STRUCT_OFFSET (YtvEntryTextAreaClass,
+                                               link_clicked),
+                              NULL, NULL,
+                              ytv_cclosure_marshal_VOID__STRING_STRING,
+                              G_TYPE_NONE, 2,
+                              G_TYPE_STRING, G_TYPE_STRING);
+
+        return;
+}
+
+static void
+ytv_entry_text_area_init (YtvEntryTextArea* self)
+{
+        YtvEntryTextAreaPriv* priv;
+        YtvTextItem* item;
+        gint i;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (self);
+
+        for (i = 0; i < ITEM_LAST; i++)
+        {
+                item = &priv->items[i];
+
+                item->layout = gtk_widget_create_pango_layout
+                        (GTK_WIDGET (self), NULL);
+                pango_layout_set_attributes (item->layout, item_attrs[i]);
+                item->visible = FALSE;
+                item->param = NULL;
+        }
+
+        pango_layout_set_wrap (priv->items[ITEM_TITLE].layout,
+                               PANGO_WRAP_WORD_CHAR);
+        pango_layout_set_ellipsize (priv->items[ITEM_AUTHOR].layout,
+                                    PANGO_ELLIPSIZE_END);
+        pango_layout_set_ellipsize (priv->items[ITEM_CATEGORY].layout,
+                                    PANGO_ELLIPSIZE_END);
+
+        priv->entry      = NULL;
+        priv->rating     = 0;
+        priv->laid_width = -1;
+        priv->height     = 0;
+        priv->hover      = -1;
+        priv->pressed    = -1;
+
+        gtk_widget_add_events (GTK_WIDGET (self),
+                               GDK_POINTER_MOTION_MASK |
+                               GDK_POINTER_MOTION_HINT_MASK |
+                               GDK_LEAVE_NOTIFY_MASK |
+                               GDK_BUTTON_PRESS_MASK |
+                               GDK_BUTTON_RELEASE_MASK);
+
+        return;
+}
+
+/**
+ * ytv_entry_text_area_new:
+ *
+ * Create a new light weight widget for show entry data
+ */
+GtkWidget*
+ytv_entry_text_area_new (void)
+{
+        return GTK_WIDGET (g_object_new (YTV_TYPE_ENTRY_TEXT_AREA, NULL));
+}
+
+/**
+ * ytv_entry_text_area_set_entry:
+ * @self: A #YtvEntryTextArea
+ * @entry: A #YtvEntry
+ *
+ * Set the entry to display in the widget
+ */
+void
+ytv_entry_text_area_set_entry (YtvEntryTextArea* self, YtvEntry* entry)
+{
+        YtvEntryTextAreaPriv* priv;
+
+        g_return_if_fail (entry != NULL);
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (self);
+
+        if (priv->entry != NULL)
+        {
+                g_object_unref (priv->entry);
+                priv->entry = NULL;
+        }
+
+        priv->entry = g_object_ref (entry);
+
+        update_widget (self);
+
+        g_object_notify (G_OBJECT (self), "entry");
+
+        return;
+}
+
+/**
+ * ytv_entry_text_area_clean:
+ * @self: a #YtvEntryTextArea
+ *
+ * Clean the widget data.
+ */
+void
+ytv_entry_text_area_clean (YtvEntryTextArea* self)
+{
+        YtvEntryTextAreaPriv* priv;
+        gint i;
+
+        priv = YTV_ENTRY_TEXT_AREA_GET_PRIVATE (self);
+
+        if (priv->entry != NULL)
+        {
+                g_object_unref (priv->entry);
+                priv->entry = NULL;
+        }
+
+        for (i = 0; i < ITEM_LAST; i++)
+        {
+                set_item (&priv->items[i], NULL, NULL);
+        }
+
+        priv->rating = 0;
+
+        set_hover (self, -1);
+        gtk_widget_queue_draw (GTK_WIDGET (self));
+
+        return;
+}
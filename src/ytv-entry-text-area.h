@@ -0,0 +1,72 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_ENTRY_TEXT_AREA_H_
+#define _YTV_ENTRY_TEXT_AREA_H_
+
+/* ytv-entry-text-area.h - A light weight GTK+ widget for the entry text
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gtk/gtkdrawingarea.h>
+#include <ytv-entry.h>
+
+G_BEGIN_DECLS
+
+#define YTV_TYPE_ENTRY_TEXT_AREA (ytv_entry_text_area_get_type ())
+#define YTV_ENTRY_TEXT_AREA(obj) \
+        (G_TYPE_CHECK_INSTANCE_CAST ((obj), YTV_TYPE_ENTRY_TEXT_AREA, YtvEntryTextArea))
+#define YTV_ENTRY_TEXT_AREA_CLASS(klass) \
+        (G_TYPE_CHECK_CLASS_CAST ((klass), YTV_TYPE_ENTRY_TEXT_AREA, YtvEntryTextAreaClass))
+#define YTV_IS_ENTRY_TEXT_AREA(obj) \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), YTV_TYPE_ENTRY_TEXT_AREA))
+#define YTV_IS_ENTRY_TEXT_AREA_CLASS(klass) \
+        (G_TYPE_CHECK_CLASS_TYPE ((klass), YTV_TYPE_ENTRY_TEXT_AREA))
+#define YTV_ENTRY_TEXT_AREA_GET_CLASS(obj) \
+        (G_TYPE_INSTANCE_GET_CLASS ((obj), YTV_TYPE_ENTRY_TEXT_AREA, YtvEntryTextAreaClass))
+
+typedef struct _YtvEntryTextArea YtvEntryTextArea;
+typedef struct _YtvEntryTextAreaClass YtvEntryTextAreaClass;
+
+/**
+ * YtvEntryTextArea:
+ *
+ * It is a custom drawn GTK+ view for the text info in #YtvEntry
+ */
+struct _YtvEntryTextArea
+{
+        GtkDrawingArea parent;
+};
+
+struct _YtvEntryTextAreaClass
+{
+        GtkDrawingAreaClass parent_class;
+
+        /* signals */
+        void (*link_clicked) (YtvEntryTextArea* self,
+                              const gchar* class, const gchar* param);
+};
+
+GType ytv_entry_text_area_get_type (void);
+
+GtkWidget* ytv_entry_text_area_new (void);
+void ytv_entry_text_area_set_entry (YtvEntryTextArea* self, YtvEntry* entry);
+void ytv_entry_text_area_clean (YtvEntryTextArea* self);
+
+G_END_DECLS
+
+#endif /* _YTV_ENTRY_TEXT_AREA_H_ */
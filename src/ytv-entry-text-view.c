@@ -25,8 +25,9 @@
 
 #include <gtk/gtk.h>
 
-#include <ytv-star.h>
+#include <ytv-rank.h>
 #include <ytv-marshal.h>
+#include <ytv-trace.h>
 
 enum _YtvEntryTextViewProp
 {
@@ -319,54 +320,6 @@ event_after (GtkWidget* view, GdkEvent* ev)
         return FALSE;
 }
 
-static GtkWidget*
-get_rating_widget (gfloat rating)
-{
-        gint i;
-        gfloat restrank;
-        GtkWidget* retval;
-        GdkColor white;
-        
-        restrank = rating;
-        
-        retval = gtk_hbox_new (FALSE, 0);
-
-        if (gdk_color_parse ("white", &white))
-        {
-                gtk_widget_modify_bg (retval, GTK_STATE_NORMAL, &white);
-        }
-        
-        for (i = 0; i < 5; i++)
-        {
-                GtkWidget* star;
-                
-                if (restrank >= 1.0)
-                {
-                        star = ytv_star_new (1.0);
-                        restrank -= 1;
-                }
-                else if (restrank > 0.0)
-                {
-                        star = ytv_star_new (restrank);
-                        restrank = 0.0;
-                }
-                else if (restrank == 0.0)
-                {
-                        star = ytv_star_new (0.0);
-                }
-                else
-                {
-                        g_assert_not_reached ();
-                }
-                
-                gtk_widget_set_size_request (star, 18, 18);
-                gtk_widget_modify_bg (star, GTK_STATE_NORMAL, &white);
-                gtk_box_pack_start (GTK_BOX (retval), star, FALSE, FALSE, 0);
-        }
-
-        return retval;
-}
-
 static void
 insert_link (GtkTextBuffer* buffer, GtkTextIter* iter, const gchar* text,
              const gchar* class, const gchar* param, const gchar* tagname)
@@ -423,6 +376,8 @@ update_widget (YtvEntryTextView* self)
         gchar* category;
         gchar* id;
         
+        YTV_TRACE_BEGIN ("text-view", "update_widget");
+
         priv = YTV_ENTRY_TEXT_VIEW_GET_PRIVATE (self);
         buffer = gtk_text_buffer_new (priv->tagtable);
         gtk_text_view_set_buffer (GTK_TEXT_VIEW (self), buffer);
@@ -519,7 +474,8 @@ update_widget (YtvEntryTextView* self)
                         rating = 0;
                 }
 
-                rank = get_rating_widget (rating);
+                /* a single widget which paints the five stars */
+                rank = ytv_rank_new_compact (MIN (rating, 5.0));
                 
                 gtk_text_view_add_child_at_anchor (GTK_TEXT_VIEW (self),
                                                    rank, anchor);
@@ -531,6 +487,8 @@ update_widget (YtvEntryTextView* self)
         g_free (id);
         g_object_unref (buffer);
 
+        YTV_TRACE_END ("text-view", "update_widget");
+
         return;
 }
 
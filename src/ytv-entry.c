@@ -416,3 +416,76 @@ ytv_entry_dump (YtvEntry* self)
 
         return;
 }
+
+/**
+ * ytv_entry_diff:
+ * @self: (not-null): a #YtvEntry
+ * @other: (not-null): another #YtvEntry, usually a newer one of the same video
+ *
+ * Compares the fields of both entries, but the id.
+ *
+ * return value: a mask of #YtvEntryField with the fields which differ, zero
+ * if both entries are equal
+ */
+guint
+ytv_entry_diff (YtvEntry* self, YtvEntry* other)
+{
+        YtvEntryPriv* a;
+        YtvEntryPriv* b;
+        guint fields;
+
+        g_return_val_if_fail (YTV_IS_ENTRY (self), 0);
+        g_return_val_if_fail (YTV_IS_ENTRY (other), 0);
+
+        a = YTV_ENTRY_GET_PRIVATE (self);
+        b = YTV_ENTRY_GET_PRIVATE (other);
+
+        fields = 0;
+
+        if (g_strcmp0 (a->author, b->author) != 0)
+        {
+                fields |= YTV_ENTRY_FIELD_AUTHOR;
+        }
+
+        if (g_strcmp0 (a->title, b->title) != 0)
+        {
+                fields |= YTV_ENTRY_FIELD_TITLE;
+        }
+
+        if (a->duration != b->duration)
+        {
+                fields |= YTV_ENTRY_FIELD_DURATION;
+        }
+
+        if (a->rating != b->rating)
+        {
+                fields |= YTV_ENTRY_FIELD_RATING;
+        }
+
+        if (g_strcmp0 (a->published, b->published) != 0)
+        {
+                fields |= YTV_ENTRY_FIELD_PUBLISHED;
+        }
+
+        if (a->views != b->views)
+        {
+                fields |= YTV_ENTRY_FIELD_VIEWS;
+        }
+
+        if (g_strcmp0 (a->category, b->category) != 0)
+        {
+                fields |= YTV_ENTRY_FIELD_CATEGORY;
+        }
+
+        if (g_strcmp0 (a->tags, b->tags) != 0)
+        {
+                fields |= YTV_ENTRY_FIELD_TAGS;
+        }
+
+        if (g_strcmp0 (a->description, b->description) != 0)
+        {
+                fields |= YTV_ENTRY_FIELD_DESCRIPTION;
+        }
+
+        return fields;
+}
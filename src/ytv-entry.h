@@ -39,6 +39,26 @@ G_BEGIN_DECLS
 #define YTV_ENTRY_GET_CLASS(obj)                \
         (G_TYPE_INSTANCE_GET_CLASS ((obj), YTV_TYPE_ENTRY, YtvEntryClass))
 
+/**
+ * YtvEntryField:
+ *
+ * Flags for the fields of a #YtvEntry, as reported by ytv_entry_diff()
+ */
+enum _YtvEntryField
+{
+        YTV_ENTRY_FIELD_AUTHOR      = 1 << 0,
+        YTV_ENTRY_FIELD_TITLE       = 1 << 1,
+        YTV_ENTRY_FIELD_DURATION    = 1 << 2,
+        YTV_ENTRY_FIELD_RATING      = 1 << 3,
+        YTV_ENTRY_FIELD_PUBLISHED   = 1 << 4,
+        YTV_ENTRY_FIELD_VIEWS       = 1 << 5,
+        YTV_ENTRY_FIELD_CATEGORY    = 1 << 6,
+        YTV_ENTRY_FIELD_TAGS        = 1 << 7,
+        YTV_ENTRY_FIELD_DESCRIPTION = 1 << 8
+};
+
+typedef enum _YtvEntryField YtvEntryField;
+
 /**
  * YtvEntry:
  *
@@ -57,6 +77,7 @@ struct _YtvEntryClass
 GType ytv_entry_get_type (void);
 
 void ytv_entry_dump (YtvEntry* self);
+guint ytv_entry_diff (YtvEntry* self, YtvEntry* other);
 
 G_END_DECLS
 
@@ -29,7 +29,8 @@
 enum _YtvErrorDomain
 {
         YTV_HTTP_ERROR = 1,
-        YTV_PARSE_ERROR = 2
+        YTV_PARSE_ERROR = 2,
+        YTV_STORE_ERROR = 3
 };
 
 typedef enum _YtvErrorDomain YtvErrorDomain;
@@ -49,7 +50,12 @@ enum _YtvError
         YTV_HTTP_ERROR_BAD_URI,
 
         YTV_PARSE_ERROR_BAD_FORMAT,
-        YTV_PARSE_ERROR_BAD_MIME
+        YTV_PARSE_ERROR_BAD_MIME,
+
+        YTV_HTTP_ERROR_CANCELLED,
+
+        YTV_STORE_ERROR_IO,
+        YTV_STORE_ERROR_CORRUPT
 };
 
 typedef GError YError;
@@ -0,0 +1,779 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-feed-crawler.c - Fetches all the pages of a feed concurrently
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-feed-crawler
+ * @title: YtvFeedCrawler
+ * @short_description: walks through all the pages of a feed
+ *
+ * The #YtvFeedCrawler fetches every page of the query currently set in a
+ * #YtvFeed, for bulk jobs such as exporting all the uploads of an author.
+ *
+ * The first page announces the total number of results; the remaining
+ * start-index windows are then requested concurrently, at most
+ * "max-parallel" at the same time. The pages are reordered before their
+ * entries are emitted through the ::entry-crawled signal, so they arrive
+ * in the feed order, and the entries repeated by overlapping windows are
+ * emitted only once.
+ *
+ * If the parse strategy cannot tell the total, the pages are requested one
+ * after the other until an empty one is found.
+ */
+
+/**
+ * YtvFeedCrawler:
+ *
+ * Walks through all the pages of a feed
+ *
+ * free-function: g_object_unref
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <ytv-feed-crawler.h>
+
+#include <ytv-entry.h>
+#include <ytv-error.h>
+#include <ytv-feed.h>
+#include <ytv-feed-fetch-strategy.h>
+#include <ytv-feed-parse-strategy.h>
+#include <ytv-iterator.h>
+#include <ytv-list.h>
+#include <ytv-simple-list.h>
+#include <ytv-uri-builder.h>
+#include <ytv-trace.h>
+
+enum _YtvFeedCrawlerProp
+{
+        PROP_0,
+        PROP_FEED,
+        PROP_MAX_PARALLEL,
+        PROP_MAX_ENTRIES
+};
+
+enum _YtvFeedCrawlerSignal
+{
+        ENTRY_CRAWLED,
+        FINISHED,
+        LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+typedef struct _YtvFeedCrawlerPriv YtvFeedCrawlerPriv;
+
+struct _YtvFeedCrawlerPriv
+{
+        YtvFeed* feed;
+        guint max_parallel;
+        guint max_entries;
+
+        gboolean running;
+        guint serial;         /* discards the responses of older runs */
+        gint orig_start;      /* start-index of the builder before the run */
+        gint start_index;
+        gint page_size;
+        gint num_pages;       /* -1 while unknown */
+        gint next_page;       /* next window to request */
+        gint next_expected;   /* next page to emit */
+        GList* pending;       /* of YtvCrawlRequest, to cancel them */
+        guint inflight;       /* the pending ones, of any run */
+        guint emitted;
+        GHashTable* pages;    /* page number -> YtvList, received too early */
+        GHashTable* seen;     /* ids of the emitted entries */
+};
+
+typedef struct _YtvCrawlRequest YtvCrawlRequest;
+
+struct _YtvCrawlRequest
+{
+        YtvFeedCrawler* self;
+        guint serial;
+        gint page;
+};
+
+#define YTV_FEED_CRAWLER_GET_PRIVATE(obj)       \
+        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_FEED_CRAWLER, YtvFeedCrawlerPriv))
+
+#define DEFAULT_PAGE_SIZE 25
+
+G_DEFINE_TYPE (YtvFeedCrawler, ytv_feed_crawler, G_TYPE_OBJECT)
+
+static void fetch_page_cb (YtvFeedFetchStrategy* st, const gchar* mime,
+                           const gint8* response, gssize length,
+                           GError** err, gpointer user_data);
+
+static void
+stop (YtvFeedCrawler* self)
+{
+        YtvFeedCrawlerPriv* priv;
+        YtvFeedFetchStrategy* fetchst;
+        GList* pending;
+        GList* l;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+
+        priv->running = FALSE;
+        priv->serial++;
+        g_hash_table_remove_all (priv->pages);
+
+        /* the callbacks run, and free the requests, while cancelling; the
+         * pages which can not be cancelled keep their slot until then */
+        if (priv->pending != NULL)
+        {
+                fetchst = ytv_feed_get_fetch_strategy (priv->feed);
+                pending = g_list_copy (priv->pending);
+
+                for (l = pending; l != NULL; l = l->next)
+                {
+                        if (g_list_find (priv->pending, l->data) != NULL)
+                        {
+                                ytv_feed_fetch_strategy_cancel (fetchst,
+                                                                l->data);
+                        }
+                }
+
+                g_list_free (pending);
+                g_object_unref (fetchst);
+        }
+
+        return;
+}
+
+static void
+finish (YtvFeedCrawler* self, GError* err)
+{
+        stop (self);
+        g_signal_emit (self, signals[FINISHED], 0, err);
+
+        return;
+}
+
+static void
+issue_page (YtvFeedCrawler* self, gint page)
+{
+        YtvFeedCrawlerPriv* priv;
+        YtvUriBuilder* ub;
+        YtvFeedFetchStrategy* fetchst;
+        YtvCrawlRequest* req;
+        gchar* uri;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+
+        /* the builder is shared with the feed: leave it as it was */
+        ub = ytv_feed_get_uri_builder (priv->feed);
+        g_object_set (G_OBJECT (ub), "start-index",
+                      priv->start_index + page * priv->page_size, NULL);
+        uri = ytv_uri_builder_get_current_feed (ub);
+        g_object_set (G_OBJECT (ub), "start-index", priv->orig_start, NULL);
+        g_object_unref (ub);
+
+        if (uri == NULL)
+        {
+                GError* err = NULL;
+
+                g_set_error (&err, YTV_HTTP_ERROR, YTV_HTTP_ERROR_BAD_URI,
+                             "No feed set to crawl");
+                finish (self, err);
+                g_error_free (err);
+
+                return;
+        }
+
+        req = g_slice_new (YtvCrawlRequest);
+        req->self = g_object_ref (self);
+        req->serial = priv->serial;
+        req->page = page;
+
+        priv->pending = g_list_prepend (priv->pending, req);
+        priv->inflight++;
+        YTV_TRACE_COUNTER ("crawl", "pages-in-flight", priv->inflight);
+
+        fetchst = ytv_feed_get_fetch_strategy (priv->feed);
+        ytv_feed_fetch_strategy_perform (fetchst, uri, fetch_page_cb, req);
+        g_object_unref (fetchst);
+
+        g_free (uri);
+
+        return;
+}
+
+static void
+fill_window (YtvFeedCrawler* self)
+{
+        YtvFeedCrawlerPriv* priv;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+
+        if (priv->num_pages < 0)
+        {
+                /* unknown total: one page after the other */
+                if (priv->running && priv->inflight == 0 &&
+                    priv->next_page == priv->next_expected)
+                {
+                        issue_page (self, priv->next_page++);
+                }
+
+                return;
+        }
+
+        while (priv->running && priv->inflight < priv->max_parallel &&
+               priv->next_page < priv->num_pages)
+        {
+                issue_page (self, priv->next_page++);
+        }
+
+        return;
+}
+
+static void
+emit_entries (YtvFeedCrawler* self, YtvList* list)
+{
+        YtvFeedCrawlerPriv* priv;
+        YtvIterator* iter;
+        YtvEntry* entry;
+        gchar* id;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+
+        iter = ytv_list_create_iterator (list);
+
+        while (!ytv_iterator_is_done (iter) && priv->running)
+        {
+                if (priv->max_entries > 0 &&
+                    priv->emitted >= priv->max_entries)
+                {
+                        break;
+                }
+
+                entry = YTV_ENTRY (ytv_iterator_get_current (iter));
+                g_object_get (G_OBJECT (entry), "id", &id, NULL);
+
+                if (id != NULL && g_hash_table_lookup (priv->seen, id) == NULL)
+                {
+                        g_hash_table_insert (priv->seen, id,
+                                             GINT_TO_POINTER (TRUE));
+                        priv->emitted++;
+                        g_signal_emit (self, signals[ENTRY_CRAWLED], 0, entry);
+                }
+                else
+                {
+                        g_free (id);
+                }
+
+                g_object_unref (entry);
+                ytv_iterator_next (iter);
+        }
+
+        g_object_unref (iter);
+
+        return;
+}
+
+/* emits the pages which are next in order */
+static void
+flush (YtvFeedCrawler* self)
+{
+        YtvFeedCrawlerPriv* priv;
+        YtvList* list;
+        gboolean short_page;
+        gpointer key;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+
+        while (priv->running)
+        {
+                key = GINT_TO_POINTER (priv->next_expected);
+                list = g_hash_table_lookup (priv->pages, key);
+
+                if (list == NULL)
+                {
+                        break;
+                }
+
+                g_hash_table_steal (priv->pages, key);
+
+                short_page = ytv_list_get_length (list) <
+                        (guint) priv->page_size;
+
+                emit_entries (self, list);
+                g_object_unref (list);
+
+                priv->next_expected++;
+
+                if (!priv->running)
+                {
+                        break; /* cancelled by a signal handler */
+                }
+
+                if ((priv->max_entries > 0 &&
+                     priv->emitted >= priv->max_entries) ||
+                    (priv->num_pages < 0 && short_page) ||
+                    (priv->num_pages >= 0 &&
+                     priv->next_expected >= priv->num_pages))
+                {
+                        finish (self, NULL);
+                        break;
+                }
+        }
+
+        return;
+}
+
+static void
+set_total_results (YtvFeedCrawler* self, gint total)
+{
+        YtvFeedCrawlerPriv* priv;
+        gint available;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+
+        if (total < 0)
+        {
+                return;
+        }
+
+        available = total - (priv->start_index - 1);
+
+        if (priv->max_entries > 0)
+        {
+                available = MIN (available, (gint) priv->max_entries);
+        }
+
+        /* the first page is already here */
+        priv->num_pages = MAX (1, (available + priv->page_size - 1) /
+                               priv->page_size);
+
+        return;
+}
+
+static void
+fetch_page_cb (YtvFeedFetchStrategy* st, const gchar* mime,
+               const gint8* response, gssize length, GError** err,
+               gpointer user_data)
+{
+        YtvCrawlRequest* req;
+        YtvFeedCrawler* self;
+        YtvFeedCrawlerPriv* priv;
+        YtvFeedParseStrategy* parsest;
+        YtvList* list;
+        GError* tmp_error;
+
+        req = (YtvCrawlRequest*) user_data;
+        self = req->self;
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+        parsest = NULL;
+        list = NULL;
+        tmp_error = NULL;
+
+        /* a stale page still held its slot of the window until now */
+        priv->pending = g_list_remove (priv->pending, req);
+        priv->inflight--;
+        YTV_TRACE_COUNTER ("crawl", "pages-in-flight", priv->inflight);
+
+        if (req->serial != priv->serial)
+        {
+                /* cancelled or finished meanwhile */
+                if (err != NULL && *err != NULL)
+                {
+                        g_error_free (*err);
+                        *err = NULL;
+                }
+
+                /* a newer run may be waiting for the slot */
+                fill_window (self);
+                goto beach;
+        }
+
+        if (err != NULL && *err != NULL)
+        {
+                finish (self, *err);
+                g_error_free (*err);
+                *err = NULL;
+                goto beach;
+        }
+
+        parsest = ytv_feed_get_parse_strategy (priv->feed);
+
+        if (mime == NULL ||
+            g_strrstr (mime, ytv_feed_parse_strategy_get_mime (parsest)) == NULL)
+        {
+                g_set_error (&tmp_error, YTV_PARSE_ERROR,
+                             YTV_PARSE_ERROR_BAD_MIME,
+                             "Bad MIME type receibed - %s", mime);
+                finish (self, tmp_error);
+                g_error_free (tmp_error);
+                goto beach;
+        }
+
+        list = ytv_feed_parse_strategy_perform (parsest, (guchar*) response,
+                                                length, &tmp_error);
+
+        if (req->page == 0 && priv->num_pages < 0)
+        {
+                set_total_results
+                        (self,
+                         ytv_feed_parse_strategy_get_total_results (parsest));
+        }
+
+        if (tmp_error != NULL)
+        {
+                if (!g_error_matches (tmp_error, YTV_PARSE_ERROR,
+                                      YTV_PARSE_ERROR_BAD_FORMAT))
+                {
+                        finish (self, tmp_error);
+                        g_error_free (tmp_error);
+                        goto beach;
+                }
+
+                /* a page without entries */
+                g_error_free (tmp_error);
+        }
+
+        if (list == NULL)
+        {
+                list = ytv_simple_list_new ();
+        }
+
+        g_hash_table_insert (priv->pages, GINT_TO_POINTER (req->page), list);
+
+        flush (self);
+        fill_window (self);
+
+beach:
+        if (parsest != NULL)
+        {
+                g_object_unref (parsest);
+        }
+
+        g_object_unref (req->self);
+        g_slice_free (YtvCrawlRequest, req);
+
+        return;
+}
+
+static void
+ytv_feed_crawler_run_default (YtvFeedCrawler* self)
+{
+        YtvFeedCrawlerPriv* priv;
+        YtvUriBuilder* ub;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+
+        g_return_if_fail (priv->feed != NULL);
+        g_return_if_fail (priv->running == FALSE);
+
+        ub = ytv_feed_get_uri_builder (priv->feed);
+        g_object_get (G_OBJECT (ub),
+                      "start-index", &priv->orig_start,
+                      "max-results", &priv->page_size,
+                      NULL);
+        g_object_unref (ub);
+
+        priv->start_index = MAX (priv->orig_start, 1);
+
+        if (priv->page_size <= 0)
+        {
+                priv->page_size = DEFAULT_PAGE_SIZE;
+        }
+
+        priv->running = TRUE;
+        priv->serial++;
+        priv->num_pages = -1;
+        priv->next_page = 0;
+        priv->next_expected = 0;
+        priv->emitted = 0;
+        g_hash_table_remove_all (priv->pages);
+        g_hash_table_remove_all (priv->seen);
+
+        /* the total results are known after the first page */
+        issue_page (self, priv->next_page++);
+
+        return;
+}
+
+static void
+ytv_feed_crawler_set_property (GObject* object, guint prop_id,
+                               const GValue* value, GParamSpec* spec)
+{
+        YtvFeedCrawlerPriv* priv;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_FEED:
+                priv->feed = g_value_dup_object (value);
+                break;
+        case PROP_MAX_PARALLEL:
+                priv->max_parallel = g_value_get_uint (value);
+                break;
+        case PROP_MAX_ENTRIES:
+                priv->max_entries = g_value_get_uint (value);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_feed_crawler_get_property (GObject* object, guint prop_id,
+                               GValue* value, GParamSpec* spec)
+{
+        YtvFeedCrawlerPriv* priv;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_FEED:
+                g_value_set_object (value, priv->feed);
+                break;
+        case PROP_MAX_PARALLEL:
+                g_value_set_uint (value, priv->max_parallel);
+                break;
+        case PROP_MAX_ENTRIES:
+                g_value_set_uint (value, priv->max_entries);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_feed_crawler_dispose (GObject* object)
+{
+        YtvFeedCrawlerPriv* priv;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (object);
+
+        if (priv->feed != NULL)
+        {
+                g_object_unref (priv->feed);
+                priv->feed = NULL;
+        }
+
+        (*G_OBJECT_CLASS (ytv_feed_crawler_parent_class)->dispose) (object);
+
+        return;
+}
+
+static void
+ytv_feed_crawler_finalize (GObject* object)
+{
+        YtvFeedCrawlerPriv* priv;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (object);
+
+        g_hash_table_destroy (priv->pages);
+        g_hash_table_destroy (priv->seen);
+
+        (*G_OBJECT_CLASS (ytv_feed_crawler_parent_class)->finalize) (object);
+
+        return;
+}
+
+static void
+ytv_feed_crawler_class_init (YtvFeedCrawlerClass* klass)
+{
+        GObjectClass* g_klass;
+
+        g_klass = G_OBJECT_CLASS (klass);
+
+        g_type_class_add_private (g_klass, sizeof (YtvFeedCrawlerPriv));
+
+        g_klass->set_property = ytv_feed_crawler_set_property;
+        g_klass->get_property = ytv_feed_crawler_get_property;
+        g_klass->dispose      = ytv_feed_crawler_dispose;
+        g_klass->finalize     = ytv_feed_crawler_finalize;
+
+        g_object_class_install_property
+                (g_klass, PROP_FEED,
+                 g_param_spec_object
+                 ("feed", "feed", "The feed whose query is crawled",
+                  YTV_TYPE_FEED, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+        g_object_class_install_property
+                (g_klass, PROP_MAX_PARALLEL,
+                 g_param_spec_uint
+                 ("max-parallel", "maxparallel",
+                  "Maximum number of pages requested at the same time",
+                  1, 32, 4, G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        g_object_class_install_property
+                (g_klass, PROP_MAX_ENTRIES,
+                 g_param_spec_uint
+                 ("max-entries", "maxentries",
+                  "Stop after this number of entries, 0 for all of them",
+                  0, G_MAXUINT, 0, G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        /**
+         * YtvFeedCrawler::entry-crawled:
+         * @self: the #YtvFeedCrawler instance that emitted the signal
+         * @entry: the crawled #YtvEntry
+         *
+         * The ::entry-crawled signal is emmited for each different entry
+         * of the feed, in the feed order.
+         */
+        signals[ENTRY_CRAWLED] =
+                g_signal_new ("entry-crawled",
+                              G_TYPE_FROM_CLASS (klass),
+                              G_SIGNAL_RUN_LAST,
+                              G_STRUCT_OFFSET (YtvFeedCrawlerClass,
+                                               entry_crawled),
+                              NULL, NULL,
+                              g_cclosure_marshal_VOID__OBJECT,
+                              G_TYPE_NONE, 1, YTV_TYPE_ENTRY);
+
+        /**
+         * YtvFeedCrawler::finished:
+         * @self: the #YtvFeedCrawler instance that emitted the signal
+         * @err: (null-ok): the #GError which stopped the crawl, or %NULL
+         *
+         * The ::finished signal is emmited when all the pages were crawled,
+         * or when one of them failed. The handlers do not own @err.
+         */
+        signals[FINISHED] =
+                g_signal_new ("finished",
+                              G_TYPE_FROM_CLASS (klass),
+                              G_SIGNAL_RUN_LAST,
+                              G_STRUCT_OFFSET (YtvFeedCrawlerClass, finished),
+                              NULL, NULL,
+                              g_cclosure_marshal_VOID__POINTER,
+                              G_TYPE_NONE, 1, G_TYPE_POINTER);
+
+        return;
+}
+
+static void
+ytv_feed_crawler_init (YtvFeedCrawler* self)
+{
+        YtvFeedCrawlerPriv* priv;
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+
+        priv->feed          = NULL;
+        priv->max_parallel  = 4;
+        priv->max_entries   = 0;
+        priv->running       = FALSE;
+        priv->serial        = 0;
+        priv->orig_start    = 0;
+        priv->start_index   = 1;
+        priv->page_size     = DEFAULT_PAGE_SIZE;
+        priv->num_pages     = -1;
+        priv->next_page     = 0;
+        priv->next_expected = 0;
+        priv->pending       = NULL;
+        priv->inflight      = 0;
+        priv->emitted       = 0;
+        priv->pages         = g_hash_table_new_full (g_direct_hash,
+                                                     g_direct_equal,
+                                                     NULL, g_object_unref);
+        priv->seen          = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                     g_free, NULL);
+
+        return;
+}
+
+/**
+ * ytv_feed_crawler_new:
+ * @feed: (not-null): the #YtvFeed to crawl
+ *
+ * Creates a crawler of @feed. The query to crawl is the last one set in
+ * @feed, for example with ytv_feed_user(), and its page size is the
+ * "max-results" of the feed's URI builder.
+ *
+ * returns: (not-null) (caller-owns): a new #YtvFeedCrawler
+ */
+YtvFeedCrawler*
+ytv_feed_crawler_new (YtvFeed* feed)
+{
+        g_return_val_if_fail (YTV_IS_FEED (feed), NULL);
+
+        return g_object_new (YTV_TYPE_FEED_CRAWLER, "feed", feed, NULL);
+}
+
+/**
+ * ytv_feed_crawler_run:
+ * @self: (not-null): a #YtvFeedCrawler
+ *
+ * Starts to crawl the feed. The entries are delivered through the
+ * ::entry-crawled signal and the end through the ::finished signal.
+ */
+void
+ytv_feed_crawler_run (YtvFeedCrawler* self)
+{
+        g_assert (YTV_IS_FEED_CRAWLER (self));
+
+        ytv_feed_crawler_run_default (self);
+
+        return;
+}
+
+/**
+ * ytv_feed_crawler_cancel:
+ * @self: (not-null): a #YtvFeedCrawler
+ *
+ * Stops the crawl. The requests still in flight are cancelled and the
+ * ::finished signal is not emitted.
+ */
+void
+ytv_feed_crawler_cancel (YtvFeedCrawler* self)
+{
+        YtvFeedCrawlerPriv* priv;
+
+        g_assert (YTV_IS_FEED_CRAWLER (self));
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+
+        if (priv->running)
+        {
+                stop (self);
+        }
+
+        return;
+}
+
+/**
+ * ytv_feed_crawler_is_running:
+ * @self: (not-null): a #YtvFeedCrawler
+ *
+ * returns: %TRUE if the crawl has not finished yet
+ */
+gboolean
+ytv_feed_crawler_is_running (YtvFeedCrawler* self)
+{
+        YtvFeedCrawlerPriv* priv;
+
+        g_assert (YTV_IS_FEED_CRAWLER (self));
+
+        priv = YTV_FEED_CRAWLER_GET_PRIVATE (self);
+
+        return priv->running;
+}
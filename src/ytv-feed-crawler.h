@@ -0,0 +1,69 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_FEED_CRAWLER_H_
+#define _YTV_FEED_CRAWLER_H_
+
+/* ytv-feed-crawler.h - Fetches all the pages of a feed concurrently
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib-object.h>
+#include <ytv-shared.h>
+
+G_BEGIN_DECLS
+
+#define YTV_TYPE_FEED_CRAWLER                   \
+        (ytv_feed_crawler_get_type ())
+#define YTV_FEED_CRAWLER(obj)                                           \
+        (G_TYPE_CHECK_INSTANCE_CAST ((obj), YTV_TYPE_FEED_CRAWLER, YtvFeedCrawler))
+#define YTV_FEED_CRAWLER_CLASS(klass)                                   \
+        (G_TYPE_CHECK_CLASS_CAST ((klass), YTV_TYPE_FEED_CRAWLER, YtvFeedCrawlerClass))
+#define YTV_IS_FEED_CRAWLER(obj)                                        \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), YTV_TYPE_FEED_CRAWLER))
+#define YTV_IS_FEED_CRAWLER_CLASS(klass)                                \
+        (G_TYPE_CHECK_CLASS_TYPE ((klass), YTV_TYPE_FEED_CRAWLER))
+#define YTV_FEED_CRAWLER_GET_CLASS(obj)                                 \
+        (G_TYPE_INSTANCE_GET_CLASS ((obj), YTV_TYPE_FEED_CRAWLER, YtvFeedCrawlerClass))
+
+typedef struct _YtvFeedCrawler YtvFeedCrawler;
+typedef struct _YtvFeedCrawlerClass YtvFeedCrawlerClass;
+
+struct _YtvFeedCrawler
+{
+        GObject parent;
+};
+
+struct _YtvFeedCrawlerClass
+{
+        GObjectClass parent_class;
+
+        /* Signals */
+        void (*entry_crawled) (YtvFeedCrawler* self, YtvEntry* entry);
+        void (*finished) (YtvFeedCrawler* self, GError* err);
+};
+
+GType ytv_feed_crawler_get_type (void);
+
+YtvFeedCrawler* ytv_feed_crawler_new (YtvFeed* feed);
+void ytv_feed_crawler_run (YtvFeedCrawler* self);
+void ytv_feed_crawler_cancel (YtvFeedCrawler* self);
+gboolean ytv_feed_crawler_is_running (YtvFeedCrawler* self);
+
+G_END_DECLS
+
+#endif /* _YTV_FEED_CRAWLER_H_ */
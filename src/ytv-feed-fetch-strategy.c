@@ -136,6 +136,30 @@ ytv_feed_fetch_strategy_get_date (YtvFeedFetchStrategy* self,
         return retval;
 }
 
+/**
+ * ytv_feed_fetch_strategy_cancel:
+ * @self: (not-null): a #YtvFeedFetchStrategy instance
+ * @user_data: the user data given to ytv_feed_fetch_strategy_perform()
+ *
+ * Cancels the pending request which was performed with @user_data. Its
+ * callback is still called, with a %YTV_HTTP_ERROR_CANCELLED error.
+ * Implementations which can not cancel a request just ignore this call.
+ */
+void
+ytv_feed_fetch_strategy_cancel (YtvFeedFetchStrategy* self,
+                                gpointer user_data)
+{
+        g_assert (YTV_IS_FEED_FETCH_STRATEGY (self));
+
+        if (YTV_FEED_FETCH_STRATEGY_GET_IFACE (self)->cancel != NULL)
+        {
+                YTV_FEED_FETCH_STRATEGY_GET_IFACE (self)->cancel (self,
+                                                                  user_data);
+        }
+
+        return;
+}
+
 static void
 ytv_feed_fetch_strategy_base_init (gpointer g_class)
 {
@@ -56,6 +56,7 @@ struct _YtvFeedFetchStrategyIface
                          YtvGetResponseCallback callback, gpointer user_data);
         gchar* (*encode) (YtvFeedFetchStrategy* self, const gchar* part);
         time_t (*get_date) (YtvFeedFetchStrategy* self, const gchar* datestr);
+        void (*cancel) (YtvFeedFetchStrategy* self, gpointer user_data);
 };
 
 GType ytv_feed_fetch_strategy_get_type (void);
@@ -68,6 +69,8 @@ gchar* ytv_feed_fetch_strategy_encode (YtvFeedFetchStrategy* self,
                                        const gchar* part);
 time_t ytv_feed_fetch_strategy_get_date (YtvFeedFetchStrategy* self,
                                          const gchar* date);
+void ytv_feed_fetch_strategy_cancel (YtvFeedFetchStrategy* self,
+                                     gpointer user_data);
 
 G_END_DECLS
 
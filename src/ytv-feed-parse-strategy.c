@@ -110,6 +110,54 @@ ytv_feed_parse_strategy_get_mime (YtvFeedParseStrategy* self)
         return mime;
 }
 
+/**
+ * ytv_feed_parse_strategy_get_total_results:
+ * @self: a #YtvFeedParseStrategy implementation instance
+ *
+ * Retrieves the total number of results of the query, as announced by the
+ * last parsed feed, regardless of the entries in that page.
+ *
+ * returns: the number of results, or -1 if it is unknown
+ */
+gint
+ytv_feed_parse_strategy_get_total_results (YtvFeedParseStrategy* self)
+{
+        g_assert (YTV_IS_FEED_PARSE_STRATEGY (self));
+
+        if (YTV_FEED_PARSE_STRATEGY_GET_IFACE (self)->get_total_results
+            == NULL)
+        {
+                return -1;
+        }
+
+        return YTV_FEED_PARSE_STRATEGY_GET_IFACE (self)->get_total_results
+                (self);
+}
+
+/**
+ * ytv_feed_parse_strategy_get_fields:
+ * @self: a #YtvFeedParseStrategy implementation instance
+ *
+ * Retrieves the partial response expression which selects the elements
+ * of the feed that the parser actually reads, in the GData "fields" syntax.
+ * A parser which reads the whole feed doesn't need to implement it.
+ *
+ * returns: (null-ok): the fields expression, or NULL to request the whole
+ * feed. Do not modify the internal string.
+ */
+const gchar*
+ytv_feed_parse_strategy_get_fields (YtvFeedParseStrategy* self)
+{
+        g_assert (YTV_IS_FEED_PARSE_STRATEGY (self));
+
+        if (YTV_FEED_PARSE_STRATEGY_GET_IFACE (self)->get_fields == NULL)
+        {
+                return NULL;
+        }
+
+        return YTV_FEED_PARSE_STRATEGY_GET_IFACE (self)->get_fields (self);
+}
+
 static void
 ytv_feed_parse_strategy_base_init (gpointer g_class)
 {
@@ -49,6 +49,8 @@ struct _YtvFeedParseStrategyIface
         YtvList* (*perform) (YtvFeedParseStrategy* self, const guchar* data,
                              gssize length, GError **err);
         const gchar* (*get_mime) (YtvFeedParseStrategy* self);
+        gint (*get_total_results) (YtvFeedParseStrategy* self);
+        const gchar* (*get_fields) (YtvFeedParseStrategy* self);
 };
 
 GType ytv_feed_parse_strategy_get_type (void);
@@ -57,6 +59,8 @@ YtvList* ytv_feed_parse_strategy_perform (YtvFeedParseStrategy* self,
                                           const guchar* data, gssize length,
                                           GError **err);
 const gchar* ytv_feed_parse_strategy_get_mime (YtvFeedParseStrategy* self);
+gint ytv_feed_parse_strategy_get_total_results (YtvFeedParseStrategy* self);
+const gchar* ytv_feed_parse_strategy_get_fields (YtvFeedParseStrategy* self);
 
 G_END_DECLS
 
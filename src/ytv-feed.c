@@ -26,6 +26,17 @@
  *
  * An abstract type that defines a feed, which is a mean to retrive
  * a set of related #YtvEntry
+ *
+ * A feed may be refreshed with ytv_feed_refresh(), which fetches again the
+ * last delivered page and compares it, entry by entry, with the previous
+ * one. Only the differences are signaled through #YtvFeed::entry-added,
+ * #YtvFeed::entry-removed and #YtvFeed::entry-changed, so the views may be
+ * patched instead of rebuilt.
+ *
+ * A feed may also deliver a page it keeps locally, maybe stale, and fetch
+ * it again in the background. If the fetched page differs, the same
+ * signals are emitted, followed by #YtvFeed::entries-revalidated with the
+ * whole page.
  */
 
 /**
@@ -41,10 +52,12 @@
 #endif
 
 #include <ytv-feed.h>
+#include <ytv-entry.h>
 #include <ytv-list.h>
 #include <ytv-feed-fetch-strategy.h>
 #include <ytv-feed-parse-strategy.h>
 #include <ytv-uri-builder.h>
+#include <ytv-marshal.h>
 
 /**
  * ytv_feed_get_fetch_strategy:
@@ -358,6 +371,59 @@ ytv_feed_get_entries_async (YtvFeed* self, YtvGetEntriesCallback callback,
         return;
 }
 
+/**
+ * ytv_feed_refresh:
+ * @self: a #YtvFeed
+ * @callback: (null-ok): a #YtvGetEntriesCallback or NULL
+ * @user_data: (null-ok): user data that will be passed to the callbacks
+ *
+ * Fetches again the last page delivered by @self. Before @callback is
+ * called with the new entries, the entries which are not there anymore
+ * are signaled with #YtvFeed::entry-removed, the new ones with
+ * #YtvFeed::entry-added and those whose fields differ with
+ * #YtvFeed::entry-changed. The entries are matched by their id. If
+ * another page was delivered meanwhile, @callback is called with
+ * @cancelled set to %TRUE and no entries.
+ */
+void
+ytv_feed_refresh (YtvFeed* self, YtvGetEntriesCallback callback,
+                  gpointer user_data)
+{
+        g_assert (YTV_IS_FEED (self));
+
+        if (YTV_FEED_GET_IFACE (self)->refresh == NULL)
+        {
+                g_warning ("%s does not support refreshing",
+                           G_OBJECT_TYPE_NAME (self));
+                return;
+        }
+
+        YTV_FEED_GET_IFACE (self)->refresh (self, callback, user_data);
+
+        return;
+}
+
+/**
+ * ytv_feed_cancel:
+ * @self: a #YtvFeed
+ *
+ * Cancels the pending requests of @self. Their callbacks are still called,
+ * with @cancelled set to %TRUE. Implementations which can not cancel their
+ * requests just ignore this call.
+ */
+void
+ytv_feed_cancel (YtvFeed* self)
+{
+        g_assert (YTV_IS_FEED (self));
+
+        if (YTV_FEED_GET_IFACE (self)->cancel != NULL)
+        {
+                YTV_FEED_GET_IFACE (self)->cancel (self);
+        }
+
+        return;
+}
+
 
 static void
 ytv_feed_base_init (gpointer g_class)
@@ -366,6 +432,79 @@ ytv_feed_base_init (gpointer g_class)
 
         if (!initialized)
         {
+                /**
+                 * YtvFeed::entry-added:
+                 * @self: the #YtvFeed
+                 * @entry: the new #YtvEntry
+                 * @position: its position in the refreshed page
+                 *
+                 * Emitted on refresh for an entry which was not in the
+                 * previous page.
+                 */
+                g_signal_new ("entry-added",
+                              YTV_TYPE_FEED,
+                              G_SIGNAL_RUN_LAST,
+                              G_STRUCT_OFFSET (YtvFeedIface, entry_added),
+                              NULL, NULL,
+                              ytv_cclosure_marshal_VOID__OBJECT_INT,
+                              G_TYPE_NONE, 2,
+                              YTV_TYPE_ENTRY, G_TYPE_INT);
+
+                /**
+                 * YtvFeed::entry-removed:
+                 * @self: the #YtvFeed
+                 * @entry: the gone #YtvEntry
+                 * @position: its position in the previous page
+                 *
+                 * Emitted on refresh for an entry which is not in the
+                 * refreshed page anymore.
+                 */
+                g_signal_new ("entry-removed",
+                              YTV_TYPE_FEED,
+                              G_SIGNAL_RUN_LAST,
+                              G_STRUCT_OFFSET (YtvFeedIface, entry_removed),
+                              NULL, NULL,
+                              ytv_cclosure_marshal_VOID__OBJECT_INT,
+                              G_TYPE_NONE, 2,
+                              YTV_TYPE_ENTRY, G_TYPE_INT);
+
+                /**
+                 * YtvFeed::entry-changed:
+                 * @self: the #YtvFeed
+                 * @entry: the refreshed #YtvEntry
+                 * @fields: a mask of the #YtvEntryField which changed
+                 *
+                 * Emitted on refresh for an entry which is in both pages
+                 * but with different fields.
+                 */
+                g_signal_new ("entry-changed",
+                              YTV_TYPE_FEED,
+                              G_SIGNAL_RUN_LAST,
+                              G_STRUCT_OFFSET (YtvFeedIface, entry_changed),
+                              NULL, NULL,
+                              ytv_cclosure_marshal_VOID__OBJECT_UINT,
+                              G_TYPE_NONE, 2,
+                              YTV_TYPE_ENTRY, G_TYPE_UINT);
+
+                /**
+                 * YtvFeed::entries-revalidated:
+                 * @self: the #YtvFeed
+                 * @list: the fetched #YtvList of #YtvEntry
+                 *
+                 * Emitted when the delivered page was stale and the
+                 * page fetched in the background differs from it. The
+                 * handlers must not keep @list without referencing it.
+                 */
+                g_signal_new ("entries-revalidated",
+                              YTV_TYPE_FEED,
+                              G_SIGNAL_RUN_LAST,
+                              G_STRUCT_OFFSET (YtvFeedIface,
+                                               entries_revalidated),
+                              NULL, NULL,
+                              g_cclosure_marshal_VOID__OBJECT,
+                              G_TYPE_NONE, 1,
+                              YTV_TYPE_LIST);
+
                 initialized = TRUE;
         }
 
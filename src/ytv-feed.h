@@ -66,6 +66,15 @@ struct _YtvFeedIface
         void (*get_entries_async) (YtvFeed* self,
                                    YtvGetEntriesCallback callback,
                                    gpointer user_data);
+        void (*refresh) (YtvFeed* self, YtvGetEntriesCallback callback,
+                         gpointer user_data);
+        void (*cancel) (YtvFeed* self);
+
+        /* Signals */
+        void (*entry_added) (YtvFeed* self, YtvEntry* entry, gint position);
+        void (*entry_removed) (YtvFeed* self, YtvEntry* entry, gint position);
+        void (*entry_changed) (YtvFeed* self, YtvEntry* entry, guint fields);
+        void (*entries_revalidated) (YtvFeed* self, YtvList* list);
 };
 
 GType ytv_feed_get_type (void);
@@ -85,6 +94,9 @@ void ytv_feed_keywords (YtvFeed* self, const gchar* category,
 void ytv_feed_related (YtvFeed* self, const gchar* vid);
 void ytv_feed_get_entries_async (YtvFeed* self, YtvGetEntriesCallback callback,
                                  gpointer user_data);
+void ytv_feed_refresh (YtvFeed* self, YtvGetEntriesCallback callback,
+                       gpointer user_data);
+void ytv_feed_cancel (YtvFeed* self);
 
 G_END_DECLS
 
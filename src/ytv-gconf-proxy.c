@@ -0,0 +1,109 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-gconf-proxy.c - The HTTP proxy of the desktop settings
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-gconf-proxy
+ * @title: YtvGconfProxy
+ * @short_description: reads the HTTP proxy of the desktop settings
+ *
+ * The GNOME desktop keeps its HTTP proxy in GConf, under
+ * /system/http_proxy. It is read here, apart from the core library, so
+ * the headless tools do not depend on GConf: the GUI passes the URI to
+ * the #YtvSoupFeedFetchStrategy:proxy-uri property.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gconf/gconf-client.h>
+
+#include <ytv-gconf-proxy.h>
+
+/**
+ * ytv_gconf_proxy_get_uri:
+ *
+ * Builds the URI of the HTTP proxy set in the desktop settings, with the
+ * user and password if the proxy requires authentication.
+ *
+ * returns: (null-ok) (caller-owns): the proxy URI, or NULL if no proxy is
+ * used
+ */
+gchar*
+ytv_gconf_proxy_get_uri (void)
+{
+        GConfClient* conf_client;
+        gchar *server, *proxy_uri;
+        gint port;
+
+        proxy_uri = NULL;
+        conf_client = gconf_client_get_default ();
+
+        if (!gconf_client_get_bool (conf_client,
+                                    "/system/http_proxy/use_http_proxy", NULL))
+        {
+                goto beach;
+        }
+
+        server = gconf_client_get_string (conf_client,
+                                          "/system/http_proxy/host", NULL);
+        port = gconf_client_get_int (conf_client,
+                                     "/system/http_proxy/port", NULL);
+
+        if (server && server[0])
+        {
+                if (gconf_client_get_bool
+                    (conf_client, "/system/http_proxy/use_authentication",
+                     NULL))
+                {
+                        gchar *user, *password;
+
+                        user = gconf_client_get_string
+                                (conf_client,
+                                 "/system/http_proxy/authentication_user",
+                                 NULL);
+
+                        password = gconf_client_get_string
+                                (conf_client,
+                                 "/system/http_proxy/authentication_password",
+                                 NULL);
+
+                        proxy_uri = g_strdup_printf ("http://%s:%s@%s:%d",
+                                                     user, password,
+                                                     server, port);
+
+                        g_free (user);
+                        g_free (password);
+                }
+                else
+                {
+                        proxy_uri = g_strdup_printf ("http://%s:%d",
+                                                     server, port);
+                }
+        }
+
+        g_free (server);
+
+beach:
+        g_object_unref (conf_client);
+
+        return proxy_uri;
+}
@@ -0,0 +1,1462 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-gdata-server.c - A local stand-in of the YouTube GData service
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-gdata-server
+ * @short_description: a SoupServer serving synthetic or recorded GData
+ * feeds
+ *
+ * #YtvGdataServer mimics the subset of the YouTube GData API used by the
+ * #YtvYoutubeUriBuilder: the standard feeds, the search, the user
+ * uploads, the category and the related feeds, in their JSON flavour,
+ * and the video thumbnails.
+ *
+ * The entries are synthesized from a seed, or taken from a recorded feed
+ * file. The start-index, max-results, orderby and time parameters are
+ * honoured, and the latency, jitter, bandwidth and failures of the real
+ * service can be simulated.
+ *
+ * Point a #YtvYoutubeUriBuilder to it through its "base-uri" and
+ * "thumbnail-uri" properties.
+ */
+
+/**
+ * YtvGdataServer:
+ *
+ * A local stand-in of the YouTube GData service
+ *
+ * free-function: g_object_unref
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+#include <time.h>
+
+#include <libsoup/soup.h>
+#include <json-glib/json-glib.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#include <ytv-error.h>
+#include <ytv-gdata-server.h>
+
+enum _YtvGdataServerProp
+{
+        PROP_0,
+        PROP_PORT,
+        PROP_CONTEXT,
+        PROP_LATENCY,
+        PROP_JITTER,
+        PROP_BANDWIDTH,
+        PROP_ERROR_RATE,
+        PROP_CORRUPT_RATE,
+        PROP_ENTRIES,
+        PROP_FEED_FILE,
+        PROP_SEED
+};
+
+typedef struct _YtvFakeEntry YtvFakeEntry;
+
+struct _YtvFakeEntry
+{
+        gchar* json; /* the serialized entry object */
+
+        gchar* id;
+        gchar* author;
+        gchar* title;
+        gchar* category;
+        gchar* tags;
+        glong published;
+        guint views;
+        gdouble rating;
+};
+
+typedef struct _YtvGdataServerPriv YtvGdataServerPriv;
+
+struct _YtvGdataServerPriv
+{
+        SoupServer* server;
+        GMainContext* context;
+        guint port;
+
+        guint latency;   /* ms */
+        guint jitter;    /* ms */
+        guint bandwidth; /* bytes per second, 0 is unlimited */
+        gdouble error_rate;
+        gdouble corrupt_rate;
+
+        guint num_entries;
+        gchar* feed_file;
+        guint seed;
+
+        GRand* rand;
+        GPtrArray* corpus;
+        GHashTable* thumbs;
+        glong now;
+};
+
+typedef struct _YtvDelayedReply YtvDelayedReply;
+
+struct _YtvDelayedReply
+{
+        SoupServer* server;
+        SoupMessage* msg;
+};
+
+#define YTV_GDATA_SERVER_GET_PRIVATE(obj)       \
+        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_GDATA_SERVER, YtvGdataServerPriv))
+
+#define FEEDS_PATH "/feeds/api"
+#define THUMBS_PATH "/vi"
+#define MIMETYPE "application/json; charset=UTF-8"
+#define DAY (24 * 60 * 60)
+
+static const gchar* authors[] =
+{
+        "alice", "bob", "carol", "dave", "eve", "mallory", "trent", "peggy"
+};
+
+static const gchar* categories[] =
+{
+        "Music", "Comedy", "Sports", "News", "Education", "Film", "Games",
+        "Howto"
+};
+
+static const gchar* words[] =
+{
+        "live", "cover", "tutorial", "funny", "cat", "guitar", "goal",
+        "review", "trailer", "remix", "news", "cooking", "speedrun",
+        "interview", "lecture", "dance"
+};
+
+static const guint32 colors[] =
+{
+        0xcc3333ff, 0x33cc33ff, 0x3333ccff, 0xcccc33ff,
+        0xcc33ccff, 0x33ccccff, 0x999999ff, 0xff9933ff
+};
+
+G_DEFINE_TYPE (YtvGdataServer, ytv_gdata_server, G_TYPE_OBJECT)
+
+static void
+fake_entry_free (YtvFakeEntry* entry)
+{
+        g_free (entry->json);
+        g_free (entry->id);
+        g_free (entry->author);
+        g_free (entry->title);
+        g_free (entry->category);
+        g_free (entry->tags);
+        g_slice_free (YtvFakeEntry, entry);
+
+        return;
+}
+
+static void
+append_json_string (GString* json, const gchar* str)
+{
+        const gchar* p;
+
+        g_string_append_c (json, '"');
+
+        for (p = str; *p != '\0'; p++)
+        {
+                switch (*p)
+                {
+                case '"':
+                        g_string_append (json, "\\\"");
+                        break;
+                case '\\':
+                        g_string_append (json, "\\\\");
+                        break;
+                case '\n':
+                        g_string_append (json, "\\n");
+                        break;
+                default:
+                        if ((guchar) *p < 0x20)
+                        {
+                                g_string_append_printf (json, "\\u%04x",
+                                                        (guint) *p);
+                        }
+                        else
+                        {
+                                g_string_append_c (json, *p);
+                        }
+                }
+        }
+
+        g_string_append_c (json, '"');
+
+        return;
+}
+
+static void
+append_member (GString* json, const gchar* name, const gchar* value)
+{
+        g_string_append_printf (json, "\"%s\":{\"$t\":", name);
+        append_json_string (json, value);
+        g_string_append_c (json, '}');
+
+        return;
+}
+
+static gchar*
+format_date (glong t)
+{
+        GTimeVal tv;
+
+        tv.tv_sec = t;
+        tv.tv_usec = 0;
+
+        return g_time_val_to_iso8601 (&tv);
+}
+
+static gchar*
+serialize_entry (YtvFakeEntry* entry, gint duration, const gchar* desc)
+{
+        GString* json;
+        gchar* published;
+        gchar num[G_ASCII_DTOSTR_BUF_SIZE];
+
+        json = g_string_sized_new (1024);
+        published = format_date (entry->published);
+
+        g_string_append_c (json, '{');
+        g_string_append_printf (json, "\"id\":{\"$t\":"
+                                "\"http://gdata.youtube.com/feeds/api/"
+                                "videos/%s\"},", entry->id);
+        append_member (json, "published", published);
+        g_string_append_c (json, ',');
+        append_member (json, "title", entry->title);
+        g_string_append (json, ",\"author\":[{");
+        append_member (json, "name", entry->author);
+        g_string_append (json, "}],\"media$group\":{\"media$category\":[{");
+        g_string_append (json, "\"$t\":");
+        append_json_string (json, entry->category);
+        g_string_append (json, "}],");
+        append_member (json, "media$description", desc);
+        g_string_append_c (json, ',');
+        append_member (json, "media$keywords", entry->tags);
+        g_string_append_printf (json, ",\"yt$duration\":"
+                                "{\"seconds\":\"%d\"}},", duration);
+        g_ascii_formatd (num, sizeof (num), "%.2f", entry->rating);
+        g_string_append_printf (json, "\"gd$rating\":{\"average\":\"%s\","
+                                "\"max\":5,\"min\":1},", num);
+        g_string_append_printf (json, "\"yt$statistics\":"
+                                "{\"viewCount\":\"%u\"}", entry->views);
+        g_string_append_c (json, '}');
+
+        g_free (published);
+
+        return g_string_free (json, FALSE);
+}
+
+static gchar*
+random_words (GRand* rand, gint min, gint max, const gchar* sep)
+{
+        GString* str;
+        gint i, n;
+
+        str = g_string_new (NULL);
+        n = g_rand_int_range (rand, min, max + 1);
+
+        for (i = 0; i < n; i++)
+        {
+                if (i > 0)
+                {
+                        g_string_append (str, sep);
+                }
+
+                g_string_append (str, words[g_rand_int_range
+                                            (rand, 0, G_N_ELEMENTS (words))]);
+        }
+
+        return g_string_free (str, FALSE);
+}
+
+static void
+synthesize_corpus (YtvGdataServer* self)
+{
+        static const gchar alphabet[] =
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+                "0123456789-_";
+        YtvGdataServerPriv* priv;
+        YtvFakeEntry* entry;
+        gchar* desc;
+        guint i, j;
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (self);
+
+        for (i = 0; i < priv->num_entries; i++)
+        {
+                entry = g_slice_new0 (YtvFakeEntry);
+
+                entry->id = g_malloc0 (12);
+                for (j = 0; j < 11; j++)
+                {
+                        entry->id[j] = alphabet[g_rand_int_range
+                                                (priv->rand, 0,
+                                                 sizeof (alphabet) - 1)];
+                }
+
+                entry->author = g_strdup
+                        (authors[g_rand_int_range (priv->rand, 0,
+                                                   G_N_ELEMENTS (authors))]);
+                entry->title = random_words (priv->rand, 2, 5, " ");
+                entry->category = g_strdup
+                        (categories[g_rand_int_range
+                                    (priv->rand, 0,
+                                     G_N_ELEMENTS (categories))]);
+                entry->tags = random_words (priv->rand, 1, 4, ", ");
+                entry->published = priv->now -
+                        g_rand_int_range (priv->rand, 0, 60 * DAY);
+                entry->views = g_rand_int_range (priv->rand, 0, 10000000);
+                entry->rating = g_rand_double_range (priv->rand, 1.0, 5.0);
+
+                desc = random_words (priv->rand, 8, 30, " ");
+                entry->json = serialize_entry
+                        (entry, g_rand_int_range (priv->rand, 30, 1200), desc);
+                g_free (desc);
+
+                g_ptr_array_add (priv->corpus, entry);
+        }
+
+        return;
+}
+
+/* gets obj.member[.sub] as string, or NULL */
+static const gchar*
+lookup_string (JsonObject* obj, const gchar* member, const gchar* sub)
+{
+        JsonNode* node;
+
+        node = json_object_get_member (obj, member);
+
+        if (node != NULL && JSON_NODE_TYPE (node) == JSON_NODE_ARRAY)
+        {
+                node = json_array_get_element (json_node_get_array (node), 0);
+        }
+
+        if (node == NULL || JSON_NODE_TYPE (node) != JSON_NODE_OBJECT)
+        {
+                return NULL;
+        }
+
+        if (sub != NULL)
+        {
+                node = json_object_get_member (json_node_get_object (node),
+                                               sub);
+
+                if (node == NULL || JSON_NODE_TYPE (node) != JSON_NODE_OBJECT)
+                {
+                        return NULL;
+                }
+        }
+
+        node = json_object_get_member (json_node_get_object (node), "$t");
+
+        if (node == NULL || JSON_NODE_TYPE (node) != JSON_NODE_VALUE)
+        {
+                return NULL;
+        }
+
+        return json_node_get_string (node);
+}
+
+static const gchar*
+lookup_attribute (JsonObject* obj, const gchar* member, const gchar* attr)
+{
+        JsonNode* node;
+
+        node = json_object_get_member (obj, member);
+
+        if (node == NULL || JSON_NODE_TYPE (node) != JSON_NODE_OBJECT)
+        {
+                return NULL;
+        }
+
+        node = json_object_get_member (json_node_get_object (node), attr);
+
+        if (node == NULL || JSON_NODE_TYPE (node) != JSON_NODE_VALUE)
+        {
+                return NULL;
+        }
+
+        return json_node_get_string (node);
+}
+
+static YtvFakeEntry*
+load_entry (JsonNode* node)
+{
+        YtvFakeEntry* entry;
+        JsonObject* obj;
+        JsonObject* group;
+        const gchar* str;
+        GTimeVal tv;
+
+        if (JSON_NODE_TYPE (node) != JSON_NODE_OBJECT)
+        {
+                return NULL;
+        }
+
+        obj = json_node_get_object (node);
+        str = lookup_string (obj, "id", NULL);
+
+        if (str == NULL || strrchr (str, '/') == NULL)
+        {
+                return NULL;
+        }
+
+        entry = g_slice_new0 (YtvFakeEntry);
+        entry->id = g_strdup (strrchr (str, '/') + 1);
+        entry->author = g_strdup (lookup_string (obj, "author", "name"));
+        entry->title = g_strdup (lookup_string (obj, "title", NULL));
+
+        node = json_object_get_member (obj, "media$group");
+        if (node != NULL && JSON_NODE_TYPE (node) == JSON_NODE_OBJECT)
+        {
+                group = json_node_get_object (node);
+                entry->category = g_strdup
+                        (lookup_string (group, "media$category", NULL));
+                entry->tags = g_strdup
+                        (lookup_string (group, "media$keywords", NULL));
+        }
+
+        str = lookup_string (obj, "published", NULL);
+        if (str != NULL && g_time_val_from_iso8601 (str, &tv))
+        {
+                entry->published = tv.tv_sec;
+        }
+
+        str = lookup_attribute (obj, "yt$statistics", "viewCount");
+        entry->views = str ? g_ascii_strtoull (str, NULL, 10) : 0;
+
+        str = lookup_attribute (obj, "gd$rating", "average");
+        entry->rating = str ? g_ascii_strtod (str, NULL) : 0;
+
+        return entry;
+}
+
+static gboolean
+load_corpus (YtvGdataServer* self, GError** err)
+{
+        YtvGdataServerPriv* priv;
+        JsonParser* parser;
+        JsonGenerator* gen;
+        JsonNode* node;
+        JsonArray* entries;
+        YtvFakeEntry* entry;
+        gboolean retval;
+        guint i;
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (self);
+        retval = FALSE;
+
+        parser = json_parser_new ();
+        gen = json_generator_new ();
+
+        if (!json_parser_load_from_file (parser, priv->feed_file, err))
+        {
+                goto beach;
+        }
+
+        node = json_parser_get_root (parser);
+        if (node == NULL || JSON_NODE_TYPE (node) != JSON_NODE_OBJECT)
+        {
+                goto bad_format;
+        }
+
+        node = json_object_get_member (json_node_get_object (node), "feed");
+        if (node == NULL || JSON_NODE_TYPE (node) != JSON_NODE_OBJECT)
+        {
+                goto bad_format;
+        }
+
+        node = json_object_get_member (json_node_get_object (node), "entry");
+        if (node == NULL || JSON_NODE_TYPE (node) != JSON_NODE_ARRAY)
+        {
+                goto bad_format;
+        }
+
+        entries = json_node_get_array (node);
+
+        for (i = 0; i < json_array_get_length (entries); i++)
+        {
+                node = json_array_get_element (entries, i);
+                entry = load_entry (node);
+
+                if (entry != NULL)
+                {
+                        json_generator_set_root (gen, node);
+                        entry->json = json_generator_to_data (gen, NULL);
+                        g_ptr_array_add (priv->corpus, entry);
+                }
+        }
+
+        retval = TRUE;
+        goto beach;
+
+bad_format:
+        g_set_error (err, YTV_PARSE_ERROR, YTV_PARSE_ERROR_BAD_FORMAT,
+                     "No feed entries in %s", priv->feed_file);
+
+beach:
+        g_object_unref (gen);
+        g_object_unref (parser);
+
+        return retval;
+}
+
+static gint
+compare_views (gconstpointer a, gconstpointer b)
+{
+        const YtvFakeEntry* ea = *(YtvFakeEntry**) a;
+        const YtvFakeEntry* eb = *(YtvFakeEntry**) b;
+
+        return (ea->views < eb->views) - (ea->views > eb->views);
+}
+
+static gint
+compare_rating (gconstpointer a, gconstpointer b)
+{
+        const YtvFakeEntry* ea = *(YtvFakeEntry**) a;
+        const YtvFakeEntry* eb = *(YtvFakeEntry**) b;
+
+        return (ea->rating < eb->rating) - (ea->rating > eb->rating);
+}
+
+static gint
+compare_published (gconstpointer a, gconstpointer b)
+{
+        const YtvFakeEntry* ea = *(YtvFakeEntry**) a;
+        const YtvFakeEntry* eb = *(YtvFakeEntry**) b;
+
+        return (ea->published < eb->published) -
+                (ea->published > eb->published);
+}
+
+static gboolean
+matches_query (YtvFakeEntry* entry, gchar** terms)
+{
+        gint i;
+
+        for (i = 0; terms[i] != NULL; i++)
+        {
+                if (terms[i][0] == '\0')
+                {
+                        continue;
+                }
+
+                if ((entry->title == NULL ||
+                     strstr (entry->title, terms[i]) == NULL) &&
+                    (entry->tags == NULL ||
+                     strstr (entry->tags, terms[i]) == NULL))
+                {
+                        return FALSE;
+                }
+        }
+
+        return TRUE;
+}
+
+static YtvFakeEntry*
+find_entry (YtvGdataServerPriv* priv, const gchar* id)
+{
+        YtvFakeEntry* entry;
+        guint i;
+
+        for (i = 0; i < priv->corpus->len; i++)
+        {
+                entry = g_ptr_array_index (priv->corpus, i);
+
+                if (g_str_equal (entry->id, id))
+                {
+                        return entry;
+                }
+        }
+
+        return NULL;
+}
+
+/* selects the entries of the feed addressed by path; returns NULL if the
+ * path is unknown */
+static GPtrArray*
+select_entries (YtvGdataServerPriv* priv, gchar** parts, GHashTable* query,
+                GCompareFunc* order)
+{
+        GPtrArray* result;
+        YtvFakeEntry* entry;
+        YtvFakeEntry* related;
+        gchar** terms;
+        guint i;
+
+        result = g_ptr_array_new ();
+        terms = NULL;
+        related = NULL;
+        *order = NULL;
+
+        if (parts[0] == NULL)
+        {
+                goto not_found;
+        }
+        else if (g_str_equal (parts[0], "standardfeeds") && parts[1] != NULL)
+        {
+                if (g_str_equal (parts[1], "most_viewed"))
+                {
+                        *order = compare_views;
+                }
+                else if (g_str_equal (parts[1], "top_rated"))
+                {
+                        *order = compare_rating;
+                }
+                else if (g_str_equal (parts[1], "most_recent"))
+                {
+                        *order = compare_published;
+                }
+        }
+        else if (g_str_equal (parts[0], "videos") && parts[1] == NULL)
+        {
+                const gchar* vq = query ? g_hash_table_lookup (query, "vq")
+                        : NULL;
+                terms = g_strsplit (vq ? vq : "", " ", -1);
+        }
+        else if (g_str_equal (parts[0], "videos") && parts[1] != NULL &&
+                 g_str_equal (parts[1], "-") && parts[2] != NULL)
+        {
+                ; /* filtered below */
+        }
+        else if (g_str_equal (parts[0], "videos") && parts[1] != NULL &&
+                 parts[2] != NULL && g_str_equal (parts[2], "related"))
+        {
+                related = find_entry (priv, parts[1]);
+        }
+        else if (g_str_equal (parts[0], "users") && parts[1] != NULL &&
+                 parts[2] != NULL && g_str_equal (parts[2], "uploads"))
+        {
+                ; /* filtered below */
+        }
+        else
+        {
+                goto not_found;
+        }
+
+        for (i = 0; i < priv->corpus->len; i++)
+        {
+                entry = g_ptr_array_index (priv->corpus, i);
+
+                if (terms != NULL && !matches_query (entry, terms))
+                {
+                        continue;
+                }
+
+                if (g_str_equal (parts[0], "users") &&
+                    g_strcmp0 (entry->author, parts[1]) != 0)
+                {
+                        continue;
+                }
+
+                if (parts[1] != NULL && g_str_equal (parts[1], "-") &&
+                    g_ascii_strcasecmp (entry->category ?
+                                        entry->category : "", parts[2]) != 0)
+                {
+                        continue;
+                }
+
+                if (parts[2] != NULL && g_str_equal (parts[2], "related") &&
+                    (related == NULL || entry == related ||
+                     g_strcmp0 (entry->category, related->category) != 0))
+                {
+                        continue;
+                }
+
+                g_ptr_array_add (result, entry);
+        }
+
+        g_strfreev (terms);
+
+        return result;
+
+not_found:
+        g_ptr_array_free (result, TRUE);
+
+        return NULL;
+}
+
+static void
+filter_params (YtvGdataServerPriv* priv, GPtrArray* result,
+               GHashTable* query, GCompareFunc* order)
+{
+        const gchar* value;
+        glong since;
+        YtvFakeEntry* entry;
+        gint i;
+
+        since = 0;
+
+        value = query ? g_hash_table_lookup (query, "time") : NULL;
+        if (value != NULL)
+        {
+                if (g_str_equal (value, "today"))
+                {
+                        since = priv->now - DAY;
+                }
+                else if (g_str_equal (value, "this_week"))
+                {
+                        since = priv->now - 7 * DAY;
+                }
+                else if (g_str_equal (value, "this_month"))
+                {
+                        since = priv->now - 30 * DAY;
+                }
+        }
+
+        value = query ? g_hash_table_lookup (query, "author") : NULL;
+
+        for (i = result->len - 1; i >= 0; i--)
+        {
+                entry = g_ptr_array_index (result, i);
+
+                if (entry->published < since ||
+                    (value != NULL && g_strcmp0 (entry->author, value) != 0))
+                {
+                        g_ptr_array_remove_index (result, i);
+                }
+        }
+
+        value = query ? g_hash_table_lookup (query, "orderby") : NULL;
+        if (value != NULL)
+        {
+                if (g_str_equal (value, "viewCount"))
+                {
+                        *order = compare_views;
+                }
+                else if (g_str_equal (value, "rating"))
+                {
+                        *order = compare_rating;
+                }
+                else if (g_str_equal (value, "published"))
+                {
+                        *order = compare_published;
+                }
+        }
+
+        if (*order != NULL)
+        {
+                g_ptr_array_sort (result, *order);
+        }
+
+        return;
+}
+
+static gint
+int_param (GHashTable* query, const gchar* name, gint defval)
+{
+        const gchar* value;
+
+        value = query ? g_hash_table_lookup (query, name) : NULL;
+
+        if (value == NULL)
+        {
+                return defval;
+        }
+
+        return (gint) g_ascii_strtoll (value, NULL, 10);
+}
+
+static gchar*
+build_feed (GPtrArray* result, GHashTable* query, gsize* length)
+{
+        GString* json;
+        YtvFakeEntry* entry;
+        gint start, max, i;
+
+        start = MAX (int_param (query, "start-index", 1), 1);
+        max = CLAMP (int_param (query, "max-results", 25), 0, 50);
+
+        json = g_string_sized_new (2048 * max + 256);
+
+        g_string_append_printf (json, "{\"version\":\"1.0\","
+                                "\"encoding\":\"UTF-8\",\"feed\":{"
+                                "\"openSearch$totalResults\":{\"$t\":%u},"
+                                "\"openSearch$startIndex\":{\"$t\":%d},"
+                                "\"openSearch$itemsPerPage\":{\"$t\":%d}",
+                                result->len, start, max);
+
+        /* like the real service: no entry member past the last page */
+        if (start <= (gint) result->len && max > 0)
+        {
+                g_string_append (json, ",\"entry\":[");
+
+                for (i = start - 1;
+                     i < (gint) result->len && i < start - 1 + max; i++)
+                {
+                        entry = g_ptr_array_index (result, i);
+
+                        if (i > start - 1)
+                        {
+                                g_string_append_c (json, ',');
+                        }
+
+                        g_string_append (json, entry->json);
+                }
+
+                g_string_append_c (json, ']');
+        }
+
+        g_string_append (json, "}}");
+
+        *length = json->len;
+
+        return g_string_free (json, FALSE);
+}
+
+static gboolean
+delayed_reply_cb (gpointer user_data)
+{
+        YtvDelayedReply* reply;
+
+        reply = (YtvDelayedReply*) user_data;
+
+        soup_server_unpause_message (reply->server, reply->msg);
+
+        g_object_unref (reply->msg);
+        g_object_unref (reply->server);
+        g_slice_free (YtvDelayedReply, reply);
+
+        return FALSE;
+}
+
+/* takes the ownership of body */
+static void
+respond (YtvGdataServer* self, SoupMessage* msg, const gchar* mime,
+         gchar* body, gsize length)
+{
+        YtvGdataServerPriv* priv;
+        gdouble delay;
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (self);
+
+        if (priv->error_rate > 0 &&
+            g_rand_double (priv->rand) < priv->error_rate)
+        {
+                soup_message_set_status (msg, SOUP_STATUS_SERVICE_UNAVAILABLE);
+                g_free (body);
+                length = 0;
+        }
+        else
+        {
+                if (priv->corrupt_rate > 0 &&
+                    g_rand_double (priv->rand) < priv->corrupt_rate)
+                {
+                        length /= 2; /* truncated response */
+                }
+
+                soup_message_set_status (msg, SOUP_STATUS_OK);
+                soup_message_set_response (msg, mime, SOUP_MEMORY_TAKE,
+                                           body, length);
+        }
+
+        delay = priv->latency;
+
+        if (priv->jitter > 0)
+        {
+                delay += g_rand_double_range (priv->rand,
+                                              - (gdouble) priv->jitter,
+                                              priv->jitter);
+        }
+
+        if (priv->bandwidth > 0)
+        {
+                delay += length * 1000.0 / priv->bandwidth;
+        }
+
+        if (delay >= 1)
+        {
+                YtvDelayedReply* reply;
+                GSource* source;
+
+                reply = g_slice_new (YtvDelayedReply);
+                reply->server = g_object_ref (priv->server);
+                reply->msg = g_object_ref (msg);
+
+                soup_server_pause_message (priv->server, msg);
+
+                source = g_timeout_source_new ((guint) delay);
+                g_source_set_callback (source, delayed_reply_cb, reply, NULL);
+                g_source_attach (source, priv->context);
+                g_source_unref (source);
+        }
+
+        return;
+}
+
+static void
+feed_handler (SoupServer* server, SoupMessage* msg, const gchar* path,
+              GHashTable* query, SoupClientContext* client,
+              gpointer user_data)
+{
+        YtvGdataServer* self;
+        YtvGdataServerPriv* priv;
+        GPtrArray* result;
+        GCompareFunc order;
+        gchar** parts;
+        gchar* body;
+        gsize length;
+
+        self = YTV_GDATA_SERVER (user_data);
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (self);
+
+        if (msg->method != SOUP_METHOD_GET)
+        {
+                soup_message_set_status (msg, SOUP_STATUS_NOT_IMPLEMENTED);
+                return;
+        }
+
+        path += strlen (FEEDS_PATH);
+        while (*path == '/')
+        {
+                path++;
+        }
+
+        parts = g_strsplit (path, "/", 4);
+        result = select_entries (priv, parts, query, &order);
+
+        if (result == NULL)
+        {
+                soup_message_set_status (msg, SOUP_STATUS_NOT_FOUND);
+                goto beach;
+        }
+
+        filter_params (priv, result, query, &order);
+        body = build_feed (result, query, &length);
+        respond (self, msg, MIMETYPE, body, length);
+
+        g_ptr_array_free (result, TRUE);
+
+beach:
+        g_strfreev (parts);
+
+        return;
+}
+
+static void
+thumbnail_handler (SoupServer* server, SoupMessage* msg, const gchar* path,
+                   GHashTable* query, SoupClientContext* client,
+                   gpointer user_data)
+{
+        YtvGdataServer* self;
+        YtvGdataServerPriv* priv;
+        GByteArray* jpeg;
+        gchar** parts;
+        gchar* key;
+        gint width, height;
+        guint color;
+
+        self = YTV_GDATA_SERVER (user_data);
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (self);
+
+        /* /vi/<id>/<variant>.jpg */
+        parts = g_strsplit (path, "/", 5);
+
+        if (g_strv_length (parts) != 4)
+        {
+                soup_message_set_status (msg, SOUP_STATUS_NOT_FOUND);
+                goto beach;
+        }
+
+        if (g_str_equal (parts[3], "hqdefault.jpg"))
+        {
+                width = 480;
+                height = 360;
+        }
+        else if (g_str_equal (parts[3], "mqdefault.jpg"))
+        {
+                width = 320;
+                height = 180;
+        }
+        else
+        {
+                width = 120;
+                height = 90;
+        }
+
+        color = g_str_hash (parts[2]) % G_N_ELEMENTS (colors);
+        key = g_strdup_printf ("%dx%d-%u", width, height, color);
+        jpeg = g_hash_table_lookup (priv->thumbs, key);
+
+        if (jpeg == NULL)
+        {
+                GdkPixbuf* pixbuf;
+                gchar* buffer;
+                gsize size;
+
+                pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8,
+                                         width, height);
+                gdk_pixbuf_fill (pixbuf, colors[color]);
+
+                if (!gdk_pixbuf_save_to_buffer (pixbuf, &buffer, &size,
+                                                "jpeg", NULL, "quality", "85",
+                                                NULL))
+                {
+                        soup_message_set_status
+                                (msg, SOUP_STATUS_INTERNAL_SERVER_ERROR);
+                        g_object_unref (pixbuf);
+                        g_free (key);
+                        goto beach;
+                }
+
+                jpeg = g_byte_array_sized_new (size);
+                g_byte_array_append (jpeg, (guint8*) buffer, size);
+                g_hash_table_insert (priv->thumbs, key, jpeg);
+
+                g_free (buffer);
+                g_object_unref (pixbuf);
+        }
+        else
+        {
+                g_free (key);
+        }
+
+        respond (self, msg, "image/jpeg",
+                 g_memdup (jpeg->data, jpeg->len), jpeg->len);
+
+beach:
+        g_strfreev (parts);
+
+        return;
+}
+
+static void
+free_thumb (gpointer data)
+{
+        g_byte_array_free ((GByteArray*) data, TRUE);
+
+        return;
+}
+
+static void
+ytv_gdata_server_set_property (GObject* object, guint prop_id,
+                               const GValue* value, GParamSpec* spec)
+{
+        YtvGdataServerPriv* priv;
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_PORT:
+                priv->port = g_value_get_uint (value);
+                break;
+        case PROP_CONTEXT:
+                priv->context = g_value_get_pointer (value);
+                break;
+        case PROP_LATENCY:
+                priv->latency = g_value_get_uint (value);
+                break;
+        case PROP_JITTER:
+                priv->jitter = g_value_get_uint (value);
+                break;
+        case PROP_BANDWIDTH:
+                priv->bandwidth = g_value_get_uint (value);
+                break;
+        case PROP_ERROR_RATE:
+                priv->error_rate = g_value_get_double (value);
+                break;
+        case PROP_CORRUPT_RATE:
+                priv->corrupt_rate = g_value_get_double (value);
+                break;
+        case PROP_ENTRIES:
+                priv->num_entries = g_value_get_uint (value);
+                break;
+        case PROP_FEED_FILE:
+                g_free (priv->feed_file);
+                priv->feed_file = g_value_dup_string (value);
+                break;
+        case PROP_SEED:
+                priv->seed = g_value_get_uint (value);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_gdata_server_get_property (GObject* object, guint prop_id,
+                               GValue* value, GParamSpec* spec)
+{
+        YtvGdataServerPriv* priv;
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_PORT:
+                g_value_set_uint (value, ytv_gdata_server_get_port
+                                  (YTV_GDATA_SERVER (object)));
+                break;
+        case PROP_CONTEXT:
+                g_value_set_pointer (value, priv->context);
+                break;
+        case PROP_LATENCY:
+                g_value_set_uint (value, priv->latency);
+                break;
+        case PROP_JITTER:
+                g_value_set_uint (value, priv->jitter);
+                break;
+        case PROP_BANDWIDTH:
+                g_value_set_uint (value, priv->bandwidth);
+                break;
+        case PROP_ERROR_RATE:
+                g_value_set_double (value, priv->error_rate);
+                break;
+        case PROP_CORRUPT_RATE:
+                g_value_set_double (value, priv->corrupt_rate);
+                break;
+        case PROP_ENTRIES:
+                g_value_set_uint (value, priv->num_entries);
+                break;
+        case PROP_FEED_FILE:
+                g_value_set_string (value, priv->feed_file);
+                break;
+        case PROP_SEED:
+                g_value_set_uint (value, priv->seed);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_gdata_server_dispose (GObject* object)
+{
+        ytv_gdata_server_stop (YTV_GDATA_SERVER (object));
+
+        (*G_OBJECT_CLASS (ytv_gdata_server_parent_class)->dispose) (object);
+
+        return;
+}
+
+static void
+ytv_gdata_server_finalize (GObject* object)
+{
+        YtvGdataServerPriv* priv;
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (object);
+
+        g_ptr_array_foreach (priv->corpus, (GFunc) fake_entry_free, NULL);
+        g_ptr_array_free (priv->corpus, TRUE);
+        g_hash_table_destroy (priv->thumbs);
+        g_free (priv->feed_file);
+
+        if (priv->rand != NULL)
+        {
+                g_rand_free (priv->rand);
+        }
+
+        (*G_OBJECT_CLASS (ytv_gdata_server_parent_class)->finalize) (object);
+
+        return;
+}
+
+static void
+ytv_gdata_server_class_init (YtvGdataServerClass* klass)
+{
+        GObjectClass* object_class;
+
+        object_class = G_OBJECT_CLASS (klass);
+
+        g_type_class_add_private (object_class, sizeof (YtvGdataServerPriv));
+
+        object_class->set_property = ytv_gdata_server_set_property;
+        object_class->get_property = ytv_gdata_server_get_property;
+        object_class->dispose      = ytv_gdata_server_dispose;
+        object_class->finalize     = ytv_gdata_server_finalize;
+
+        g_object_class_install_property
+                (object_class, PROP_PORT,
+                 g_param_spec_uint
+                 ("port", "port", "The TCP port to listen, 0 for any",
+                  0, 65535, 0, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+        g_object_class_install_property
+                (object_class, PROP_CONTEXT,
+                 g_param_spec_pointer
+                 ("context", "context", "The GMainContext where the server "
+                  "runs, NULL for the default one",
+                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+        g_object_class_install_property
+                (object_class, PROP_LATENCY,
+                 g_param_spec_uint
+                 ("latency", "latency", "Milliseconds before each response",
+                  0, G_MAXUINT, 0, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (object_class, PROP_JITTER,
+                 g_param_spec_uint
+                 ("jitter", "jitter", "Maximum random deviation of the "
+                  "latency, in milliseconds", 0, G_MAXUINT, 0,
+                  G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (object_class, PROP_BANDWIDTH,
+                 g_param_spec_uint
+                 ("bandwidth", "bandwidth", "Simulated bytes per second of "
+                  "each response, 0 for unlimited", 0, G_MAXUINT, 0,
+                  G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (object_class, PROP_ERROR_RATE,
+                 g_param_spec_double
+                 ("error-rate", "errorrate", "Probability of answering with "
+                  "a HTTP 503 error", 0, 1, 0, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (object_class, PROP_CORRUPT_RATE,
+                 g_param_spec_double
+                 ("corrupt-rate", "corruptrate", "Probability of answering "
+                  "with a truncated body", 0, 1, 0, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (object_class, PROP_ENTRIES,
+                 g_param_spec_uint
+                 ("entries", "entries", "Number of synthetic entries",
+                  0, G_MAXUINT, 500, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (object_class, PROP_FEED_FILE,
+                 g_param_spec_string
+                 ("feed-file", "feedfile", "A recorded JSON feed whose "
+                  "entries are served instead of the synthetic ones", NULL,
+                  G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (object_class, PROP_SEED,
+                 g_param_spec_uint
+                 ("seed", "seed", "Seed of the synthetic entries and of the "
+                  "simulated network", 0, G_MAXUINT, 0, G_PARAM_READWRITE));
+
+        return;
+}
+
+static void
+ytv_gdata_server_init (YtvGdataServer* self)
+{
+        YtvGdataServerPriv* priv;
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (self);
+
+        priv->server       = NULL;
+        priv->context      = NULL;
+        priv->port         = 0;
+        priv->latency      = 0;
+        priv->jitter       = 0;
+        priv->bandwidth    = 0;
+        priv->error_rate   = 0;
+        priv->corrupt_rate = 0;
+        priv->num_entries  = 500;
+        priv->feed_file    = NULL;
+        priv->seed         = 0;
+        priv->rand         = NULL;
+        priv->corpus       = g_ptr_array_new ();
+        priv->thumbs       = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                    g_free, free_thumb);
+        priv->now          = time (NULL);
+
+        return;
+}
+
+/**
+ * ytv_gdata_server_new:
+ * @context: (null-ok): the #GMainContext where the server will run
+ * @port: the TCP port to listen, or 0 for any free one
+ *
+ * Creates a stand-in GData server. Set its properties and then call
+ * ytv_gdata_server_start().
+ *
+ * returns: (not-null) (caller-owns): a new #YtvGdataServer
+ */
+YtvGdataServer*
+ytv_gdata_server_new (GMainContext* context, guint port)
+{
+        return g_object_new (YTV_TYPE_GDATA_SERVER,
+                             "context", context, "port", port, NULL);
+}
+
+/**
+ * ytv_gdata_server_start:
+ * @self: (not-null): a #YtvGdataServer
+ * @err: return location for a #GError
+ *
+ * Builds the corpus of entries and starts to listen.
+ *
+ * returns: %TRUE if the server is listening
+ */
+gboolean
+ytv_gdata_server_start (YtvGdataServer* self, GError** err)
+{
+        YtvGdataServerPriv* priv;
+
+        g_return_val_if_fail (YTV_IS_GDATA_SERVER (self), FALSE);
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (self);
+
+        g_return_val_if_fail (priv->server == NULL, FALSE);
+
+        priv->rand = priv->seed ?
+                g_rand_new_with_seed (priv->seed) : g_rand_new ();
+
+        if (priv->corpus->len == 0)
+        {
+                if (priv->feed_file != NULL)
+                {
+                        if (!load_corpus (self, err))
+                        {
+                                return FALSE;
+                        }
+                }
+                else
+                {
+                        synthesize_corpus (self);
+                }
+        }
+
+        priv->server = soup_server_new (SOUP_SERVER_PORT, priv->port,
+                                        SOUP_SERVER_ASYNC_CONTEXT,
+                                        priv->context, NULL);
+
+        if (priv->server == NULL)
+        {
+                g_set_error (err, YTV_HTTP_ERROR, YTV_HTTP_ERROR_CONNECTION,
+                             "Cannot listen on port %u", priv->port);
+                return FALSE;
+        }
+
+        soup_server_add_handler (priv->server, FEEDS_PATH,
+                                 feed_handler, self, NULL);
+        soup_server_add_handler (priv->server, THUMBS_PATH,
+                                 thumbnail_handler, self, NULL);
+
+        soup_server_run_async (priv->server);
+
+        return TRUE;
+}
+
+/**
+ * ytv_gdata_server_stop:
+ * @self: (not-null): a #YtvGdataServer
+ *
+ * Stops listening.
+ */
+void
+ytv_gdata_server_stop (YtvGdataServer* self)
+{
+        YtvGdataServerPriv* priv;
+
+        g_return_if_fail (YTV_IS_GDATA_SERVER (self));
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (self);
+
+        if (priv->server != NULL)
+        {
+                soup_server_quit (priv->server);
+                g_object_unref (priv->server);
+                priv->server = NULL;
+        }
+
+        return;
+}
+
+/**
+ * ytv_gdata_server_get_port:
+ * @self: (not-null): a #YtvGdataServer
+ *
+ * returns: the TCP port where the server listens
+ */
+guint
+ytv_gdata_server_get_port (YtvGdataServer* self)
+{
+        YtvGdataServerPriv* priv;
+
+        g_return_val_if_fail (YTV_IS_GDATA_SERVER (self), 0);
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (self);
+
+        if (priv->server != NULL)
+        {
+                return soup_server_get_port (priv->server);
+        }
+
+        return priv->port;
+}
+
+/**
+ * ytv_gdata_server_get_base_uri:
+ * @self: (not-null): a #YtvGdataServer
+ *
+ * returns: (caller-owns): the value for the "base-uri" property of
+ * #YtvYoutubeUriBuilder
+ */
+gchar*
+ytv_gdata_server_get_base_uri (YtvGdataServer* self)
+{
+        return g_strdup_printf ("http://127.0.0.1:%u" FEEDS_PATH "/",
+                                ytv_gdata_server_get_port (self));
+}
+
+/**
+ * ytv_gdata_server_get_thumbnail_uri:
+ * @self: (not-null): a #YtvGdataServer
+ *
+ * returns: (caller-owns): the value for the "thumbnail-uri" property of
+ * #YtvYoutubeUriBuilder
+ */
+gchar*
+ytv_gdata_server_get_thumbnail_uri (YtvGdataServer* self)
+{
+        return g_strdup_printf ("http://127.0.0.1:%u" THUMBS_PATH "/",
+                                ytv_gdata_server_get_port (self));
+}
+
+/**
+ * ytv_gdata_server_get_corpus_size:
+ * @self: (not-null): a #YtvGdataServer
+ *
+ * returns: the number of entries served
+ */
+guint
+ytv_gdata_server_get_corpus_size (YtvGdataServer* self)
+{
+        YtvGdataServerPriv* priv;
+
+        g_return_val_if_fail (YTV_IS_GDATA_SERVER (self), 0);
+
+        priv = YTV_GDATA_SERVER_GET_PRIVATE (self);
+
+        return priv->corpus->len;
+}
@@ -0,0 +1,67 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_GDATA_SERVER_H_
+#define _YTV_GDATA_SERVER_H_
+
+/* ytv-gdata-server.h - A local stand-in of the YouTube GData service
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define YTV_TYPE_GDATA_SERVER                   \
+        (ytv_gdata_server_get_type ())
+#define YTV_GDATA_SERVER(obj)                                           \
+        (G_TYPE_CHECK_INSTANCE_CAST ((obj), YTV_TYPE_GDATA_SERVER, YtvGdataServer))
+#define YTV_GDATA_SERVER_CLASS(klass)                                   \
+        (G_TYPE_CHECK_CLASS_CAST ((klass), YTV_TYPE_GDATA_SERVER, YtvGdataServerClass))
+#define YTV_IS_GDATA_SERVER(obj)                                        \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), YTV_TYPE_GDATA_SERVER))
+#define YTV_IS_GDATA_SERVER_CLASS(klass)                                \
+        (G_TYPE_CHECK_CLASS_TYPE ((klass), YTV_TYPE_GDATA_SERVER))
+#define YTV_GDATA_SERVER_GET_CLASS(obj)                                 \
+        (G_TYPE_INSTANCE_GET_CLASS ((obj), YTV_TYPE_GDATA_SERVER, YtvGdataServerClass))
+
+typedef struct _YtvGdataServer YtvGdataServer;
+typedef struct _YtvGdataServerClass YtvGdataServerClass;
+
+struct _YtvGdataServer
+{
+        GObject parent;
+};
+
+struct _YtvGdataServerClass
+{
+        GObjectClass parent_class;
+};
+
+GType ytv_gdata_server_get_type (void);
+
+YtvGdataServer* ytv_gdata_server_new (GMainContext* context, guint port);
+gboolean ytv_gdata_server_start (YtvGdataServer* self, GError** err);
+void ytv_gdata_server_stop (YtvGdataServer* self);
+guint ytv_gdata_server_get_port (YtvGdataServer* self);
+gchar* ytv_gdata_server_get_base_uri (YtvGdataServer* self);
+gchar* ytv_gdata_server_get_thumbnail_uri (YtvGdataServer* self);
+guint ytv_gdata_server_get_corpus_size (YtvGdataServer* self);
+
+G_END_DECLS
+
+#endif /* _YTV_GDATA_SERVER_H_ */
@@ -24,12 +24,16 @@
 #include <ytv-list.h>
 #include <ytv-iterator.h>
 #include <ytv-entry.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
 
 enum _YtvGtkBrowserProp
 {
         PROP_0,
         PROP_ORIENTATION,
-        PROP_NUMENTRIES
+        PROP_NUMENTRIES,
+        PROP_RECYCLE,
+        PROP_INCREMENTAL
 };
 
 typedef struct _YtvGtkBrowserPriv YtvGtkBrowserPriv;
@@ -41,8 +45,22 @@ struct _YtvGtkBrowserPriv
         gint start_idx;
         gboolean last_page;
         gint wid_pos; /* table current col or row */
+        gboolean recycle;
+        GPtrArray* views; /* attached entry views, by position; with
+                           * recycle the hidden ones after wid_pos too */
+        GHashTable* ids;  /* entry id -> the entry view showing it */
+        gboolean incremental;
+
+        /* page population in progress */
+        guint populate_id;
+        YtvList* populate_list;
+        YtvIterator* populate_iter;
+        YtvStatsTime populate_start;
 };
 
+/* time budget of each population slice, in microseconds */
+#define POPULATE_SLICE 8000
+
 #define YTV_GTK_BROWSER_GET_PRIVATE(obj)  \
         (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_GTK_BROWSER, YtvGtkBrowserPriv))
 
@@ -133,10 +151,163 @@ create_entry_view (YtvFeed* feed, YtvOrientation orientation)
         g_object_unref (ub);
         
         gtk_widget_show_all (GTK_WIDGET (view));
+
+        ytv_stats_inc (YTV_STATS_ENTRY_VIEWS);
         
         return GTK_WIDGET (view);
 }
 
+static gchar*
+get_entry_id (GObject* entry)
+{
+        gchar* id;
+
+        g_object_get (entry, "id", &id, NULL);
+
+        return id;
+}
+
+/* the id of the entry bound to @view, or NULL */
+static const gchar*
+get_entry_view_id (GtkWidget* view)
+{
+        return g_object_get_data (G_OBJECT (view), "ytv-entry-id");
+}
+
+static void
+unbind_view (YtvGtkBrowser* self, GtkWidget* view)
+{
+        YtvGtkBrowserPriv* priv;
+        const gchar* id;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        id = get_entry_view_id (view);
+
+        if (id != NULL && g_hash_table_lookup (priv->ids, id) == view)
+        {
+                g_hash_table_remove (priv->ids, id);
+        }
+
+        g_object_set_data (G_OBJECT (view), "ytv-entry-id", NULL);
+
+        return;
+}
+
+static void
+bind_view (YtvGtkBrowser* self, GtkWidget* view, YtvEntry* entry)
+{
+        YtvGtkBrowserPriv* priv;
+        gchar* id;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        unbind_view (self, view);
+
+        ytv_entry_view_set_entry (YTV_ENTRY_VIEW (view), entry);
+
+        id = get_entry_id (G_OBJECT (entry));
+
+        if (id != NULL)
+        {
+                g_hash_table_replace (priv->ids, g_strdup (id), view);
+        }
+
+        g_object_set_data_full (G_OBJECT (view), "ytv-entry-id", id, g_free);
+
+        return;
+}
+
+/* attaches @view, already a child, at @pos */
+static void
+move_view (YtvGtkBrowser* self, GtkWidget* view, gint pos)
+{
+        YtvGtkBrowserPriv* priv;
+        const gchar* left;
+        const gchar* right;
+        guint attach;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        if (priv->orientation == YTV_ORIENTATION_HORIZONTAL)
+        {
+                left = "left-attach";
+                right = "right-attach";
+        }
+        else
+        {
+                left = "top-attach";
+                right = "bottom-attach";
+        }
+
+        gtk_container_child_get (GTK_CONTAINER (self), view,
+                                 left, &attach, NULL);
+
+        /* the far edge first, the start must stay before the end */
+        if ((gint) attach < pos)
+        {
+                gtk_container_child_set (GTK_CONTAINER (self), view,
+                                         right, pos + 1, left, pos, NULL);
+        }
+        else if ((gint) attach > pos)
+        {
+                gtk_container_child_set (GTK_CONTAINER (self), view,
+                                         left, pos, right, pos + 1, NULL);
+        }
+
+        return;
+}
+
+/* forgets the entry views, e.g. when they were built for another feed or
+ * orientation */
+static void
+drop_views (YtvGtkBrowser* self)
+{
+        YtvGtkBrowserPriv* priv;
+        GtkWidget* view;
+        guint i;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        for (i = 0; i < priv->views->len; i++)
+        {
+                view = g_ptr_array_index (priv->views, i);
+                gtk_widget_destroy (view);
+                g_object_unref (view);
+        }
+
+        g_ptr_array_set_size (priv->views, 0);
+        g_hash_table_remove_all (priv->ids);
+
+        return;
+}
+
+/* forgets the hidden views after the ones shown, kept for recycling */
+static void
+drop_spare_views (YtvGtkBrowser* self)
+{
+        YtvGtkBrowserPriv* priv;
+        GtkWidget* view;
+        guint i;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        for (i = priv->wid_pos; i < priv->views->len; i++)
+        {
+                view = g_ptr_array_index (priv->views, i);
+                unbind_view (self, view);
+                gtk_widget_destroy (view);
+                g_object_unref (view);
+        }
+
+        if ((guint) priv->wid_pos < priv->views->len)
+        {
+                g_ptr_array_set_size (priv->views, priv->wid_pos);
+        }
+
+        return;
+}
+
 static void
 link_clicked_cb (GtkWidget* widget,
                  const gchar* class, const gchar* param, gpointer user_data)
@@ -171,12 +342,27 @@ show_entry_view (YtvGtkBrowser* self, YtvEntry* entry)
         
         priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
 
+        YTV_TRACE_BEGIN ("browser", "show_entry_view");
+
+        if (priv->wid_pos < (gint) priv->views->len)
+        {
+                /* already attached at this position: just rebind it */
+                entryview = g_ptr_array_index (priv->views, priv->wid_pos);
+                bind_view (self, entryview, entry);
+                gtk_widget_show (entryview);
+
+                YTV_TRACE_END ("browser", "show_entry_view");
+
+                return;
+        }
+
         entryview = create_entry_view (self->feed, priv->orientation);
 
         g_signal_connect (entryview, "link-clicked",
                           G_CALLBACK (link_clicked_cb), self);
 
-        ytv_entry_view_set_entry (YTV_ENTRY_VIEW (entryview), entry);
+        bind_view (self, entryview, entry);
+        g_ptr_array_add (priv->views, g_object_ref (entryview));
 
         if (priv->orientation == YTV_ORIENTATION_HORIZONTAL)
         {
@@ -190,16 +376,152 @@ show_entry_view (YtvGtkBrowser* self, YtvEntry* entry)
                                            0, 1,
                                            priv->wid_pos, priv->wid_pos + 1);
         }
+
+        YTV_TRACE_END ("browser", "show_entry_view");
         
         return;
 }
 
+static void
+stop_population (YtvGtkBrowser* self)
+{
+        YtvGtkBrowserPriv* priv;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        if (priv->populate_id != 0)
+        {
+                g_source_remove (priv->populate_id);
+                priv->populate_id = 0;
+        }
+
+        if (priv->populate_iter != NULL)
+        {
+                g_object_unref (priv->populate_iter);
+                priv->populate_iter = NULL;
+        }
+
+        if (priv->populate_list != NULL)
+        {
+                g_object_unref (priv->populate_list);
+                priv->populate_list = NULL;
+        }
+
+        return;
+}
+
+/* tells whether the page shown is the first or the last one */
+static void
+update_page_state (YtvGtkBrowser* self)
+{
+        YtvGtkBrowserPriv* priv;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        if (priv->wid_pos < priv->num_entries)
+        {
+                g_signal_emit_by_name (self, "last-page");
+                priv->last_page = TRUE;
+        }
+        else
+        {
+                priv->last_page = FALSE;
+
+                if (priv->start_idx == 0)
+                {
+                        g_signal_emit_by_name (self, "first-page");
+                }
+        }
+
+        return;
+}
+
+static void
+finish_population (YtvGtkBrowser* self)
+{
+        YtvGtkBrowserPriv* priv;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        stop_population (self);
+
+        ytv_stats_inc (YTV_STATS_PAGES_SHOWN);
+        ytv_stats_observe_since (YTV_STATS_PAGE_TIME, priv->populate_start);
+
+        YTV_TRACE_COUNTER ("browser", "entry-views", priv->wid_pos);
+
+        update_page_state (self);
+
+        return;
+}
+
+/* shows entries until the list is done or, if budget is positive, the
+ * slice time is over; returns TRUE if the list is done */
+static gboolean
+populate (YtvGtkBrowser* self, YtvStatsTime budget)
+{
+        YtvGtkBrowserPriv* priv;
+        YtvEntry* entry;
+        YtvStatsTime start;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        YTV_TRACE_BEGIN ("browser", "populate");
+        start = ytv_stats_time_now ();
+
+        while (!ytv_iterator_is_done (priv->populate_iter))
+        {
+                entry = YTV_ENTRY (ytv_iterator_get_current
+                                   (priv->populate_iter));
+
+                show_entry_view (self, entry);
+
+                if (priv->wid_pos == 0)
+                {
+                        ytv_stats_observe_since (YTV_STATS_FIRST_ENTRY_TIME,
+                                                 priv->populate_start);
+                }
+
+                priv->wid_pos++;
+
+                g_object_unref (entry);
+                ytv_iterator_next (priv->populate_iter);
+
+                if (budget > 0 && ytv_stats_time_now () - start >= budget)
+                {
+                        break;
+                }
+        }
+
+        YTV_TRACE_END ("browser", "populate");
+
+        return ytv_iterator_is_done (priv->populate_iter);
+}
+
+static gboolean
+populate_cb (gpointer user_data)
+{
+        YtvGtkBrowser* self;
+        YtvGtkBrowserPriv* priv;
+
+        self = YTV_GTK_BROWSER (user_data);
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        if (populate (self, POPULATE_SLICE))
+        {
+                priv->populate_id = 0; /* removed by returning FALSE */
+                finish_population (self);
+                return FALSE;
+        }
+
+        return TRUE;
+}
+
 static void
 feed_entry_cb (YtvFeed* feed, gboolean cancelled, YtvList* list,
                GError **err, gpointer user_data)
 {
         YtvGtkBrowser* self;
-        YtvIterator* iter;
         YtvGtkBrowserPriv* priv;
 
         self = YTV_GTK_BROWSER (user_data);
@@ -225,18 +547,276 @@ feed_entry_cb (YtvFeed* feed, gboolean cancelled, YtvList* list,
 
         g_return_if_fail (list != NULL);
 
+        YTV_TRACE_BEGIN ("browser", "feed_entry_cb");
+
+        stop_population (self);
+
         priv->wid_pos = 0;
+        priv->populate_start = ytv_stats_time_now ();
+        priv->populate_list = list; /* takes the reference */
+        priv->populate_iter = ytv_list_create_iterator (list);
+
+        /* the first slice goes now, the rest after the redraws */
+        if (populate (self, priv->incremental ? POPULATE_SLICE : 0))
+        {
+                finish_population (self);
+        }
+        else
+        {
+                priv->populate_id = g_idle_add_full
+                        (YTV_PRIORITY_LOWER_THAN_GTK_REDRAWS,
+                         populate_cb, self, NULL);
+        }
+
+        YTV_TRACE_END ("browser", "feed_entry_cb");
+
+        return;
+}
+
+/* the entry view attached at @pos, or NULL */
+static GtkWidget*
+get_entry_view (YtvGtkBrowser* self, gint pos)
+{
+        YtvGtkBrowserPriv* priv;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        if (pos < (gint) priv->views->len)
+        {
+                return g_ptr_array_index (priv->views, pos);
+        }
+
+        return NULL;
+}
+
+/* rebinds, in place, the view which shows the changed entry */
+static void
+entry_changed_cb (YtvFeed* feed, YtvEntry* entry, guint fields,
+                  gpointer user_data)
+{
+        YtvGtkBrowser* self;
+        YtvGtkBrowserPriv* priv;
+        GtkWidget* view;
+        gchar* id;
+
+        self = YTV_GTK_BROWSER (user_data);
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        id = get_entry_id (G_OBJECT (entry));
+        view = (id != NULL) ? g_hash_table_lookup (priv->ids, id) : NULL;
+        g_free (id);
+
+        if (view != NULL)
+        {
+                bind_view (self, view, entry);
+        }
+
+        return;
+}
+
+/* a new entry at @pos: the views from there on move one place down, and
+ * only the one at @pos is bound */
+static void
+entry_added_cb (YtvFeed* feed, YtvEntry* entry, gint pos,
+                gpointer user_data)
+{
+        YtvGtkBrowser* self;
+        YtvGtkBrowserPriv* priv;
+        GtkWidget* view;
+        gint i;
+
+        self = YTV_GTK_BROWSER (user_data);
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        /* beyond the views shown: the refresh callback appends it */
+        if (pos < 0 || pos > priv->wid_pos)
+        {
+                return;
+        }
+
+        if (priv->recycle && priv->wid_pos < (gint) priv->views->len)
+        {
+                /* the first hidden view is taken from the end */
+                view = g_ptr_array_index (priv->views, priv->wid_pos);
+        }
+        else
+        {
+                view = create_entry_view (self->feed, priv->orientation);
+
+                g_signal_connect (view, "link-clicked",
+                                  G_CALLBACK (link_clicked_cb), self);
+
+                if (priv->orientation == YTV_ORIENTATION_HORIZONTAL)
+                {
+                        gtk_table_attach_defaults (GTK_TABLE (self), view,
+                                                   priv->wid_pos,
+                                                   priv->wid_pos + 1, 0, 1);
+                }
+                else
+                {
+                        gtk_table_attach_defaults (GTK_TABLE (self), view,
+                                                   0, 1, priv->wid_pos,
+                                                   priv->wid_pos + 1);
+                }
+
+                g_ptr_array_add (priv->views, g_object_ref (view));
+        }
+
+        for (i = priv->wid_pos; i > pos; i--)
+        {
+                priv->views->pdata[i] = priv->views->pdata[i - 1];
+                move_view (self, g_ptr_array_index (priv->views, i), i);
+        }
+
+        priv->views->pdata[pos] = view;
+        move_view (self, view, pos);
+
+        bind_view (self, view, entry);
+        gtk_widget_show (view);
+
+        priv->wid_pos++;
+
+        return;
+}
+
+/* an entry gone: its view is dropped, and the following ones move one
+ * place up without being rebound */
+static void
+entry_removed_cb (YtvFeed* feed, YtvEntry* entry, gint pos,
+                  gpointer user_data)
+{
+        YtvGtkBrowser* self;
+        YtvGtkBrowserPriv* priv;
+        GtkWidget* view;
+        gchar* id;
+        gint i, last;
+
+        self = YTV_GTK_BROWSER (user_data);
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        /* @pos is in the previous page, before the former removals */
+        id = get_entry_id (G_OBJECT (entry));
+        view = (id != NULL) ? g_hash_table_lookup (priv->ids, id) : NULL;
+        g_free (id);
+
+        for (i = 0; i < priv->wid_pos && view != NULL; i++)
+        {
+                if (g_ptr_array_index (priv->views, i) == view)
+                {
+                        break;
+                }
+        }
+
+        if (view == NULL || i == priv->wid_pos)
+        {
+                return;
+        }
+
+        unbind_view (self, view);
+
+        last = priv->views->len - 1;
+
+        for (; i < last; i++)
+        {
+                priv->views->pdata[i] = priv->views->pdata[i + 1];
+                move_view (self, g_ptr_array_index (priv->views, i), i);
+        }
+
+        if (priv->recycle)
+        {
+                /* kept hidden at the end, for the next page */
+                priv->views->pdata[last] = view;
+                move_view (self, view, last);
+                gtk_widget_hide (view);
+        }
+        else
+        {
+                g_ptr_array_set_size (priv->views, last);
+                gtk_widget_destroy (view);
+                g_object_unref (view);
+        }
+
+        priv->wid_pos--;
+
+        return;
+}
+
+/* the changed, added and removed entries were already applied to the
+ * views, so only the positions whose entry is still another one, e.g. a
+ * moved entry, are rebound */
+static void
+feed_refresh_cb (YtvFeed* feed, gboolean cancelled, YtvList* list,
+                 GError **err, gpointer user_data)
+{
+        YtvGtkBrowser* self;
+        YtvGtkBrowserPriv* priv;
+        YtvIterator* iter;
+        GtkWidget* view;
+        GObject* entry;
+        gchar* id;
+        gint pos;
+        gint shown;
+        gboolean populating;
+
+        self = YTV_GTK_BROWSER (user_data);
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
+
+        /* the refreshed page is not the one shown anymore */
+        if (cancelled)
+        {
+                if (*err != NULL)
+                {
+                        g_error_free (*err);
+                }
+
+                if (list != NULL)
+                {
+                        g_object_unref (list);
+                }
+
+                return;
+        }
+
+        if (*err != NULL)
+        {
+                g_debug ("%s", ytv_error_get_message (*err));
+                g_signal_emit_by_name (self, "error-raised", *err);
+                return;
+        }
+
+        g_return_if_fail (list != NULL);
+
+        YTV_TRACE_BEGIN ("browser", "feed_refresh_cb");
+
+        /* the page being shown is completed by the refreshed one */
+        populating = (priv->populate_list != NULL);
+        stop_population (self);
+
+        shown = priv->wid_pos;
         iter = ytv_list_create_iterator (list);
-        while (!ytv_iterator_is_done (iter))
+
+        for (pos = 0; !ytv_iterator_is_done (iter); pos++)
         {
-                YtvEntry* entry;
-                
-                entry = YTV_ENTRY (ytv_iterator_get_current (iter));
+                entry = ytv_iterator_get_current (iter);
+                view = (pos < shown) ? get_entry_view (self, pos) : NULL;
 
-                show_entry_view (self, entry);
+                if (view == NULL)
+                {
+                        priv->wid_pos = pos;
+                        show_entry_view (self, YTV_ENTRY (entry));
+                }
+                else
+                {
+                        id = get_entry_id (entry);
+
+                        if (g_strcmp0 (id, get_entry_view_id (view)) != 0)
+                        {
+                                bind_view (self, view, YTV_ENTRY (entry));
+                        }
+
+                        g_free (id);
+                }
 
-                priv->wid_pos++;
-                
                 g_object_unref (entry);
                 ytv_iterator_next (iter);
         }
@@ -244,21 +824,68 @@ feed_entry_cb (YtvFeed* feed, gboolean cancelled, YtvList* list,
         g_object_unref (iter);
         g_object_unref (list);
 
-        if (priv->wid_pos < priv->num_entries)
-        {
-                g_signal_emit_by_name (self, "last-page");
-                priv->last_page = TRUE;
-        }
-        else
+        priv->wid_pos = pos;
+
+        /* the page got shorter */
+        for (; pos < shown; pos++)
         {
-                priv->last_page = FALSE;
+                view = get_entry_view (self, pos);
 
-                if (priv->start_idx == 0)
+                if (view == NULL)
                 {
-                        g_signal_emit_by_name (self, "first-page");
+                        continue;
+                }
+
+                unbind_view (self, view);
+
+                if (priv->recycle)
+                {
+                        gtk_widget_hide (view);
+                }
+                else
+                {
+                        gtk_widget_destroy (view);
+                        g_object_unref (view);
                 }
         }
 
+        if (!priv->recycle && shown > priv->wid_pos)
+        {
+                g_ptr_array_set_size (priv->views, priv->wid_pos);
+        }
+
+        /* the page length may have changed */
+        if (populating)
+        {
+                finish_population (self);
+        }
+        else
+        {
+                YTV_TRACE_COUNTER ("browser", "entry-views", priv->wid_pos);
+                update_page_state (self);
+        }
+
+        YTV_TRACE_END ("browser", "feed_refresh_cb");
+
+        return;
+}
+
+/* the stale page shown was fetched again, and it changed */
+static void
+entries_revalidated_cb (YtvFeed* feed, YtvList* list, gpointer user_data)
+{
+        GError* err = NULL;
+
+        feed_refresh_cb (feed, FALSE, g_object_ref (list), &err, user_data);
+
+        return;
+}
+
+static void
+ytv_gtk_browser_refresh_default (YtvGtkBrowser* self)
+{
+        ytv_feed_refresh (self->feed, feed_refresh_cb, self);
+
         return;
 }
 
@@ -322,12 +949,34 @@ ytv_gtk_browser_set_feed_default (YtvBrowser* me, YtvFeed* feed)
 
         if (self->feed != NULL)
         {
+                g_signal_handlers_disconnect_by_func
+                        (self->feed, G_CALLBACK (entry_changed_cb), self);
+                g_signal_handlers_disconnect_by_func
+                        (self->feed, G_CALLBACK (entry_added_cb), self);
+                g_signal_handlers_disconnect_by_func
+                        (self->feed, G_CALLBACK (entry_removed_cb), self);
+                g_signal_handlers_disconnect_by_func
+                        (self->feed, G_CALLBACK (entries_revalidated_cb),
+                         self);
                 g_object_unref (self->feed);
         }
         
+        stop_population (self);
+
         self->feed = g_object_ref (feed);
         g_signal_connect (self->feed, "notify::uri",
                           G_CALLBACK (change_uri_cb), self);
+        g_signal_connect (self->feed, "entry-changed",
+                          G_CALLBACK (entry_changed_cb), self);
+        g_signal_connect (self->feed, "entry-added",
+                          G_CALLBACK (entry_added_cb), self);
+        g_signal_connect (self->feed, "entry-removed",
+                          G_CALLBACK (entry_removed_cb), self);
+        g_signal_connect (self->feed, "entries-revalidated",
+                          G_CALLBACK (entries_revalidated_cb), self);
+
+        /* the views use the fetch strategy and URI builder of the feed */
+        drop_views (self);
 
         return;
 }
@@ -352,8 +1001,19 @@ ytv_gtk_browser_clean_default (YtvBrowser* me)
         YtvGtkBrowser* self = YTV_GTK_BROWSER (me);
         YtvGtkBrowserPriv* priv = YTV_GTK_BROWSER_GET_PRIVATE (self);
 
-        gtk_container_foreach (GTK_CONTAINER (self),
-                               (GtkCallback) gtk_widget_destroy, NULL);
+        stop_population (self);
+
+        if (priv->recycle)
+        {
+                /* hidden until they are rebound to the next page */
+                g_ptr_array_foreach (priv->views, (GFunc) gtk_widget_hide,
+                                     NULL);
+                g_hash_table_remove_all (priv->ids);
+        }
+        else
+        {
+                drop_views (self);
+        }
 
         priv->wid_pos = 0;
 
@@ -376,6 +1036,12 @@ ytv_gtk_browser_get_property (GObject* object, guint prop_id,
         case PROP_NUMENTRIES:
                 g_value_set_int (value, priv->num_entries);
                 break;
+        case PROP_RECYCLE:
+                g_value_set_boolean (value, priv->recycle);
+                break;
+        case PROP_INCREMENTAL:
+                g_value_set_boolean (value, priv->incremental);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -398,12 +1064,27 @@ ytv_gtk_browser_set_property (GObject* object, guint prop_id,
         {
         case PROP_ORIENTATION:
                 priv->orientation = g_value_get_enum (value);
+                drop_views (self);
                 g_object_notify (object, "orientation");
                 break;
         case PROP_NUMENTRIES:
                 priv->num_entries = g_value_get_int (value);
                 g_object_notify (object, "num-entries");
                 break;
+        case PROP_RECYCLE:
+                /* the views shown are kept either way, they are already
+                 * in views; only the hidden spare ones go away */
+                priv->recycle = g_value_get_boolean (value);
+                if (!priv->recycle)
+                {
+                        drop_spare_views (self);
+                }
+                g_object_notify (object, "recycle");
+                break;
+        case PROP_INCREMENTAL:
+                priv->incremental = g_value_get_boolean (value);
+                g_object_notify (object, "incremental");
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -421,12 +1102,42 @@ ytv_gtk_browser_dispose (GObject* object)
 
         me = YTV_GTK_BROWSER (object);
 
+        stop_population (me);
+
         if (me->feed != NULL)
         {
+                g_signal_handlers_disconnect_by_func
+                        (me->feed, G_CALLBACK (entry_changed_cb), me);
+                g_signal_handlers_disconnect_by_func
+                        (me->feed, G_CALLBACK (entry_added_cb), me);
+                g_signal_handlers_disconnect_by_func
+                        (me->feed, G_CALLBACK (entry_removed_cb), me);
+                g_signal_handlers_disconnect_by_func
+                        (me->feed, G_CALLBACK (entries_revalidated_cb), me);
                 g_object_unref (me->feed);
                 me->feed = NULL;
         }
 
+        /* already destroyed by the container */
+        g_ptr_array_foreach (YTV_GTK_BROWSER_GET_PRIVATE (me)->views,
+                             (GFunc) g_object_unref, NULL);
+        g_ptr_array_set_size (YTV_GTK_BROWSER_GET_PRIVATE (me)->views, 0);
+
+        return;
+}
+
+static void
+ytv_gtk_browser_finalize (GObject* object)
+{
+        YtvGtkBrowserPriv* priv;
+
+        priv = YTV_GTK_BROWSER_GET_PRIVATE (object);
+
+        g_ptr_array_free (priv->views, TRUE);
+        g_hash_table_destroy (priv->ids);
+
+        (*G_OBJECT_CLASS (ytv_gtk_browser_parent_class)->finalize) (object);
+
         return;
 }
 
@@ -442,6 +1153,7 @@ ytv_gtk_browser_class_init (YtvGtkBrowserClass* klass)
         object_class->get_property = ytv_gtk_browser_get_property;
         object_class->set_property = ytv_gtk_browser_set_property;
         object_class->dispose      = ytv_gtk_browser_dispose;
+        object_class->finalize     = ytv_gtk_browser_finalize;
 
         klass->fetch_entries = ytv_gtk_browser_fetch_entries_default;
         klass->next_page     = ytv_gtk_browser_next_page_default;
@@ -450,6 +1162,7 @@ ytv_gtk_browser_class_init (YtvGtkBrowserClass* klass)
         klass->get_feed      = ytv_gtk_browser_get_feed_default;
         klass->get_focused_entry_view = ytv_gtk_browser_get_focused_entry_view_default;
         klass->clean         = ytv_gtk_browser_clean_default;
+        klass->refresh       = ytv_gtk_browser_refresh_default;
         
         g_object_class_install_property
                 (object_class, PROP_ORIENTATION,
@@ -465,6 +1178,20 @@ ytv_gtk_browser_class_init (YtvGtkBrowserClass* klass)
                                    "Number of entries per page",
                                    0, 25, 5, G_PARAM_READWRITE));
 
+        g_object_class_install_property
+                (object_class, PROP_RECYCLE,
+                 g_param_spec_boolean
+                 ("recycle", "recycle", "Keep the entry views between pages "
+                  "and rebind them instead of building new ones",
+                  FALSE, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (object_class, PROP_INCREMENTAL,
+                 g_param_spec_boolean
+                 ("incremental", "incremental", "Show the entries of a page "
+                  "in short idle slices instead of all at once",
+                  FALSE, G_PARAM_READWRITE));
+
         return;
 }
 
@@ -480,6 +1207,15 @@ ytv_gtk_browser_init (YtvGtkBrowser* self)
         priv->start_idx   = 0;
         priv->last_page   = FALSE;
         priv->wid_pos     = 0;
+        priv->recycle     = FALSE;
+        priv->views       = g_ptr_array_sized_new (5);
+        priv->ids         = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                   g_free, NULL);
+        priv->incremental = FALSE;
+        priv->populate_id = 0;
+        priv->populate_list = NULL;
+        priv->populate_iter = NULL;
+        priv->populate_start = 0;
 
         self->feed = NULL;
         
@@ -574,3 +1310,20 @@ ytv_gtk_browser_clean (YtvBrowser* self)
 
         return;
 }
+
+/**
+ * ytv_gtk_browser_refresh:
+ * @self: (not-null): a #YtvGtkBrowser
+ *
+ * Fetches again the shown page, patching only the entry views whose entry
+ * was added, removed or changed, instead of rebuilding all of them.
+ */
+void
+ytv_gtk_browser_refresh (YtvGtkBrowser* self)
+{
+        g_assert (YTV_IS_GTK_BROWSER (self));
+
+        YTV_GTK_BROWSER_GET_CLASS (self)->refresh (self);
+
+        return;
+}
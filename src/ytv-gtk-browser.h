@@ -70,6 +70,7 @@ struct _YtvGtkBrowserClass
         YtvFeed* (*get_feed) (YtvBrowser* self);
         YtvEntryView* (*get_focused_entry_view) (YtvBrowser* self);
         void (*clean) (YtvBrowser* self);        
+        void (*refresh) (YtvGtkBrowser* self);
 };
 
 GType ytv_gtk_browser_get_type (void);
@@ -83,6 +84,7 @@ void ytv_gtk_browser_set_feed (YtvBrowser* self, YtvFeed* feed);
 YtvFeed* ytv_gtk_browser_get_feed (YtvBrowser* self);
 YtvEntryView* ytv_gtk_browser_get_focused_entry_view (YtvBrowser* self);
 void ytv_gtk_browser_clean (YtvBrowser* self);
+void ytv_gtk_browser_refresh (YtvGtkBrowser* self);
 
 G_END_DECLS
 
@@ -26,13 +26,16 @@
 #include <ytv-thumbnail.h>
 #include <ytv-rank.h>
 #include <ytv-entry-text-view.h>
+#include <ytv-entry-text-area.h>
 
 #include <ytv-entry.h>
+#include <ytv-trace.h>
 
 enum _YtvGtkEntryViewProp
 {
         PROP_0,
-        PROP_ORIENTATION
+        PROP_ORIENTATION,
+        PROP_TEXT_AREA
 };
 
 typedef struct _YtvGtkEntryViewPriv YtvGtkEntryViewPriv;
@@ -41,6 +44,7 @@ struct _YtvGtkEntryViewPriv
         YtvOrientation orientation;
         GtkWidget* text;
         GtkWidget* thumb;
+        gboolean text_area;
 };
 
 #define YTV_GTK_ENTRY_VIEW_GET_PRIVATE(obj) \
@@ -64,7 +68,7 @@ thumb_clicked_cb (YtvThumbnail* thumb, gpointer user_data)
 }
 
 static void
-link_clicked_cb (YtvEntryTextView* text_view,
+link_clicked_cb (GtkWidget* text,
                  const gchar* class, const gchar* param, gpointer user_data)
 {
         YtvGtkEntryView* self = (YtvGtkEntryView*) user_data;
@@ -105,33 +109,72 @@ G_DEFINE_TYPE_EXTENDED (YtvGtkEntryView, ytv_gtk_entry_view, GTK_TYPE_TABLE, 0,
                                                ytv_entry_view_init))
 
 static void
-resize (YtvGtkEntryView* self)
+attach_text (YtvGtkEntryView* self)
 {
         YtvGtkEntryViewPriv* priv;
 
         priv = YTV_GTK_ENTRY_VIEW_GET_PRIVATE (self);
 
-        /** TODO **/
         if (priv->orientation == YTV_ORIENTATION_VERTICAL)
         {
-                gtk_table_resize (GTK_TABLE (self), 1, 2);
                 gtk_table_attach_defaults (GTK_TABLE (self), priv->text,
                                            0, 1, 1, 2);
         }
         else if (priv->orientation == YTV_ORIENTATION_HORIZONTAL)
         {
-                gtk_table_resize (GTK_TABLE (self), 2, 1);
                 gtk_table_attach_defaults (GTK_TABLE (self), priv->text,
                                            1, 2, 0, 1);
         }
+
+        return;
+}
+
+static void
+resize (YtvGtkEntryView* self)
+{
+        YtvGtkEntryViewPriv* priv;
+
+        priv = YTV_GTK_ENTRY_VIEW_GET_PRIVATE (self);
+
+        /** TODO **/
+        if (priv->orientation == YTV_ORIENTATION_VERTICAL)
+        {
+                gtk_table_resize (GTK_TABLE (self), 1, 2);
+        }
+        else if (priv->orientation == YTV_ORIENTATION_HORIZONTAL)
+        {
+                gtk_table_resize (GTK_TABLE (self), 2, 1);
+        }
         else
         {
                 g_return_if_reached ();
         }
 
+        attach_text (self);
+
         return;
 }
 
+static GtkWidget*
+create_text (YtvGtkEntryView* self, gboolean text_area)
+{
+        GtkWidget* text;
+
+        if (text_area)
+        {
+                text = ytv_entry_text_area_new ();
+        }
+        else
+        {
+                text = ytv_entry_text_view_new ();
+        }
+
+        g_signal_connect (text, "link-clicked",
+                          G_CALLBACK (link_clicked_cb), self);
+
+        return text;
+}
+
 static void
 update_widget (YtvGtkEntryView* self)
 {
@@ -142,6 +185,8 @@ update_widget (YtvGtkEntryView* self)
 
         priv = YTV_GTK_ENTRY_VIEW_GET_PRIVATE (self);
 
+        YTV_TRACE_BEGIN ("entry-view", "update_widget");
+
         g_object_get (G_OBJECT (self->entry), "id", &id, NULL);
 
         if (id != NULL)
@@ -151,8 +196,18 @@ update_widget (YtvGtkEntryView* self)
         }
 
         /* g_object_set (G_OBJECT (priv->text), "entry", self->entry, NULL); */
-        ytv_entry_text_view_set_entry (YTV_ENTRY_TEXT_VIEW (priv->text),
-                                       self->entry);
+        if (priv->text_area)
+        {
+                ytv_entry_text_area_set_entry
+                        (YTV_ENTRY_TEXT_AREA (priv->text), self->entry);
+        }
+        else
+        {
+                ytv_entry_text_view_set_entry
+                        (YTV_ENTRY_TEXT_VIEW (priv->text), self->entry);
+        }
+
+        YTV_TRACE_END ("entry-view", "update_widget");
 
         return;
 }
@@ -269,7 +324,15 @@ ytv_gtk_entry_view_clean_default (YtvEntryView* self)
         priv = YTV_GTK_ENTRY_VIEW_GET_PRIVATE (self);
 
         ytv_thumbnail_clean (YTV_THUMBNAIL (priv->thumb));
-        ytv_entry_text_view_clean (YTV_ENTRY_TEXT_VIEW (priv->text));
+
+        if (priv->text_area)
+        {
+                ytv_entry_text_area_clean (YTV_ENTRY_TEXT_AREA (priv->text));
+        }
+        else
+        {
+                ytv_entry_text_view_clean (YTV_ENTRY_TEXT_VIEW (priv->text));
+        }
 
         return;
 }
@@ -287,6 +350,9 @@ ytv_gtk_entry_view_get_property (GObject* object, guint prop_id,
         case PROP_ORIENTATION:
                 g_value_set_enum (value, priv->orientation);
                 break;
+        case PROP_TEXT_AREA:
+                g_value_set_boolean (value, priv->text_area);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -305,6 +371,10 @@ ytv_gtk_entry_view_set_property (GObject* object, guint prop_id,
                 ytv_gtk_entry_view_set_orientation (YTV_GTK_ENTRY_VIEW (object),
                                                     g_value_get_enum (value));
                 break;
+        case PROP_TEXT_AREA:
+                ytv_gtk_entry_view_set_text_area (YTV_GTK_ENTRY_VIEW (object),
+                                                  g_value_get_boolean (value));
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -364,6 +434,13 @@ ytv_gtk_entry_view_class_init (YtvGtkEntryViewClass* klass)
                   YTV_TYPE_ORIENTATION, YTV_ORIENTATION_UNDEF,
                   G_PARAM_READWRITE));
 
+        g_object_class_install_property
+                (object_class, PROP_TEXT_AREA,
+                 g_param_spec_boolean
+                 ("text-area", "Text area",
+                  "Show the text with the light weight, custom drawn, widget",
+                  FALSE, G_PARAM_READWRITE));
+
         return;
 }
 
@@ -381,10 +458,8 @@ ytv_gtk_entry_view_init (YtvGtkEntryView* self)
         g_signal_connect (priv->thumb, "clicked",
                           G_CALLBACK (thumb_clicked_cb), self);
         
-        priv->text        = ytv_entry_text_view_new ();
-
-        g_signal_connect (priv->text, "link-clicked",
-                          G_CALLBACK (link_clicked_cb), self);
+        priv->text_area   = FALSE;
+        priv->text        = create_text (self, priv->text_area);
 
         self->entry = NULL;
 
@@ -487,6 +562,78 @@ ytv_gtk_entry_view_set_orientation (YtvGtkEntryView* self,
         return;
 }
 
+/**
+ * ytv_gtk_entry_view_set_text_area:
+ * @self: (not-null): a #YtvGtkEntryView
+ * @text_area: whether to use #YtvEntryTextArea
+ *
+ * Chooses the widget for the entry text: the custom drawn #YtvEntryTextArea
+ * if @text_area is %TRUE, or the #YtvEntryTextView otherwise. The former
+ * is much cheaper to create and to update with a new entry.
+ */
+void
+ytv_gtk_entry_view_set_text_area (YtvGtkEntryView* self, gboolean text_area)
+{
+        YtvGtkEntryViewPriv* priv;
+        GtkWidget* old;
+        gboolean visible;
+
+        g_return_if_fail (self != NULL);
+
+        priv = YTV_GTK_ENTRY_VIEW_GET_PRIVATE (self);
+
+        if (text_area == priv->text_area)
+        {
+                return;
+        }
+
+        old = g_object_ref_sink (priv->text);
+        visible = GTK_WIDGET_VISIBLE (old);
+
+        priv->text_area = text_area;
+        priv->text = create_text (self, text_area);
+
+        if (old->parent != NULL)
+        {
+                attach_text (self);
+        }
+
+        gtk_widget_destroy (old);
+        g_object_unref (old);
+
+        if (self->entry != NULL)
+        {
+                update_widget (self);
+        }
+
+        if (visible)
+        {
+                gtk_widget_show (priv->text);
+        }
+
+        g_object_notify (G_OBJECT (self), "text-area");
+
+        return;
+}
+
+/**
+ * ytv_gtk_entry_view_get_text_area:
+ * @self: (not-null): a #YtvGtkEntryView
+ *
+ * returns: %TRUE if the entry text is shown by a #YtvEntryTextArea
+ */
+gboolean
+ytv_gtk_entry_view_get_text_area (YtvGtkEntryView* self)
+{
+        YtvGtkEntryViewPriv* priv;
+
+        g_return_val_if_fail (self != NULL, FALSE);
+
+        priv = YTV_GTK_ENTRY_VIEW_GET_PRIVATE (self);
+
+        return priv->text_area;
+}
+
 /**
  * ytv_gtk_entry_view_get_orientation:
  * @self: (not-null): a #YtvGtkEntryView
@@ -95,6 +95,10 @@ void ytv_gtk_entry_view_set_orientation (YtvGtkEntryView* self,
                                          YtvOrientation orientation);
 YtvOrientation ytv_gtk_entry_view_get_orientation (YtvGtkEntryView* self);
 
+void ytv_gtk_entry_view_set_text_area (YtvGtkEntryView* self,
+                                       gboolean text_area);
+gboolean ytv_gtk_entry_view_get_text_area (YtvGtkEntryView* self);
+
 void ytv_gtk_entry_view_set_fetch_strategy (YtvEntryView* self,
                                             YtvFeedFetchStrategy* st);
 YtvFeedFetchStrategy* ytv_gtk_entry_view_get_fetch_strategy (YtvEntryView* self);
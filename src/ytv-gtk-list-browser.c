@@ -0,0 +1,915 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-gtk-list-browser.c - A scrolling browser with virtualized rows
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-gtk-list-browser
+ * @short_description: a #YtvBrowser for very long feeds
+ *
+ * The #YtvGtkListBrowser shows the entries of a feed as a scrolling list
+ * of fixed height rows. The entries are kept, but only the rows in, or
+ * close to, the viewport have a #YtvGtkEntryView bound; the views are
+ * recycled as the list scrolls, so the number of widgets does not depend
+ * on the number of entries.
+ *
+ * The pages of the feed are requested when the viewport gets close to the
+ * end of the loaded entries, until the feed runs out of them.
+ *
+ * It is meant to be added directly into a #GtkScrolledWindow.
+ */
+
+#include <ytv-gtk-list-browser.h>
+#include <ytv-error.h>
+#include <ytv-list.h>
+#include <ytv-iterator.h>
+#include <ytv-entry.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
+
+#include <gtk/gtk.h>
+
+enum _YtvGtkListBrowserProp
+{
+        PROP_0,
+        PROP_ROW_HEIGHT,
+        PROP_PAGE_SIZE
+};
+
+typedef struct _YtvListRow YtvListRow;
+
+struct _YtvListRow
+{
+        GtkWidget* view;
+        gint index; /* of the bound entry, -1 if free */
+};
+
+typedef struct _YtvGtkListBrowserPriv YtvGtkListBrowserPriv;
+
+struct _YtvGtkListBrowserPriv
+{
+        gint row_height;
+        gint row_width;
+        gint page_size;
+
+        GPtrArray* entries;   /* all the loaded YtvEntry */
+        GPtrArray* rows;      /* YtvListRow pool */
+        GtkAdjustment* vadj;
+
+        gboolean fetching;
+        gboolean last_page;
+        guint serial;         /* discards the pages of a cleared list */
+};
+
+typedef struct _YtvListRequest YtvListRequest;
+
+struct _YtvListRequest
+{
+        YtvGtkListBrowser* self;
+        guint serial;
+};
+
+#define YTV_GTK_LIST_BROWSER_GET_PRIVATE(obj)  \
+        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_GTK_LIST_BROWSER, YtvGtkListBrowserPriv))
+
+/* rows bound beyond each edge of the viewport */
+#define OVERSCAN 2
+/* rows from the end of the loaded entries which trigger the next page */
+#define PREFETCH 10
+
+static void
+ytv_browser_init (YtvBrowserIface* iface)
+{
+        iface->fetch_entries = ytv_gtk_list_browser_fetch_entries;
+        iface->next_page     = ytv_gtk_list_browser_next_page;
+        iface->prev_page     = ytv_gtk_list_browser_prev_page;
+        iface->set_feed      = ytv_gtk_list_browser_set_feed;
+        iface->get_feed      = ytv_gtk_list_browser_get_feed;
+        iface->get_focused_entry_view =
+                ytv_gtk_list_browser_get_focused_entry_view;
+        iface->clean         = ytv_gtk_list_browser_clean;
+
+        return;
+}
+
+G_DEFINE_TYPE_EXTENDED (YtvGtkListBrowser, ytv_gtk_list_browser,
+                        GTK_TYPE_LAYOUT, 0,
+                        G_IMPLEMENT_INTERFACE (YTV_TYPE_BROWSER,
+                                               ytv_browser_init))
+
+static void update_rows (YtvGtkListBrowser* self);
+static void link_clicked_cb (GtkWidget* widget, const gchar* class,
+                             const gchar* param, gpointer user_data);
+
+static GtkWidget*
+create_entry_view (YtvFeed* feed)
+{
+        YtvFeedFetchStrategy* fetchst;
+        YtvUriBuilder* ub;
+        YtvEntryView* view;
+
+        view = ytv_gtk_entry_view_new (YTV_ORIENTATION_HORIZONTAL);
+        ytv_gtk_entry_view_set_text_area (YTV_GTK_ENTRY_VIEW (view), TRUE);
+
+        fetchst = ytv_feed_get_fetch_strategy (feed);
+        ytv_entry_view_set_fetch_strategy (view, fetchst);
+        g_object_unref (fetchst);
+
+        ub = ytv_feed_get_uri_builder (feed);
+        ytv_entry_view_set_uri_builder (view, ub);
+        g_object_unref (ub);
+
+        gtk_widget_show_all (GTK_WIDGET (view));
+
+        ytv_stats_inc (YTV_STATS_ENTRY_VIEWS);
+
+        return GTK_WIDGET (view);
+}
+
+static void
+update_size (YtvGtkListBrowser* self)
+{
+        YtvGtkListBrowserPriv* priv;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        gtk_layout_set_size (GTK_LAYOUT (self), priv->row_width,
+                             priv->entries->len * priv->row_height);
+
+        return;
+}
+
+/* unbinds the rows and forgets the entries */
+static void
+clear_entries (YtvGtkListBrowser* self)
+{
+        YtvGtkListBrowserPriv* priv;
+        YtvListRow* row;
+        guint i;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        for (i = 0; i < priv->rows->len; i++)
+        {
+                row = g_ptr_array_index (priv->rows, i);
+                row->index = -1;
+                gtk_widget_hide (row->view);
+        }
+
+        g_ptr_array_foreach (priv->entries, (GFunc) g_object_unref, NULL);
+        g_ptr_array_set_size (priv->entries, 0);
+
+        /* the page in flight belongs to the entries just cleared */
+        priv->serial++;
+        priv->fetching = FALSE;
+        priv->last_page = FALSE;
+
+        update_size (self);
+
+        return;
+}
+
+/* forgets the row views, which belong to the current feed */
+static void
+drop_rows (YtvGtkListBrowser* self)
+{
+        YtvGtkListBrowserPriv* priv;
+        YtvListRow* row;
+        guint i;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        for (i = 0; i < priv->rows->len; i++)
+        {
+                row = g_ptr_array_index (priv->rows, i);
+                gtk_widget_destroy (row->view);
+                g_object_unref (row->view);
+                g_slice_free (YtvListRow, row);
+        }
+
+        g_ptr_array_set_size (priv->rows, 0);
+
+        return;
+}
+
+static void
+feed_entries_cb (YtvFeed* feed, gboolean cancelled, YtvList* list,
+                 GError **err, gpointer user_data)
+{
+        YtvListRequest* req;
+        YtvGtkListBrowser* self;
+        YtvGtkListBrowserPriv* priv;
+        YtvIterator* iter;
+        guint before;
+
+        req = (YtvListRequest*) user_data;
+        self = req->self;
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        if (req->serial != priv->serial)
+        {
+                /* cleared meanwhile, a newer page may be in flight */
+                if (*err != NULL)
+                {
+                        g_error_free (*err);
+                        *err = NULL;
+                }
+
+                if (list != NULL)
+                {
+                        g_object_unref (list);
+                }
+
+                goto beach;
+        }
+
+        priv->fetching = FALSE;
+
+        if (*err != NULL)
+        {
+                g_debug ("%s", ytv_error_get_message (*err));
+
+                if (ytv_error_get_code (*err) == YTV_PARSE_ERROR_BAD_FORMAT)
+                {
+                        priv->last_page = TRUE;
+                        g_signal_emit_by_name (self, "last-page");
+                        g_error_free (*err);
+                }
+                else
+                {
+                        g_signal_emit_by_name (self, "error-raised", *err);
+                }
+
+                goto beach;
+        }
+
+        if (list == NULL)
+        {
+                goto beach;
+        }
+
+        YTV_TRACE_BEGIN ("list-browser", "feed_entries_cb");
+
+        before = priv->entries->len;
+
+        iter = ytv_list_create_iterator (list);
+        while (!ytv_iterator_is_done (iter))
+        {
+                /* keeps the reference */
+                g_ptr_array_add (priv->entries, ytv_iterator_get_current (iter));
+                ytv_iterator_next (iter);
+        }
+        g_object_unref (iter);
+        g_object_unref (list);
+
+        ytv_stats_inc (YTV_STATS_PAGES_SHOWN);
+        YTV_TRACE_COUNTER ("list-browser", "entries", priv->entries->len);
+
+        if (before == 0)
+        {
+                g_signal_emit_by_name (self, "first-page");
+        }
+
+        if (priv->entries->len == before)
+        {
+                priv->last_page = TRUE;
+                g_signal_emit_by_name (self, "last-page");
+        }
+
+        update_size (self);
+        update_rows (self);
+
+        YTV_TRACE_END ("list-browser", "feed_entries_cb");
+
+beach:
+        g_object_unref (self); /* taken by fetch_page */
+        g_slice_free (YtvListRequest, req);
+
+        return;
+}
+
+static void
+fetch_page (YtvGtkListBrowser* self)
+{
+        YtvGtkListBrowserPriv* priv;
+        YtvUriBuilder* ub;
+        YtvListRequest* req;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        if (self->feed == NULL || priv->fetching || priv->last_page)
+        {
+                return;
+        }
+
+        /* the first page keeps the URI set by the caller */
+        if (priv->entries->len > 0)
+        {
+                ub = ytv_feed_get_uri_builder (self->feed);
+                g_object_set (G_OBJECT (ub),
+                              "start-index", priv->entries->len + 1,
+                              "max-results", priv->page_size, NULL);
+                g_object_unref (ub);
+        }
+
+        req = g_slice_new (YtvListRequest);
+        req->self = g_object_ref (self);
+        req->serial = priv->serial;
+
+        priv->fetching = TRUE;
+        ytv_feed_get_entries_async (self->feed, feed_entries_cb, req);
+
+        return;
+}
+
+static YtvListRow*
+get_free_row (YtvGtkListBrowser* self)
+{
+        YtvGtkListBrowserPriv* priv;
+        YtvListRow* row;
+        guint i;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        for (i = 0; i < priv->rows->len; i++)
+        {
+                row = g_ptr_array_index (priv->rows, i);
+
+                if (row->index < 0)
+                {
+                        return row;
+                }
+        }
+
+        row = g_slice_new (YtvListRow);
+        row->index = -1;
+        row->view = g_object_ref (create_entry_view (self->feed));
+        g_signal_connect (row->view, "link-clicked",
+                          G_CALLBACK (link_clicked_cb), self);
+        gtk_widget_set_size_request (row->view,
+                                     priv->row_width, priv->row_height);
+        gtk_layout_put (GTK_LAYOUT (self), row->view, 0, 0);
+
+        g_ptr_array_add (priv->rows, row);
+
+        return row;
+}
+
+static gboolean
+is_bound (YtvGtkListBrowser* self, gint index)
+{
+        YtvGtkListBrowserPriv* priv;
+        guint i;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        for (i = 0; i < priv->rows->len; i++)
+        {
+                if (((YtvListRow*) g_ptr_array_index (priv->rows, i))->index
+                    == index)
+                {
+                        return TRUE;
+                }
+        }
+
+        return FALSE;
+}
+
+/* binds the rows of the visible range and releases the others */
+static void
+update_rows (YtvGtkListBrowser* self)
+{
+        YtvGtkListBrowserPriv* priv;
+        YtvListRow* row;
+        gint first, last, i;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        if (priv->vadj == NULL || self->feed == NULL)
+        {
+                return;
+        }
+
+        YTV_TRACE_BEGIN ("list-browser", "update_rows");
+
+        first = (gint) (priv->vadj->value / priv->row_height) - OVERSCAN;
+        last = (gint) ((priv->vadj->value + priv->vadj->page_size) /
+                       priv->row_height) + OVERSCAN;
+
+        first = MAX (first, 0);
+        last = MIN (last, (gint) priv->entries->len - 1);
+
+        for (i = 0; i < (gint) priv->rows->len; i++)
+        {
+                row = g_ptr_array_index (priv->rows, i);
+
+                if (row->index >= 0 && (row->index < first || row->index > last))
+                {
+                        row->index = -1;
+                        gtk_widget_hide (row->view);
+                }
+        }
+
+        for (i = first; i <= last; i++)
+        {
+                if (is_bound (self, i))
+                {
+                        continue;
+                }
+
+                row = get_free_row (self);
+                row->index = i;
+
+                ytv_entry_view_set_entry (YTV_ENTRY_VIEW (row->view),
+                                          g_ptr_array_index (priv->entries, i));
+                gtk_layout_move (GTK_LAYOUT (self), row->view,
+                                 0, i * priv->row_height);
+                gtk_widget_show (row->view);
+        }
+
+        YTV_TRACE_COUNTER ("list-browser", "rows", priv->rows->len);
+        YTV_TRACE_END ("list-browser", "update_rows");
+
+        if (last + PREFETCH >= (gint) priv->entries->len)
+        {
+                fetch_page (self);
+        }
+
+        return;
+}
+
+static void
+value_changed_cb (GtkAdjustment* adj, gpointer user_data)
+{
+        update_rows (YTV_GTK_LIST_BROWSER (user_data));
+
+        return;
+}
+
+static void
+set_scroll_adjustments_cb (GtkLayout* layout, GtkAdjustment* hadj,
+                           GtkAdjustment* vadj, gpointer user_data)
+{
+        YtvGtkListBrowserPriv* priv;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (layout);
+
+        if (priv->vadj != NULL)
+        {
+                g_signal_handlers_disconnect_by_func (priv->vadj,
+                                                      value_changed_cb,
+                                                      layout);
+                g_object_unref (priv->vadj);
+        }
+
+        priv->vadj = gtk_layout_get_vadjustment (layout);
+
+        if (priv->vadj != NULL)
+        {
+                g_object_ref (priv->vadj);
+                g_signal_connect (priv->vadj, "value-changed",
+                                  G_CALLBACK (value_changed_cb), layout);
+        }
+
+        return;
+}
+
+static void
+ytv_gtk_list_browser_size_allocate (GtkWidget* widget,
+                                    GtkAllocation* allocation)
+{
+        YtvGtkListBrowser* self;
+        YtvGtkListBrowserPriv* priv;
+        YtvListRow* row;
+        guint i;
+
+        self = YTV_GTK_LIST_BROWSER (widget);
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        GTK_WIDGET_CLASS (ytv_gtk_list_browser_parent_class)->size_allocate
+                (widget, allocation);
+
+        /* only when it changes, it queues another resize */
+        if (allocation->width != priv->row_width)
+        {
+                priv->row_width = allocation->width;
+
+                for (i = 0; i < priv->rows->len; i++)
+                {
+                        row = g_ptr_array_index (priv->rows, i);
+                        gtk_widget_set_size_request (row->view,
+                                                     priv->row_width,
+                                                     priv->row_height);
+                }
+
+                update_size (self);
+        }
+
+        update_rows (self);
+
+        return;
+}
+
+static void
+link_clicked_cb (GtkWidget* widget,
+                 const gchar* class, const gchar* param, gpointer user_data)
+{
+        YtvGtkListBrowser* self = YTV_GTK_LIST_BROWSER (user_data);
+        YtvUriBuilder* ub;
+
+        ub = ytv_feed_get_uri_builder (self->feed);
+        g_object_set (G_OBJECT (ub), "start-index", 0, NULL);
+        g_object_unref (ub);
+
+        if (g_strrstr (class, "author") != NULL)
+        {
+                ytv_feed_user (self->feed, param);
+        }
+        else if (g_strrstr (class, "category") != NULL)
+        {
+                ytv_feed_keywords (self->feed, param, ""); /* @fixme */
+        }
+        else
+        {
+                return;
+        }
+
+        ytv_gtk_list_browser_fetch_entries (YTV_BROWSER (self));
+
+        return;
+}
+
+static void
+ytv_gtk_list_browser_fetch_entries_default (YtvBrowser* me)
+{
+        YtvGtkListBrowser* self = YTV_GTK_LIST_BROWSER (me);
+        YtvGtkListBrowserPriv* priv;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        clear_entries (self);
+
+        if (priv->vadj != NULL)
+        {
+                gtk_adjustment_set_value (priv->vadj, 0);
+        }
+
+        fetch_page (self);
+
+        return;
+}
+
+static gboolean
+ytv_gtk_list_browser_next_page_default (YtvBrowser* me)
+{
+        YtvGtkListBrowserPriv* priv;
+        gdouble value;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (me);
+
+        if (priv->vadj != NULL)
+        {
+                value = MIN (priv->vadj->value + priv->vadj->page_increment,
+                             priv->vadj->upper - priv->vadj->page_size);
+                gtk_adjustment_set_value (priv->vadj, MAX (value, 0));
+        }
+
+        return priv->last_page;
+}
+
+static gboolean
+ytv_gtk_list_browser_prev_page_default (YtvBrowser* me)
+{
+        YtvGtkListBrowserPriv* priv;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (me);
+
+        if (priv->vadj == NULL)
+        {
+                return TRUE;
+        }
+
+        gtk_adjustment_set_value
+                (priv->vadj,
+                 MAX (priv->vadj->value - priv->vadj->page_increment, 0));
+
+        if (priv->vadj->value <= 0)
+        {
+                g_signal_emit_by_name (me, "first-page");
+                return TRUE;
+        }
+
+        return FALSE;
+}
+
+static void
+ytv_gtk_list_browser_set_feed_default (YtvBrowser* me, YtvFeed* feed)
+{
+        YtvGtkListBrowser* self = YTV_GTK_LIST_BROWSER (me);
+
+        clear_entries (self);
+        drop_rows (self);
+
+        if (self->feed != NULL)
+        {
+                g_object_unref (self->feed);
+        }
+
+        self->feed = g_object_ref (feed);
+
+        return;
+}
+
+static YtvFeed*
+ytv_gtk_list_browser_get_feed_default (YtvBrowser* me)
+{
+        YtvGtkListBrowser* self = YTV_GTK_LIST_BROWSER (me);
+
+        return g_object_ref (self->feed);
+}
+
+static YtvEntryView*
+ytv_gtk_list_browser_get_focused_entry_view_default (YtvBrowser* self)
+{
+        /* @todo */
+        return NULL;
+}
+
+static void
+ytv_gtk_list_browser_clean_default (YtvBrowser* me)
+{
+        clear_entries (YTV_GTK_LIST_BROWSER (me));
+
+        return;
+}
+
+static void
+ytv_gtk_list_browser_get_property (GObject* object, guint prop_id,
+                                   GValue* value, GParamSpec* spec)
+{
+        YtvGtkListBrowserPriv* priv;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_ROW_HEIGHT:
+                g_value_set_int (value, priv->row_height);
+                break;
+        case PROP_PAGE_SIZE:
+                g_value_set_int (value, priv->page_size);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_gtk_list_browser_set_property (GObject* object, guint prop_id,
+                                   const GValue* value, GParamSpec* spec)
+{
+        YtvGtkListBrowserPriv* priv;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_ROW_HEIGHT:
+                priv->row_height = g_value_get_int (value);
+                g_object_notify (object, "row-height");
+                break;
+        case PROP_PAGE_SIZE:
+                priv->page_size = g_value_get_int (value);
+                g_object_notify (object, "page-size");
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_gtk_list_browser_dispose (GObject* object)
+{
+        YtvGtkListBrowser* me;
+        YtvGtkListBrowserPriv* priv;
+        YtvListRow* row;
+        guint i;
+
+        (*G_OBJECT_CLASS (ytv_gtk_list_browser_parent_class)->dispose) (object);
+
+        me = YTV_GTK_LIST_BROWSER (object);
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (object);
+
+        if (me->feed != NULL)
+        {
+                g_object_unref (me->feed);
+                me->feed = NULL;
+        }
+
+        if (priv->vadj != NULL)
+        {
+                g_signal_handlers_disconnect_by_func (priv->vadj,
+                                                      value_changed_cb, me);
+                g_object_unref (priv->vadj);
+                priv->vadj = NULL;
+        }
+
+        /* the views were already destroyed by the container */
+        for (i = 0; i < priv->rows->len; i++)
+        {
+                row = g_ptr_array_index (priv->rows, i);
+                g_object_unref (row->view);
+                g_slice_free (YtvListRow, row);
+        }
+
+        g_ptr_array_set_size (priv->rows, 0);
+
+        g_ptr_array_foreach (priv->entries, (GFunc) g_object_unref, NULL);
+        g_ptr_array_set_size (priv->entries, 0);
+
+        return;
+}
+
+static void
+ytv_gtk_list_browser_finalize (GObject* object)
+{
+        YtvGtkListBrowserPriv* priv;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (object);
+
+        g_ptr_array_free (priv->rows, TRUE);
+        g_ptr_array_free (priv->entries, TRUE);
+
+        (*G_OBJECT_CLASS (ytv_gtk_list_browser_parent_class)->finalize)
+                (object);
+
+        return;
+}
+
+static void
+ytv_gtk_list_browser_class_init (YtvGtkListBrowserClass* klass)
+{
+        GObjectClass* object_class;
+        GtkWidgetClass* widget_class;
+
+        object_class = G_OBJECT_CLASS (klass);
+        widget_class = GTK_WIDGET_CLASS (klass);
+
+        g_type_class_add_private (object_class,
+                                  sizeof (YtvGtkListBrowserPriv));
+
+        object_class->get_property = ytv_gtk_list_browser_get_property;
+        object_class->set_property = ytv_gtk_list_browser_set_property;
+        object_class->dispose      = ytv_gtk_list_browser_dispose;
+        object_class->finalize     = ytv_gtk_list_browser_finalize;
+
+        widget_class->size_allocate = ytv_gtk_list_browser_size_allocate;
+
+        klass->fetch_entries = ytv_gtk_list_browser_fetch_entries_default;
+        klass->next_page     = ytv_gtk_list_browser_next_page_default;
+        klass->prev_page     = ytv_gtk_list_browser_prev_page_default;
+        klass->set_feed      = ytv_gtk_list_browser_set_feed_default;
+        klass->get_feed      = ytv_gtk_list_browser_get_feed_default;
+        klass->get_focused_entry_view =
+                ytv_gtk_list_browser_get_focused_entry_view_default;
+        klass->clean         = ytv_gtk_list_browser_clean_default;
+
+        g_object_class_install_property
+                (object_class, PROP_ROW_HEIGHT,
+                 g_param_spec_int ("row-height", "row_height",
+                                   "Height of every entry row, in pixels",
+                                   16, 1024, 120,
+                                   G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        g_object_class_install_property
+                (object_class, PROP_PAGE_SIZE,
+                 g_param_spec_int ("page-size", "page_size",
+                                   "Number of entries requested each time "
+                                   "the end of the list is reached",
+                                   1, 50, 25,
+                                   G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        return;
+}
+
+static void
+ytv_gtk_list_browser_init (YtvGtkListBrowser* self)
+{
+        YtvGtkListBrowserPriv* priv;
+
+        priv = YTV_GTK_LIST_BROWSER_GET_PRIVATE (self);
+
+        priv->row_height = 120;
+        priv->row_width  = 0;
+        priv->page_size  = 25;
+        priv->entries    = g_ptr_array_sized_new (256);
+        priv->rows       = g_ptr_array_sized_new (16);
+        priv->vadj       = NULL;
+        priv->fetching   = FALSE;
+        priv->serial     = 0;
+        priv->last_page  = FALSE;
+
+        self->feed = NULL;
+
+        g_signal_connect_after (self, "set-scroll-adjustments",
+                                G_CALLBACK (set_scroll_adjustments_cb), NULL);
+
+        return;
+}
+
+/**
+ * ytv_gtk_list_browser_new:
+ *
+ * returns: (not-null): a new scrolling #YtvBrowser
+ */
+YtvBrowser*
+ytv_gtk_list_browser_new (void)
+{
+        return g_object_new (YTV_TYPE_GTK_LIST_BROWSER, NULL);
+}
+
+void
+ytv_gtk_list_browser_fetch_entries (YtvBrowser* self)
+{
+        g_assert (YTV_IS_GTK_LIST_BROWSER (self));
+
+        YTV_GTK_LIST_BROWSER_GET_CLASS (self)->fetch_entries (self);
+
+        return;
+}
+
+gboolean
+ytv_gtk_list_browser_next_page (YtvBrowser* self)
+{
+        g_assert (YTV_IS_GTK_LIST_BROWSER (self));
+
+        return YTV_GTK_LIST_BROWSER_GET_CLASS (self)->next_page (self);
+}
+
+gboolean
+ytv_gtk_list_browser_prev_page (YtvBrowser* self)
+{
+        g_assert (YTV_IS_GTK_LIST_BROWSER (self));
+
+        return YTV_GTK_LIST_BROWSER_GET_CLASS (self)->prev_page (self);
+}
+
+void
+ytv_gtk_list_browser_set_feed (YtvBrowser* self, YtvFeed* feed)
+{
+        g_assert (YTV_IS_GTK_LIST_BROWSER (self));
+        g_assert (feed != NULL);
+
+        YTV_GTK_LIST_BROWSER_GET_CLASS (self)->set_feed (self, feed);
+
+        return;
+}
+
+YtvFeed*
+ytv_gtk_list_browser_get_feed (YtvBrowser* self)
+{
+        g_assert (YTV_IS_GTK_LIST_BROWSER (self));
+
+        return YTV_GTK_LIST_BROWSER_GET_CLASS (self)->get_feed (self);
+}
+
+YtvEntryView*
+ytv_gtk_list_browser_get_focused_entry_view (YtvBrowser* self)
+{
+        g_assert (YTV_IS_GTK_LIST_BROWSER (self));
+
+        return YTV_GTK_LIST_BROWSER_GET_CLASS (self)->get_focused_entry_view
+                (self);
+}
+
+void
+ytv_gtk_list_browser_clean (YtvBrowser* self)
+{
+        g_assert (YTV_IS_GTK_LIST_BROWSER (self));
+
+        YTV_GTK_LIST_BROWSER_GET_CLASS (self)->clean (self);
+
+        return;
+}
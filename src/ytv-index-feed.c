@@ -0,0 +1,464 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-index-feed.c - A feed which searches the indexed entries
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-index-feed
+ * @title: YtvIndexFeed
+ * @short_description: searches the already fetched entries
+ *
+ * The #YtvIndexFeed answers ytv_feed_search() with the entries of a
+ * #YtvEntryIndex, without going to the network, so it can be used
+ * offline or while the remote search is on its way. The entries are
+ * delivered from within ytv_feed_get_entries_async(), sorted by the
+ * #YtvIndexFeed:order property.
+ *
+ * The page to deliver is set with the #YtvIndexFeed:start-index and
+ * #YtvIndexFeed:max-results properties. The other queries are not
+ * supported: the index only knows about words.
+ */
+
+/**
+ * YtvIndexFeed:
+ *
+ * A #YtvFeed which answers the searches from a #YtvEntryIndex
+ *
+ * free-function: g_object_unref
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <ytv-index-feed.h>
+
+#include <ytv-feed-fetch-strategy.h>
+#include <ytv-feed-parse-strategy.h>
+#include <ytv-list.h>
+#include <ytv-uri-builder.h>
+
+enum _YtvIndexFeedProp
+{
+        PROP_0,
+        PROP_INDEX,
+        PROP_QUERY,
+        PROP_ORDER,
+        PROP_START_INDEX,
+        PROP_MAX_RESULTS
+};
+
+typedef struct _YtvIndexFeedPriv YtvIndexFeedPriv;
+
+struct _YtvIndexFeedPriv
+{
+        YtvFeedFetchStrategy* fetchst;
+        YtvFeedParseStrategy* parsest;
+        YtvUriBuilder* uribuild;
+
+        YtvEntryIndex* index;
+        gchar* query;
+
+        YtvEntryIndexOrder order;
+        gint start_index;         /* of the page, from zero */
+        gint max_results;
+};
+
+#define YTV_INDEX_FEED_GET_PRIVATE(obj)         \
+        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_INDEX_FEED, YtvIndexFeedPriv))
+
+#define DEFAULT_MAX_RESULTS 25
+
+static void ytv_feed_init (YtvFeedIface* klass);
+
+G_DEFINE_TYPE_EXTENDED (YtvIndexFeed, ytv_index_feed,
+                        G_TYPE_OBJECT, 0,
+                        G_IMPLEMENT_INTERFACE (YTV_TYPE_FEED,
+                                               ytv_feed_init))
+
+static YtvFeedFetchStrategy*
+ytv_index_feed_get_fetch_strategy (YtvFeed* self)
+{
+        YtvIndexFeedPriv* priv = YTV_INDEX_FEED_GET_PRIVATE (self);
+
+        return priv->fetchst != NULL ? g_object_ref (priv->fetchst) : NULL;
+}
+
+static void
+ytv_index_feed_set_fetch_strategy (YtvFeed* self, YtvFeedFetchStrategy* st)
+{
+        YtvIndexFeedPriv* priv = YTV_INDEX_FEED_GET_PRIVATE (self);
+
+        if (priv->fetchst != NULL)
+        {
+                g_object_unref (priv->fetchst);
+        }
+
+        priv->fetchst = g_object_ref (st);
+
+        return;
+}
+
+static YtvFeedParseStrategy*
+ytv_index_feed_get_parse_strategy (YtvFeed* self)
+{
+        YtvIndexFeedPriv* priv = YTV_INDEX_FEED_GET_PRIVATE (self);
+
+        return priv->parsest != NULL ? g_object_ref (priv->parsest) : NULL;
+}
+
+static void
+ytv_index_feed_set_parse_strategy (YtvFeed* self, YtvFeedParseStrategy* st)
+{
+        YtvIndexFeedPriv* priv = YTV_INDEX_FEED_GET_PRIVATE (self);
+
+        if (priv->parsest != NULL)
+        {
+                g_object_unref (priv->parsest);
+        }
+
+        priv->parsest = g_object_ref (st);
+
+        return;
+}
+
+static YtvUriBuilder*
+ytv_index_feed_get_uri_builder (YtvFeed* self)
+{
+        YtvIndexFeedPriv* priv = YTV_INDEX_FEED_GET_PRIVATE (self);
+
+        return priv->uribuild != NULL ? g_object_ref (priv->uribuild) : NULL;
+}
+
+static void
+ytv_index_feed_set_uri_builder (YtvFeed* self, YtvUriBuilder* ub)
+{
+        YtvIndexFeedPriv* priv = YTV_INDEX_FEED_GET_PRIVATE (self);
+
+        if (priv->uribuild != NULL)
+        {
+                g_object_unref (priv->uribuild);
+        }
+
+        priv->uribuild = g_object_ref (ub);
+
+        return;
+}
+
+static void
+ytv_index_feed_standard (YtvFeed* self, guint type)
+{
+        g_warning ("An index feed only answers searches");
+
+        return;
+}
+
+static void
+ytv_index_feed_search (YtvFeed* self, const gchar* query)
+{
+        YtvIndexFeedPriv* priv = YTV_INDEX_FEED_GET_PRIVATE (self);
+
+        g_return_if_fail (query != NULL);
+
+        g_free (priv->query);
+        priv->query = g_strdup (query);
+
+        g_object_notify (G_OBJECT (self), "query");
+
+        return;
+}
+
+static void
+ytv_index_feed_user (YtvFeed* self, const gchar* user)
+{
+        ytv_index_feed_standard (self, 0);
+
+        return;
+}
+
+static void
+ytv_index_feed_keywords (YtvFeed* self, const gchar* category,
+                         const gchar* keywords)
+{
+        ytv_index_feed_standard (self, 0);
+
+        return;
+}
+
+static void
+ytv_index_feed_related (YtvFeed* self, const gchar* vid)
+{
+        ytv_index_feed_standard (self, 0);
+
+        return;
+}
+
+static void
+ytv_index_feed_get_entries_async (YtvFeed* self,
+                                  YtvGetEntriesCallback callback,
+                                  gpointer user_data)
+{
+        YtvIndexFeedPriv* priv;
+        YtvList* list;
+        GError* err = NULL;
+
+        priv = YTV_INDEX_FEED_GET_PRIVATE (self);
+
+        g_return_if_fail (callback != NULL);
+        g_return_if_fail (priv->query != NULL);
+
+        list = ytv_entry_index_search (priv->index, priv->query, priv->order,
+                                       priv->start_index, priv->max_results);
+
+        callback (self, FALSE, list, &err, user_data);
+
+        return;
+}
+
+/* the index may have grown since the last search */
+static void
+ytv_index_feed_refresh (YtvFeed* self, YtvGetEntriesCallback callback,
+                        gpointer user_data)
+{
+        ytv_index_feed_get_entries_async (self, callback, user_data);
+
+        return;
+}
+
+static void
+ytv_feed_init (YtvFeedIface* klass)
+{
+        klass->get_fetch_strategy = ytv_index_feed_get_fetch_strategy;
+        klass->set_fetch_strategy = ytv_index_feed_set_fetch_strategy;
+        klass->get_parse_strategy = ytv_index_feed_get_parse_strategy;
+        klass->set_parse_strategy = ytv_index_feed_set_parse_strategy;
+        klass->get_uri_builder = ytv_index_feed_get_uri_builder;
+        klass->set_uri_builder = ytv_index_feed_set_uri_builder;
+
+        klass->standard = ytv_index_feed_standard;
+        klass->search = ytv_index_feed_search;
+        klass->user = ytv_index_feed_user;
+        klass->keywords = ytv_index_feed_keywords;
+        klass->related = ytv_index_feed_related;
+
+        klass->get_entries_async = ytv_index_feed_get_entries_async;
+        klass->refresh = ytv_index_feed_refresh;
+
+        return;
+}
+
+static void
+ytv_index_feed_set_property (GObject* object, guint prop_id,
+                             const GValue* value, GParamSpec* spec)
+{
+        YtvIndexFeedPriv* priv;
+
+        priv = YTV_INDEX_FEED_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_INDEX:
+                priv->index = g_value_dup_object (value);
+                break;
+        case PROP_ORDER:
+                priv->order = g_value_get_enum (value);
+                break;
+        case PROP_START_INDEX:
+                priv->start_index = g_value_get_int (value);
+                break;
+        case PROP_MAX_RESULTS:
+                priv->max_results = g_value_get_int (value);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_index_feed_get_property (GObject* object, guint prop_id,
+                             GValue* value, GParamSpec* spec)
+{
+        YtvIndexFeedPriv* priv;
+
+        priv = YTV_INDEX_FEED_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_INDEX:
+                g_value_set_object (value, priv->index);
+                break;
+        case PROP_QUERY:
+                g_value_set_string (value, priv->query);
+                break;
+        case PROP_ORDER:
+                g_value_set_enum (value, priv->order);
+                break;
+        case PROP_START_INDEX:
+                g_value_set_int (value, priv->start_index);
+                break;
+        case PROP_MAX_RESULTS:
+                g_value_set_int (value, priv->max_results);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_index_feed_dispose (GObject* object)
+{
+        YtvIndexFeedPriv* priv;
+
+        priv = YTV_INDEX_FEED_GET_PRIVATE (object);
+
+        if (priv->index != NULL)
+        {
+                g_object_unref (priv->index);
+                priv->index = NULL;
+        }
+
+        if (priv->fetchst != NULL)
+        {
+                g_object_unref (priv->fetchst);
+                priv->fetchst = NULL;
+        }
+
+        if (priv->parsest != NULL)
+        {
+                g_object_unref (priv->parsest);
+                priv->parsest = NULL;
+        }
+
+        if (priv->uribuild != NULL)
+        {
+                g_object_unref (priv->uribuild);
+                priv->uribuild = NULL;
+        }
+
+        (*G_OBJECT_CLASS (ytv_index_feed_parent_class)->dispose) (object);
+
+        return;
+}
+
+static void
+ytv_index_feed_finalize (GObject* object)
+{
+        YtvIndexFeedPriv* priv;
+
+        priv = YTV_INDEX_FEED_GET_PRIVATE (object);
+
+        g_free (priv->query);
+
+        (*G_OBJECT_CLASS (ytv_index_feed_parent_class)->finalize) (object);
+
+        return;
+}
+
+static void
+ytv_index_feed_class_init (YtvIndexFeedClass* klass)
+{
+        GObjectClass* g_klass;
+
+        g_klass = G_OBJECT_CLASS (klass);
+
+        g_type_class_add_private (g_klass, sizeof (YtvIndexFeedPriv));
+
+        g_klass->set_property = ytv_index_feed_set_property;
+        g_klass->get_property = ytv_index_feed_get_property;
+        g_klass->dispose      = ytv_index_feed_dispose;
+        g_klass->finalize     = ytv_index_feed_finalize;
+
+        g_object_class_install_property
+                (g_klass, PROP_INDEX,
+                 g_param_spec_object
+                 ("index", "index", "The index which answers the searches",
+                  YTV_TYPE_ENTRY_INDEX,
+                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+        g_object_class_install_property
+                (g_klass, PROP_QUERY,
+                 g_param_spec_string
+                 ("query", "query", "The words to search", NULL,
+                  G_PARAM_READABLE));
+
+        g_object_class_install_property
+                (g_klass, PROP_ORDER,
+                 g_param_spec_enum
+                 ("order", "order", "How the matching entries are sorted",
+                  YTV_TYPE_ENTRY_INDEX_ORDER, YTV_ENTRY_INDEX_ORDER_VIEWCOUNT,
+                  G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (g_klass, PROP_START_INDEX,
+                 g_param_spec_int
+                 ("start-index", "startindex",
+                  "Position of the first matching entry of the page, "
+                  "from zero", 0, G_MAXINT, 0, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (g_klass, PROP_MAX_RESULTS,
+                 g_param_spec_int
+                 ("max-results", "maxresults",
+                  "The number of matching entries of a page", 1, G_MAXINT,
+                  DEFAULT_MAX_RESULTS, G_PARAM_READWRITE));
+
+        return;
+}
+
+static void
+ytv_index_feed_init (YtvIndexFeed* self)
+{
+        YtvIndexFeedPriv* priv;
+
+        priv = YTV_INDEX_FEED_GET_PRIVATE (self);
+
+        priv->fetchst     = NULL;
+        priv->parsest     = NULL;
+        priv->uribuild    = NULL;
+        priv->index       = NULL;
+        priv->query       = NULL;
+        priv->order       = YTV_ENTRY_INDEX_ORDER_VIEWCOUNT;
+        priv->start_index = 0;
+        priv->max_results = DEFAULT_MAX_RESULTS;
+
+        return;
+}
+
+/**
+ * ytv_index_feed_new:
+ * @index: (not-null): the #YtvEntryIndex to search
+ *
+ * Creates a feed which answers the searches with the entries of @index.
+ *
+ * returns: (not-null) (caller-owns): a new #YtvIndexFeed
+ */
+YtvFeed*
+ytv_index_feed_new (YtvEntryIndex* index)
+{
+        g_assert (YTV_IS_ENTRY_INDEX (index));
+
+        return YTV_FEED (g_object_new (YTV_TYPE_INDEX_FEED,
+                                       "index", index, NULL));
+}
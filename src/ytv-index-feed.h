@@ -0,0 +1,69 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_INDEX_FEED_H_
+#define _YTV_INDEX_FEED_H_
+
+/* ytv-index-feed.h - A feed which searches the indexed entries
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib-object.h>
+
+#include <ytv-feed.h>
+#include <ytv-entry-index.h>
+
+G_BEGIN_DECLS
+
+#define YTV_TYPE_INDEX_FEED                     \
+        (ytv_index_feed_get_type ())
+#define YTV_INDEX_FEED(obj)                                             \
+        (G_TYPE_CHECK_INSTANCE_CAST ((obj), YTV_TYPE_INDEX_FEED, YtvIndexFeed))
+#define YTV_INDEX_FEED_CLASS(klass)                                     \
+        (G_TYPE_CHECK_CLASS_CAST ((klass), YTV_TYPE_INDEX_FEED, YtvIndexFeedClass))
+#define YTV_IS_INDEX_FEED(obj)                                          \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), YTV_TYPE_INDEX_FEED))
+#define YTV_IS_INDEX_FEED_CLASS(klass)                                  \
+        (G_TYPE_CHECK_CLASS_TYPE ((klass), YTV_TYPE_INDEX_FEED))
+#define YTV_INDEX_FEED_GET_CLASS(obj)                                   \
+        (G_TYPE_INSTANCE_GET_CLASS ((obj), YTV_TYPE_INDEX_FEED, YtvIndexFeedClass))
+
+typedef struct _YtvIndexFeed YtvIndexFeed;
+typedef struct _YtvIndexFeedClass YtvIndexFeedClass;
+
+/**
+ * YtvIndexFeed:
+ *
+ * A #YtvFeed which answers the searches from a #YtvEntryIndex
+ */
+struct _YtvIndexFeed
+{
+        GObject parent;
+};
+
+struct _YtvIndexFeedClass
+{
+        GObjectClass parent_class;
+};
+
+GType ytv_index_feed_get_type (void);
+
+YtvFeed* ytv_index_feed_new (YtvEntryIndex* index);
+
+G_END_DECLS
+
+#endif /* _YTV_INDEX_FEED_H_ */
@@ -51,6 +51,8 @@
 #include <ytv-json-feed-parse-strategy.h>
 #include <ytv-simple-list.h>
 #include <ytv-list.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
 
 typedef struct _YtvJsonFeedParseStrategyPriv YtvJsonFeedParseStrategyPriv;
 
@@ -58,6 +60,7 @@ struct _YtvJsonFeedParseStrategyPriv
 {
         JsonParser* parser;
         JsonNode* root;
+        gint total_results; /* of the last parsed feed */
 };
 
 #define YTV_JSON_FEED_PARSE_STRATEGY_GET_PRIVATE(o) \
@@ -80,6 +83,14 @@ struct _YtvJsonFeedParseStrategyPriv
 
 #define MIMETYPE "application/json"
 
+/* the elements read by parse_entry (), in the GData partial response
+ * syntax: the links, thumbnails and media contents are left out */
+#define FIELDS                                                  \
+        "openSearch:totalResults,"                              \
+        "entry(id,author(name),title,published,gd:rating,"      \
+        "yt:statistics,media:group(media:category,"             \
+        "media:keywords,media:description,yt:duration))"
+
 #define do_indent(i) { gint z; for (z = 0; z < i; z++) g_print (" ");  }
 
 static void
@@ -538,11 +549,65 @@ get_description (JsonNode* node)
         return retval;
 }
 
+/* extracts openSearch$totalResults, either a number or a string */
+static gint
+get_total_results (JsonNode* node)
+{
+        gint retval;
+        JsonNode* total;
+
+        if (node == NULL || JSON_NODE_TYPE (node) != JSON_NODE_OBJECT)
+        {
+                return -1;
+        }
+
+        retval = -1;
+        total = json_object_get_member (json_node_get_object (node), "$t");
+
+        if (total == NULL || JSON_NODE_TYPE (total) != JSON_NODE_VALUE)
+        {
+                return -1;
+        }
+
+        if (json_node_get_value_type (total) == G_TYPE_STRING)
+        {
+                const gchar* str;
+                gchar* tail;
+
+                str = json_node_get_string (total);
+                errno = 0;
+                retval = strtol (str, &tail, 10);
+                if (errno != 0 || tail == str)
+                {
+                        return -1;
+                }
+        }
+        else
+        {
+                GValue value = { 0, };
+                GValue intval = { 0, };
+
+                json_node_get_value (total, &value);
+                g_value_init (&intval, G_TYPE_INT);
+
+                if (g_value_transform (&value, &intval))
+                {
+                        retval = g_value_get_int (&intval);
+                }
+
+                g_value_unset (&intval);
+                g_value_unset (&value);
+        }
+
+        return retval;
+}
+
 static YtvEntry*
 parse_entry (JsonNode* node)
 {
         YtvEntry* entry;
         JsonObject* obj;
+        JsonNode* group;
 
         gchar* id;
         gchar* authors;
@@ -561,6 +626,13 @@ parse_entry (JsonNode* node)
         entry = NULL;
         obj = json_node_get_object (node);
 
+        /* four of the fields live there: look it up once */
+        group = json_object_get_member (obj, "media$group");
+        if (group == NULL)
+        {
+                return NULL;
+        }
+
         id = get_id (
                 json_object_get_member (obj, "id")
                 );
@@ -573,9 +645,7 @@ parse_entry (JsonNode* node)
                 json_object_get_member (obj, "title")
                 );
         
-        duration = get_duration (
-                json_object_get_member (obj, "media$group")
-                );
+        duration = get_duration (group);
         
         rating = get_rating (
                 json_object_get_member (obj, "gd$rating")
@@ -589,17 +659,11 @@ parse_entry (JsonNode* node)
                 json_object_get_member (obj, "yt$statistics")
                 );
         
-        category = get_category (
-                json_object_get_member (obj,"media$group")
-                );
+        category = get_category (group);
         
-        tags = get_tags (
-                json_object_get_member (obj,"media$group")
-                );
+        tags = get_tags (group);
         
-        description = get_description (
-                json_object_get_member (obj,"media$group")
-                );
+        description = get_description (group);
 
         if (id != NULL && authors != NULL && title != NULL && duration > 0 &&
             rating > -1 && published != NULL && views >= 0 &&
@@ -657,9 +721,10 @@ ytv_json_feed_parse_strategy_perform_default (YtvFeedParseStrategy* self,
                                               const guchar* data, gssize length,
                                               GError **err)
 {
-        GError* tmp_error;
+        GError* tmp_error = NULL;
         JsonParser* parser;
         YtvList* fl;
+        YtvJsonFeedParseStrategyPriv* priv;
         
         JsonNode* root;
         JsonObject* object_root;
@@ -670,12 +735,18 @@ ytv_json_feed_parse_strategy_perform_default (YtvFeedParseStrategy* self,
 
         gint i;
         gint size;
+        YtvStatsTime start;
 
         g_return_val_if_fail (err == NULL || *err == NULL, NULL);
         g_return_val_if_fail (data != NULL, NULL);
         g_return_val_if_fail (length != 0, NULL);
 
         fl = NULL;
+        start = ytv_stats_time_now ();
+        priv = YTV_JSON_FEED_PARSE_STRATEGY_GET_PRIVATE (self);
+        priv->total_results = -1;
+
+        YTV_TRACE_BEGIN ("parse", "json-parse");
         
         parser = json_parser_new ();
 
@@ -697,11 +768,18 @@ ytv_json_feed_parse_strategy_perform_default (YtvFeedParseStrategy* self,
         JSON_GET_NODE (object_root, feed);
         JSON_GET_OBJECT (object_feed, feed);
 
+        /* even the pages past the end announce the total */
+        priv->total_results = get_total_results
+                (json_object_get_member (object_feed,
+                                         "openSearch$totalResults"));
+
         JSON_GET_NODE (object_feed, entry);
 
         entries_arr = json_node_get_array (entry);
         JSON_BAIL (err, entries_arr, "Could not find the entry array");
 
+        YTV_TRACE_BEGIN ("parse", "build-entries");
+
         fl = ytv_simple_list_new (); /* feed list */
         size = json_array_get_length (entries_arr);
         for (i = 0; i < size; i++)
@@ -723,9 +801,27 @@ ytv_json_feed_parse_strategy_perform_default (YtvFeedParseStrategy* self,
 
         g_debug ("number of entries = %d", ytv_list_get_length (fl));
 
+        YTV_TRACE_END ("parse", "build-entries");
+
+        ytv_stats_inc (YTV_STATS_FEEDS_PARSED);
+        ytv_stats_add (YTV_STATS_ENTRIES_PARSED, ytv_list_get_length (fl));
+
+        /* the running total: a counter track plots levels, not deltas */
+        YTV_TRACE_COUNTER ("parse", "entries-parsed",
+                           ytv_stats_get (YTV_STATS_ENTRIES_PARSED));
+
 beach:
         g_object_unref (parser);
 
+        if (err != NULL)
+        {
+                ytv_stats_count_error (*err);
+        }
+
+        ytv_stats_observe_since (YTV_STATS_PARSE_TIME, start);
+
+        YTV_TRACE_END ("parse", "json-parse");
+
         return fl;
 }
 
@@ -735,11 +831,31 @@ ytv_json_feed_parse_strategy_get_mime_default (YtvFeedParseStrategy* self)
         return MIMETYPE;
 }
 
+static gint
+ytv_json_feed_parse_strategy_get_total_results_default
+(YtvFeedParseStrategy* self)
+{
+        YtvJsonFeedParseStrategyPriv* priv;
+
+        priv = YTV_JSON_FEED_PARSE_STRATEGY_GET_PRIVATE (self);
+
+        return priv->total_results;
+}
+
+static const gchar*
+ytv_json_feed_parse_strategy_get_fields_default (YtvFeedParseStrategy* self)
+{
+        return FIELDS;
+}
+
 static void
 ytv_feed_parse_strategy_init (YtvFeedParseStrategyIface* klass)
 {
         klass->perform = ytv_json_feed_parse_strategy_perform;
         klass->get_mime = ytv_json_feed_parse_strategy_get_mime;
+        klass->get_total_results =
+                ytv_json_feed_parse_strategy_get_total_results;
+        klass->get_fields = ytv_json_feed_parse_strategy_get_fields;
 
         return;
 }
@@ -752,8 +868,14 @@ G_DEFINE_TYPE_EXTENDED (YtvJsonFeedParseStrategy, ytv_json_feed_parse_strategy,
 static void
 ytv_json_feed_parse_strategy_class_init (YtvJsonFeedParseStrategyClass* klass)
 {
+        g_type_class_add_private (klass,
+                                  sizeof (YtvJsonFeedParseStrategyPriv));
+
         klass->perform = ytv_json_feed_parse_strategy_perform_default;
         klass->get_mime = ytv_json_feed_parse_strategy_get_mime_default;
+        klass->get_total_results =
+                ytv_json_feed_parse_strategy_get_total_results_default;
+        klass->get_fields = ytv_json_feed_parse_strategy_get_fields_default;
 
         return;
 }
@@ -761,6 +883,14 @@ ytv_json_feed_parse_strategy_class_init (YtvJsonFeedParseStrategyClass* klass)
 static void
 ytv_json_feed_parse_strategy_init (YtvJsonFeedParseStrategy* self)
 {
+        YtvJsonFeedParseStrategyPriv* priv;
+
+        priv = YTV_JSON_FEED_PARSE_STRATEGY_GET_PRIVATE (self);
+
+        priv->parser = NULL;
+        priv->root = NULL;
+        priv->total_results = -1;
+
         return;
 }
 
@@ -824,3 +954,41 @@ ytv_json_feed_parse_strategy_get_mime (YtvFeedParseStrategy* self)
 
         return YTV_JSON_FEED_PARSE_STRATEGY_GET_CLASS (self)->get_mime (self);
 }
+
+/**
+ * ytv_json_feed_parse_strategy_get_total_results:
+ * @self: a #YtvFeedParseStrategy implementation instance
+ *
+ * Retrieves the openSearch$totalResults value of the last parsed feed.
+ *
+ * returns: the number of results of the query, or -1 if it is unknown
+ */
+gint
+ytv_json_feed_parse_strategy_get_total_results (YtvFeedParseStrategy* self)
+{
+        g_assert (self != NULL);
+        g_assert (YTV_IS_JSON_FEED_PARSE_STRATEGY (self));
+
+        return YTV_JSON_FEED_PARSE_STRATEGY_GET_CLASS (self)->get_total_results
+                (self);
+}
+
+/**
+ * ytv_json_feed_parse_strategy_get_fields:
+ * @self: a #YtvFeedParseStrategy implementation instance
+ *
+ * Retrieves the partial response expression with the elements of the
+ * feed that this parser reads, so the rest of the feed is not sent.
+ *
+ * returns: (not-null): the fields expression. Do not modify the internal
+ * string.
+ */
+const gchar*
+ytv_json_feed_parse_strategy_get_fields (YtvFeedParseStrategy* self)
+{
+        g_assert (self != NULL);
+        g_assert (YTV_IS_JSON_FEED_PARSE_STRATEGY (self));
+
+        return YTV_JSON_FEED_PARSE_STRATEGY_GET_CLASS (self)->get_fields
+                (self);
+}
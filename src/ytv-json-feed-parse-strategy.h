@@ -55,6 +55,8 @@ struct _YtvJsonFeedParseStrategyClass
         YtvList* (*perform) (YtvFeedParseStrategy* self, const guchar* data,
                              gssize length, GError **err);
         const gchar* (*get_mime) (YtvFeedParseStrategy* self);
+        gint (*get_total_results) (YtvFeedParseStrategy* self);
+        const gchar* (*get_fields) (YtvFeedParseStrategy* self);
 };
 
 GType ytv_json_feed_parse_strategy_get_type (void);
@@ -64,6 +66,10 @@ YtvList* ytv_json_feed_parse_strategy_perform (YtvFeedParseStrategy *self,
                                                const guchar* data,
                                                gssize length, GError **err);
 const gchar* ytv_json_feed_parse_strategy_get_mime (YtvFeedParseStrategy* self);
+gint ytv_json_feed_parse_strategy_get_total_results
+(YtvFeedParseStrategy* self);
+const gchar* ytv_json_feed_parse_strategy_get_fields
+(YtvFeedParseStrategy* self);
 
 G_END_DECLS
 
@@ -0,0 +1,590 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-loadtest.c - concurrent load driver against a local GData server
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Runs N concurrent fetch, parse and list pipelines, each one a
+ * YtvBaseFeed paging through a feed, against a YtvGdataServer running in
+ * its own thread (or against --base-uri), and reports the throughput and
+ * the latency percentiles of the whole run.
+ */
+
+#include <stdlib.h>
+
+#include <ytv-entry.h>
+#include <ytv-list.h>
+#include <ytv-iterator.h>
+#include <ytv-soup-feed-fetch-strategy.h>
+#include <ytv-json-feed-parse-strategy.h>
+#include <ytv-youtube-uri-builder.h>
+#include <ytv-base-feed.h>
+#include <ytv-error.h>
+#include <ytv-stats.h>
+#include <ytv-gdata-server.h>
+
+static gint concurrency = 8;
+static gint requests = 200;
+static gint port = 0;
+static gint latency = 50;
+static gint jitter = 20;
+static gint bandwidth = 0;
+static gdouble error_rate = 0;
+static gdouble corrupt_rate = 0;
+static gint num_entries = 500;
+static gchar* feed_file = NULL;
+static gint max_results = 25;
+static gint seed = 0;
+static gboolean thumbnails = FALSE;
+static gboolean server_only = FALSE;
+static gchar* base_uri = NULL;
+static gchar* thumbnail_uri = NULL;
+
+static const GOptionEntry entries[] =
+{
+        { "concurrency", 'c', 0, G_OPTION_ARG_INT, &concurrency,
+          "number of concurrent feed pipelines (8)", "N" },
+        { "requests", 'n', 0, G_OPTION_ARG_INT, &requests,
+          "total number of feed requests (200)", "N" },
+        { "port", 'p', 0, G_OPTION_ARG_INT, &port,
+          "port of the local server (any)", "PORT" },
+        { "latency", 'l', 0, G_OPTION_ARG_INT, &latency,
+          "server latency (50)", "MS" },
+        { "jitter", 'j', 0, G_OPTION_ARG_INT, &jitter,
+          "server latency jitter (20)", "MS" },
+        { "bandwidth", 'b', 0, G_OPTION_ARG_INT, &bandwidth,
+          "server bytes per second per response (unlimited)", "BPS" },
+        { "error-rate", 'e', 0, G_OPTION_ARG_DOUBLE, &error_rate,
+          "probability of a HTTP 503 (0)", "P" },
+        { "corrupt-rate", 'k', 0, G_OPTION_ARG_DOUBLE, &corrupt_rate,
+          "probability of a truncated response (0)", "P" },
+        { "entries", 'E', 0, G_OPTION_ARG_INT, &num_entries,
+          "number of synthetic entries (500)", "N" },
+        { "feed-file", 'f', 0, G_OPTION_ARG_FILENAME, &feed_file,
+          "serve the entries of a recorded JSON feed", "FILE" },
+        { "max-results", 'm', 0, G_OPTION_ARG_INT, &max_results,
+          "entries per page (25)", "N" },
+        { "seed", 0, 0, G_OPTION_ARG_INT, &seed,
+          "seed of the server randomness (random)", "N" },
+        { "thumbnails", 't', 0, G_OPTION_ARG_NONE, &thumbnails,
+          "also fetch the thumbnail of every entry", NULL },
+        { "server-only", 0, 0, G_OPTION_ARG_NONE, &server_only,
+          "only run the server, until interrupted", NULL },
+        { "base-uri", 0, 0, G_OPTION_ARG_STRING, &base_uri,
+          "drive an external server instead of the local one", "URI" },
+        { "thumbnail-uri", 0, 0, G_OPTION_ARG_STRING, &thumbnail_uri,
+          "thumbnail prefix of the external server", "URI" },
+        { NULL }
+};
+
+typedef struct _Pipeline Pipeline;
+
+struct _Pipeline
+{
+        YtvFeed* feed;
+        YtvFeedFetchStrategy* fetchst;
+        YtvUriBuilder* ub;
+        gint num;
+        gint page;
+        gint pending; /* the page and the thumbnails in flight */
+        YtvStatsTime start;
+};
+
+typedef struct _Run Run;
+
+struct _Run
+{
+        GMainLoop* loop;
+        gint issued;
+        gint completed;
+        gint active;
+        gint errors;
+        gint wraps;
+        gint entries;
+        gint thumbs;
+        GArray* latencies;
+        YtvStatsTime start;
+};
+
+static Run run;
+
+static void pipeline_next (Pipeline* pipe);
+
+static gboolean
+pipeline_next_cb (gpointer user_data)
+{
+        pipeline_next ((Pipeline*) user_data);
+
+        return FALSE;
+}
+
+/* called once for the page and once for each thumbnail: the next request
+ * is scheduled only when the last of them is done, even if a thumbnail
+ * fails while the page is still being walked */
+static void
+pipeline_done (Pipeline* pipe)
+{
+        g_assert (pipe->pending > 0);
+
+        /* the next request is set up from an idle: the feed still owns
+         * its current URI while the callback runs */
+        if (--pipe->pending == 0)
+        {
+                g_idle_add (pipeline_next_cb, pipe);
+        }
+
+        return;
+}
+
+static void
+thumbnail_cb (YtvFeedFetchStrategy* st, const gchar* mime,
+              const gint8* response, gssize length, GError** err,
+              gpointer user_data)
+{
+        Pipeline* pipe;
+
+        pipe = (Pipeline*) user_data;
+
+        if (err != NULL && *err != NULL)
+        {
+                run.errors++;
+                g_error_free (*err);
+                *err = NULL;
+        }
+        else
+        {
+                run.thumbs++;
+        }
+
+        pipeline_done (pipe);
+
+        return;
+}
+
+static void
+fetch_thumbnail (Pipeline* pipe, YtvEntry* entry)
+{
+        gchar* id;
+        gchar* uri;
+
+        g_object_get (G_OBJECT (entry), "id", &id, NULL);
+
+        if (id == NULL)
+        {
+                return;
+        }
+
+        uri = ytv_uri_builder_get_thumbnail (pipe->ub, id);
+        pipe->pending++;
+        ytv_feed_fetch_strategy_perform (pipe->fetchst, uri,
+                                         thumbnail_cb, pipe);
+
+        g_free (uri);
+        g_free (id);
+
+        return;
+}
+
+static void
+feed_entries_cb (YtvFeed* feed, gboolean cancelled, YtvList* list,
+                 GError** err, gpointer user_data)
+{
+        Pipeline* pipe;
+        YtvIterator* iter;
+        gdouble ms;
+
+        pipe = (Pipeline*) user_data;
+
+        ms = (ytv_stats_time_now () - pipe->start) / 1000.0;
+        g_array_append_val (run.latencies, ms);
+        run.completed++;
+
+        if (*err != NULL)
+        {
+                if (g_error_matches (*err, YTV_PARSE_ERROR,
+                                     YTV_PARSE_ERROR_BAD_FORMAT))
+                {
+                        /* past the last page: start again */
+                        run.wraps++;
+                        pipe->page = 0;
+                }
+                else
+                {
+                        g_debug ("%s", ytv_error_get_message (*err));
+                        run.errors++;
+                        pipe->page++;
+                }
+
+                g_error_free (*err);
+                *err = NULL;
+                goto beach;
+        }
+
+        pipe->page++;
+
+        iter = ytv_list_create_iterator (list);
+        while (!ytv_iterator_is_done (iter))
+        {
+                YtvEntry* entry;
+
+                entry = YTV_ENTRY (ytv_iterator_get_current (iter));
+                run.entries++;
+
+                if (thumbnails)
+                {
+                        fetch_thumbnail (pipe, entry);
+                }
+
+                g_object_unref (entry);
+                ytv_iterator_next (iter);
+        }
+        g_object_unref (iter);
+
+beach:
+        if (list != NULL)
+        {
+                g_object_unref (list);
+        }
+
+        pipeline_done (pipe);
+
+        return;
+}
+
+static void
+pipeline_next (Pipeline* pipe)
+{
+        static const gchar* users[] = { "alice", "bob", "carol", "dave" };
+
+        if (run.issued >= requests)
+        {
+                if (--run.active == 0)
+                {
+                        g_main_loop_quit (run.loop);
+                }
+
+                return;
+        }
+
+        run.issued++;
+
+        /* the start index must be set before building the feed URI */
+        g_object_set (G_OBJECT (pipe->ub),
+                      "start-index", pipe->page * max_results + 1, NULL);
+
+        switch (pipe->num % 4)
+        {
+        case 0:
+                ytv_feed_standard (pipe->feed,
+                                   YTV_YOUTUBE_STD_FEED_MOST_VIEWED);
+                break;
+        case 1:
+                ytv_feed_standard (pipe->feed,
+                                   YTV_YOUTUBE_STD_FEED_MOST_RECENT);
+                break;
+        case 2:
+                ytv_feed_search (pipe->feed, "live");
+                break;
+        default:
+                ytv_feed_user (pipe->feed,
+                               users[(pipe->num / 4) % G_N_ELEMENTS (users)]);
+                break;
+        }
+
+        pipe->start = ytv_stats_time_now ();
+        pipe->pending = 1;
+        ytv_feed_get_entries_async (pipe->feed, feed_entries_cb, pipe);
+
+        return;
+}
+
+static Pipeline*
+pipeline_new (gint num, const gchar* feeds, const gchar* thumbs)
+{
+        Pipeline* pipe;
+        YtvFeedParseStrategy* parsest;
+
+        pipe = g_slice_new0 (Pipeline);
+        pipe->num = num;
+
+        pipe->feed = ytv_base_feed_new ();
+        pipe->fetchst = ytv_soup_feed_fetch_strategy_new ();
+        parsest = ytv_json_feed_parse_strategy_new ();
+        pipe->ub = ytv_youtube_uri_builder_new ();
+
+        g_object_set (G_OBJECT (pipe->ub), "max-results", max_results, NULL);
+
+        /* the builder keeps its default prefixes for the missing ones */
+        if (feeds != NULL)
+        {
+                g_object_set (G_OBJECT (pipe->ub), "base-uri", feeds, NULL);
+        }
+
+        if (thumbs != NULL)
+        {
+                g_object_set (G_OBJECT (pipe->ub), "thumbnail-uri", thumbs,
+                              NULL);
+        }
+
+        ytv_feed_set_fetch_strategy (pipe->feed, pipe->fetchst);
+        ytv_feed_set_parse_strategy (pipe->feed, parsest);
+        ytv_feed_set_uri_builder (pipe->feed, pipe->ub);
+
+        g_object_unref (parsest);
+
+        return pipe;
+}
+
+static void
+pipeline_free (Pipeline* pipe)
+{
+        g_object_unref (pipe->feed);
+        g_object_unref (pipe->fetchst);
+        g_object_unref (pipe->ub);
+        g_slice_free (Pipeline, pipe);
+
+        return;
+}
+
+static gint
+compare_double (gconstpointer a, gconstpointer b)
+{
+        gdouble da = *(gdouble*) a;
+        gdouble db = *(gdouble*) b;
+
+        return (da > db) - (da < db);
+}
+
+static gdouble
+percentile (GArray* sorted, gdouble p)
+{
+        guint i;
+
+        if (sorted->len == 0)
+        {
+                return 0;
+        }
+
+        i = (guint) (p * (sorted->len - 1) + 0.5);
+
+        return g_array_index (sorted, gdouble, i);
+}
+
+static void
+report (void)
+{
+        gdouble elapsed;
+
+        elapsed = (ytv_stats_time_now () - run.start) / 1000000.0;
+        g_array_sort (run.latencies, compare_double);
+
+        g_print ("pipelines:   %d\n", concurrency);
+        g_print ("requests:    %d in %.3f s (%.1f req/s)\n",
+                 run.completed, elapsed,
+                 elapsed > 0 ? run.completed / elapsed : 0);
+        g_print ("entries:     %d (%.1f entries/s)\n", run.entries,
+                 elapsed > 0 ? run.entries / elapsed : 0);
+
+        if (thumbnails)
+        {
+                g_print ("thumbnails:  %d\n", run.thumbs);
+        }
+
+        g_print ("errors:      %d (%d wrap-arounds)\n", run.errors, run.wraps);
+        g_print ("latency ms:  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+                 percentile (run.latencies, 0.50),
+                 percentile (run.latencies, 0.90),
+                 percentile (run.latencies, 0.99),
+                 percentile (run.latencies, 1.0));
+
+        return;
+}
+
+static gpointer
+server_thread (gpointer data)
+{
+        GMainLoop* loop;
+
+        loop = (GMainLoop*) data;
+        g_main_loop_run (loop);
+
+        return NULL;
+}
+
+static YtvGdataServer*
+server_create (GMainContext* context, GError** err)
+{
+        YtvGdataServer* server;
+
+        server = ytv_gdata_server_new (context, port);
+
+        g_object_set (G_OBJECT (server),
+                      "latency", latency,
+                      "jitter", jitter,
+                      "bandwidth", bandwidth,
+                      "error-rate", error_rate,
+                      "corrupt-rate", corrupt_rate,
+                      "entries", num_entries,
+                      "feed-file", feed_file,
+                      "seed", seed,
+                      NULL);
+
+        if (!ytv_gdata_server_start (server, err))
+        {
+                g_object_unref (server);
+                return NULL;
+        }
+
+        return server;
+}
+
+gint
+main (gint argc, gchar** argv)
+{
+        GError* error = NULL;
+        GOptionContext* options;
+        YtvGdataServer* server;
+        GMainContext* context;
+        GMainLoop* server_loop;
+        GThread* thread;
+        Pipeline** pipes;
+        gchar* feeds;
+        gchar* thumbs;
+        gint i;
+
+        g_thread_init (NULL);
+        g_type_init ();
+
+        server = NULL;
+        context = NULL;
+        server_loop = NULL;
+        thread = NULL;
+
+        options = g_option_context_new ("- GData load test");
+        g_option_context_add_main_entries (options, entries, NULL);
+
+        if (!g_option_context_parse (options, &argc, &argv, &error))
+        {
+                g_print ("option parsing failed: %s\n", error->message);
+                g_error_free (error);
+                g_option_context_free (options);
+                return EXIT_FAILURE;
+        }
+
+        g_option_context_free (options);
+
+        if ((base_uri != NULL && *base_uri == '\0') ||
+            (thumbnail_uri != NULL &&
+             (*thumbnail_uri == '\0' || base_uri == NULL)))
+        {
+                g_printerr ("--base-uri and --thumbnail-uri must not be "
+                            "empty, and --thumbnail-uri needs --base-uri\n");
+                return EXIT_FAILURE;
+        }
+
+        if (base_uri != NULL)
+        {
+                feeds = g_strdup (base_uri);
+                thumbs = g_strdup (thumbnail_uri);
+        }
+        else
+        {
+                context = g_main_context_new ();
+                server = server_create (server_only ? NULL : context, &error);
+
+                if (server == NULL)
+                {
+                        g_printerr ("cannot start the server: %s\n",
+                                    error->message);
+                        g_error_free (error);
+                        g_main_context_unref (context);
+                        return EXIT_FAILURE;
+                }
+
+                feeds = ytv_gdata_server_get_base_uri (server);
+                thumbs = ytv_gdata_server_get_thumbnail_uri (server);
+
+                g_print ("serving %u entries at %s\n",
+                         ytv_gdata_server_get_corpus_size (server), feeds);
+
+                if (server_only)
+                {
+                        /* the server runs in the default context */
+                        g_main_loop_run (g_main_loop_new (NULL, FALSE));
+                        goto beach;
+                }
+
+                server_loop = g_main_loop_new (context, FALSE);
+                thread = g_thread_create (server_thread, server_loop,
+                                          TRUE, NULL);
+        }
+
+        run.loop = g_main_loop_new (NULL, FALSE);
+        run.latencies = g_array_sized_new (FALSE, FALSE, sizeof (gdouble),
+                                           requests);
+        run.start = ytv_stats_time_now ();
+
+        pipes = g_new0 (Pipeline*, concurrency);
+
+        for (i = 0; i < concurrency; i++)
+        {
+                pipes[i] = pipeline_new (i, feeds, thumbs);
+                run.active++;
+                pipeline_next (pipes[i]);
+        }
+
+        if (run.active > 0)
+        {
+                g_main_loop_run (run.loop);
+        }
+
+        report ();
+
+        for (i = 0; i < concurrency; i++)
+        {
+                pipeline_free (pipes[i]);
+        }
+
+        g_free (pipes);
+        g_array_free (run.latencies, TRUE);
+        g_main_loop_unref (run.loop);
+
+        if (thread != NULL)
+        {
+                g_main_loop_quit (server_loop);
+                g_thread_join (thread);
+                g_main_loop_unref (server_loop);
+        }
+
+beach:
+        if (server != NULL)
+        {
+                g_object_unref (server);
+        }
+
+        if (context != NULL)
+        {
+                g_main_context_unref (context);
+        }
+
+        g_free (feeds);
+        g_free (thumbs);
+
+        return run.errors > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -25,6 +25,10 @@
  *
  * The #YtvRank draws an area with a filled stars according to a
  * rank from 0.0 to 5.0
+ *
+ * By default every star is a #YtvStar child widget. A compact #YtvRank
+ * has no children: it paints the five stars itself, in the window of its
+ * parent.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -40,7 +44,8 @@
 enum _YtvRankProperties
 {
         PROP_0,
-        PROP_RANK
+        PROP_RANK,
+        PROP_COMPACT
 };
 
 typedef struct _YtvRankPriv YtvRankPriv;
@@ -48,14 +53,23 @@ typedef struct _YtvRankPriv YtvRankPriv;
 struct _YtvRankPriv
 {
         gfloat rank;
+        gboolean compact;
         GtkWidget* stars[5];
 };
 
+#define STAR_SIZE 18
+
 #define YTV_RANK_GET_PRIVATE(obj) \
 	(G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_RANK, YtvRankPriv))
 
 G_DEFINE_TYPE (YtvRank, ytv_rank, GTK_TYPE_HBOX)
 
+static gfloat
+get_star_fill (gfloat rank, gint star)
+{
+        return CLAMP (rank - star, 0.0, 1.0);
+}
+
 static void
 fill_stars (YtvRank* self)
 {
@@ -101,6 +115,60 @@ fill_stars (YtvRank* self)
         return;
 }
 
+static gboolean
+ytv_rank_expose_event (GtkWidget* widget, GdkEventExpose* event)
+{
+        YtvRankPriv* priv;
+        cairo_t* cr;
+        gint i, size;
+
+        priv = YTV_RANK_GET_PRIVATE (widget);
+
+        if (!priv->compact)
+        {
+                return GTK_WIDGET_CLASS (ytv_rank_parent_class)->expose_event
+                        (widget, event);
+        }
+
+        size = MIN (widget->allocation.width / 5, widget->allocation.height);
+
+        /* no window: the allocation is in the parent's window coords */
+        cr = gdk_cairo_create (widget->window);
+        gdk_cairo_region (cr, event->region);
+        cairo_clip (cr);
+
+        for (i = 0; i < 5; i++)
+        {
+                ytv_star_paint (cr, widget->allocation.x + i * size,
+                                widget->allocation.y, size,
+                                get_star_fill (priv->rank, i));
+        }
+
+        cairo_destroy (cr);
+
+        return FALSE;
+}
+
+static void
+ytv_rank_size_request (GtkWidget* widget, GtkRequisition* requisition)
+{
+        YtvRankPriv* priv;
+
+        priv = YTV_RANK_GET_PRIVATE (widget);
+
+        if (!priv->compact)
+        {
+                GTK_WIDGET_CLASS (ytv_rank_parent_class)->size_request
+                        (widget, requisition);
+                return;
+        }
+
+        requisition->width = 5 * STAR_SIZE;
+        requisition->height = STAR_SIZE;
+
+        return;
+}
+
 static void
 ytv_rank_set_property (GObject* object, guint prop_id,
                        const GValue* value, GParamSpec* spec)
@@ -111,6 +179,10 @@ ytv_rank_set_property (GObject* object, guint prop_id,
                 ytv_rank_set_rank (YTV_RANK (object),
                                    g_value_get_float (value));
                 break;
+        case PROP_COMPACT:
+                YTV_RANK_GET_PRIVATE (object)->compact =
+                        g_value_get_boolean (value);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -132,6 +204,9 @@ ytv_rank_get_property (GObject* object, guint prop_id,
         case PROP_RANK:
                 g_value_set_float (value, priv->rank);
                 break;
+        case PROP_COMPACT:
+                g_value_set_boolean (value, priv->compact);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -149,10 +224,11 @@ ytv_rank_init (YtvRank* self)
         priv = YTV_RANK_GET_PRIVATE (self);
 
         priv->rank = 0;
+        priv->compact = FALSE;
 
         g_object_set (G_OBJECT (self), "homogeneous", TRUE, "spacing", 0, NULL);
 
-        for (i = 0; i < 6; i++)
+        for (i = 0; i < 5; i++)
         {
 #if 0 /* segfault !! */        
                 priv->stars[i] = g_object_new (YTV_TYPE_STAR, NULL);
@@ -180,12 +256,22 @@ ytv_rank_class_init (YtvRankClass* klass)
         object_class->set_property = ytv_rank_set_property;
         object_class->get_property = ytv_rank_get_property;
 
+        widget_class->expose_event = ytv_rank_expose_event;
+        widget_class->size_request = ytv_rank_size_request;
+
         g_object_class_install_property
                 (object_class, PROP_RANK,
                  g_param_spec_float
                  ("rank", "rank", "the area to fill", 0.0, 5.0, 0.0,
                   G_PARAM_READWRITE));
 
+        g_object_class_install_property
+                (object_class, PROP_COMPACT,
+                 g_param_spec_boolean
+                 ("compact", "compact",
+                  "paint the stars instead of using a widget for each one",
+                  FALSE, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
         return;
 }
 
@@ -203,6 +289,22 @@ ytv_rank_new (gfloat rank)
         return GTK_WIDGET (g_object_new (YTV_TYPE_RANK, "rank", rank, NULL));
 }
 
+/**
+ * ytv_rank_new_compact:
+ * @rank: The filled rank percentage
+ *
+ * Generate a compact #YtvRank, which paints its stars without child
+ * widgets
+ *
+ * return value: a #YtvRank
+ */
+GtkWidget*
+ytv_rank_new_compact (gfloat rank)
+{
+        return GTK_WIDGET (g_object_new (YTV_TYPE_RANK, "compact", TRUE,
+                                         "rank", rank, NULL));
+}
+
 /**
  * ytv_rank_set_rank:
  * @self: a #YtvRank
@@ -216,7 +318,16 @@ ytv_rank_set_rank (YtvRank* self, gfloat rank)
         YtvRankPriv* priv = YTV_RANK_GET_PRIVATE (self);
 
         priv->rank = rank;
-        fill_stars (self);
+
+        if (priv->compact)
+        {
+                gtk_widget_queue_draw (GTK_WIDGET (self));
+        }
+        else
+        {
+                fill_stars (self);
+        }
+
         g_object_notify (G_OBJECT (self), "rank");
 
         return;
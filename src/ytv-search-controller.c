@@ -0,0 +1,896 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-search-controller.c - Drives a feed from a search box
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-search-controller
+ * @title: YtvSearchController
+ * @short_description: searches as the user types
+ *
+ * The #YtvSearchController turns the text of a search box, given on every
+ * keystroke with ytv_search_controller_set_text(), into searches of a
+ * #YtvFeed, delivered through the ::results signal.
+ *
+ * A query is sent only after the text has been still for "delay"
+ * milliseconds. Sending a query cancels the one in flight, and every
+ * response which is not for the current text is discarded, so they can
+ * not arrive out of order.
+ *
+ * The last "cache-size" results are kept by query, so going back to a
+ * query already seen, e.g. with backspace, is answered at once. While a
+ * longer query is waiting, the cached results of its longest prefix,
+ * filtered by the typed words, are delivered as provisional.
+ *
+ * The given feed must be a #YtvBaseFeed. The controller searches with a
+ * copy of it, which shares its strategies but has a copy of its URI
+ * builder, so changing the query and cancelling the superseded one never
+ * touch the pages or the requests of a browser showing the given feed. The time from the keystroke to its final
+ * results is observed in the %YTV_STATS_SEARCH_TIME histogram.
+ */
+
+/**
+ * YtvSearchController:
+ *
+ * Searches as the user types
+ *
+ * free-function: g_object_unref
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include <ytv-search-controller.h>
+
+#include <ytv-base-feed.h>
+#include <ytv-entry.h>
+#include <ytv-error.h>
+#include <ytv-feed.h>
+#include <ytv-iterator.h>
+#include <ytv-list.h>
+#include <ytv-simple-list.h>
+#include <ytv-marshal.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
+
+enum _YtvSearchControllerProp
+{
+        PROP_0,
+        PROP_FEED,
+        PROP_DELAY,
+        PROP_CACHE_SIZE
+};
+
+enum _YtvSearchControllerSignal
+{
+        RESULTS,
+        ERROR_RAISED,
+        LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+typedef struct _YtvSearchControllerPriv YtvSearchControllerPriv;
+
+struct _YtvSearchControllerPriv
+{
+        YtvFeed* feed;        /* its own, only searched by the controller */
+        guint delay;
+        guint cache_size;
+
+        gchar* query;         /* the current text */
+        guint serial;         /* discards the responses of older queries */
+        YtvStatsTime typed;   /* the last keystroke */
+        guint timer_id;
+        guint inflight;
+
+        GHashTable* cache;    /* query -> YtvCachedResult */
+        GQueue* lru;          /* of YtvCachedResult, the most recent first */
+};
+
+typedef struct _YtvCachedResult YtvCachedResult;
+
+struct _YtvCachedResult
+{
+        gchar* query;
+        YtvList* list;
+        GList* link;          /* in the lru queue */
+};
+
+typedef struct _YtvSearchRequest YtvSearchRequest;
+
+struct _YtvSearchRequest
+{
+        YtvSearchController* self;
+        guint serial;
+        gchar* query;
+};
+
+#define YTV_SEARCH_CONTROLLER_GET_PRIVATE(obj)  \
+        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_SEARCH_CONTROLLER, YtvSearchControllerPriv))
+
+#define DEFAULT_DELAY      250 /* milliseconds */
+#define DEFAULT_CACHE_SIZE 16
+
+G_DEFINE_TYPE (YtvSearchController, ytv_search_controller, G_TYPE_OBJECT)
+
+/* copies the settable properties of @src which are not at their default
+ * value into @dst, an object of the same type */
+static void
+copy_properties (GObject* dst, GObject* src)
+{
+        GParamSpec** specs;
+        GValue value = { 0, };
+        guint i, n;
+
+        specs = g_object_class_list_properties (G_OBJECT_GET_CLASS (src), &n);
+
+        for (i = 0; i < n; i++)
+        {
+                if ((specs[i]->flags & G_PARAM_READWRITE) != G_PARAM_READWRITE
+                    || (specs[i]->flags & G_PARAM_CONSTRUCT_ONLY) != 0)
+                {
+                        continue;
+                }
+
+                g_value_init (&value, specs[i]->value_type);
+                g_object_get_property (src, specs[i]->name, &value);
+
+                if (!g_param_value_defaults (specs[i], &value))
+                {
+                        g_object_set_property (dst, specs[i]->name, &value);
+                }
+
+                g_value_unset (&value);
+        }
+
+        g_free (specs);
+
+        return;
+}
+
+/* a new feed of the same type as @feed, which fetches and parses like it,
+ * with a URI builder of its own: searching must not change the state of
+ * the builder of @feed, which tells its next and previous pages */
+static YtvFeed*
+feed_clone (YtvFeed* feed)
+{
+        YtvFeed* retval;
+        YtvFeedFetchStrategy* fetchst;
+        YtvFeedParseStrategy* parsest;
+        YtvUriBuilder* ub;
+
+        retval = g_object_new (G_OBJECT_TYPE (feed), NULL);
+        copy_properties (G_OBJECT (retval), G_OBJECT (feed));
+
+        fetchst = ytv_feed_get_fetch_strategy (feed);
+        parsest = ytv_feed_get_parse_strategy (feed);
+        ub = ytv_feed_get_uri_builder (feed);
+
+        if (fetchst != NULL)
+        {
+                ytv_feed_set_fetch_strategy (retval, fetchst);
+                g_object_unref (fetchst);
+        }
+
+        if (parsest != NULL)
+        {
+                ytv_feed_set_parse_strategy (retval, parsest);
+                g_object_unref (parsest);
+        }
+
+        if (ub != NULL)
+        {
+                YtvUriBuilder* own;
+
+                own = g_object_new (G_OBJECT_TYPE (ub), NULL);
+                copy_properties (G_OBJECT (own), G_OBJECT (ub));
+
+                /* the results start at their first page */
+                if (g_object_class_find_property (G_OBJECT_GET_CLASS (own),
+                                                  "start-index") != NULL)
+                {
+                        g_object_set (G_OBJECT (own), "start-index", 0, NULL);
+                }
+                ytv_feed_set_uri_builder (retval, own);
+                g_object_unref (own);
+                g_object_unref (ub);
+        }
+
+        return retval;
+}
+
+static void
+cache_remove (YtvSearchControllerPriv* priv, YtvCachedResult* item)
+{
+        g_hash_table_remove (priv->cache, item->query);
+        g_queue_delete_link (priv->lru, item->link);
+
+        g_object_unref (item->list);
+        g_free (item->query);
+        g_slice_free (YtvCachedResult, item);
+
+        return;
+}
+
+static void
+cache_trim (YtvSearchControllerPriv* priv)
+{
+        while (g_queue_get_length (priv->lru) > priv->cache_size)
+        {
+                cache_remove (priv,
+                              (YtvCachedResult*) g_queue_peek_tail (priv->lru));
+        }
+
+        return;
+}
+
+static void
+cache_clear (YtvSearchControllerPriv* priv)
+{
+        while (!g_queue_is_empty (priv->lru))
+        {
+                cache_remove (priv,
+                              (YtvCachedResult*) g_queue_peek_head (priv->lru));
+        }
+
+        return;
+}
+
+static void
+cache_add (YtvSearchControllerPriv* priv, const gchar* query, YtvList* list)
+{
+        YtvCachedResult* item;
+
+        if (priv->cache_size == 0)
+        {
+                return;
+        }
+
+        item = g_hash_table_lookup (priv->cache, query);
+
+        if (item != NULL)
+        {
+                cache_remove (priv, item);
+        }
+
+        item = g_slice_new (YtvCachedResult);
+        item->query = g_strdup (query);
+        item->list = g_object_ref (list);
+
+        g_queue_push_head (priv->lru, item);
+        item->link = g_queue_peek_head_link (priv->lru);
+        g_hash_table_insert (priv->cache, item->query, item);
+
+        cache_trim (priv);
+
+        return;
+}
+
+/* returns a new reference to the cached results of @query, or NULL */
+static YtvList*
+cache_lookup (YtvSearchControllerPriv* priv, const gchar* query)
+{
+        YtvCachedResult* item;
+
+        item = g_hash_table_lookup (priv->cache, query);
+
+        if (item == NULL)
+        {
+                return NULL;
+        }
+
+        g_queue_unlink (priv->lru, item->link);
+        g_queue_push_head_link (priv->lru, item->link);
+
+        return g_object_ref (item->list);
+}
+
+/* the cached result of the longest query which prefixes @query */
+static YtvCachedResult*
+cache_lookup_prefix (YtvSearchControllerPriv* priv, const gchar* query)
+{
+        YtvCachedResult* best;
+        YtvCachedResult* item;
+        GList* l;
+
+        best = NULL;
+
+        for (l = priv->lru->head; l != NULL; l = l->next)
+        {
+                item = (YtvCachedResult*) l->data;
+
+                if (g_str_has_prefix (query, item->query) &&
+                    (best == NULL ||
+                     strlen (item->query) > strlen (best->query)))
+                {
+                        best = item;
+                }
+        }
+
+        return best;
+}
+
+static gboolean
+entry_matches (GObject* entry, gchar** words)
+{
+        gchar* title;
+        gchar* tags;
+        gchar* text;
+        gboolean retval;
+        gint i;
+
+        g_object_get (entry, "title", &title, "tags", &tags, NULL);
+        text = g_utf8_strdown (title != NULL ? title : "", -1);
+        g_free (title);
+
+        if (tags != NULL)
+        {
+                gchar* lower;
+
+                lower = g_utf8_strdown (tags, -1);
+                title = text;
+                text = g_strconcat (title, " ", lower, NULL);
+                g_free (title);
+                g_free (lower);
+                g_free (tags);
+        }
+
+        retval = TRUE;
+
+        for (i = 0; words[i] != NULL && retval; i++)
+        {
+                if (*words[i] != '\0' && strstr (text, words[i]) == NULL)
+                {
+                        retval = FALSE;
+                }
+        }
+
+        g_free (text);
+
+        return retval;
+}
+
+/* the entries of @list whose title or tags contain every word of @query */
+static YtvList*
+filter_entries (YtvList* list, const gchar* query)
+{
+        YtvList* retval;
+        YtvIterator* iter;
+        GObject* entry;
+        gchar* lower;
+        gchar** words;
+
+        lower = g_utf8_strdown (query, -1);
+        words = g_strsplit (lower, " ", -1);
+        g_free (lower);
+
+        retval = ytv_simple_list_new ();
+        iter = ytv_list_create_iterator (list);
+
+        while (!ytv_iterator_is_done (iter))
+        {
+                entry = ytv_iterator_get_current (iter);
+
+                if (entry_matches (entry, words))
+                {
+                        ytv_list_append (retval, entry);
+                }
+
+                g_object_unref (entry);
+                ytv_iterator_next (iter);
+        }
+
+        g_object_unref (iter);
+        g_strfreev (words);
+
+        return retval;
+}
+
+static void
+deliver (YtvSearchController* self, const gchar* query, YtvList* list,
+         gboolean provisional)
+{
+        YtvSearchControllerPriv* priv;
+
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (self);
+
+        if (!provisional)
+        {
+                ytv_stats_observe_since (YTV_STATS_SEARCH_TIME, priv->typed);
+        }
+
+        g_signal_emit (self, signals[RESULTS], 0, query, list, provisional);
+
+        return;
+}
+
+static void
+cancel_inflight (YtvSearchController* self)
+{
+        YtvSearchControllerPriv* priv;
+
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (self);
+
+        /* the feed is not shared, only our own queries are cancelled */
+        if (priv->inflight > 0)
+        {
+                ytv_feed_cancel (priv->feed);
+        }
+
+        return;
+}
+
+static void
+stop_timer (YtvSearchControllerPriv* priv)
+{
+        if (priv->timer_id != 0)
+        {
+                g_source_remove (priv->timer_id);
+                priv->timer_id = 0;
+        }
+
+        return;
+}
+
+static void
+search_cb (YtvFeed* feed, gboolean cancelled, YtvList* list,
+           GError **err, gpointer user_data)
+{
+        YtvSearchRequest* req;
+        YtvSearchController* self;
+        YtvSearchControllerPriv* priv;
+
+        req = (YtvSearchRequest*) user_data;
+        self = req->self;
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (self);
+
+        priv->inflight--;
+
+        if (err != NULL && *err != NULL)
+        {
+                if (!cancelled &&
+                    ytv_error_get_code (*err) != YTV_PARSE_ERROR_BAD_FORMAT &&
+                    req->serial == priv->serial)
+                {
+                        g_signal_emit (self, signals[ERROR_RAISED], 0, *err);
+                }
+
+                /* a feed without entries is an empty result */
+                if (!cancelled && list == NULL &&
+                    ytv_error_get_code (*err) == YTV_PARSE_ERROR_BAD_FORMAT)
+                {
+                        list = ytv_simple_list_new ();
+                }
+
+                g_error_free (*err);
+                *err = NULL;
+        }
+
+        if (cancelled || list == NULL)
+        {
+                if (list != NULL)
+                {
+                        g_object_unref (list);
+                }
+
+                goto beach;
+        }
+
+        /* a stale response is still a good answer for its own query */
+        cache_add (priv, req->query, list);
+
+        if (req->serial == priv->serial)
+        {
+                deliver (self, req->query, list, FALSE);
+        }
+
+        g_object_unref (list);
+
+beach:
+        g_object_unref (req->self);
+        g_free (req->query);
+        g_slice_free (YtvSearchRequest, req);
+
+        return;
+}
+
+static gboolean
+debounce_cb (gpointer user_data)
+{
+        YtvSearchController* self;
+        YtvSearchControllerPriv* priv;
+        YtvSearchRequest* req;
+
+        self = YTV_SEARCH_CONTROLLER (user_data);
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (self);
+
+        priv->timer_id = 0;
+
+        YTV_TRACE_BEGIN ("search", "debounce_cb");
+
+        /* the query in flight is superseded */
+        cancel_inflight (self);
+
+        req = g_slice_new (YtvSearchRequest);
+        req->self = g_object_ref (self);
+        req->serial = priv->serial;
+        req->query = g_strdup (priv->query);
+
+        priv->inflight++;
+
+        ytv_feed_search (priv->feed, req->query);
+        ytv_feed_get_entries_async (priv->feed, search_cb, req);
+
+        YTV_TRACE_END ("search", "debounce_cb");
+
+        return FALSE;
+}
+
+static void
+ytv_search_controller_set_text_default (YtvSearchController* self,
+                                        const gchar* text)
+{
+        YtvSearchControllerPriv* priv;
+        YtvCachedResult* prefix;
+        YtvList* list;
+        gchar* query;
+
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (self);
+
+        g_return_if_fail (priv->feed != NULL);
+
+        query = g_strstrip (g_strdup (text != NULL ? text : ""));
+
+        if (g_strcmp0 (query, priv->query) == 0)
+        {
+                /* e.g. a trailing space */
+                g_free (query);
+                return;
+        }
+
+        g_free (priv->query);
+        priv->query = query;
+        priv->serial++;
+        priv->typed = ytv_stats_time_now ();
+
+        stop_timer (priv);
+
+        if (*query == '\0')
+        {
+                cancel_inflight (self);
+                list = ytv_simple_list_new ();
+                deliver (self, query, list, FALSE);
+                g_object_unref (list);
+                return;
+        }
+
+        list = cache_lookup (priv, query);
+
+        if (list != NULL)
+        {
+                cancel_inflight (self);
+                deliver (self, query, list, FALSE);
+                g_object_unref (list);
+                return;
+        }
+
+        prefix = cache_lookup_prefix (priv, query);
+
+        if (prefix != NULL)
+        {
+                list = filter_entries (prefix->list, query);
+
+                if (ytv_list_get_length (list) > 0)
+                {
+                        deliver (self, query, list, TRUE);
+                }
+
+                g_object_unref (list);
+        }
+
+        priv->timer_id = g_timeout_add (priv->delay, debounce_cb, self);
+
+        return;
+}
+
+static void
+ytv_search_controller_set_property (GObject* object, guint prop_id,
+                                    const GValue* value, GParamSpec* spec)
+{
+        YtvSearchControllerPriv* priv;
+        GObject* feed;
+
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_FEED:
+                feed = g_value_get_object (value);
+
+                if (feed != NULL && !YTV_IS_BASE_FEED (feed))
+                {
+                        g_warning ("Only a YtvBaseFeed can be searched");
+                }
+                else if (feed != NULL)
+                {
+                        priv->feed = feed_clone (YTV_FEED (feed));
+                }
+                break;
+        case PROP_DELAY:
+                priv->delay = g_value_get_uint (value);
+                break;
+        case PROP_CACHE_SIZE:
+                priv->cache_size = g_value_get_uint (value);
+                cache_trim (priv);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_search_controller_get_property (GObject* object, guint prop_id,
+                                    GValue* value, GParamSpec* spec)
+{
+        YtvSearchControllerPriv* priv;
+
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_FEED:
+                g_value_set_object (value, priv->feed);
+                break;
+        case PROP_DELAY:
+                g_value_set_uint (value, priv->delay);
+                break;
+        case PROP_CACHE_SIZE:
+                g_value_set_uint (value, priv->cache_size);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_search_controller_dispose (GObject* object)
+{
+        YtvSearchControllerPriv* priv;
+
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (object);
+
+        stop_timer (priv);
+        cache_clear (priv);
+
+        if (priv->feed != NULL)
+        {
+                g_object_unref (priv->feed);
+                priv->feed = NULL;
+        }
+
+        (*G_OBJECT_CLASS (ytv_search_controller_parent_class)->dispose) (object);
+
+        return;
+}
+
+static void
+ytv_search_controller_finalize (GObject* object)
+{
+        YtvSearchControllerPriv* priv;
+
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (object);
+
+        g_free (priv->query);
+        g_hash_table_destroy (priv->cache);
+        g_queue_free (priv->lru);
+
+        (*G_OBJECT_CLASS (ytv_search_controller_parent_class)->finalize) (object);
+
+        return;
+}
+
+static void
+ytv_search_controller_class_init (YtvSearchControllerClass* klass)
+{
+        GObjectClass* g_klass;
+
+        g_klass = G_OBJECT_CLASS (klass);
+
+        g_type_class_add_private (g_klass, sizeof (YtvSearchControllerPriv));
+
+        g_klass->set_property = ytv_search_controller_set_property;
+        g_klass->get_property = ytv_search_controller_get_property;
+        g_klass->dispose      = ytv_search_controller_dispose;
+        g_klass->finalize     = ytv_search_controller_finalize;
+
+        g_object_class_install_property
+                (g_klass, PROP_FEED,
+                 g_param_spec_object
+                 ("feed", "feed",
+                  "The feed whose strategies are used to search",
+                  YTV_TYPE_FEED, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+        g_object_class_install_property
+                (g_klass, PROP_DELAY,
+                 g_param_spec_uint
+                 ("delay", "delay",
+                  "Milliseconds the text must be still before searching it",
+                  0, G_MAXUINT, DEFAULT_DELAY,
+                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        g_object_class_install_property
+                (g_klass, PROP_CACHE_SIZE,
+                 g_param_spec_uint
+                 ("cache-size", "cache_size",
+                  "Number of query results kept, zero disables the cache",
+                  0, G_MAXUINT, DEFAULT_CACHE_SIZE,
+                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        /**
+         * YtvSearchController::results:
+         * @self: the #YtvSearchController instance that emitted the signal
+         * @query: the query of the results
+         * @entries: the #YtvList of found #YtvEntry
+         * @provisional: %TRUE if @entries were filtered from the results of
+         * a shorter query, while the real ones arrive
+         *
+         * The ::results signal is emmited with the results of the current
+         * text. The handlers do not own @entries.
+         */
+        signals[RESULTS] =
+                g_signal_new ("results",
+                              G_TYPE_FROM_CLASS (klass),
+                              G_SIGNAL_RUN_LAST,
+                              G_STRUCT_OFFSET (YtvSearchControllerClass,
+                                               results),
+                              NULL, NULL,
+                              ytv_cclosure_marshal_VOID__STRING_OBJECT_BOOLEAN,
+                              G_TYPE_NONE, 3,
+                              G_TYPE_STRING, YTV_TYPE_LIST, G_TYPE_BOOLEAN);
+
+        /**
+         * YtvSearchController::error-raised:
+         * @self: the #YtvSearchController instance that emitted the signal
+         * @err: the raised #GError
+         *
+         * The ::error-raised signal is emmited when the search of the
+         * current text failed. The handlers do not own @err.
+         */
+        signals[ERROR_RAISED] =
+                g_signal_new ("error-raised",
+                              G_TYPE_FROM_CLASS (klass),
+                              G_SIGNAL_RUN_LAST,
+                              G_STRUCT_OFFSET (YtvSearchControllerClass,
+                                               error_raised),
+                              NULL, NULL,
+                              g_cclosure_marshal_VOID__POINTER,
+                              G_TYPE_NONE, 1, G_TYPE_POINTER);
+
+        return;
+}
+
+static void
+ytv_search_controller_init (YtvSearchController* self)
+{
+        YtvSearchControllerPriv* priv;
+
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (self);
+
+        priv->feed       = NULL;
+        priv->delay      = DEFAULT_DELAY;
+        priv->cache_size = DEFAULT_CACHE_SIZE;
+        priv->query      = NULL;
+        priv->serial     = 0;
+        priv->typed      = 0;
+        priv->timer_id   = 0;
+        priv->inflight   = 0;
+        priv->cache      = g_hash_table_new (g_str_hash, g_str_equal);
+        priv->lru        = g_queue_new ();
+
+        return;
+}
+
+/**
+ * ytv_search_controller_new:
+ * @feed: (not-null): the #YtvBaseFeed whose strategies are used to search
+ *
+ * Creates a search controller with a copy of @feed, of the same type and
+ * with a copy of its URI builder. @feed itself is not modified.
+ *
+ * returns: (not-null) (caller-owns): a new #YtvSearchController
+ */
+YtvSearchController*
+ytv_search_controller_new (YtvFeed* feed)
+{
+        g_return_val_if_fail (YTV_IS_BASE_FEED (feed), NULL);
+
+        return g_object_new (YTV_TYPE_SEARCH_CONTROLLER, "feed", feed, NULL);
+}
+
+/**
+ * ytv_search_controller_set_text:
+ * @self: (not-null): a #YtvSearchController
+ * @text: (null-ok): the text of the search box
+ *
+ * Tells the controller the text changed, usually on every keystroke.
+ * Cached results are delivered at once, otherwise the text is searched
+ * when it has been still for "delay" milliseconds. An empty text delivers
+ * an empty result.
+ */
+void
+ytv_search_controller_set_text (YtvSearchController* self, const gchar* text)
+{
+        g_assert (YTV_IS_SEARCH_CONTROLLER (self));
+
+        ytv_search_controller_set_text_default (self, text);
+
+        return;
+}
+
+/**
+ * ytv_search_controller_cancel:
+ * @self: (not-null): a #YtvSearchController
+ *
+ * Forgets the current text: the waiting query is not sent and the one in
+ * flight is cancelled.
+ */
+void
+ytv_search_controller_cancel (YtvSearchController* self)
+{
+        YtvSearchControllerPriv* priv;
+
+        g_assert (YTV_IS_SEARCH_CONTROLLER (self));
+
+        priv = YTV_SEARCH_CONTROLLER_GET_PRIVATE (self);
+
+        stop_timer (priv);
+        priv->serial++;
+        cancel_inflight (self);
+
+        g_free (priv->query);
+        priv->query = NULL;
+
+        return;
+}
+
+/**
+ * ytv_search_controller_clear_cache:
+ * @self: (not-null): a #YtvSearchController
+ *
+ * Forgets the cached results, so every query is searched again.
+ */
+void
+ytv_search_controller_clear_cache (YtvSearchController* self)
+{
+        g_assert (YTV_IS_SEARCH_CONTROLLER (self));
+
+        cache_clear (YTV_SEARCH_CONTROLLER_GET_PRIVATE (self));
+
+        return;
+}
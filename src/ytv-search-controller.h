@@ -0,0 +1,71 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_SEARCH_CONTROLLER_H_
+#define _YTV_SEARCH_CONTROLLER_H_
+
+/* ytv-search-controller.h - Drives a feed from a search box
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib-object.h>
+#include <ytv-shared.h>
+
+G_BEGIN_DECLS
+
+#define YTV_TYPE_SEARCH_CONTROLLER              \
+        (ytv_search_controller_get_type ())
+#define YTV_SEARCH_CONTROLLER(obj)                                      \
+        (G_TYPE_CHECK_INSTANCE_CAST ((obj), YTV_TYPE_SEARCH_CONTROLLER, YtvSearchController))
+#define YTV_SEARCH_CONTROLLER_CLASS(klass)                              \
+        (G_TYPE_CHECK_CLASS_CAST ((klass), YTV_TYPE_SEARCH_CONTROLLER, YtvSearchControllerClass))
+#define YTV_IS_SEARCH_CONTROLLER(obj)                                   \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), YTV_TYPE_SEARCH_CONTROLLER))
+#define YTV_IS_SEARCH_CONTROLLER_CLASS(klass)                           \
+        (G_TYPE_CHECK_CLASS_TYPE ((klass), YTV_TYPE_SEARCH_CONTROLLER))
+#define YTV_SEARCH_CONTROLLER_GET_CLASS(obj)                            \
+        (G_TYPE_INSTANCE_GET_CLASS ((obj), YTV_TYPE_SEARCH_CONTROLLER, YtvSearchControllerClass))
+
+typedef struct _YtvSearchController YtvSearchController;
+typedef struct _YtvSearchControllerClass YtvSearchControllerClass;
+
+struct _YtvSearchController
+{
+        GObject parent;
+};
+
+struct _YtvSearchControllerClass
+{
+        GObjectClass parent_class;
+
+        /* Signals */
+        void (*results) (YtvSearchController* self, const gchar* query,
+                         YtvList* entries, gboolean provisional);
+        void (*error_raised) (YtvSearchController* self, GError* err);
+};
+
+GType ytv_search_controller_get_type (void);
+
+YtvSearchController* ytv_search_controller_new (YtvFeed* feed);
+void ytv_search_controller_set_text (YtvSearchController* self,
+                                     const gchar* text);
+void ytv_search_controller_cancel (YtvSearchController* self);
+void ytv_search_controller_clear_cache (YtvSearchController* self);
+
+G_END_DECLS
+
+#endif /* _YTV_SEARCH_CONTROLLER_H_ */
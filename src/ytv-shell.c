@@ -22,6 +22,7 @@
 #include <ytv-shell.h>
 
 #include <ytv-gtk-browser.h>
+#include <ytv-gtk-list-browser.h>
 #include <ytv-youtube-uri-builder.h>
 
 #include <gtk/gtk.h>
@@ -34,6 +35,12 @@ enum _YtvShellSignals
 
 static guint signals[LAST_SIGNAL] = { 0 };
 
+enum _YtvShellProp
+{
+        PROP_0,
+        PROP_LIST_BROWSER
+};
+
 typedef struct _YtvShellPriv YtvShellPriv;
 struct _YtvShellPriv
 {
@@ -42,6 +49,7 @@ struct _YtvShellPriv
         GtkWidget* next;
         GtkWidget* prev;
         GtkWidget* search_entry;
+        gboolean list_browser;
 };
 
 #define YTV_SHELL_GET_PRIVATE(obj) \
@@ -203,7 +211,17 @@ create_browser_tab (YtvShell* self)
         
         box = gtk_vbox_new (FALSE, 0);
         
-        priv->browser = ytv_gtk_browser_new (YTV_ORIENTATION_HORIZONTAL);
+        if (priv->list_browser)
+        {
+                priv->browser = ytv_gtk_list_browser_new ();
+        }
+        else
+        {
+                priv->browser = ytv_gtk_browser_new (YTV_ORIENTATION_HORIZONTAL);
+                g_object_set (G_OBJECT (priv->browser),
+                              "recycle", TRUE, "incremental", TRUE, NULL);
+        }
+
         g_signal_connect (priv->browser, "error-raised",
                           G_CALLBACK (error_raised_cb), self);
         g_signal_connect (priv->browser, "last-page",
@@ -219,10 +237,20 @@ create_browser_tab (YtvShell* self)
                 GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
         gtk_scrolled_window_set_shadow_type (
                 GTK_SCROLLED_WINDOW (scrolledwin), GTK_SHADOW_NONE);
-        gtk_scrolled_window_add_with_viewport (
-                GTK_SCROLLED_WINDOW (scrolledwin),
-                GTK_WIDGET (priv->browser)
-                );
+
+        if (priv->list_browser)
+        {
+                /* it scrolls by itself */
+                gtk_container_add (GTK_CONTAINER (scrolledwin),
+                                   GTK_WIDGET (priv->browser));
+        }
+        else
+        {
+                gtk_scrolled_window_add_with_viewport (
+                        GTK_SCROLLED_WINDOW (scrolledwin),
+                        GTK_WIDGET (priv->browser)
+                        );
+        }
         
         gtk_box_pack_start (GTK_BOX (box), scrolledwin, TRUE, TRUE, 0);
 
@@ -296,6 +324,62 @@ create_ui (YtvShell* self)
         /* @todo update the status bar */
 }
 
+static void
+ytv_shell_get_property (GObject* object, guint prop_id,
+                        GValue* value, GParamSpec* spec)
+{
+        YtvShellPriv* priv;
+
+        priv = YTV_SHELL_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_LIST_BROWSER:
+                g_value_set_boolean (value, priv->list_browser);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_shell_set_property (GObject* object, guint prop_id,
+                        const GValue* value, GParamSpec* spec)
+{
+        YtvShellPriv* priv;
+
+        priv = YTV_SHELL_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_LIST_BROWSER:
+                priv->list_browser = g_value_get_boolean (value);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_shell_constructed (GObject* object)
+{
+        /* the browser kind is known only after the construct properties */
+        create_ui (YTV_SHELL (object));
+
+        if (G_OBJECT_CLASS (ytv_shell_parent_class)->constructed != NULL)
+        {
+                G_OBJECT_CLASS (ytv_shell_parent_class)->constructed (object);
+        }
+
+        return;
+}
+
 static void
 ytv_shell_class_init (YtvShellClass* klass)
 {
@@ -305,6 +389,18 @@ ytv_shell_class_init (YtvShellClass* klass)
         
         g_type_class_add_private (object_class, sizeof (YtvShellPriv));
 
+        object_class->get_property = ytv_shell_get_property;
+        object_class->set_property = ytv_shell_set_property;
+        object_class->constructed  = ytv_shell_constructed;
+
+        g_object_class_install_property
+                (object_class, PROP_LIST_BROWSER,
+                 g_param_spec_boolean ("list-browser", "list_browser",
+                                       "Use the scrolling list browser",
+                                       FALSE,
+                                       G_PARAM_READWRITE |
+                                       G_PARAM_CONSTRUCT_ONLY));
+
         /**
          * YtvShell::error-raised:
          * @self: the #YtvShell instance that emitted the signal
@@ -331,8 +427,6 @@ ytv_shell_init (YtvShell* self)
                       "tab-pos", GTK_POS_BOTTOM,
                       "show-tabs", FALSE, NULL);
 
-        create_ui (self);
-        
         return;
 }
 
@@ -47,6 +47,7 @@
 #include <ytv-list.h>
 
 #include <ytv-simple-list.h>
+#include <ytv-stats.h>
 
 #include "ytv-simple-list-priv.h"
 #include "ytv-simple-list-iterator-priv.h"
@@ -74,6 +75,8 @@ ytv_simple_list_prepend (YtvList* self, GObject* item)
         priv->first = g_list_prepend (priv->first, item);
         g_mutex_unlock (priv->iterator_lock);
 
+        ytv_stats_inc (YTV_STATS_LIST_ITEMS);
+
         return;
 }
 
@@ -87,6 +90,8 @@ ytv_simple_list_append (YtvList* self, GObject* item)
         priv->first = g_list_append (priv->first, item);
         g_mutex_unlock (priv->iterator_lock);
 
+        ytv_stats_inc (YTV_STATS_LIST_ITEMS);
+
         return;
 }
 
@@ -102,6 +107,7 @@ ytv_simple_list_remove (YtvList* self, GObject* item)
         {
                 priv->first = g_list_delete_link (priv->first, link);
                 g_object_unref (G_OBJECT (item));
+                ytv_stats_dec (YTV_STATS_LIST_ITEMS);
         }
         g_mutex_unlock (priv->iterator_lock);
 
@@ -128,6 +134,8 @@ ytv_simple_list_copy_the_simple_list (YtvList* self)
         cpriv->first = list_copy;
         g_mutex_unlock (priv->iterator_lock);
 
+        ytv_stats_add (YTV_STATS_LIST_ITEMS, g_list_length (list_copy));
+
         return YTV_LIST (copy);
 }
 
@@ -179,6 +187,8 @@ ytv_simple_list_finalize (GObject* object)
         g_mutex_lock (priv->iterator_lock);
         if (priv->first)
         {
+                ytv_stats_add (YTV_STATS_LIST_ITEMS,
+                               - (gint) g_list_length (priv->first));
                 g_list_foreach (priv->first, destroy_items, NULL);
                 g_list_free (priv->first);
                 priv->first = NULL;
@@ -188,6 +198,8 @@ ytv_simple_list_finalize (GObject* object)
         g_mutex_free (priv->iterator_lock);
         priv->iterator_lock = NULL;
 
+        ytv_stats_dec (YTV_STATS_LISTS);
+
         G_OBJECT_CLASS (ytv_simple_list_parent_class)->finalize (object);
 
         return;
@@ -214,6 +226,8 @@ ytv_simple_list_init (YtvSimpleList *self)
         
         priv->iterator_lock = g_mutex_new ();
         priv->first = NULL;
+
+        ytv_stats_inc (YTV_STATS_LISTS);
 }
 
 /**
@@ -26,6 +26,9 @@
  *
  * It is a #YtvFeedFetchStrategy implementation using the libsoup
  * library for the HTTP client communications.
+ *
+ * The HTTP proxy, if any, is set through #YtvSoupFeedFetchStrategy:proxy-uri;
+ * the desktop settings may be read with ytv_gconf_proxy_get_uri().
  */
 
 /**
@@ -43,16 +46,26 @@
 #endif
 
 #include <libsoup/soup.h>
-#include <gconf/gconf-client.h>
 
 #include <ytv-error.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
 #include <ytv-soup-feed-fetch-strategy.h>
 
+enum _YtvSoupFeedFetchStrategyProp
+{
+        PROP_0,
+        PROP_PROXY_URI
+};
+
 typedef struct _YtvSoupFeedFetchStrategyPriv YtvSoupFeedFetchStrategyPriv;
 
 struct _YtvSoupFeedFetchStrategyPriv
 {
 	SoupSession* session;
+        gint inflight;
+        GList* pending;
+        gchar* proxy_uri;
 };
 
 /* helper for the session_async queue */
@@ -62,18 +75,48 @@ struct _YtvCbWrapper
         YtvFeedFetchStrategy*  st;
         YtvGetResponseCallback cb;
         gpointer user_data;
+        SoupMessage* message;
+        YtvStatsTime start;
 };
 
 #define YTV_SOUP_FEED_FETCH_STRATEGY_GET_PRIVATE(o) \
         (G_TYPE_INSTANCE_GET_PRIVATE ((o), YTV_TYPE_SOUP_FEED_FETCH_STRATEGY, YtvSoupFeedFetchStrategyPriv))
 
+/* sets the proxy of the session, or none if there is no proxy uri */
+static void
+set_session_proxy (YtvSoupFeedFetchStrategyPriv* priv)
+{
+        SoupURI* suri;
+
+        suri = NULL;
+
+        if (priv->proxy_uri != NULL)
+        {
+                suri = soup_uri_new (priv->proxy_uri);
+
+                if (suri == NULL)
+                {
+                        g_warning ("Invalid proxy URI - %s", priv->proxy_uri);
+                }
+        }
+
+        g_object_set (G_OBJECT (priv->session),
+                      SOUP_SESSION_PROXY_URI, suri, NULL);
+
+        if (suri != NULL)
+        {
+                soup_uri_free (suri);
+        }
+
+        return;
+}
+
 /* creates a HTTP session and set the proxy */
 static void
 create_session (YtvSoupFeedFetchStrategy* self)
 {
         YtvSoupFeedFetchStrategyPriv* priv =
                 YTV_SOUP_FEED_FETCH_STRATEGY_GET_PRIVATE (self);
-        GConfClient* conf_client;
 
         if (priv->session != NULL)
         {
@@ -83,67 +126,11 @@ create_session (YtvSoupFeedFetchStrategy* self)
         priv->session = soup_session_async_new_with_options
                 (SOUP_SESSION_USER_AGENT, "youtube-viewer/" VERSION, NULL);
 
-        conf_client = gconf_client_get_default ();
-
-        if (gconf_client_get_bool (conf_client,
-                                   "/system/http_proxy/use_http_proxy", NULL))
+        if (priv->proxy_uri != NULL)
         {
-                gchar *server, *proxy_uri;
-                gint port;
-
-                server = gconf_client_get_string (conf_client,
-                                                  "/system/http_proxy/host",
-                                                  NULL);
-                port = gconf_client_get_int (conf_client,
-                                             "/system/http_proxy/port", NULL);
-
-                if (server && server[0])
-                {
-                        SoupURI *suri;
-
-                        if (gconf_client_get_bool
-                            (conf_client,
-                             "/system/http_proxy/use_authentication",
-                             NULL))
-                        {
-                                gchar *user, *password;
-
-                                user = gconf_client_get_string
-                                        (conf_client,
-                                         "/system/http_proxy/authentication_user",
-                                         NULL);
-                                
-                                password = gconf_client_get_string
-                                        (conf_client,
-                                         "/system/http_proxy/authentication_password",
-                                         NULL);
-
-                                proxy_uri = g_strdup_printf ("http://%s:%s@%s:%d",
-                                                             user, password,
-                                                             server, port);
-
-                                g_free (user);
-                                g_free (password);
-                        }
-                        else
-                        {
-                                proxy_uri = g_strdup_printf ("http://%s:%d",
-                                                             server, port);
-                        }
-
-                        suri = soup_uri_new (proxy_uri);
-                        g_object_set (G_OBJECT (priv->session),
-                                      SOUP_SESSION_PROXY_URI, suri, NULL);
-
-                        soup_uri_free (suri);
-
-                        g_free (server);
-                        g_free (proxy_uri);
-                }
+                set_session_proxy (priv);
         }
 
-        g_object_unref (conf_client);
-
         return;
 }
 
@@ -162,6 +149,26 @@ retrieval_done (SoupSession* session, SoupMessage* message, gpointer user_data)
 
         self = YTV_SOUP_FEED_FETCH_STRATEGY (cbw->st);
         priv = YTV_SOUP_FEED_FETCH_STRATEGY_GET_PRIVATE (self);
+
+        priv->inflight--;
+        priv->pending = g_list_remove (priv->pending, cbw);
+        ytv_stats_dec (YTV_STATS_REQUESTS_IN_FLIGHT);
+        ytv_stats_observe_since (YTV_STATS_FETCH_LATENCY, cbw->start);
+        YTV_TRACE_ASYNC_END ("fetch", "http-request", cbw);
+        YTV_TRACE_COUNTER ("fetch", "requests-in-flight", priv->inflight);
+
+        if (message->status_code == SOUP_STATUS_CANCELLED)
+        {
+                /* asked for by the user, so it is not counted as an error */
+                g_set_error (&err, YTV_HTTP_ERROR, YTV_HTTP_ERROR_CANCELLED,
+                             "HTTP request cancelled");
+
+                if (cbw->cb != NULL)
+                {
+                        cbw->cb (cbw->st, NULL, NULL, -1, &err, cbw->user_data);
+                }
+                goto done;
+        }
                 
         if (!SOUP_STATUS_IS_SUCCESSFUL (message->status_code))
         {
@@ -170,6 +177,8 @@ retrieval_done (SoupSession* session, SoupMessage* message, gpointer user_data)
                              soup_message_get_http_version (message),
                              message->status_code, message->reason_phrase);
 
+                ytv_stats_count_error (err);
+
                 if (cbw->cb != NULL)
                 {
                         cbw->cb (cbw->st, NULL, NULL, -1, &err, cbw->user_data);
@@ -180,12 +189,19 @@ retrieval_done (SoupSession* session, SoupMessage* message, gpointer user_data)
         mimetype = soup_message_headers_get (message->response_headers,
                                              "Content-Type");
 
+        ytv_stats_add (YTV_STATS_BYTES_FETCHED,
+                       message->response_body->length);
+        YTV_TRACE_COUNTER ("fetch", "response-bytes",
+                           message->response_body->length);
+
         if (cbw->cb != NULL)
         {
+                YTV_TRACE_BEGIN ("fetch", "response-callback");
                 cbw->cb (cbw->st, mimetype,
                          (const gint8*) message->response_body->data,
                          (gsize) message->response_body->length,
                          &err, cbw->user_data);
+                YTV_TRACE_END ("fetch", "response-callback");
         }
         
 done:
@@ -215,6 +231,7 @@ ytv_soup_feed_fetch_strategy_perform_default (YtvFeedFetchStrategy* self,
         cbw->st = self;
         cbw->cb = callback;
         cbw->user_data = user_data;
+        cbw->message = NULL;
 
         message = soup_message_new (SOUP_METHOD_GET, uri);
 
@@ -225,6 +242,8 @@ ytv_soup_feed_fetch_strategy_perform_default (YtvFeedFetchStrategy* self,
                 g_set_error (&err, YTV_HTTP_ERROR, YTV_HTTP_ERROR_BAD_URI,
                              "Could not parse URI - %s", uri);
 
+                ytv_stats_count_error (err);
+
                 if (cbw->cb != NULL)
                 {
                         cbw->cb (cbw->st, NULL, NULL, -1, &err, cbw->user_data);
@@ -237,6 +256,15 @@ ytv_soup_feed_fetch_strategy_perform_default (YtvFeedFetchStrategy* self,
         
         soup_message_set_flags (message, SOUP_MESSAGE_NO_REDIRECT);
 
+        priv->inflight++;
+        cbw->message = message;
+        priv->pending = g_list_prepend (priv->pending, cbw);
+        cbw->start = ytv_stats_time_now ();
+        ytv_stats_inc (YTV_STATS_REQUESTS);
+        ytv_stats_inc (YTV_STATS_REQUESTS_IN_FLIGHT);
+        YTV_TRACE_ASYNC_BEGIN ("fetch", "http-request", cbw);
+        YTV_TRACE_COUNTER ("fetch", "requests-in-flight", priv->inflight);
+
         soup_session_queue_message (priv->session, message,
                                     (SoupSessionCallback) retrieval_done,
                                     cbw);
@@ -244,6 +272,34 @@ ytv_soup_feed_fetch_strategy_perform_default (YtvFeedFetchStrategy* self,
         return;
 }
 
+static void
+ytv_soup_feed_fetch_strategy_cancel_default (YtvFeedFetchStrategy* self,
+                                             gpointer user_data)
+{
+        YtvSoupFeedFetchStrategyPriv* priv;
+        GList* l;
+
+        g_assert (YTV_IS_SOUP_FEED_FETCH_STRATEGY (self));
+
+        priv = YTV_SOUP_FEED_FETCH_STRATEGY_GET_PRIVATE (self);
+
+        for (l = priv->pending; l != NULL; l = l->next)
+        {
+                YtvCbWrapper* cbw = (YtvCbWrapper*) l->data;
+
+                if (cbw->user_data == user_data)
+                {
+                        /* retrieval_done will be called synchronously */
+                        soup_session_cancel_message (priv->session,
+                                                     cbw->message,
+                                                     SOUP_STATUS_CANCELLED);
+                        break;
+                }
+        }
+
+        return;
+}
+
 static gchar*
 ytv_soup_feed_fetch_strategy_encode_default (YtvFeedFetchStrategy* self,
                                              const gchar* part)
@@ -269,6 +325,7 @@ ytv_feed_fetch_strategy_init (YtvFeedFetchStrategyIface* klass)
         klass->perform = ytv_soup_feed_fetch_strategy_perform;
         klass->encode = ytv_soup_feed_fetch_strategy_encode;
         klass->get_date = ytv_soup_feed_fetch_strategy_get_date;
+        klass->cancel = ytv_soup_feed_fetch_strategy_cancel;
 
 	return;
 }
@@ -278,6 +335,55 @@ G_DEFINE_TYPE_EXTENDED (YtvSoupFeedFetchStrategy, ytv_soup_feed_fetch_strategy,
 			G_IMPLEMENT_INTERFACE (YTV_TYPE_FEED_FETCH_STRATEGY,
 					       ytv_feed_fetch_strategy_init))
 
+static void
+ytv_soup_feed_fetch_strategy_set_property (GObject* object, guint prop_id,
+                                           const GValue* value,
+                                           GParamSpec* spec)
+{
+        YtvSoupFeedFetchStrategyPriv* priv;
+
+        priv = YTV_SOUP_FEED_FETCH_STRATEGY_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_PROXY_URI:
+                g_free (priv->proxy_uri);
+                priv->proxy_uri = g_value_dup_string (value);
+
+                if (priv->session != NULL)
+                {
+                        set_session_proxy (priv);
+                }
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_soup_feed_fetch_strategy_get_property (GObject* object, guint prop_id,
+                                           GValue* value, GParamSpec* spec)
+{
+        YtvSoupFeedFetchStrategyPriv* priv;
+
+        priv = YTV_SOUP_FEED_FETCH_STRATEGY_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_PROXY_URI:
+                g_value_set_string (value, priv->proxy_uri);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
 static void
 ytv_soup_feed_fetch_strategy_finalize (GObject *object)
 {
@@ -296,6 +402,8 @@ ytv_soup_feed_fetch_strategy_finalize (GObject *object)
                 priv->session = NULL;
         }
 
+        g_free (priv->proxy_uri);
+
         (*G_OBJECT_CLASS (ytv_soup_feed_fetch_strategy_parent_class)->finalize) (object);
         
         return;
@@ -311,10 +419,21 @@ ytv_soup_feed_fetch_strategy_class_init (YtvSoupFeedFetchStrategyClass* klass)
         klass->perform = ytv_soup_feed_fetch_strategy_perform_default;
         klass->encode = ytv_soup_feed_fetch_strategy_encode_default;
         klass->get_date = ytv_soup_feed_fetch_strategy_get_date_default;
+        klass->cancel = ytv_soup_feed_fetch_strategy_cancel_default;
         
+        object_class->set_property = ytv_soup_feed_fetch_strategy_set_property;
+        object_class->get_property = ytv_soup_feed_fetch_strategy_get_property;
         object_class->finalize = ytv_soup_feed_fetch_strategy_finalize;
 
         g_type_class_add_private (klass, sizeof (YtvSoupFeedFetchStrategyPriv));
+
+        g_object_class_install_property
+                (object_class, PROP_PROXY_URI,
+                 g_param_spec_string
+                 ("proxy-uri", "proxyuri",
+                  "The URI of the HTTP proxy, with its credentials if needed, "
+                  "or NULL for a direct connection", NULL,
+                  G_PARAM_READWRITE));
         
         return;
 }
@@ -326,6 +445,9 @@ ytv_soup_feed_fetch_strategy_init (YtvSoupFeedFetchStrategy* self)
 
         priv = YTV_SOUP_FEED_FETCH_STRATEGY_GET_PRIVATE (self);
         priv->session = NULL;
+        priv->inflight = 0;
+        priv->pending = NULL;
+        priv->proxy_uri = NULL;
         
         return;
 }
@@ -411,6 +533,27 @@ ytv_soup_feed_fetch_strategy_get_date (YtvFeedFetchStrategy* self,
         return retval;        
 }
 
+/**
+ * ytv_soup_feed_fetch_strategy_cancel:
+ * @self: (not-null): a #YtvFeedFetchStrategy instance
+ * @user_data: the user data of the request to cancel
+ *
+ * Cancels the queued or running libsoup message which was performed
+ * with @user_data. Its callback gets a %YTV_HTTP_ERROR_CANCELLED error.
+ */
+void
+ytv_soup_feed_fetch_strategy_cancel (YtvFeedFetchStrategy* self,
+                                     gpointer user_data)
+{
+        g_assert (self != NULL);
+        g_assert (YTV_IS_SOUP_FEED_FETCH_STRATEGY (self));
+
+        YTV_SOUP_FEED_FETCH_STRATEGY_GET_CLASS (self)->cancel (self,
+                                                               user_data);
+
+        return;
+}
+
 /**
  * ytv_soup_feed_fetch_strategy_new:
  *
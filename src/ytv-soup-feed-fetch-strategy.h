@@ -56,6 +56,7 @@ struct _YtvSoupFeedFetchStrategyClass
                          YtvGetResponseCallback callback, gpointer user_data);
         gchar* (*encode) (YtvFeedFetchStrategy* self, const gchar* part);
         time_t (*get_date) (YtvFeedFetchStrategy* self, const gchar* date);
+        void (*cancel) (YtvFeedFetchStrategy* self, gpointer user_data);
 };
 
 GType ytv_soup_feed_fetch_strategy_get_type (void);
@@ -69,6 +70,8 @@ gchar* ytv_soup_feed_fetch_strategy_encode (YtvFeedFetchStrategy* self,
                                             const gchar* part);
 time_t ytv_soup_feed_fetch_strategy_get_date (YtvFeedFetchStrategy* self,
                                               const gchar* date);
+void ytv_soup_feed_fetch_strategy_cancel (YtvFeedFetchStrategy* self,
+                                          gpointer user_data);
 
 G_END_DECLS
 
@@ -25,6 +25,9 @@
  *
  * The #YtvStar draws an area with a star filled according a rank from
  * 0 to 1
+ *
+ * The stars are rendered once per size and fill level, and the rendered
+ * images of the last few sizes are shared by all the #YtvStar instances.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -32,6 +35,7 @@
 #endif
 
 #include <ytv-star.h>
+#include <ytv-trace.h>
 
 #include <glib.h>
 #include <gtk/gtk.h>
@@ -56,100 +60,98 @@ typedef struct _YtvStarPriv YtvStarPriv;
 struct _YtvStarPriv
 {
         gfloat percentage;
-        GArray* star_points;
 };
 
 #define YTV_STAR_GET_PRIVATE(obj) \
 	(G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_STAR, YtvStarPriv))
 
+#define STAR_POINTS 12
+
 G_DEFINE_TYPE (YtvStar, ytv_star, GTK_TYPE_DRAWING_AREA)
 
-static void
-calculate_star_points (GArray* star_points)
+/* the outline is the same for every star: it is computed once */
+static const YtvPoint*
+get_star_points (void)
 {
+        static YtvPoint star_points[STAR_POINTS];
+        static gboolean calculated = FALSE;
         gint i;
         gfloat incr, rad;
-        YtvPoint* point;
 
-        if (star_points->len > 0)
+        if (calculated)
         {
-                return;
+                return star_points;
         }
 
         incr = -2 * G_PI / 5;
 
-        for (i = 0; i < 6; i++)
+        for (i = 0; i < STAR_POINTS / 2; i++)
         {
                 rad = i * incr - G_PI_2;
 
-                point = g_slice_new0 (YtvPoint);
-
-                point->x = cos (rad);
-                point->y = sin (rad);
+                star_points[2 * i].x = cos (rad);
+                star_points[2 * i].y = sin (rad);
 
-                g_array_append_val (star_points, point);
-                
                 rad += incr / 2;
 
-                point = g_slice_new0 (YtvPoint);
+                star_points[2 * i + 1].x = cos (rad) / 2;
+                star_points[2 * i + 1].y = sin (rad) / 2;
+        }
+
+        calculated = TRUE;
 
-                point->x = cos (rad) / 2;
-                point->y = sin (rad) / 2;
+        return star_points;
+}
 
-                g_array_append_val (star_points, point);
+/* the fill levels of a star: 0..10 are the partial wedges, 11 is full */
+#define STAR_LEVEL_FULL 11
+
+static gint
+get_level (gfloat percentage)
+{
+        if (percentage >= 1.0)
+        {
+                return STAR_LEVEL_FULL;
         }
 
-        return;
+        return CLAMP (rint (percentage / 0.1), 0, 10);
 }
 
 static void
-draw (GtkWidget* self, cairo_t* cr)
+draw_level (cairo_t* cr, gdouble x, gdouble y, gdouble size, gint level)
 {
-        YtvStarPriv* priv;
-        gdouble width, height, side;
-        YtvPoint* point;
+        const YtvPoint* points;
         gint i, num_points;
 
-        priv = YTV_STAR_GET_PRIVATE (self);
-
-        if (priv->star_points->len == 0)
-        {
-                calculate_star_points (priv->star_points);
-        }
-
-        width = self->allocation.width;
-        height = self->allocation.height;
-
-        cairo_translate (cr, width / 2.0, height / 1.85);
-        side = MIN (width, height);
-        cairo_scale (cr, side / 2.0, side / 2.0);
+        points = get_star_points ();
 
         cairo_save (cr); /* stack-pen-size */
 
+        cairo_translate (cr, x + size / 2.0, y + size / 1.85);
+        cairo_scale (cr, size / 2.0, size / 2.0);
+
         cairo_set_source_rgb (cr, 1.0, 0.75, 0.25);
         cairo_set_line_width (cr, 0.1);
         cairo_set_line_join (cr, CAIRO_LINE_JOIN_ROUND);
 
-        point = g_array_index (priv->star_points, YtvPoint*, 0);
-        cairo_move_to (cr, point->x, point->y);
+        cairo_move_to (cr, points[0].x, points[0].y);
 
-        for (i = 1; i < priv->star_points->len; i++)
+        for (i = 1; i < STAR_POINTS; i++)
         {
-                point = g_array_index (priv->star_points, YtvPoint*, i);
-                cairo_line_to (cr, point->x, point->y);
+                cairo_line_to (cr, points[i].x, points[i].y);
         }
 
         cairo_stroke_preserve (cr);
         cairo_clip (cr);
 
-        if (priv->percentage != 1.0)
+        if (level != STAR_LEVEL_FULL)
         {
                 cairo_set_source_rgb (cr, 1, 1, 1);
                 cairo_rectangle (cr, -1, -1, 2, 2);
                 cairo_fill (cr);
                 cairo_set_source_rgb (cr, 1.0, 0.75, 0.25);
                 
-                num_points = 1 + rint (priv->percentage / 0.1);
+                num_points = 1 + level;
 
                 if (num_points != 1)
                 {
@@ -157,9 +159,7 @@ draw (GtkWidget* self, cairo_t* cr)
 
                         for (i = 0; i < num_points; i++)
                         {
-                                point = g_array_index (priv->star_points,
-                                                       YtvPoint*, i);
-                                cairo_line_to (cr, point->x, point->y);
+                                cairo_line_to (cr, points[i].x, points[i].y);
                         }
                 }
         }
@@ -176,6 +176,177 @@ draw (GtkWidget* self, cairo_t* cr)
         return;
 }
 
+/**
+ * ytv_star_draw:
+ * @cr: (not-null): a cairo context
+ * @x: left side of the star box
+ * @y: top side of the star box
+ * @size: side of the star box
+ * @percentage: the area percentage to fill, from 0 to 1
+ *
+ * Draws a star, filled according @percentage, inside the square box at
+ * (@x, @y) in @cr, building its path. Use ytv_star_paint() to paint it
+ * on screen.
+ */
+void
+ytv_star_draw (cairo_t* cr, gdouble x, gdouble y, gdouble size,
+               gfloat percentage)
+{
+        draw_level (cr, x, y, size, get_level (percentage));
+
+        return;
+}
+
+/* the rendered stars of the last sizes painted, the most recent first;
+ * the colours are fixed, so they never have to be rendered again */
+#define CACHE_SIZES 4
+
+typedef struct _YtvStarCache YtvStarCache;
+
+struct _YtvStarCache
+{
+        gint size; /* 0 if unused */
+        cairo_surface_t* levels[STAR_LEVEL_FULL + 1];
+};
+
+static YtvStarCache star_cache[CACHE_SIZES];
+
+static void
+cache_entry_clear (YtvStarCache* entry)
+{
+        gint i;
+
+        for (i = 0; i <= STAR_LEVEL_FULL; i++)
+        {
+                if (entry->levels[i] != NULL)
+                {
+                        cairo_surface_destroy (entry->levels[i]);
+                        entry->levels[i] = NULL;
+                }
+        }
+
+        entry->size = 0;
+
+        return;
+}
+
+static cairo_surface_t*
+get_surface (gint size, gint level)
+{
+        YtvStarCache entry;
+        cairo_surface_t* surface;
+        cairo_t* cr;
+        gint i;
+
+        for (i = 0; i < CACHE_SIZES - 1; i++)
+        {
+                if (star_cache[i].size == size || star_cache[i].size == 0)
+                {
+                        break;
+                }
+        }
+
+        if (star_cache[i].size != size)
+        {
+                /* an unused slot, or the least recently painted size */
+                cache_entry_clear (&star_cache[i]);
+                star_cache[i].size = size;
+        }
+
+        if (i > 0)
+        {
+                entry = star_cache[i];
+                g_memmove (&star_cache[1], &star_cache[0],
+                           i * sizeof (YtvStarCache));
+                star_cache[0] = entry;
+        }
+
+        surface = star_cache[0].levels[level];
+
+        if (surface != NULL)
+        {
+                return surface;
+        }
+
+        YTV_TRACE_BEGIN ("star", "render");
+
+        surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                              size, size);
+        cr = cairo_create (surface);
+        draw_level (cr, 0, 0, size, level);
+        cairo_destroy (cr);
+
+        star_cache[0].levels[level] = surface;
+
+        YTV_TRACE_END ("star", "render");
+
+        return surface;
+}
+
+/**
+ * ytv_star_paint:
+ * @cr: (not-null): a cairo context
+ * @x: left side of the star box
+ * @y: top side of the star box
+ * @size: side of the star box
+ * @percentage: the area percentage to fill, from 0 to 1
+ *
+ * Paints a star like ytv_star_draw(), but from a pre-rendered image
+ * shared by all the stars with the same @size and fill level, so the
+ * star path is built only once.
+ */
+void
+ytv_star_paint (cairo_t* cr, gint x, gint y, gint size, gfloat percentage)
+{
+        if (size <= 0)
+        {
+                return;
+        }
+
+        cairo_set_source_surface (cr, get_surface (size,
+                                                   get_level (percentage)),
+                                  x, y);
+        cairo_paint (cr);
+
+        return;
+}
+
+/**
+ * ytv_star_cache_clear:
+ *
+ * Drops all the pre-rendered stars, e.g. to release their memory.
+ */
+void
+ytv_star_cache_clear (void)
+{
+        gint i;
+
+        for (i = 0; i < CACHE_SIZES; i++)
+        {
+                cache_entry_clear (&star_cache[i]);
+        }
+
+        return;
+}
+
+static void
+draw (GtkWidget* self, cairo_t* cr)
+{
+        YtvStarPriv* priv;
+        gint width, height, side;
+
+        priv = YTV_STAR_GET_PRIVATE (self);
+
+        width = self->allocation.width;
+        height = self->allocation.height;
+        side = MIN (width, height);
+
+        ytv_star_paint (cr, (width - side) / 2, rint ((height - side) / 1.85),
+                        side, priv->percentage);
+
+        return;
+}
+
 static void
 redraw_canvas (YtvStar* self)
 {
@@ -222,6 +393,8 @@ ytv_star_expose_event (GtkWidget* self, GdkEventExpose* event)
 {
         cairo_t* cr;
 
+        YTV_TRACE_BEGIN ("star", "expose");
+
         cr = gdk_cairo_create (self->window);
 
         cairo_rectangle (cr,
@@ -234,6 +407,8 @@ ytv_star_expose_event (GtkWidget* self, GdkEventExpose* event)
 
         cairo_destroy (cr);
 
+        YTV_TRACE_END ("star", "expose");
+
         return FALSE;
 }
 
@@ -288,36 +463,12 @@ ytv_star_get_property (GObject* object, guint prop_id,
         return;
 }
 
-static void
-ytv_star_finalize (GObject* object)
-{
-        YtvStarPriv* priv;
-        gint i;
-        YtvPoint* point;
-
-        priv = YTV_STAR_GET_PRIVATE (object);
-
-        for (i = 0; i < priv->star_points->len; i++)
-        {
-                point = g_array_index (priv->star_points, YtvPoint*, i);
-                g_slice_free (YtvPoint, point);
-        }
-        
-        g_array_free (priv->star_points, TRUE);
-
-        (*G_OBJECT_CLASS (ytv_star_parent_class)->finalize) (object);
-
-        return;
-}
-
 static void
 ytv_star_init (YtvStar* self)
 {
         YtvStarPriv* priv = YTV_STAR_GET_PRIVATE (self);
 
         priv->percentage = 0;
-        priv->star_points = g_array_sized_new (FALSE, FALSE,
-                                               sizeof (YtvPoint*), 12);
 
         return;
 }
@@ -332,7 +483,6 @@ ytv_star_class_init (YtvStarClass* klass)
 
         object_class->set_property = ytv_star_set_property;
         object_class->get_property = ytv_star_get_property;
-        object_class->finalize     = ytv_star_finalize;
         
         widget_class->expose_event = ytv_star_expose_event;
         widget_class->size_request = ytv_star_size_request; 
@@ -60,6 +60,12 @@ struct _YtvStarClass
 GType      ytv_star_get_type (void);
 GtkWidget* ytv_star_new (gfloat percentage);
 
+void ytv_star_draw (cairo_t* cr, gdouble x, gdouble y, gdouble size,
+                    gfloat percentage);
+void ytv_star_paint (cairo_t* cr, gint x, gint y, gint size,
+                     gfloat percentage);
+void ytv_star_cache_clear (void);
+
 G_END_DECLS
 
 #endif /* _YTV_STAR_H_ */
@@ -0,0 +1,456 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-stats.c - Runtime statistics registry
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-stats
+ * @short_description: counters and latency histograms of the viewer
+ *
+ * A process wide registry of 64 bit counters and fixed-bucket latency
+ * histograms, updated with atomic operations from the fetch and parse
+ * strategies, the lists, the thumbnails and the browser.
+ *
+ * The registry can be serialized as JSON with ytv_stats_to_json(), and
+ * written on demand when the process receives a signal, after calling
+ * ytv_stats_dump_on_signal().
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <ytv-error.h>
+#include <ytv-stats.h>
+
+/* upper bounds, in milliseconds, of the histogram buckets; the last
+ * bucket holds everything above */
+static const gdouble bounds[] =
+{
+        1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192
+};
+
+#define NUM_BUCKETS (G_N_ELEMENTS (bounds) + 1)
+
+typedef struct _YtvHistogram YtvHistogram;
+
+struct _YtvHistogram
+{
+        gint buckets[NUM_BUCKETS];
+        gint count;
+        gdouble sum; /* protected by stats_lock */
+};
+
+static const gchar* counter_names[YTV_STATS_LAST_COUNTER] =
+{
+        "requests",
+        "requests-in-flight",
+        "bytes-fetched",
+        "feeds-parsed",
+        "history-hits",
+        "stale-hits",
+        "revalidations",
+        "entries-parsed",
+        "lists",
+        "list-items",
+        "thumbnails-decoded",
+        "pixbuf-bytes",
+        "decoded-bytes",
+        "thumbnail-upgrades",
+        "entry-views",
+        "pages-shown",
+        "store-records",
+        "store-syncs",
+        "http-errors",
+        "parse-errors",
+        "other-errors"
+};
+
+static const gchar* histogram_names[YTV_STATS_LAST_HISTOGRAM] =
+{
+        "fetch-latency-ms",
+        "parse-time-ms",
+        "decode-time-ms",
+        "page-time-ms",
+        "first-entry-time-ms",
+        "search-time-ms"
+};
+
+/* the byte counters overflow 32 bits in a long session, and there is no
+ * 64 bit atomic add: a counter is the sum of an atomic 32 bit part,
+ * updated lock-free, and a 64 bit part where the former is folded, under
+ * stats_lock, before it gets near to overflow */
+static volatile gint counters[YTV_STATS_LAST_COUNTER];
+static gint64 folded[YTV_STATS_LAST_COUNTER];
+static YtvHistogram histograms[YTV_STATS_LAST_HISTOGRAM];
+static GStaticMutex stats_lock = G_STATIC_MUTEX_INIT;
+
+#define FOLD_LIMIT (1 << 30)
+
+static gint signal_pipe[2] = { -1, -1 };
+static gchar* signal_file = NULL;
+
+/**
+ * ytv_stats_add:
+ * @counter: the #YtvStatsCounter to modify
+ * @delta: the amount to add, negative for gauges going down
+ *
+ * Atomically adds @delta to @counter.
+ */
+void
+ytv_stats_add (YtvStatsCounter counter, gint delta)
+{
+        gint value;
+
+        g_assert (counter < YTV_STATS_LAST_COUNTER);
+
+        value = g_atomic_int_exchange_and_add (&counters[counter], delta) +
+                delta;
+
+        if (G_UNLIKELY (value >= FOLD_LIMIT || value <= -FOLD_LIMIT))
+        {
+                g_static_mutex_lock (&stats_lock);
+
+                /* only what is moved is taken out: a concurrent add stays
+                 * in the atomic part */
+                value = g_atomic_int_get (&counters[counter]);
+                g_atomic_int_add (&counters[counter], -value);
+                folded[counter] += value;
+
+                g_static_mutex_unlock (&stats_lock);
+        }
+
+        return;
+}
+
+/**
+ * ytv_stats_get:
+ * @counter: a #YtvStatsCounter
+ *
+ * returns: the current value of @counter
+ */
+gint64
+ytv_stats_get (YtvStatsCounter counter)
+{
+        gint64 value;
+
+        g_assert (counter < YTV_STATS_LAST_COUNTER);
+
+        g_static_mutex_lock (&stats_lock);
+        value = folded[counter] + g_atomic_int_get (&counters[counter]);
+        g_static_mutex_unlock (&stats_lock);
+
+        return value;
+}
+
+/**
+ * ytv_stats_count_error:
+ * @err: (null-ok): a #GError
+ *
+ * Increments the error counter of the @err's domain.
+ */
+void
+ytv_stats_count_error (const GError* err)
+{
+        if (err == NULL)
+        {
+                return;
+        }
+
+        if (err->domain == YTV_HTTP_ERROR)
+        {
+                ytv_stats_inc (YTV_STATS_HTTP_ERRORS);
+        }
+        else if (err->domain == YTV_PARSE_ERROR)
+        {
+                ytv_stats_inc (YTV_STATS_PARSE_ERRORS);
+        }
+        else
+        {
+                ytv_stats_inc (YTV_STATS_OTHER_ERRORS);
+        }
+
+        return;
+}
+
+/**
+ * ytv_stats_time_now:
+ *
+ * returns: the current time, to be used with ytv_stats_observe_since()
+ */
+YtvStatsTime
+ytv_stats_time_now (void)
+{
+        GTimeVal tv;
+
+        g_get_current_time (&tv);
+
+        return ((gint64) tv.tv_sec) * G_USEC_PER_SEC + tv.tv_usec;
+}
+
+/**
+ * ytv_stats_observe:
+ * @histogram: the #YtvStatsHistogram to update
+ * @ms: the measured latency, in milliseconds
+ *
+ * Adds a sample into the bucket of @histogram where it belongs.
+ */
+void
+ytv_stats_observe (YtvStatsHistogram histogram, gdouble ms)
+{
+        YtvHistogram* h;
+        guint i;
+
+        g_assert (histogram < YTV_STATS_LAST_HISTOGRAM);
+
+        h = &histograms[histogram];
+
+        for (i = 0; i < G_N_ELEMENTS (bounds) && ms > bounds[i]; i++)
+                ;
+
+        g_atomic_int_add (&h->buckets[i], 1);
+        g_atomic_int_add (&h->count, 1);
+
+        g_static_mutex_lock (&stats_lock);
+        h->sum += ms;
+        g_static_mutex_unlock (&stats_lock);
+
+        return;
+}
+
+/**
+ * ytv_stats_observe_since:
+ * @histogram: the #YtvStatsHistogram to update
+ * @start: a time given by ytv_stats_time_now()
+ *
+ * Adds the time elapsed since @start to @histogram.
+ */
+void
+ytv_stats_observe_since (YtvStatsHistogram histogram, YtvStatsTime start)
+{
+        ytv_stats_observe (histogram,
+                           (ytv_stats_time_now () - start) / 1000.0);
+
+        return;
+}
+
+static void
+append_histogram (GString* json, YtvStatsHistogram histogram)
+{
+        YtvHistogram* h;
+        gdouble sum;
+        guint i;
+
+        h = &histograms[histogram];
+
+        g_static_mutex_lock (&stats_lock);
+        sum = h->sum;
+        g_static_mutex_unlock (&stats_lock);
+
+        g_string_append_printf (json, "\"%s\":{\"count\":%d,\"sum\":%.3f,"
+                                "\"buckets\":{", histogram_names[histogram],
+                                g_atomic_int_get (&h->count), sum);
+
+        for (i = 0; i < G_N_ELEMENTS (bounds); i++)
+        {
+                g_string_append_printf (json, "\"%g\":%d,", bounds[i],
+                                        g_atomic_int_get (&h->buckets[i]));
+        }
+
+        g_string_append_printf (json, "\"+Inf\":%d}}",
+                                g_atomic_int_get (&h->buckets[i]));
+
+        return;
+}
+
+/**
+ * ytv_stats_to_json:
+ *
+ * Serializes the current state of the registry.
+ *
+ * returns: (not-null) (caller-owns): a JSON object as string
+ */
+gchar*
+ytv_stats_to_json (void)
+{
+        GString* json;
+        gint64 values[YTV_STATS_LAST_COUNTER];
+        guint i;
+
+        /* a consistent snapshot, formatted out of the lock */
+        g_static_mutex_lock (&stats_lock);
+
+        for (i = 0; i < YTV_STATS_LAST_COUNTER; i++)
+        {
+                values[i] = folded[i] + g_atomic_int_get (&counters[i]);
+        }
+
+        g_static_mutex_unlock (&stats_lock);
+
+        json = g_string_new ("{\"counters\":{");
+
+        for (i = 0; i < YTV_STATS_LAST_COUNTER; i++)
+        {
+                g_string_append_printf (json, "%s\"%s\":%" G_GINT64_FORMAT,
+                                        i > 0 ? "," : "", counter_names[i],
+                                        values[i]);
+        }
+
+        g_string_append (json, "},\"histograms\":{");
+
+        for (i = 0; i < YTV_STATS_LAST_HISTOGRAM; i++)
+        {
+                if (i > 0)
+                {
+                        g_string_append_c (json, ',');
+                }
+
+                append_histogram (json, i);
+        }
+
+        g_string_append (json, "}}");
+
+        return g_string_free (json, FALSE);
+}
+
+/**
+ * ytv_stats_dump:
+ * @filename: (null-ok): the file where to write
+ *
+ * Writes the registry as JSON in @filename, or in the standard error
+ * output if it is %NULL.
+ *
+ * returns: %TRUE if the registry was written
+ */
+gboolean
+ytv_stats_dump (const gchar* filename)
+{
+        gchar* json;
+        gboolean retval;
+
+        json = ytv_stats_to_json ();
+        retval = TRUE;
+
+        if (filename == NULL)
+        {
+                fprintf (stderr, "%s\n", json);
+        }
+        else
+        {
+                GError* error = NULL;
+                gchar* contents;
+
+                contents = g_strconcat (json, "\n", NULL);
+                retval = g_file_set_contents (filename, contents, -1, &error);
+
+                if (!retval)
+                {
+                        g_warning ("Cannot write the stats: %s",
+                                   error->message);
+                        g_error_free (error);
+                }
+
+                g_free (contents);
+        }
+
+        g_free (json);
+
+        return retval;
+}
+
+static void
+on_signal (gint signum)
+{
+        gint saved_errno = errno;
+        gchar c = 0;
+
+        /* only async-signal-safe calls here */
+        if (write (signal_pipe[1], &c, 1) < 0)
+        {
+                ; /* the pipe is full, a dump is pending anyway */
+        }
+
+        errno = saved_errno;
+
+        return;
+}
+
+static gboolean
+signal_watch_cb (GIOChannel* source, GIOCondition condition,
+                 gpointer user_data)
+{
+        gchar buf[16];
+
+        while (read (signal_pipe[0], buf, sizeof (buf)) > 0)
+                ;
+
+        ytv_stats_dump (signal_file);
+
+        return TRUE;
+}
+
+/**
+ * ytv_stats_dump_on_signal:
+ * @signum: the Unix signal which triggers the dump, like SIGUSR1
+ * @filename: (null-ok): the file where to write, or %NULL for stderr
+ *
+ * Installs a handler for @signum which writes the registry from the
+ * default main context.
+ *
+ * returns: %TRUE if the handler was installed
+ */
+gboolean
+ytv_stats_dump_on_signal (gint signum, const gchar* filename)
+{
+        struct sigaction sa;
+        GIOChannel* channel;
+
+        if (signal_pipe[0] != -1)
+        {
+                return FALSE;
+        }
+
+        if (pipe (signal_pipe) != 0)
+        {
+                g_warning ("Cannot create the stats signal pipe");
+                return FALSE;
+        }
+
+        fcntl (signal_pipe[0], F_SETFL, O_NONBLOCK);
+        fcntl (signal_pipe[1], F_SETFL, O_NONBLOCK);
+
+        signal_file = g_strdup (filename);
+
+        channel = g_io_channel_unix_new (signal_pipe[0]);
+        g_io_add_watch (channel, G_IO_IN, signal_watch_cb, NULL);
+        g_io_channel_unref (channel);
+
+        sa.sa_handler = on_signal;
+        sigemptyset (&sa.sa_mask);
+        sa.sa_flags = SA_RESTART;
+        sigaction (signum, &sa, NULL);
+
+        return TRUE;
+}
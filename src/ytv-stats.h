@@ -0,0 +1,104 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_STATS_H_
+#define _YTV_STATS_H_
+
+/* ytv-stats.h - Runtime statistics registry
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * YtvStatsCounter:
+ *
+ * The counters of the registry. Some of them are gauges: they go up and
+ * down following the resources currently in use.
+ */
+enum _YtvStatsCounter
+{
+        YTV_STATS_REQUESTS,             /* HTTP requests issued */
+        YTV_STATS_REQUESTS_IN_FLIGHT,   /* gauge */
+        YTV_STATS_BYTES_FETCHED,
+        YTV_STATS_FEEDS_PARSED,
+        YTV_STATS_HISTORY_HITS,         /* pages reused without fetching */
+        YTV_STATS_STALE_HITS,           /* stale pages shown, then fetched */
+        YTV_STATS_REVALIDATIONS,        /* stale pages which had changed */
+        YTV_STATS_ENTRIES_PARSED,
+        YTV_STATS_LISTS,                /* gauge: live YtvSimpleList */
+        YTV_STATS_LIST_ITEMS,           /* gauge: items in all the lists */
+        YTV_STATS_THUMBNAILS_DECODED,
+        YTV_STATS_PIXBUF_BYTES,         /* gauge: thumbnail pixels kept */
+        YTV_STATS_DECODED_BYTES,        /* pixels allocated while decoding */
+        YTV_STATS_THUMBNAIL_UPGRADES,   /* sharper variants fetched later */
+        YTV_STATS_ENTRY_VIEWS,          /* entry views created */
+        YTV_STATS_PAGES_SHOWN,
+        YTV_STATS_STORE_RECORDS,        /* records appended to the store */
+        YTV_STATS_STORE_SYNCS,          /* fsync of the store batches */
+        YTV_STATS_HTTP_ERRORS,
+        YTV_STATS_PARSE_ERRORS,
+        YTV_STATS_OTHER_ERRORS,
+
+        YTV_STATS_LAST_COUNTER
+};
+
+typedef enum _YtvStatsCounter YtvStatsCounter;
+
+/**
+ * YtvStatsHistogram:
+ *
+ * The latency histograms of the registry, in milliseconds.
+ */
+enum _YtvStatsHistogram
+{
+        YTV_STATS_FETCH_LATENCY,        /* request queued to response */
+        YTV_STATS_PARSE_TIME,
+        YTV_STATS_DECODE_TIME,          /* thumbnail decode and scale */
+        YTV_STATS_PAGE_TIME,            /* browser page population */
+        YTV_STATS_FIRST_ENTRY_TIME,     /* page data to first entry shown */
+        YTV_STATS_SEARCH_TIME,          /* keystroke to search results */
+
+        YTV_STATS_LAST_HISTOGRAM
+};
+
+typedef enum _YtvStatsHistogram YtvStatsHistogram;
+
+/* microseconds from an arbitrary origin */
+typedef gint64 YtvStatsTime;
+
+#define ytv_stats_inc(counter) ytv_stats_add ((counter), 1)
+#define ytv_stats_dec(counter) ytv_stats_add ((counter), -1)
+
+void ytv_stats_add (YtvStatsCounter counter, gint delta);
+gint64 ytv_stats_get (YtvStatsCounter counter);
+void ytv_stats_count_error (const GError* err);
+
+YtvStatsTime ytv_stats_time_now (void);
+void ytv_stats_observe (YtvStatsHistogram histogram, gdouble ms);
+void ytv_stats_observe_since (YtvStatsHistogram histogram,
+                              YtvStatsTime start);
+
+gchar* ytv_stats_to_json (void);
+gboolean ytv_stats_dump (const gchar* filename);
+gboolean ytv_stats_dump_on_signal (gint signum, const gchar* filename);
+
+G_END_DECLS
+
+#endif /* _YTV_STATS_H_ */
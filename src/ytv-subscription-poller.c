@@ -0,0 +1,1129 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-subscription-poller.c - Polls periodically a set of feeds
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-subscription-poller
+ * @title: YtvSubscriptionPoller
+ * @short_description: watches a set of feeds for new entries
+ *
+ * The #YtvSubscriptionPoller keeps a set of subscriptions, usually the
+ * uploads of several users, and polls each one of them every its own
+ * interval. Only the entries which were not in the previous poll of a
+ * subscription are delivered, through the ::new-entries signal; the first
+ * poll just records what is already there.
+ *
+ * The subscriptions are kept in a heap by their due time, and a single
+ * timer waits for the soonest one. The due subscriptions are queued and
+ * requested through a window of at most "max-parallel" requests, so the
+ * network load is bounded whatever the number of subscriptions. Every
+ * poll is rescheduled from its completion, with a random "jitter", so the
+ * polls spread along the time instead of coming in bursts.
+ *
+ * A subscription which does not bring new entries, or fails, is polled
+ * half as often the next time, until "max-interval"; new entries bring it
+ * back to its own interval.
+ */
+
+/**
+ * YtvSubscriptionPoller:
+ *
+ * Watches a set of feeds for new entries
+ *
+ * free-function: g_object_unref
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <ytv-subscription-poller.h>
+
+#include <ytv-entry.h>
+#include <ytv-error.h>
+#include <ytv-feed.h>
+#include <ytv-feed-fetch-strategy.h>
+#include <ytv-feed-parse-strategy.h>
+#include <ytv-iterator.h>
+#include <ytv-list.h>
+#include <ytv-simple-list.h>
+#include <ytv-uri-builder.h>
+#include <ytv-marshal.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
+
+enum _YtvSubscriptionPollerProp
+{
+        PROP_0,
+        PROP_FEED,
+        PROP_MAX_PARALLEL,
+        PROP_INTERVAL,
+        PROP_MAX_INTERVAL,
+        PROP_JITTER
+};
+
+enum _YtvSubscriptionPollerSignal
+{
+        NEW_ENTRIES,
+        LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+typedef struct _YtvSubscription YtvSubscription;
+
+struct _YtvSubscription
+{
+        guint id;             /* tells apart a removed and added again name */
+        gchar* name;
+        gchar* uri;
+        guint interval;       /* seconds between polls while it changes */
+        guint backoff;        /* multiplier of the interval */
+        YtvStatsTime due;
+        gboolean queued;      /* in the ready queue or in flight */
+        gboolean primed;      /* polled at least once */
+        GHashTable* seen;     /* ids of the last poll */
+};
+
+typedef struct _YtvSubscriptionPollerPriv YtvSubscriptionPollerPriv;
+
+struct _YtvSubscriptionPollerPriv
+{
+        YtvFeed* feed;
+        guint max_parallel;
+        guint interval;
+        guint max_interval;
+        guint jitter;
+
+        gboolean running;
+        guint serial;         /* discards the responses of older runs */
+        guint next_id;
+        GHashTable* subs;     /* name -> YtvSubscription */
+        GPtrArray* heap;      /* the scheduled subscriptions, soonest first */
+        GQueue* ready;        /* due subscriptions waiting for a slot */
+        GList* pending;       /* of YtvPollRequest, to cancel them */
+        guint inflight;       /* the pending ones, of any run */
+        guint timer_id;
+};
+
+typedef struct _YtvPollRequest YtvPollRequest;
+
+struct _YtvPollRequest
+{
+        YtvSubscriptionPoller* self;
+        guint serial;
+        guint id;
+        gchar* name;
+};
+
+#define YTV_SUBSCRIPTION_POLLER_GET_PRIVATE(obj)        \
+        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_SUBSCRIPTION_POLLER, YtvSubscriptionPollerPriv))
+
+#define DEFAULT_INTERVAL     600   /* seconds */
+#define DEFAULT_MAX_INTERVAL 21600 /* seconds */
+
+G_DEFINE_TYPE (YtvSubscriptionPoller, ytv_subscription_poller, G_TYPE_OBJECT)
+
+static void poll_cb (YtvFeedFetchStrategy* st, const gchar* mime,
+                     const gint8* response, gssize length,
+                     GError** err, gpointer user_data);
+
+static void
+subscription_free (YtvSubscription* sub)
+{
+        g_hash_table_destroy (sub->seen);
+        g_free (sub->name);
+        g_free (sub->uri);
+        g_slice_free (YtvSubscription, sub);
+
+        return;
+}
+
+static gboolean
+heap_less (YtvSubscriptionPollerPriv* priv, guint i, guint j)
+{
+        YtvSubscription* a = g_ptr_array_index (priv->heap, i);
+        YtvSubscription* b = g_ptr_array_index (priv->heap, j);
+
+        return a->due < b->due;
+}
+
+static void
+heap_swap (YtvSubscriptionPollerPriv* priv, guint i, guint j)
+{
+        gpointer tmp;
+
+        tmp = priv->heap->pdata[i];
+        priv->heap->pdata[i] = priv->heap->pdata[j];
+        priv->heap->pdata[j] = tmp;
+
+        return;
+}
+
+static void
+heap_sift_up (YtvSubscriptionPollerPriv* priv, guint i)
+{
+        for (; i > 0; i = (i - 1) / 2)
+        {
+                if (!heap_less (priv, i, (i - 1) / 2))
+                {
+                        break;
+                }
+
+                heap_swap (priv, i, (i - 1) / 2);
+        }
+
+        return;
+}
+
+static void
+heap_sift_down (YtvSubscriptionPollerPriv* priv, guint i)
+{
+        guint child;
+
+        while ((child = 2 * i + 1) < priv->heap->len)
+        {
+                if (child + 1 < priv->heap->len &&
+                    heap_less (priv, child + 1, child))
+                {
+                        child++;
+                }
+
+                if (!heap_less (priv, child, i))
+                {
+                        break;
+                }
+
+                heap_swap (priv, i, child);
+                i = child;
+        }
+
+        return;
+}
+
+static void
+heap_push (YtvSubscriptionPollerPriv* priv, YtvSubscription* sub)
+{
+        g_ptr_array_add (priv->heap, sub);
+        heap_sift_up (priv, priv->heap->len - 1);
+
+        return;
+}
+
+static YtvSubscription*
+heap_pop (YtvSubscriptionPollerPriv* priv)
+{
+        YtvSubscription* sub;
+
+        sub = g_ptr_array_index (priv->heap, 0);
+
+        heap_swap (priv, 0, priv->heap->len - 1);
+        g_ptr_array_remove_index (priv->heap, priv->heap->len - 1);
+        heap_sift_down (priv, 0);
+
+        return sub;
+}
+
+static void
+heap_remove (YtvSubscriptionPollerPriv* priv, YtvSubscription* sub)
+{
+        guint i;
+
+        for (i = 0; i < priv->heap->len; i++)
+        {
+                if (g_ptr_array_index (priv->heap, i) == sub)
+                {
+                        break;
+                }
+        }
+
+        if (i == priv->heap->len)
+        {
+                return;
+        }
+
+        heap_swap (priv, i, priv->heap->len - 1);
+        g_ptr_array_remove_index (priv->heap, priv->heap->len - 1);
+
+        if (i < priv->heap->len)
+        {
+                heap_sift_down (priv, i);
+                heap_sift_up (priv, i);
+        }
+
+        return;
+}
+
+/* seconds until the next poll of @sub, backed off and jittered */
+static gdouble
+next_delay (YtvSubscriptionPollerPriv* priv, YtvSubscription* sub)
+{
+        gdouble delay;
+        gdouble jitter;
+
+        delay = (gdouble) sub->interval * sub->backoff;
+
+        if (priv->max_interval > 0)
+        {
+                delay = MIN (delay, (gdouble) priv->max_interval);
+        }
+
+        jitter = priv->jitter / 100.0;
+
+        if (jitter > 0)
+        {
+                delay *= 1 + g_random_double_range (-jitter, jitter);
+        }
+
+        return delay;
+}
+
+static void
+schedule (YtvSubscriptionPollerPriv* priv, YtvSubscription* sub,
+          gdouble delay)
+{
+        sub->due = ytv_stats_time_now () + (YtvStatsTime) (delay * G_USEC_PER_SEC);
+        sub->queued = FALSE;
+        heap_push (priv, sub);
+
+        return;
+}
+
+static void arm_timer (YtvSubscriptionPoller* self);
+
+static void
+issue_poll (YtvSubscriptionPoller* self, YtvSubscription* sub)
+{
+        YtvSubscriptionPollerPriv* priv;
+        YtvFeedFetchStrategy* fetchst;
+        YtvPollRequest* req;
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        req = g_slice_new (YtvPollRequest);
+        req->self = g_object_ref (self);
+        req->serial = priv->serial;
+        req->id = sub->id;
+        req->name = g_strdup (sub->name);
+
+        priv->pending = g_list_prepend (priv->pending, req);
+        priv->inflight++;
+        YTV_TRACE_COUNTER ("poll", "polls-in-flight", priv->inflight);
+
+        fetchst = ytv_feed_get_fetch_strategy (priv->feed);
+        ytv_feed_fetch_strategy_perform (fetchst, sub->uri, poll_cb, req);
+        g_object_unref (fetchst);
+
+        return;
+}
+
+/* requests the due subscriptions while there are free slots */
+static void
+pump (YtvSubscriptionPoller* self)
+{
+        YtvSubscriptionPollerPriv* priv;
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        while (priv->running && priv->inflight < priv->max_parallel &&
+               !g_queue_is_empty (priv->ready))
+        {
+                issue_poll (self,
+                            (YtvSubscription*) g_queue_pop_head (priv->ready));
+        }
+
+        return;
+}
+
+static gboolean
+timer_cb (gpointer user_data)
+{
+        YtvSubscriptionPoller* self;
+        YtvSubscriptionPollerPriv* priv;
+        YtvSubscription* sub;
+        YtvStatsTime now;
+
+        self = YTV_SUBSCRIPTION_POLLER (user_data);
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        priv->timer_id = 0;
+        now = ytv_stats_time_now ();
+
+        while (priv->heap->len > 0)
+        {
+                sub = g_ptr_array_index (priv->heap, 0);
+
+                if (sub->due > now)
+                {
+                        break;
+                }
+
+                heap_pop (priv);
+                sub->queued = TRUE;
+                g_queue_push_tail (priv->ready, sub);
+        }
+
+        pump (self);
+        arm_timer (self);
+
+        return FALSE;
+}
+
+/* waits for the soonest subscription */
+static void
+arm_timer (YtvSubscriptionPoller* self)
+{
+        YtvSubscriptionPollerPriv* priv;
+        YtvSubscription* sub;
+        YtvStatsTime wait;
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        if (priv->timer_id != 0)
+        {
+                g_source_remove (priv->timer_id);
+                priv->timer_id = 0;
+        }
+
+        if (!priv->running || priv->heap->len == 0)
+        {
+                return;
+        }
+
+        sub = g_ptr_array_index (priv->heap, 0);
+        wait = MAX (sub->due - ytv_stats_time_now (), 0);
+
+        priv->timer_id = g_timeout_add ((guint) (wait / 1000), timer_cb, self);
+
+        return;
+}
+
+/* returns the entries which were not in the previous poll, or NULL */
+static YtvList*
+update_seen (YtvSubscription* sub, YtvList* list)
+{
+        YtvList* fresh;
+        YtvIterator* iter;
+        GHashTable* seen;
+        GObject* entry;
+        gchar* id;
+
+        fresh = NULL;
+        seen = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+        iter = ytv_list_create_iterator (list);
+
+        while (!ytv_iterator_is_done (iter))
+        {
+                entry = ytv_iterator_get_current (iter);
+                g_object_get (entry, "id", &id, NULL);
+
+                if (id != NULL)
+                {
+                        if (sub->primed &&
+                            g_hash_table_lookup (sub->seen, id) == NULL)
+                        {
+                                if (fresh == NULL)
+                                {
+                                        fresh = ytv_simple_list_new ();
+                                }
+
+                                ytv_list_append (fresh, entry);
+                        }
+
+                        g_hash_table_replace (seen, id, GINT_TO_POINTER (TRUE));
+                }
+
+                g_object_unref (entry);
+                ytv_iterator_next (iter);
+        }
+
+        g_object_unref (iter);
+
+        g_hash_table_destroy (sub->seen);
+        sub->seen = seen;
+        sub->primed = TRUE;
+
+        return fresh;
+}
+
+static void
+back_off (YtvSubscriptionPollerPriv* priv, YtvSubscription* sub)
+{
+        if (priv->max_interval == 0 ||
+            (gdouble) sub->interval * sub->backoff * 2 <= priv->max_interval)
+        {
+                sub->backoff *= 2;
+        }
+
+        return;
+}
+
+static void
+poll_cb (YtvFeedFetchStrategy* st, const gchar* mime,
+         const gint8* response, gssize length, GError** err,
+         gpointer user_data)
+{
+        YtvPollRequest* req;
+        YtvSubscriptionPoller* self;
+        YtvSubscriptionPollerPriv* priv;
+        YtvSubscription* sub;
+        YtvFeedParseStrategy* parsest;
+        YtvList* list;
+        YtvList* fresh;
+        GError* tmp_error;
+        gboolean primed;
+
+        req = (YtvPollRequest*) user_data;
+        self = req->self;
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+        parsest = NULL;
+        list = NULL;
+        fresh = NULL;
+        tmp_error = NULL;
+
+        /* a stale poll still held its slot of the window until now */
+        priv->pending = g_list_remove (priv->pending, req);
+        priv->inflight--;
+        YTV_TRACE_COUNTER ("poll", "polls-in-flight", priv->inflight);
+
+        if (req->serial != priv->serial)
+        {
+                /* stopped meanwhile */
+                if (err != NULL && *err != NULL)
+                {
+                        g_error_free (*err);
+                        *err = NULL;
+                }
+
+                goto next;
+        }
+
+        sub = g_hash_table_lookup (priv->subs, req->name);
+
+        if (sub == NULL || sub->id != req->id)
+        {
+                /* removed meanwhile */
+                if (err != NULL && *err != NULL)
+                {
+                        g_error_free (*err);
+                        *err = NULL;
+                }
+
+                goto next;
+        }
+
+        if (err != NULL && *err != NULL)
+        {
+                g_debug ("poll of %s failed: %s", sub->name,
+                         ytv_error_get_message (*err));
+                g_error_free (*err);
+                *err = NULL;
+                back_off (priv, sub);
+                goto reschedule;
+        }
+
+        parsest = ytv_feed_get_parse_strategy (priv->feed);
+
+        if (mime == NULL ||
+            g_strrstr (mime, ytv_feed_parse_strategy_get_mime (parsest)) == NULL)
+        {
+                g_debug ("poll of %s failed: bad MIME type - %s", sub->name,
+                         mime);
+                back_off (priv, sub);
+                goto reschedule;
+        }
+
+        list = ytv_feed_parse_strategy_perform (parsest, (guchar*) response,
+                                                length, &tmp_error);
+
+        if (tmp_error != NULL)
+        {
+                if (ytv_error_get_code (tmp_error) !=
+                    YTV_PARSE_ERROR_BAD_FORMAT)
+                {
+                        g_debug ("poll of %s failed: %s", sub->name,
+                                 ytv_error_get_message (tmp_error));
+                        g_error_free (tmp_error);
+                        back_off (priv, sub);
+                        goto reschedule;
+                }
+
+                /* a feed without entries */
+                g_error_free (tmp_error);
+        }
+
+        if (list == NULL)
+        {
+                list = ytv_simple_list_new ();
+        }
+
+        primed = sub->primed;
+        fresh = update_seen (sub, list);
+
+        if (fresh != NULL)
+        {
+                sub->backoff = 1;
+        }
+        else if (primed)
+        {
+                back_off (priv, sub);
+        }
+
+reschedule:
+        schedule (priv, sub, next_delay (priv, sub));
+
+        if (fresh != NULL)
+        {
+                g_signal_emit (self, signals[NEW_ENTRIES], 0, sub->name, fresh);
+        }
+
+next:
+        pump (self);
+        arm_timer (self);
+
+        if (fresh != NULL)
+        {
+                g_object_unref (fresh);
+        }
+
+        if (list != NULL)
+        {
+                g_object_unref (list);
+        }
+
+        if (parsest != NULL)
+        {
+                g_object_unref (parsest);
+        }
+
+        g_object_unref (req->self);
+        g_free (req->name);
+        g_slice_free (YtvPollRequest, req);
+
+        return;
+}
+
+static void
+ytv_subscription_poller_add_uri_default (YtvSubscriptionPoller* self,
+                                         const gchar* name,
+                                         const gchar* uri,
+                                         guint interval)
+{
+        YtvSubscriptionPollerPriv* priv;
+        YtvSubscription* sub;
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        if (g_hash_table_lookup (priv->subs, name) != NULL)
+        {
+                g_warning ("Already subscribed to %s", name);
+                return;
+        }
+
+        sub = g_slice_new (YtvSubscription);
+        sub->id = priv->next_id++;
+        sub->name = g_strdup (name);
+        sub->uri = g_strdup (uri);
+        sub->interval = (interval > 0) ? interval : priv->interval;
+        sub->backoff = 1;
+        sub->primed = FALSE;
+        sub->seen = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                           g_free, NULL);
+
+        g_hash_table_insert (priv->subs, sub->name, sub);
+
+        /* the first poll is due now; the window keeps the burst bounded */
+        schedule (priv, sub, 0);
+        arm_timer (self);
+
+        return;
+}
+
+static void
+ytv_subscription_poller_stop_default (YtvSubscriptionPoller* self)
+{
+        YtvSubscriptionPollerPriv* priv;
+        YtvFeedFetchStrategy* fetchst;
+        GHashTableIter iter;
+        gpointer value;
+        YtvSubscription* sub;
+        GList* pending;
+        GList* l;
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        priv->running = FALSE;
+        priv->serial++;
+        g_queue_clear (priv->ready);
+
+        arm_timer (self);
+
+        /* the callbacks run, and free the requests, while cancelling; the
+         * polls which can not be cancelled keep their slot until then */
+        if (priv->pending != NULL)
+        {
+                fetchst = ytv_feed_get_fetch_strategy (priv->feed);
+                pending = g_list_copy (priv->pending);
+
+                for (l = pending; l != NULL; l = l->next)
+                {
+                        if (g_list_find (priv->pending, l->data) != NULL)
+                        {
+                                ytv_feed_fetch_strategy_cancel (fetchst,
+                                                                l->data);
+                        }
+                }
+
+                g_list_free (pending);
+                g_object_unref (fetchst);
+        }
+
+        /* the ready and in flight subscriptions are due again */
+        g_hash_table_iter_init (&iter, priv->subs);
+
+        while (g_hash_table_iter_next (&iter, NULL, &value))
+        {
+                sub = (YtvSubscription*) value;
+
+                if (sub->queued)
+                {
+                        schedule (priv, sub, 0);
+                }
+        }
+
+        return;
+}
+
+static void
+ytv_subscription_poller_set_property (GObject* object, guint prop_id,
+                                      const GValue* value, GParamSpec* spec)
+{
+        YtvSubscriptionPollerPriv* priv;
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_FEED:
+                priv->feed = g_value_dup_object (value);
+                break;
+        case PROP_MAX_PARALLEL:
+                priv->max_parallel = g_value_get_uint (value);
+                pump (YTV_SUBSCRIPTION_POLLER (object));
+                break;
+        case PROP_INTERVAL:
+                priv->interval = g_value_get_uint (value);
+                break;
+        case PROP_MAX_INTERVAL:
+                priv->max_interval = g_value_get_uint (value);
+                break;
+        case PROP_JITTER:
+                priv->jitter = g_value_get_uint (value);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_subscription_poller_get_property (GObject* object, guint prop_id,
+                                      GValue* value, GParamSpec* spec)
+{
+        YtvSubscriptionPollerPriv* priv;
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (object);
+
+        switch (prop_id)
+        {
+        case PROP_FEED:
+                g_value_set_object (value, priv->feed);
+                break;
+        case PROP_MAX_PARALLEL:
+                g_value_set_uint (value, priv->max_parallel);
+                break;
+        case PROP_INTERVAL:
+                g_value_set_uint (value, priv->interval);
+                break;
+        case PROP_MAX_INTERVAL:
+                g_value_set_uint (value, priv->max_interval);
+                break;
+        case PROP_JITTER:
+                g_value_set_uint (value, priv->jitter);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
+                break;
+        }
+
+        return;
+}
+
+static void
+ytv_subscription_poller_dispose (GObject* object)
+{
+        YtvSubscriptionPollerPriv* priv;
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (object);
+
+        if (priv->running)
+        {
+                ytv_subscription_poller_stop_default
+                        (YTV_SUBSCRIPTION_POLLER (object));
+        }
+
+        if (priv->feed != NULL)
+        {
+                g_object_unref (priv->feed);
+                priv->feed = NULL;
+        }
+
+        (*G_OBJECT_CLASS (ytv_subscription_poller_parent_class)->dispose) (object);
+
+        return;
+}
+
+static void
+ytv_subscription_poller_finalize (GObject* object)
+{
+        YtvSubscriptionPollerPriv* priv;
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (object);
+
+        g_ptr_array_free (priv->heap, TRUE);
+        g_queue_free (priv->ready);
+        g_hash_table_destroy (priv->subs);
+
+        (*G_OBJECT_CLASS (ytv_subscription_poller_parent_class)->finalize) (object);
+
+        return;
+}
+
+static void
+ytv_subscription_poller_class_init (YtvSubscriptionPollerClass* klass)
+{
+        GObjectClass* g_klass;
+
+        g_klass = G_OBJECT_CLASS (klass);
+
+        g_type_class_add_private (g_klass, sizeof (YtvSubscriptionPollerPriv));
+
+        g_klass->set_property = ytv_subscription_poller_set_property;
+        g_klass->get_property = ytv_subscription_poller_get_property;
+        g_klass->dispose      = ytv_subscription_poller_dispose;
+        g_klass->finalize     = ytv_subscription_poller_finalize;
+
+        g_object_class_install_property
+                (g_klass, PROP_FEED,
+                 g_param_spec_object
+                 ("feed", "feed", "The feed whose strategies are used to poll",
+                  YTV_TYPE_FEED, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+        g_object_class_install_property
+                (g_klass, PROP_MAX_PARALLEL,
+                 g_param_spec_uint
+                 ("max-parallel", "maxparallel",
+                  "Maximum number of polls requested at the same time",
+                  1, 32, 4, G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        g_object_class_install_property
+                (g_klass, PROP_INTERVAL,
+                 g_param_spec_uint
+                 ("interval", "interval",
+                  "Seconds between polls of the subscriptions added "
+                  "without their own interval",
+                  1, G_MAXUINT, DEFAULT_INTERVAL,
+                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        g_object_class_install_property
+                (g_klass, PROP_MAX_INTERVAL,
+                 g_param_spec_uint
+                 ("max-interval", "maxinterval",
+                  "Seconds between polls of the subscriptions which do not "
+                  "change, at most; 0 for no limit",
+                  0, G_MAXUINT, DEFAULT_MAX_INTERVAL,
+                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        g_object_class_install_property
+                (g_klass, PROP_JITTER,
+                 g_param_spec_uint
+                 ("jitter", "jitter",
+                  "Random variation of every interval, in percent",
+                  0, 100, 10, G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        /**
+         * YtvSubscriptionPoller::new-entries:
+         * @self: the #YtvSubscriptionPoller instance that emitted the signal
+         * @name: the polled subscription
+         * @entries: a #YtvList of the #YtvEntry which were not in the
+         * previous poll
+         *
+         * The ::new-entries signal is emmited when a poll brings new
+         * entries. The handlers do not own @entries.
+         */
+        signals[NEW_ENTRIES] =
+                g_signal_new ("new-entries",
+                              G_TYPE_FROM_CLASS (klass),
+                              G_SIGNAL_RUN_LAST,
+                              G_STRUCT_OFFSET (YtvSubscriptionPollerClass,
+                                               new_entries),
+                              NULL, NULL,
+                              ytv_cclosure_marshal_VOID__STRING_OBJECT,
+                              G_TYPE_NONE, 2, G_TYPE_STRING, YTV_TYPE_LIST);
+
+        return;
+}
+
+static void
+ytv_subscription_poller_init (YtvSubscriptionPoller* self)
+{
+        YtvSubscriptionPollerPriv* priv;
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        priv->feed         = NULL;
+        priv->max_parallel = 4;
+        priv->interval     = DEFAULT_INTERVAL;
+        priv->max_interval = DEFAULT_MAX_INTERVAL;
+        priv->jitter       = 10;
+        priv->running      = FALSE;
+        priv->serial       = 0;
+        priv->next_id      = 0;
+        priv->subs         = g_hash_table_new_full
+                (g_str_hash, g_str_equal, NULL,
+                 (GDestroyNotify) subscription_free);
+        priv->heap         = g_ptr_array_new ();
+        priv->ready        = g_queue_new ();
+        priv->pending      = NULL;
+        priv->inflight     = 0;
+        priv->timer_id     = 0;
+
+        return;
+}
+
+/**
+ * ytv_subscription_poller_new:
+ * @feed: (not-null): the #YtvFeed whose strategies are used
+ *
+ * Creates a poller which fetches and parses the subscriptions with the
+ * fetch and parse strategies of @feed, and builds their URIs with its
+ * URI builder.
+ *
+ * returns: (not-null) (caller-owns): a new #YtvSubscriptionPoller
+ */
+YtvSubscriptionPoller*
+ytv_subscription_poller_new (YtvFeed* feed)
+{
+        g_return_val_if_fail (YTV_IS_FEED (feed), NULL);
+
+        return g_object_new (YTV_TYPE_SUBSCRIPTION_POLLER, "feed", feed, NULL);
+}
+
+/**
+ * ytv_subscription_poller_add_uri:
+ * @self: (not-null): a #YtvSubscriptionPoller
+ * @uri: (not-null): the URI of the feed to poll, which names the
+ * subscription too
+ * @interval: seconds between polls, or 0 for the "interval" property
+ *
+ * Subscribes to the feed at @uri. Its first poll is due now.
+ */
+void
+ytv_subscription_poller_add_uri (YtvSubscriptionPoller* self,
+                                 const gchar* uri, guint interval)
+{
+        g_assert (YTV_IS_SUBSCRIPTION_POLLER (self));
+        g_assert (uri != NULL);
+
+        ytv_subscription_poller_add_uri_default (self, uri, uri, interval);
+
+        return;
+}
+
+/**
+ * ytv_subscription_poller_add_user:
+ * @self: (not-null): a #YtvSubscriptionPoller
+ * @user: (not-null): the user whose uploads are polled, which names the
+ * subscription too
+ * @interval: seconds between polls, or 0 for the "interval" property
+ *
+ * Subscribes to the uploads of @user, as ytv_feed_user() would query them,
+ * but from the first result whatever the "start-index" of the builder.
+ */
+void
+ytv_subscription_poller_add_user (YtvSubscriptionPoller* self,
+                                  const gchar* user, guint interval)
+{
+        YtvSubscriptionPollerPriv* priv;
+        YtvFeedFetchStrategy* fetchst;
+        YtvUriBuilder* ub;
+        gchar* encuser;
+        gchar* uri;
+        gint start;
+
+        g_assert (YTV_IS_SUBSCRIPTION_POLLER (self));
+        g_assert (user != NULL);
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        fetchst = ytv_feed_get_fetch_strategy (priv->feed);
+        encuser = ytv_feed_fetch_strategy_encode (fetchst, user);
+        g_object_unref (fetchst);
+
+        /* the builder is shared with the feed: leave it as it was */
+        ub = ytv_feed_get_uri_builder (priv->feed);
+        g_object_get (G_OBJECT (ub), "start-index", &start, NULL);
+        g_object_set (G_OBJECT (ub), "start-index", 0, NULL);
+        uri = ytv_uri_builder_get_user_feed (ub, encuser);
+        g_object_set (G_OBJECT (ub), "start-index", start, NULL);
+        g_object_unref (ub);
+
+        ytv_subscription_poller_add_uri_default (self, user, uri, interval);
+
+        g_free (encuser);
+        g_free (uri);
+
+        return;
+}
+
+/**
+ * ytv_subscription_poller_remove:
+ * @self: (not-null): a #YtvSubscriptionPoller
+ * @name: (not-null): the user or URI of the subscription
+ *
+ * Unsubscribes. A poll in flight is discarded.
+ */
+void
+ytv_subscription_poller_remove (YtvSubscriptionPoller* self,
+                                const gchar* name)
+{
+        YtvSubscriptionPollerPriv* priv;
+        YtvSubscription* sub;
+
+        g_assert (YTV_IS_SUBSCRIPTION_POLLER (self));
+        g_assert (name != NULL);
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        sub = g_hash_table_lookup (priv->subs, name);
+
+        if (sub == NULL)
+        {
+                return;
+        }
+
+        if (sub->queued)
+        {
+                g_queue_remove (priv->ready, sub);
+        }
+        else
+        {
+                heap_remove (priv, sub);
+                arm_timer (self);
+        }
+
+        g_hash_table_remove (priv->subs, name);
+
+        return;
+}
+
+/**
+ * ytv_subscription_poller_get_size:
+ * @self: (not-null): a #YtvSubscriptionPoller
+ *
+ * returns: the number of subscriptions
+ */
+guint
+ytv_subscription_poller_get_size (YtvSubscriptionPoller* self)
+{
+        g_assert (YTV_IS_SUBSCRIPTION_POLLER (self));
+
+        return g_hash_table_size
+                (YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self)->subs);
+}
+
+/**
+ * ytv_subscription_poller_start:
+ * @self: (not-null): a #YtvSubscriptionPoller
+ *
+ * Starts to poll the subscriptions as they are due.
+ */
+void
+ytv_subscription_poller_start (YtvSubscriptionPoller* self)
+{
+        YtvSubscriptionPollerPriv* priv;
+
+        g_assert (YTV_IS_SUBSCRIPTION_POLLER (self));
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        g_return_if_fail (priv->feed != NULL);
+
+        if (priv->running)
+        {
+                return;
+        }
+
+        priv->running = TRUE;
+        arm_timer (self);
+
+        return;
+}
+
+/**
+ * ytv_subscription_poller_stop:
+ * @self: (not-null): a #YtvSubscriptionPoller
+ *
+ * Stops polling. The polls in flight are cancelled and will be due again
+ * when the poller is started.
+ */
+void
+ytv_subscription_poller_stop (YtvSubscriptionPoller* self)
+{
+        YtvSubscriptionPollerPriv* priv;
+
+        g_assert (YTV_IS_SUBSCRIPTION_POLLER (self));
+
+        priv = YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self);
+
+        if (priv->running)
+        {
+                ytv_subscription_poller_stop_default (self);
+        }
+
+        return;
+}
+
+/**
+ * ytv_subscription_poller_is_running:
+ * @self: (not-null): a #YtvSubscriptionPoller
+ *
+ * returns: %TRUE if the poller was started
+ */
+gboolean
+ytv_subscription_poller_is_running (YtvSubscriptionPoller* self)
+{
+        g_assert (YTV_IS_SUBSCRIPTION_POLLER (self));
+
+        return YTV_SUBSCRIPTION_POLLER_GET_PRIVATE (self)->running;
+}
@@ -0,0 +1,76 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_SUBSCRIPTION_POLLER_H_
+#define _YTV_SUBSCRIPTION_POLLER_H_
+
+/* ytv-subscription-poller.h - Polls periodically a set of feeds
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib-object.h>
+#include <ytv-shared.h>
+
+G_BEGIN_DECLS
+
+#define YTV_TYPE_SUBSCRIPTION_POLLER                    \
+        (ytv_subscription_poller_get_type ())
+#define YTV_SUBSCRIPTION_POLLER(obj)                                    \
+        (G_TYPE_CHECK_INSTANCE_CAST ((obj), YTV_TYPE_SUBSCRIPTION_POLLER, YtvSubscriptionPoller))
+#define YTV_SUBSCRIPTION_POLLER_CLASS(klass)                            \
+        (G_TYPE_CHECK_CLASS_CAST ((klass), YTV_TYPE_SUBSCRIPTION_POLLER, YtvSubscriptionPollerClass))
+#define YTV_IS_SUBSCRIPTION_POLLER(obj)                                 \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), YTV_TYPE_SUBSCRIPTION_POLLER))
+#define YTV_IS_SUBSCRIPTION_POLLER_CLASS(klass)                         \
+        (G_TYPE_CHECK_CLASS_TYPE ((klass), YTV_TYPE_SUBSCRIPTION_POLLER))
+#define YTV_SUBSCRIPTION_POLLER_GET_CLASS(obj)                          \
+        (G_TYPE_INSTANCE_GET_CLASS ((obj), YTV_TYPE_SUBSCRIPTION_POLLER, YtvSubscriptionPollerClass))
+
+typedef struct _YtvSubscriptionPoller YtvSubscriptionPoller;
+typedef struct _YtvSubscriptionPollerClass YtvSubscriptionPollerClass;
+
+struct _YtvSubscriptionPoller
+{
+        GObject parent;
+};
+
+struct _YtvSubscriptionPollerClass
+{
+        GObjectClass parent_class;
+
+        /* Signals */
+        void (*new_entries) (YtvSubscriptionPoller* self, const gchar* name,
+                             YtvList* entries);
+};
+
+GType ytv_subscription_poller_get_type (void);
+
+YtvSubscriptionPoller* ytv_subscription_poller_new (YtvFeed* feed);
+void ytv_subscription_poller_add_uri (YtvSubscriptionPoller* self,
+                                      const gchar* uri, guint interval);
+void ytv_subscription_poller_add_user (YtvSubscriptionPoller* self,
+                                       const gchar* user, guint interval);
+void ytv_subscription_poller_remove (YtvSubscriptionPoller* self,
+                                     const gchar* name);
+guint ytv_subscription_poller_get_size (YtvSubscriptionPoller* self);
+void ytv_subscription_poller_start (YtvSubscriptionPoller* self);
+void ytv_subscription_poller_stop (YtvSubscriptionPoller* self);
+gboolean ytv_subscription_poller_is_running (YtvSubscriptionPoller* self);
+
+G_END_DECLS
+
+#endif /* _YTV_SUBSCRIPTION_POLLER_H_ */
@@ -24,6 +24,23 @@
  * @short_description: Draws an image thumbnail
  *
  * Will display an imange thumbnail keeping the same size
+ *
+ * The fetched images are decoded and scaled by a small pool of worker
+ * threads, so the main loop only sets the resulting pixbuf.
+ *
+ * Unless #YtvThumbnail:decode-at-size is unset, the decoder is told the
+ * thumbnail size before it starts, so a JPEG is scaled down while it is
+ * decoded and the full size image is never allocated.
+ *
+ * Unless #YtvThumbnail:lazy is unset, the image is fetched only when
+ * the thumbnail is mapped and near the visible area of its scrolled
+ * window, and a fetch still in progress is cancelled when the thumbnail
+ * scrolls away.
+ *
+ * Unless #YtvThumbnail:adaptive is unset, the #YtvThumbnailVariant of the
+ * image is chosen from the size of the thumbnail and from the throughput
+ * measured on the previous images. If the sharp variant would take too
+ * long to arrive, the small one is shown first and replaced later.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -37,11 +54,16 @@
 #include <ytv-thumbnail.h>
 
 #include <ytv-error.h>
+#include <ytv-stats.h>
+#include <ytv-trace.h>
 
 enum _YtvThumbnailProp
 {
         PROP_0,
-        PROP_ID
+        PROP_ID,
+        PROP_DECODE_AT_SIZE,
+        PROP_LAZY,
+        PROP_ADAPTIVE
 };
 
 enum _YtvThumbnailSignals
@@ -64,6 +86,60 @@ struct _YtvThumbnailPriv
         GdkColor* selected_color;
 
         GdkPixbuf* pixbuf;
+
+        guint serial; /* of the last requested image */
+        gboolean decode_at_size;
+
+        gboolean lazy;
+        gboolean pending;                 /* id set but not fetched yet */
+        struct _YtvThumbnailRequest* inflight; /* the running fetch */
+
+        GtkWidget* scrolled;              /* the scrolled window ancestor */
+        GtkAdjustment* hadj;
+        GtkAdjustment* vadj;
+
+        gboolean adaptive;
+        gint shown;                       /* variant shown, or -1 */
+};
+
+/* the default thumbnail size */
+#define THUMB_WIDTH  130
+#define THUMB_HEIGHT  97
+#define THUMB_PAD      6
+
+/* how far out of the visible area an image is already fetched, so it is
+ * ready when it is scrolled in */
+#define LAZY_MARGIN  200
+
+/* the nominal width and a typical size in bytes of each variant */
+static const gint variant_widths[YTV_THUMBNAIL_VARIANT_LAST] =
+{
+        120, 320, 480
+};
+
+static const gint variant_bytes[YTV_THUMBNAIL_VARIANT_LAST] =
+{
+        5000, 15000, 30000
+};
+
+/* milliseconds: the longest wait for the first image, and for an upgrade */
+#define FIRST_PAINT_TIME  250
+#define UPGRADE_TIME     2000
+
+/* bytes per millisecond of the fetched images, a moving average shared by
+ * all the thumbnails; zero until the first one arrives */
+static gdouble throughput = 0.0;
+
+/* the widget may be rebound to another id, or destroyed, before its image
+ * arrives */
+typedef struct _YtvThumbnailRequest YtvThumbnailRequest;
+
+struct _YtvThumbnailRequest
+{
+        YtvThumbnail* self; /* weak pointer */
+        guint serial;
+        YtvThumbnailVariant variant;
+        YtvStatsTime start;
 };
 
 #define YTV_THUMBNAIL_GET_PRIVATE(obj) \
@@ -71,6 +147,9 @@ struct _YtvThumbnailPriv
 
 G_DEFINE_TYPE (YtvThumbnail, ytv_thumbnail, GTK_TYPE_ALIGNMENT)
 
+static void fetch_image (YtvThumbnail* self);
+static void update_visibility (YtvThumbnail* self);
+
 static void
 on_realize (GtkWidget* widget, gpointer user_data)
 {
@@ -148,49 +227,236 @@ on_clicked (GtkWidget* widget, gpointer user_data)
         return;
 }
 
+/* takes the ownership of pixbuf, keeping the resident bytes gauge */
 static void
-fetch_img_cb (YtvFeedFetchStrategy* st, const gchar* mime,
-              const gint8* response, gssize length, GError **err,
-              gpointer user_data)
+set_pixbuf (YtvThumbnail* self, GdkPixbuf* pixbuf)
 {
-        YtvThumbnail* self;
         YtvThumbnailPriv* priv;
-        GError* error = NULL;
-        GdkPixbufLoader* loader = NULL;
-        GdkPixbuf* pixbuf = NULL;
 
-        if (err != NULL && *err != NULL)
+        priv = YTV_THUMBNAIL_GET_PRIVATE (self);
+
+        if (priv->pixbuf != NULL)
         {
-                g_debug ("image fetching error: %s",
-                         ytv_error_get_message (*err));
+                ytv_stats_add (YTV_STATS_PIXBUF_BYTES,
+                               - gdk_pixbuf_get_rowstride (priv->pixbuf) *
+                               gdk_pixbuf_get_height (priv->pixbuf));
+                g_object_unref (priv->pixbuf);
+        }
 
-                g_error_free (*err);
-                *err = NULL;
+        priv->pixbuf = pixbuf;
 
-                return;
+        if (priv->pixbuf != NULL)
+        {
+                ytv_stats_add (YTV_STATS_PIXBUF_BYTES,
+                               gdk_pixbuf_get_rowstride (priv->pixbuf) *
+                               gdk_pixbuf_get_height (priv->pixbuf));
         }
 
-        if (!YTV_IS_THUMBNAIL (user_data))
+        return;
+}
+
+/* the default thumbnail size, or the image size request less its padding
+ * when there is one; not the allocation, which is the placeholder's until
+ * the first image is shown */
+static void
+get_display_size (YtvThumbnail* self, gint* width, gint* height)
+{
+        gint w, h;
+
+        gtk_widget_get_size_request (self->image, &w, &h);
+
+        *width = w > 2 * THUMB_PAD ? w - 2 * THUMB_PAD : THUMB_WIDTH;
+        *height = h > 2 * THUMB_PAD ? h - 2 * THUMB_PAD : THUMB_HEIGHT;
+
+        return;
+}
+
+static void
+update_throughput (gssize length, YtvStatsTime start)
+{
+        gdouble ms, sample;
+
+        ms = (ytv_stats_time_now () - start) / 1000.0;
+
+        if (ms <= 0.0 || length <= 0)
         {
                 return;
         }
 
-        self = YTV_THUMBNAIL (user_data);
+        sample = length / ms;
+        throughput = throughput == 0.0 ?
+                sample : 0.75 * throughput + 0.25 * sample;
+
+        return;
+}
+
+/* milliseconds to fetch the variant, or -1 if it is not known yet */
+static gdouble
+estimate_time (YtvThumbnailVariant variant)
+{
+        if (throughput == 0.0)
+        {
+                return -1;
+        }
+
+        return variant_bytes[variant] / throughput;
+}
+
+/* the smallest variant which is not noticeably upscaled */
+static YtvThumbnailVariant
+get_wanted_variant (YtvThumbnail* self)
+{
+        gint width, height, i;
+
+        if (!YTV_THUMBNAIL_GET_PRIVATE (self)->adaptive)
+        {
+                return YTV_THUMBNAIL_VARIANT_DEFAULT;
+        }
+
+        get_display_size (self, &width, &height);
+
+        for (i = 0; i < YTV_THUMBNAIL_VARIANT_LAST - 1; i++)
+        {
+                if (variant_widths[i] * 10 >= width * 9)
+                {
+                        break;
+                }
+        }
+
+        return i;
+}
+
+/* the variant to fetch next, or -1 if the shown one is good enough */
+static gint
+choose_variant (YtvThumbnail* self)
+{
+        YtvThumbnailPriv* priv;
+        YtvThumbnailVariant wanted;
+        gdouble estimate;
+
         priv = YTV_THUMBNAIL_GET_PRIVATE (self);
+        wanted = get_wanted_variant (self);
+        estimate = estimate_time (wanted);
 
-        error  = NULL;
-        loader = NULL;
-        pixbuf = NULL;
+        if (priv->shown < 0)
+        {
+                if (wanted == YTV_THUMBNAIL_VARIANT_DEFAULT ||
+                    (estimate >= 0 && estimate <= FIRST_PAINT_TIME))
+                {
+                        return wanted;
+                }
 
-        if (length == 0)
+                /* something fast to look at while the link is measured or
+                 * the upgrade is fetched */
+                return YTV_THUMBNAIL_VARIANT_DEFAULT;
+        }
+
+        if (priv->shown < wanted && estimate >= 0 && estimate <= UPGRADE_TIME)
         {
-                g_debug ("zero sized image");
-                return;
+                return wanted;
+        }
+
+        return -1;
+}
+
+static void
+request_free (YtvThumbnailRequest* req)
+{
+        if (req->self != NULL)
+        {
+                g_object_remove_weak_pointer (G_OBJECT (req->self),
+                                              (gpointer*) &req->self);
+        }
+
+        g_slice_free (YtvThumbnailRequest, req);
+
+        return;
+}
+
+/* thumbnail decoding, done by the worker threads */
+typedef struct _YtvDecodeJob YtvDecodeJob;
+
+struct _YtvDecodeJob
+{
+        YtvThumbnailRequest* req;
+        gchar* mime;
+        guchar* data;
+        gsize length;
+
+        gint width, height;    /* of the thumbnail */
+        gboolean at_size;      /* tell the size to the decoder */
+
+        GdkPixbuf* pixbuf;     /* the result */
+        gdouble decode_ms;
+        gint decoded_bytes;    /* of all the pixbufs allocated */
+};
+
+/* JPEG decoding is CPU bound: more threads than this would only compete
+ * with the main loop */
+#define MAX_DECODE_THREADS 2
+
+static void
+decode_job_free (YtvDecodeJob* job)
+{
+        request_free (job->req);
+        g_free (job->mime);
+        g_free (job->data);
+
+        if (job->pixbuf != NULL)
+        {
+                g_object_unref (job->pixbuf);
         }
 
-        if (mime != NULL)
+        g_slice_free (YtvDecodeJob, job);
+
+        return;
+}
+
+static gint
+get_pixbuf_bytes (GdkPixbuf* pixbuf)
+{
+        return gdk_pixbuf_get_rowstride (pixbuf) *
+                gdk_pixbuf_get_height (pixbuf);
+}
+
+static void
+size_prepared_cb (GdkPixbufLoader* loader, gint width, gint height,
+                  gpointer user_data)
+{
+        YtvDecodeJob* job = (YtvDecodeJob*) user_data;
+        gdouble scale;
+
+        /* shrink only, keeping the aspect ratio and still covering the
+         * thumbnail: enlarging and cropping are done once, at the end */
+        scale = MAX ((gdouble) job->width / width,
+                     (gdouble) job->height / height);
+
+        if (scale < 1.0)
+        {
+                width = MAX (job->width, (gint) (width * scale + 0.5));
+                height = MAX (job->height, (gint) (height * scale + 0.5));
+                gdk_pixbuf_loader_set_size (loader, width, height);
+        }
+
+        return;
+}
+
+/* it must not touch any widget nor the stats: it may run in a worker */
+static void
+decode (YtvDecodeJob* job)
+{
+        GError* error = NULL;
+        GdkPixbufLoader* loader = NULL;
+        GdkPixbuf* pixbuf = NULL;
+        GTimeVal start, end;
+
+        YTV_TRACE_BEGIN ("thumbnail", "decode");
+        g_get_current_time (&start);
+
+        if (job->mime != NULL)
         {
-                loader = gdk_pixbuf_loader_new_with_mime_type (mime, &error);
+                loader = gdk_pixbuf_loader_new_with_mime_type (job->mime,
+                                                               &error);
         }
 
         if (error != NULL)
@@ -204,14 +470,20 @@ fetch_img_cb (YtvFeedFetchStrategy* st, const gchar* mime,
                 loader = gdk_pixbuf_loader_new ();
         }
 
-        if (!gdk_pixbuf_loader_write (loader, (guchar*) response,
-                                      (gsize) length, &error))
+        if (job->at_size)
+        {
+                g_signal_connect (loader, "size-prepared",
+                                  G_CALLBACK (size_prepared_cb), job);
+        }
+
+        if (!gdk_pixbuf_loader_write (loader, job->data, job->length, &error))
         {
                 g_debug ("image parsing error: %s",
                          ytv_error_get_message (error));
                 g_error_free (error);
                 error = NULL;
 
+                gdk_pixbuf_loader_close (loader, NULL);
                 goto beach;
         }
 
@@ -225,27 +497,225 @@ fetch_img_cb (YtvFeedFetchStrategy* st, const gchar* mime,
 
         pixbuf = gdk_pixbuf_loader_get_pixbuf (loader);
 
-        if (pixbuf != NULL)
+        if (pixbuf == NULL)
         {
-                if (priv->pixbuf != NULL)
-                {
-                        g_object_unref (priv->pixbuf);
-                }
-                
-                priv->pixbuf = gdk_pixbuf_scale_simple (pixbuf, 130, 97,
-                                                        GDK_INTERP_BILINEAR);
-
-                gtk_image_set_from_pixbuf (GTK_IMAGE (self->image),
-                                           priv->pixbuf);
+                g_debug ("Not enough data for image");
+        }
+        else if (gdk_pixbuf_get_width (pixbuf) == job->width &&
+                 gdk_pixbuf_get_height (pixbuf) == job->height)
+        {
+                job->decoded_bytes = get_pixbuf_bytes (pixbuf);
+                job->pixbuf = g_object_ref (pixbuf);
         }
         else
         {
-                g_debug ("Not enough data for image");
+                gint width, height;
+                gdouble scale;
+
+                width = gdk_pixbuf_get_width (pixbuf);
+                height = gdk_pixbuf_get_height (pixbuf);
+
+                /* fill the thumbnail without distorting it, e.g. a 16:9
+                 * variant in the 4:3 box: scale to cover, crop the center */
+                scale = MAX ((gdouble) job->width / width,
+                             (gdouble) job->height / height);
+
+                YTV_TRACE_BEGIN ("thumbnail", "scale");
+                job->pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB,
+                                              gdk_pixbuf_get_has_alpha (pixbuf),
+                                              8, job->width, job->height);
+                gdk_pixbuf_scale (pixbuf, job->pixbuf, 0, 0,
+                                  job->width, job->height,
+                                  (job->width - width * scale) / 2,
+                                  (job->height - height * scale) / 2,
+                                  scale, scale, GDK_INTERP_BILINEAR);
+                YTV_TRACE_END ("thumbnail", "scale");
+
+                job->decoded_bytes = get_pixbuf_bytes (pixbuf) +
+                        get_pixbuf_bytes (job->pixbuf);
         }
 
 beach:
         g_object_unref (loader); /* unref also the pixbuf */
 
+        g_get_current_time (&end);
+        job->decode_ms = (end.tv_sec - start.tv_sec) * 1000.0 +
+                (end.tv_usec - start.tv_usec) / 1000.0;
+
+        YTV_TRACE_END ("thumbnail", "decode");
+
+        return;
+}
+
+/* back in the main loop */
+static gboolean
+decode_done_cb (gpointer user_data)
+{
+        YtvDecodeJob* job;
+        YtvThumbnail* self;
+        YtvThumbnailPriv* priv;
+
+        job = (YtvDecodeJob*) user_data;
+        self = job->req->self;
+
+        if (job->pixbuf == NULL)
+        {
+                goto beach;
+        }
+
+        ytv_stats_inc (YTV_STATS_THUMBNAILS_DECODED);
+        ytv_stats_add (YTV_STATS_DECODED_BYTES, job->decoded_bytes);
+        ytv_stats_observe (YTV_STATS_DECODE_TIME, job->decode_ms);
+
+        if (self == NULL ||
+            job->req->serial != YTV_THUMBNAIL_GET_PRIVATE (self)->serial)
+        {
+                /* cleaned or rebound while it was decoded */
+                goto beach;
+        }
+
+        priv = YTV_THUMBNAIL_GET_PRIVATE (self);
+
+        set_pixbuf (self, job->pixbuf); /* takes the reference */
+        job->pixbuf = NULL;
+
+        gtk_image_set_from_pixbuf (GTK_IMAGE (self->image), priv->pixbuf);
+
+        /* a sharper variant might follow */
+        priv->shown = job->req->variant;
+        priv->pending = TRUE;
+
+        if (priv->lazy)
+        {
+                update_visibility (self);
+        }
+        else
+        {
+                fetch_image (self);
+        }
+
+beach:
+        decode_job_free (job);
+
+        return FALSE;
+}
+
+static void
+decode_worker (gpointer data, gpointer user_data)
+{
+        YtvDecodeJob* job;
+
+        job = (YtvDecodeJob*) data;
+
+        decode (job);
+
+        g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, decode_done_cb, job, NULL);
+
+        return;
+}
+
+static GThreadPool*
+get_decode_pool (void)
+{
+        static GThreadPool* pool = NULL;
+        static gboolean failed = FALSE;
+        GError* error = NULL;
+
+        if (pool == NULL && !failed && g_thread_supported ())
+        {
+                pool = g_thread_pool_new (decode_worker, NULL,
+                                          MAX_DECODE_THREADS, FALSE, &error);
+
+                if (error != NULL)
+                {
+                        g_warning ("Cannot create the decoding threads: %s",
+                                   error->message);
+                        g_error_free (error);
+                        failed = TRUE;
+                }
+        }
+
+        return pool;
+}
+
+static void
+fetch_img_cb (YtvFeedFetchStrategy* st, const gchar* mime,
+              const gint8* response, gssize length, GError **err,
+              gpointer user_data)
+{
+        YtvThumbnailRequest* req;
+        YtvThumbnail* self;
+        YtvDecodeJob* job;
+        GThreadPool* pool;
+        gint width, height;
+
+        req = (YtvThumbnailRequest*) user_data;
+        self = req->self;
+
+        if (self != NULL && YTV_THUMBNAIL_GET_PRIVATE (self)->inflight == req)
+        {
+                YTV_THUMBNAIL_GET_PRIVATE (self)->inflight = NULL;
+        }
+
+        if (err != NULL && *err != NULL)
+        {
+                if ((*err)->code != YTV_HTTP_ERROR_CANCELLED)
+                {
+                        g_debug ("image fetching error: %s",
+                                 ytv_error_get_message (*err));
+                }
+
+                g_error_free (*err);
+                *err = NULL;
+
+                request_free (req);
+                return;
+        }
+
+        if (self == NULL ||
+            req->serial != YTV_THUMBNAIL_GET_PRIVATE (self)->serial)
+        {
+                /* destroyed or showing another entry */
+                request_free (req);
+                return;
+        }
+
+        /* it might arrive after the fetcher ignored a cancellation */
+        YTV_THUMBNAIL_GET_PRIVATE (self)->pending = FALSE;
+
+        update_throughput (length, req->start);
+
+        if (length == 0)
+        {
+                g_debug ("zero sized image");
+                request_free (req);
+                return;
+        }
+
+        /* the response is only valid during the callback */
+        job = g_slice_new0 (YtvDecodeJob);
+        job->req = req; /* keeps the weak pointer */
+        job->mime = g_strdup (mime);
+        job->data = g_memdup (response, length);
+        job->length = length;
+        job->at_size = YTV_THUMBNAIL_GET_PRIVATE (self)->decode_at_size;
+
+        get_display_size (self, &width, &height);
+        job->width = width;
+        job->height = height;
+
+        pool = get_decode_pool ();
+
+        if (pool != NULL)
+        {
+                g_thread_pool_push (pool, job, NULL);
+        }
+        else
+        {
+                decode (job);
+                decode_done_cb (job);
+        }
+
         return;
 }
 
@@ -254,6 +724,8 @@ fetch_image (YtvThumbnail* self)
 {
         gchar* uri;
         YtvThumbnailPriv* priv;
+        YtvThumbnailRequest* req;
+        gint variant;
 
         priv = YTV_THUMBNAIL_GET_PRIVATE (self);
 
@@ -261,22 +733,188 @@ fetch_image (YtvThumbnail* self)
         g_return_if_fail (priv->ub != NULL);
         g_return_if_fail (priv->eid != NULL);
 
-        gtk_image_set_from_stock (GTK_IMAGE (self->image),
-                                  GTK_STOCK_MISSING_IMAGE,
-                                  GTK_ICON_SIZE_DIALOG);
-        /* gtk_widget_set_size_request (self->image, 136, 103); */ /* 130+6x97+6 */
-        
-        uri = ytv_uri_builder_get_thumbnail (priv->ub, priv->eid);
+        variant = choose_variant (self);
+
+        if (variant < 0)
+        {
+                priv->pending = FALSE;
+                return;
+        }
+
+        if (priv->shown >= 0)
+        {
+                ytv_stats_inc (YTV_STATS_THUMBNAIL_UPGRADES);
+        }
+
+        uri = ytv_uri_builder_get_thumbnail_variant (priv->ub, priv->eid,
+                                                     variant);
         g_return_if_fail (uri != NULL);
 
+        req = g_slice_new (YtvThumbnailRequest);
+        req->self = self;
+        req->serial = ++priv->serial;
+        req->variant = variant;
+        req->start = ytv_stats_time_now ();
+        g_object_add_weak_pointer (G_OBJECT (self), (gpointer*) &req->self);
+
+        priv->pending = FALSE;
+        priv->inflight = req;
+
         ytv_feed_fetch_strategy_perform (priv->fetcher,
-                                         uri, fetch_img_cb, self);
+                                         uri, fetch_img_cb, req);
 
         g_free (uri);
 
         return;
 }
 
+/* the callback is called with a cancellation error, or the image is
+ * silently dropped if the fetcher can not cancel */
+static void
+cancel_fetch (YtvThumbnail* self)
+{
+        YtvThumbnailPriv* priv;
+        YtvThumbnailRequest* req;
+
+        priv = YTV_THUMBNAIL_GET_PRIVATE (self);
+
+        if (priv->inflight == NULL)
+        {
+                return;
+        }
+
+        req = priv->inflight;
+        priv->inflight = NULL;
+
+        ytv_feed_fetch_strategy_cancel (priv->fetcher, req);
+
+        return;
+}
+
+/* TRUE if the widget is mapped and, enlarged by the margin, overlaps the
+ * area shown by its scrolled window */
+static gboolean
+is_visible (YtvThumbnail* self)
+{
+        YtvThumbnailPriv* priv;
+        GtkWidget* widget;
+        GdkRectangle area, view;
+        gint x, y;
+
+        priv = YTV_THUMBNAIL_GET_PRIVATE (self);
+        widget = GTK_WIDGET (self);
+
+        if (!GTK_WIDGET_MAPPED (widget))
+        {
+                return FALSE;
+        }
+
+        if (priv->scrolled == NULL)
+        {
+                return TRUE;
+        }
+
+        if (!gtk_widget_translate_coordinates (widget, priv->scrolled,
+                                               0, 0, &x, &y))
+        {
+                return TRUE; /* no way to know */
+        }
+
+        area.x = x - LAZY_MARGIN;
+        area.y = y - LAZY_MARGIN;
+        area.width = widget->allocation.width + 2 * LAZY_MARGIN;
+        area.height = widget->allocation.height + 2 * LAZY_MARGIN;
+
+        view.x = 0;
+        view.y = 0;
+        view.width = priv->scrolled->allocation.width;
+        view.height = priv->scrolled->allocation.height;
+
+        return gdk_rectangle_intersect (&area, &view, NULL);
+}
+
+static void
+update_visibility (YtvThumbnail* self)
+{
+        YtvThumbnailPriv* priv;
+
+        priv = YTV_THUMBNAIL_GET_PRIVATE (self);
+
+        if (!priv->lazy)
+        {
+                return;
+        }
+
+        if (is_visible (self))
+        {
+                if (priv->pending && priv->fetcher != NULL && priv->ub != NULL)
+                {
+                        fetch_image (self);
+                }
+        }
+        else if (priv->inflight != NULL)
+        {
+                cancel_fetch (self);
+                priv->pending = TRUE;
+        }
+
+        return;
+}
+
+static void
+on_scrolled (GtkAdjustment* adj, gpointer user_data)
+{
+        update_visibility (YTV_THUMBNAIL (user_data));
+
+        return;
+}
+
+static void
+set_adjustment (YtvThumbnail* self, GtkAdjustment** slot, GtkAdjustment* adj)
+{
+        if (*slot != NULL)
+        {
+                g_signal_handlers_disconnect_by_func (*slot, on_scrolled, self);
+                g_object_unref (*slot);
+        }
+
+        *slot = adj;
+
+        if (*slot != NULL)
+        {
+                g_object_ref (*slot);
+                g_signal_connect (G_OBJECT (*slot), "value-changed",
+                                  G_CALLBACK (on_scrolled), self);
+        }
+
+        return;
+}
+
+/* follows the scrolling of the nearest scrolled window */
+static void
+set_scrolled (YtvThumbnail* self, GtkWidget* scrolled)
+{
+        YtvThumbnailPriv* priv;
+        GtkAdjustment* hadj = NULL;
+        GtkAdjustment* vadj = NULL;
+
+        priv = YTV_THUMBNAIL_GET_PRIVATE (self);
+
+        if (scrolled != NULL)
+        {
+                GtkScrolledWindow* sw = GTK_SCROLLED_WINDOW (scrolled);
+
+                hadj = gtk_scrolled_window_get_hadjustment (sw);
+                vadj = gtk_scrolled_window_get_vadjustment (sw);
+        }
+
+        priv->scrolled = scrolled;
+        set_adjustment (self, &priv->hadj, hadj);
+        set_adjustment (self, &priv->vadj, vadj);
+
+        return;
+}
+
 static void
 ytv_thumbnail_set_property (GObject* object, guint prop_id,
                             const GValue* value, GParamSpec* spec)
@@ -290,6 +928,26 @@ ytv_thumbnail_set_property (GObject* object, guint prop_id,
                 ytv_thumbnail_set_id (YTV_THUMBNAIL (object),
                                       g_value_get_string (value));
                 break;
+        case PROP_DECODE_AT_SIZE:
+                priv->decode_at_size = g_value_get_boolean (value);
+                g_object_notify (object, "decode-at-size");
+                break;
+        case PROP_LAZY:
+                priv->lazy = g_value_get_boolean (value);
+
+                if (!priv->lazy && priv->pending &&
+                    priv->fetcher != NULL && priv->ub != NULL)
+                {
+                        fetch_image (YTV_THUMBNAIL (object));
+                }
+
+                update_visibility (YTV_THUMBNAIL (object));
+                g_object_notify (object, "lazy");
+                break;
+        case PROP_ADAPTIVE:
+                priv->adaptive = g_value_get_boolean (value);
+                g_object_notify (object, "adaptive");
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -310,6 +968,15 @@ ytv_thumbnail_get_property (GObject* object, guint prop_id,
         case PROP_ID:
                 g_value_set_string (value, priv->eid);
                 break;
+        case PROP_DECODE_AT_SIZE:
+                g_value_set_boolean (value, priv->decode_at_size);
+                break;
+        case PROP_LAZY:
+                g_value_set_boolean (value, priv->lazy);
+                break;
+        case PROP_ADAPTIVE:
+                g_value_set_boolean (value, priv->adaptive);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -324,6 +991,9 @@ ytv_thumbnail_dispose (GObject* object)
         YtvThumbnailPriv* priv;
         priv = YTV_THUMBNAIL_GET_PRIVATE (object);
 
+        cancel_fetch (YTV_THUMBNAIL (object));
+        set_scrolled (YTV_THUMBNAIL (object), NULL);
+
         (*G_OBJECT_CLASS (ytv_thumbnail_parent_class)->dispose) (object);
 
         if (priv->fetcher != NULL)
@@ -338,11 +1008,7 @@ ytv_thumbnail_dispose (GObject* object)
                 priv->ub = NULL;
         }
 
-        if (priv->pixbuf != NULL)
-        {
-                g_object_unref (priv->pixbuf);
-                priv->pixbuf = NULL;
-        }
+        set_pixbuf (YTV_THUMBNAIL (object), NULL);
 
         return;
 }
@@ -375,11 +1041,79 @@ ytv_thumbnail_finalize (GObject* object)
         return;
 }
 
+static void
+ytv_thumbnail_map (GtkWidget* widget)
+{
+        (*GTK_WIDGET_CLASS (ytv_thumbnail_parent_class)->map) (widget);
+
+        update_visibility (YTV_THUMBNAIL (widget));
+
+        return;
+}
+
+static void
+ytv_thumbnail_unmap (GtkWidget* widget)
+{
+        (*GTK_WIDGET_CLASS (ytv_thumbnail_parent_class)->unmap) (widget);
+
+        update_visibility (YTV_THUMBNAIL (widget));
+
+        return;
+}
+
+static void
+ytv_thumbnail_size_allocate (GtkWidget* widget, GtkAllocation* allocation)
+{
+        YtvThumbnail* self;
+        YtvThumbnailPriv* priv;
+
+        (*GTK_WIDGET_CLASS (ytv_thumbnail_parent_class)->size_allocate)
+                (widget, allocation);
+
+        self = YTV_THUMBNAIL (widget);
+        priv = YTV_THUMBNAIL_GET_PRIVATE (self);
+
+        /* a bigger size request: the shown variant might look blurry now */
+        if (priv->eid != NULL && priv->shown >= 0 && !priv->pending &&
+            priv->inflight == NULL &&
+            priv->shown < (gint) get_wanted_variant (self))
+        {
+                priv->pending = TRUE;
+
+                if (!priv->lazy && priv->fetcher != NULL && priv->ub != NULL)
+                {
+                        fetch_image (self);
+                }
+        }
+
+        update_visibility (self);
+
+        return;
+}
+
+static void
+ytv_thumbnail_hierarchy_changed (GtkWidget* widget, GtkWidget* previous)
+{
+        if (GTK_WIDGET_CLASS (ytv_thumbnail_parent_class)->hierarchy_changed)
+        {
+                (*GTK_WIDGET_CLASS (ytv_thumbnail_parent_class)->hierarchy_changed)
+                        (widget, previous);
+        }
+
+        set_scrolled (YTV_THUMBNAIL (widget),
+                      gtk_widget_get_ancestor (widget,
+                                               GTK_TYPE_SCROLLED_WINDOW));
+
+        return;
+}
+
 static void
 ytv_thumbnail_class_init (YtvThumbnailClass* klass)
 {
         GObjectClass* object_class;
+        GtkWidgetClass* widget_class;
         object_class = G_OBJECT_CLASS (klass);
+        widget_class = GTK_WIDGET_CLASS (klass);
 
         g_type_class_add_private (object_class, sizeof (YtvThumbnailPriv));
 
@@ -388,12 +1122,38 @@ ytv_thumbnail_class_init (YtvThumbnailClass* klass)
         object_class->dispose      = ytv_thumbnail_dispose;
         object_class->finalize     = ytv_thumbnail_finalize;
 
+        widget_class->map               = ytv_thumbnail_map;
+        widget_class->unmap             = ytv_thumbnail_unmap;
+        widget_class->size_allocate     = ytv_thumbnail_size_allocate;
+        widget_class->hierarchy_changed = ytv_thumbnail_hierarchy_changed;
+
         g_object_class_install_property
                 (object_class, PROP_ID,
                  g_param_spec_string
                  ("id", "vid", "Video identificator string", NULL,
                   G_PARAM_READWRITE));
 
+        g_object_class_install_property
+                (object_class, PROP_DECODE_AT_SIZE,
+                 g_param_spec_boolean
+                 ("decode-at-size", "decode_at_size",
+                  "Decode the image directly at the thumbnail size",
+                  TRUE, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (object_class, PROP_LAZY,
+                 g_param_spec_boolean
+                 ("lazy", "lazy",
+                  "Fetch the image only when it is near the visible area",
+                  TRUE, G_PARAM_READWRITE));
+
+        g_object_class_install_property
+                (object_class, PROP_ADAPTIVE,
+                 g_param_spec_boolean
+                 ("adaptive", "adaptive",
+                  "Choose the image variant from the size and the bandwidth",
+                  TRUE, G_PARAM_READWRITE));
+
         signals[CLICKED] =
                 g_signal_new ("clicked",
                               YTV_TYPE_THUMBNAIL,
@@ -432,7 +1192,8 @@ ytv_thumbnail_init (YtvThumbnail* self)
         gtk_container_add (GTK_CONTAINER (self->button), self->evbox);
 
         self->image = gtk_image_new ();
-        g_object_set (G_OBJECT (self->image), "xpad", 6, "ypad", 6, NULL);
+        g_object_set (G_OBJECT (self->image),
+                      "xpad", THUMB_PAD, "ypad", THUMB_PAD, NULL);
 
         gtk_container_add (GTK_CONTAINER (self->evbox), self->image);
 
@@ -442,6 +1203,16 @@ ytv_thumbnail_init (YtvThumbnail* self)
         priv->fetcher        = NULL;
         priv->ub             = NULL;
         priv->pixbuf         = NULL;
+        priv->serial         = 0;
+        priv->decode_at_size = TRUE;
+        priv->lazy           = TRUE;
+        priv->pending        = FALSE;
+        priv->inflight       = NULL;
+        priv->scrolled       = NULL;
+        priv->hadj           = NULL;
+        priv->vadj           = NULL;
+        priv->adaptive       = TRUE;
+        priv->shown          = -1;
 
         return;
 }
@@ -465,7 +1236,9 @@ ytv_thumbnail_new (void)
  * @self: a #YtvThumbnail
  * @id: (not-null): The #YtvEntry id
  *
- * Sets the #YtvEntry's id to fetch its thumbnail
+ * Sets the #YtvEntry's id to fetch its thumbnail. Unless
+ * #YtvThumbnail:lazy is unset, the fetch waits until the thumbnail is
+ * near the visible area.
  */
 void
 ytv_thumbnail_set_id (YtvThumbnail* self, const gchar* id)
@@ -477,6 +1250,14 @@ ytv_thumbnail_set_id (YtvThumbnail* self, const gchar* id)
 
         priv = YTV_THUMBNAIL_GET_PRIVATE (self);
 
+        /* the same video, already shown or on its way: an entry whose
+         * other fields changed must not flicker nor fetch it again */
+        if (g_strcmp0 (priv->eid, id) == 0 &&
+            (priv->shown >= 0 || priv->pending || priv->inflight != NULL))
+        {
+                return;
+        }
+
         if (priv->eid != NULL)
         {
                 g_free (priv->eid);
@@ -484,7 +1265,26 @@ ytv_thumbnail_set_id (YtvThumbnail* self, const gchar* id)
 
         priv->eid = g_strdup (id);
 
-        fetch_image (self);
+        /* the previous image is not wanted anymore */
+        cancel_fetch (self);
+        priv->serial++;
+        priv->shown = -1;
+
+        gtk_image_set_from_stock (GTK_IMAGE (self->image),
+                                  GTK_STOCK_MISSING_IMAGE,
+                                  GTK_ICON_SIZE_DIALOG);
+        /* gtk_widget_set_size_request (self->image, 136, 103); */ /* 130+6x97+6 */
+
+        priv->pending = TRUE;
+
+        if (priv->lazy)
+        {
+                update_visibility (self);
+        }
+        else
+        {
+                fetch_image (self);
+        }
 
         g_object_notify (G_OBJECT (self), "id");
 
@@ -627,7 +1427,14 @@ ytv_thumbnail_clean (YtvThumbnail* self)
 {
         g_return_if_fail (YTV_IS_THUMBNAIL (self));
 
+        /* an image still in flight must not show up */
+        cancel_fetch (self);
+        YTV_THUMBNAIL_GET_PRIVATE (self)->serial++;
+        YTV_THUMBNAIL_GET_PRIVATE (self)->pending = FALSE;
+        YTV_THUMBNAIL_GET_PRIVATE (self)->shown = -1;
+
         gtk_image_clear (GTK_IMAGE (self->image));
+        set_pixbuf (self, NULL);
 
         return;
 }
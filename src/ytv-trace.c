@@ -0,0 +1,399 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-trace.c - Lightweight span and counter tracing
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-trace
+ * @short_description: span and counter tracing in the Trace Event format
+ *
+ * The pipeline stages (fetch, parse, widget population, thumbnail decoding
+ * and star painting) are annotated with begin/end spans and counters
+ * through the YTV_TRACE_* macros. While tracing is disabled every
+ * annotation costs a single test of a global variable.
+ *
+ * When it is enabled, with ytv_trace_init() or setting the YTV_TRACE
+ * environment variable to an output file name, the events are kept in
+ * memory and written, at ytv_trace_shutdown(), as a JSON file loadable by
+ * chrome://tracing or Perfetto.
+ *
+ * The category and name strings are not copied: they must be static.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <ytv-trace.h>
+#include <ytv-watchdog.h>
+
+/* avoid filling the memory if the trace is left enabled for hours */
+#define MAX_EVENTS (1 << 20)
+
+typedef struct _YtvTraceEvent YtvTraceEvent;
+
+struct _YtvTraceEvent
+{
+        gchar phase;
+        const gchar* cat;
+        const gchar* name;
+        gint64 ts;
+        guint tid;
+        gconstpointer id;
+        gint64 value;
+};
+
+guint ytv_trace_flags = 0;
+
+static GStaticMutex trace_lock = G_STATIC_MUTEX_INIT;
+static GArray* events = NULL;
+static GHashTable* threads = NULL;
+static gchar* outfile = NULL;
+static gint64 epoch = 0;
+static guint dropped = 0;
+
+static gint64
+now (void)
+{
+        GTimeVal tv;
+
+        g_get_current_time (&tv);
+
+        return ((gint64) tv.tv_sec) * G_USEC_PER_SEC + tv.tv_usec;
+}
+
+/* maps the GThread into a small number, more readable in the viewer */
+static guint
+get_tid (void)
+{
+        gpointer key;
+        guint tid;
+
+        key = g_thread_self ();
+        tid = GPOINTER_TO_UINT (g_hash_table_lookup (threads, key));
+
+        if (tid == 0)
+        {
+                tid = g_hash_table_size (threads) + 1;
+                g_hash_table_insert (threads, key, GUINT_TO_POINTER (tid));
+        }
+
+        return tid;
+}
+
+static void
+add_event (gchar phase, const gchar* cat, const gchar* name,
+           gconstpointer id, gint64 value)
+{
+        YtvTraceEvent ev;
+
+        ev.ts = now ();
+
+        g_static_mutex_lock (&trace_lock);
+
+        if (events == NULL)
+        {
+                goto beach;
+        }
+
+        if (events->len >= MAX_EVENTS)
+        {
+                dropped++;
+                goto beach;
+        }
+
+        ev.phase = phase;
+        ev.cat = cat;
+        ev.name = name;
+        ev.tid = get_tid ();
+        ev.id = id;
+        ev.value = value;
+
+        g_array_append_val (events, ev);
+
+beach:
+        g_static_mutex_unlock (&trace_lock);
+        return;
+}
+
+static void
+write_event (FILE* fp, YtvTraceEvent* ev, gboolean first)
+{
+        fprintf (fp, "%s\n{\"ph\":\"%c\",\"cat\":\"%s\",\"name\":\"%s\","
+                 "\"pid\":%d,\"tid\":%u,\"ts\":%" G_GINT64_FORMAT,
+                 first ? "" : ",", ev->phase, ev->cat, ev->name,
+                 (gint) getpid (), ev->tid, ev->ts - epoch);
+
+        if (ev->phase == 'b' || ev->phase == 'e')
+        {
+                fprintf (fp, ",\"id\":\"%p\"", ev->id);
+        }
+        else if (ev->phase == 'C')
+        {
+                fprintf (fp, ",\"args\":{\"%s\":%" G_GINT64_FORMAT "}",
+                         ev->name, ev->value);
+        }
+
+        fputc ('}', fp);
+
+        return;
+}
+
+static gboolean
+write_file (const gchar* filename)
+{
+        FILE* fp;
+        guint i;
+
+        fp = fopen (filename, "w");
+
+        if (fp == NULL)
+        {
+                g_warning ("Cannot write the trace file %s", filename);
+                return FALSE;
+        }
+
+        fputs ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", fp);
+
+        for (i = 0; i < events->len; i++)
+        {
+                write_event (fp, &g_array_index (events, YtvTraceEvent, i),
+                             i == 0);
+        }
+
+        fputs ("\n]}\n", fp);
+        fclose (fp);
+
+        if (dropped > 0)
+        {
+                g_warning ("%u trace events were dropped", dropped);
+        }
+
+        return TRUE;
+}
+
+/**
+ * ytv_trace_init:
+ * @filename: (not-null): the path of the JSON file to write at shutdown
+ *
+ * Enables the recording of the trace events.
+ *
+ * returns: %TRUE if the tracing was enabled by this call
+ */
+gboolean
+ytv_trace_init (const gchar* filename)
+{
+        g_assert (filename != NULL);
+
+        if (ytv_trace_is_enabled ())
+        {
+                return FALSE;
+        }
+
+        g_static_mutex_lock (&trace_lock);
+
+        events = g_array_sized_new (FALSE, FALSE, sizeof (YtvTraceEvent),
+                                    4096);
+        threads = g_hash_table_new (g_direct_hash, g_direct_equal);
+        outfile = g_strdup (filename);
+        epoch = now ();
+        dropped = 0;
+
+        ytv_trace_flags |= YTV_TRACE_TIMELINE;
+
+        g_static_mutex_unlock (&trace_lock);
+
+        return TRUE;
+}
+
+/**
+ * ytv_trace_init_from_env:
+ *
+ * Enables the tracing if the YTV_TRACE environment variable holds the
+ * path of the output file.
+ *
+ * returns: %TRUE if the tracing was enabled by this call
+ */
+gboolean
+ytv_trace_init_from_env (void)
+{
+        const gchar* filename;
+
+        filename = g_getenv (YTV_TRACE_ENV);
+
+        if (filename == NULL || filename[0] == '\0')
+        {
+                return FALSE;
+        }
+
+        return ytv_trace_init (filename);
+}
+
+/**
+ * ytv_trace_is_enabled:
+ *
+ * returns: %TRUE if the trace events are being recorded
+ */
+gboolean
+ytv_trace_is_enabled (void)
+{
+        return (ytv_trace_flags & YTV_TRACE_TIMELINE) != 0;
+}
+
+/**
+ * ytv_trace_shutdown:
+ *
+ * Stops the recording and writes the collected events into the file
+ * given at ytv_trace_init().
+ */
+void
+ytv_trace_shutdown (void)
+{
+        if (!ytv_trace_is_enabled ())
+        {
+                return;
+        }
+
+        g_static_mutex_lock (&trace_lock);
+
+        ytv_trace_flags &= ~YTV_TRACE_TIMELINE;
+
+        write_file (outfile);
+
+        g_array_free (events, TRUE);
+        events = NULL;
+        g_hash_table_destroy (threads);
+        threads = NULL;
+        g_free (outfile);
+        outfile = NULL;
+
+        g_static_mutex_unlock (&trace_lock);
+
+        return;
+}
+
+/**
+ * ytv_trace_begin:
+ * @cat: (not-null): the static category string
+ * @name: (not-null): the static span name
+ *
+ * Opens a synchronous span in the current thread. Use the
+ * YTV_TRACE_BEGIN macro instead.
+ */
+void
+ytv_trace_begin (const gchar* cat, const gchar* name)
+{
+        if (ytv_trace_flags & YTV_TRACE_TIMELINE)
+        {
+                add_event ('B', cat, name, NULL, 0);
+        }
+
+        if (ytv_trace_flags & YTV_TRACE_WATCHDOG)
+        {
+                ytv_watchdog_span_begin (cat, name);
+        }
+
+        return;
+}
+
+/**
+ * ytv_trace_end:
+ * @cat: (not-null): the static category string
+ * @name: (not-null): the static span name
+ *
+ * Closes the last span opened in the current thread. Use the
+ * YTV_TRACE_END macro instead.
+ */
+void
+ytv_trace_end (const gchar* cat, const gchar* name)
+{
+        if (ytv_trace_flags & YTV_TRACE_WATCHDOG)
+        {
+                ytv_watchdog_span_end (cat, name);
+        }
+
+        if (ytv_trace_flags & YTV_TRACE_TIMELINE)
+        {
+                add_event ('E', cat, name, NULL, 0);
+        }
+
+        return;
+}
+
+/**
+ * ytv_trace_async_begin:
+ * @cat: (not-null): the static category string
+ * @name: (not-null): the static span name
+ * @id: an address identifying the operation
+ *
+ * Opens a span which may be closed in another main loop dispatch,
+ * like a HTTP request. Use the YTV_TRACE_ASYNC_BEGIN macro instead.
+ */
+void
+ytv_trace_async_begin (const gchar* cat, const gchar* name, gconstpointer id)
+{
+        if (ytv_trace_flags & YTV_TRACE_TIMELINE)
+        {
+                add_event ('b', cat, name, id, 0);
+        }
+
+        return;
+}
+
+/**
+ * ytv_trace_async_end:
+ * @cat: (not-null): the static category string
+ * @name: (not-null): the static span name
+ * @id: the address given to ytv_trace_async_begin()
+ *
+ * Closes an asynchronous span. Use the YTV_TRACE_ASYNC_END macro instead.
+ */
+void
+ytv_trace_async_end (const gchar* cat, const gchar* name, gconstpointer id)
+{
+        if (ytv_trace_flags & YTV_TRACE_TIMELINE)
+        {
+                add_event ('e', cat, name, id, 0);
+        }
+
+        return;
+}
+
+/**
+ * ytv_trace_counter:
+ * @cat: (not-null): the static category string
+ * @name: (not-null): the static counter name
+ * @value: the current value of the counter, e.g. a running total, never
+ * the increment since the previous sample
+ *
+ * Records a sample of a counter. Use the YTV_TRACE_COUNTER macro instead.
+ */
+void
+ytv_trace_counter (const gchar* cat, const gchar* name, gint64 value)
+{
+        if (ytv_trace_flags & YTV_TRACE_TIMELINE)
+        {
+                add_event ('C', cat, name, NULL, value);
+        }
+
+        return;
+}
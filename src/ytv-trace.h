@@ -0,0 +1,94 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_TRACE_H_
+#define _YTV_TRACE_H_
+
+/* ytv-trace.h - Lightweight span and counter tracing
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * YtvTraceFlags:
+ * @YTV_TRACE_TIMELINE: record the events for the chrome://tracing output
+ * @YTV_TRACE_WATCHDOG: feed the spans to the main loop stall detector
+ *
+ * The consumers of the trace events currently enabled.
+ */
+enum _YtvTraceFlags
+{
+        YTV_TRACE_TIMELINE = 1 << 0,
+        YTV_TRACE_WATCHDOG = 1 << 1
+};
+
+typedef enum _YtvTraceFlags YtvTraceFlags;
+
+#define YTV_TRACE_ENV "YTV_TRACE"
+
+/* the instrumentation points only pay this test while tracing is off */
+extern guint ytv_trace_flags;
+
+#define YTV_TRACE_BEGIN(cat, name)                                      \
+        G_STMT_START {                                                  \
+                if (G_UNLIKELY (ytv_trace_flags != 0))                  \
+                        ytv_trace_begin ((cat), (name));                \
+        } G_STMT_END
+
+#define YTV_TRACE_END(cat, name)                                        \
+        G_STMT_START {                                                  \
+                if (G_UNLIKELY (ytv_trace_flags != 0))                  \
+                        ytv_trace_end ((cat), (name));                  \
+        } G_STMT_END
+
+#define YTV_TRACE_ASYNC_BEGIN(cat, name, id)                            \
+        G_STMT_START {                                                  \
+                if (G_UNLIKELY (ytv_trace_flags != 0))                  \
+                        ytv_trace_async_begin ((cat), (name), (id));    \
+        } G_STMT_END
+
+#define YTV_TRACE_ASYNC_END(cat, name, id)                              \
+        G_STMT_START {                                                  \
+                if (G_UNLIKELY (ytv_trace_flags != 0))                  \
+                        ytv_trace_async_end ((cat), (name), (id));      \
+        } G_STMT_END
+
+#define YTV_TRACE_COUNTER(cat, name, value)                             \
+        G_STMT_START {                                                  \
+                if (G_UNLIKELY (ytv_trace_flags != 0))                  \
+                        ytv_trace_counter ((cat), (name), (value));     \
+        } G_STMT_END
+
+gboolean ytv_trace_init (const gchar* filename);
+gboolean ytv_trace_init_from_env (void);
+void ytv_trace_shutdown (void);
+gboolean ytv_trace_is_enabled (void);
+
+void ytv_trace_begin (const gchar* cat, const gchar* name);
+void ytv_trace_end (const gchar* cat, const gchar* name);
+void ytv_trace_async_begin (const gchar* cat, const gchar* name,
+                            gconstpointer id);
+void ytv_trace_async_end (const gchar* cat, const gchar* name,
+                          gconstpointer id);
+void ytv_trace_counter (const gchar* cat, const gchar* name, gint64 value);
+
+G_END_DECLS
+
+#endif /* _YTV_TRACE_H_ */
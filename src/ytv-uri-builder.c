@@ -215,6 +215,40 @@ ytv_uri_builder_get_current_feed (YtvUriBuilder* self)
         return retval;
 }
 
+/**
+ * ytv_uri_builder_get_thumbnail_variant:
+ * @self: a #YtvUriBuilder
+ * @vid: (not-null): the entry id
+ * @variant: the #YtvThumbnailVariant size of the image
+ *
+ * Construct an URI for the @vid thumbnail in the size of @variant. If the
+ * implementation does not know about variants, the URI of
+ * ytv_uri_builder_get_thumbnail() is returned.
+ *
+ * returns: (null-ok): (caller-owns): the URI string to the @vid thumbnail.
+ * The string must be freed after use.
+ */
+gchar*
+ytv_uri_builder_get_thumbnail_variant (YtvUriBuilder* self, const gchar* vid,
+                                       YtvThumbnailVariant variant)
+{
+        gchar* retval;
+
+        g_assert (vid != NULL);
+        g_assert (YTV_IS_URI_BUILDER (self));
+        g_assert (variant < YTV_THUMBNAIL_VARIANT_LAST);
+
+        if (YTV_URI_BUILDER_GET_IFACE (self)->get_thumbnail_variant == NULL)
+        {
+                return ytv_uri_builder_get_thumbnail (self, vid);
+        }
+
+        retval = YTV_URI_BUILDER_GET_IFACE (self)->get_thumbnail_variant
+                (self, vid, variant);
+
+        return retval;
+}
+
 static void
 ytv_uri_builder_base_init (gpointer g_class)
 {
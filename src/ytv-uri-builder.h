@@ -52,6 +52,21 @@ enum _YtvUriBuilderReqFeedType
 };
 typedef enum _YtvUriBuilderReqFeedType YtvUriBuilderReqFeedType;
 
+/**
+ * YtvThumbnailVariant:
+ *
+ * The sizes in which a thumbnail is available, from the smaller.
+ */
+enum _YtvThumbnailVariant
+{
+        YTV_THUMBNAIL_VARIANT_DEFAULT = 0, /* 120x90 */
+        YTV_THUMBNAIL_VARIANT_MEDIUM,      /* 320x180 */
+        YTV_THUMBNAIL_VARIANT_HIGH,        /* 480x360 */
+
+        YTV_THUMBNAIL_VARIANT_LAST
+};
+typedef enum _YtvThumbnailVariant YtvThumbnailVariant;
+
 struct _YtvUriBuilderIface
 {
         GTypeInterface parent;
@@ -66,6 +81,8 @@ struct _YtvUriBuilderIface
         gchar* (*get_related_feed) (YtvUriBuilder* self, const gchar* vid);
         gchar* (*get_thumbnail) (YtvUriBuilder* self, const gchar* vid);
         gchar* (*get_current_feed) (YtvUriBuilder* self);
+        gchar* (*get_thumbnail_variant) (YtvUriBuilder* self, const gchar* vid,
+                                         YtvThumbnailVariant variant);
 };
 
 GType ytv_uri_builder_get_type (void);
@@ -79,6 +96,9 @@ gchar* ytv_uri_builder_get_keywords_feed (YtvUriBuilder* self,
 gchar* ytv_uri_builder_get_related_feed (YtvUriBuilder* self, const gchar* vid);
 gchar* ytv_uri_builder_get_thumbnail (YtvUriBuilder* self, const gchar* vid);
 gchar* ytv_uri_builder_get_current_feed (YtvUriBuilder* self);
+gchar* ytv_uri_builder_get_thumbnail_variant (YtvUriBuilder* self,
+                                              const gchar* vid,
+                                              YtvThumbnailVariant variant);
 
 G_END_DECLS
 
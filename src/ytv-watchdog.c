@@ -0,0 +1,455 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+/* ytv-watchdog.c - Main loop stall detector
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: ytv-watchdog
+ * @short_description: reports the callbacks which block the main loop
+ *
+ * Everything in the viewer, from the soup callbacks to the pixbuf
+ * decoding, runs in the GTK+ main loop, so a slow callback freezes the
+ * UI. The watchdog wraps the poll function of the default main context
+ * to measure every main loop iteration, and hooks the ytv-trace spans
+ * (fetch_feed_cb, feed_entry_cb, fetch_img_cb, update_widget, ...) of the
+ * main thread to know which function was running.
+ *
+ * Every span whose own time, not counting the spans nested in it, is
+ * longer than the threshold is reported with the id and priority of the
+ * #GSource being dispatched, so a stall is blamed once, on the innermost
+ * span which spent it. An iteration longer than the
+ * threshold without any slow span inside is reported as unattributed
+ * (GTK+ layout and drawing, usually).
+ *
+ * The stalls are aggregated per label and dumped with
+ * ytv_watchdog_dump(), at exit or when the process receives SIGUSR2.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <signal.h>
+#include <stdlib.h>
+
+#include <ytv-trace.h>
+#include <ytv-watchdog.h>
+
+#define MAX_DEPTH 32
+
+typedef struct _YtvSpan YtvSpan;
+
+struct _YtvSpan
+{
+        const gchar* cat;
+        const gchar* name;
+        gint64 start;
+        gint64 children; /* usecs spent in the nested spans */
+        guint source_id;
+        gint priority;
+};
+
+typedef struct _YtvStall YtvStall;
+
+struct _YtvStall
+{
+        gchar* label;
+        guint count;
+        gint64 total;
+        gint64 max;
+};
+
+static GPollFunc orig_poll = NULL;
+static GThread* main_thread = NULL;
+static gint64 threshold = 0; /* usecs */
+static gint64 wake_time = 0;
+static gboolean attributed = FALSE;
+static YtvSpan stack[MAX_DEPTH];
+static gint depth = 0;
+static GHashTable* stalls = NULL;
+static volatile sig_atomic_t dump_requested = 0;
+
+static gint64
+now (void)
+{
+        GTimeVal tv;
+
+        g_get_current_time (&tv);
+
+        return ((gint64) tv.tv_sec) * G_USEC_PER_SEC + tv.tv_usec;
+}
+
+static void
+stall_free (YtvStall* stall)
+{
+        g_free (stall->label);
+        g_slice_free (YtvStall, stall);
+
+        return;
+}
+
+static void
+record (const gchar* cat, const gchar* name, gint64 elapsed,
+        guint source_id, gint priority)
+{
+        YtvStall* stall;
+        gchar* label;
+
+        label = g_strconcat (cat, ":", name, NULL);
+        stall = g_hash_table_lookup (stalls, label);
+
+        if (stall == NULL)
+        {
+                stall = g_slice_new0 (YtvStall);
+                stall->label = label;
+                g_hash_table_insert (stalls, stall->label, stall);
+        }
+        else
+        {
+                g_free (label);
+        }
+
+        stall->count++;
+        stall->total += elapsed;
+        stall->max = MAX (stall->max, elapsed);
+
+        if (source_id != 0)
+        {
+                g_message ("main loop stall: %s took %.1f ms "
+                           "(source %u, priority %d)", stall->label,
+                           elapsed / 1000.0, source_id, priority);
+        }
+        else
+        {
+                g_message ("main loop stall: %s took %.1f ms",
+                           stall->label, elapsed / 1000.0);
+        }
+
+        return;
+}
+
+static gint
+watchdog_poll (GPollFD* ufds, guint nfds, gint timeout)
+{
+        gint64 elapsed;
+        gint retval;
+
+        if (wake_time != 0)
+        {
+                elapsed = now () - wake_time;
+
+                if (elapsed >= threshold && !attributed)
+                {
+                        record ("main-loop", "unattributed", elapsed, 0, 0);
+                }
+        }
+
+        retval = orig_poll (ufds, nfds, timeout);
+
+        wake_time = now ();
+        attributed = FALSE;
+
+        if (G_UNLIKELY (dump_requested))
+        {
+                dump_requested = 0;
+                ytv_watchdog_dump (stderr);
+        }
+
+        return retval;
+}
+
+static void
+on_signal (gint signum)
+{
+        dump_requested = 1;
+
+        return;
+}
+
+static gint
+compare_stalls (gconstpointer a, gconstpointer b)
+{
+        const YtvStall* sa = *(YtvStall**) a;
+        const YtvStall* sb = *(YtvStall**) b;
+
+        if (sa->total == sb->total)
+        {
+                return 0;
+        }
+
+        return (sa->total < sb->total) ? 1 : -1;
+}
+
+static void
+collect_stall (gpointer key, gpointer value, gpointer user_data)
+{
+        g_ptr_array_add ((GPtrArray*) user_data, value);
+
+        return;
+}
+
+/**
+ * ytv_watchdog_enable:
+ * @threshold_ms: the minimum duration of a reported stall
+ *
+ * Installs the stall detector in the default main context. It must be
+ * called from the thread which runs the main loop.
+ *
+ * returns: %TRUE if the watchdog was enabled by this call
+ */
+gboolean
+ytv_watchdog_enable (guint threshold_ms)
+{
+        struct sigaction sa;
+
+        if (ytv_watchdog_is_enabled ())
+        {
+                return FALSE;
+        }
+
+        threshold = ((gint64) threshold_ms) * 1000;
+        main_thread = g_thread_self ();
+        wake_time = 0;
+        depth = 0;
+
+        if (stalls == NULL)
+        {
+                stalls = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                NULL,
+                                                (GDestroyNotify) stall_free);
+        }
+
+        orig_poll = g_main_context_get_poll_func (NULL);
+        g_main_context_set_poll_func (NULL, watchdog_poll);
+
+        sa.sa_handler = on_signal;
+        sigemptyset (&sa.sa_mask);
+        sa.sa_flags = SA_RESTART;
+        sigaction (SIGUSR2, &sa, NULL);
+
+        ytv_trace_flags |= YTV_TRACE_WATCHDOG;
+
+        return TRUE;
+}
+
+/**
+ * ytv_watchdog_enable_from_env:
+ *
+ * Enables the watchdog if the YTV_WATCHDOG environment variable is
+ * set. Its value is the threshold in milliseconds, or the default one if
+ * it is not a number.
+ *
+ * returns: %TRUE if the watchdog was enabled by this call
+ */
+gboolean
+ytv_watchdog_enable_from_env (void)
+{
+        const gchar* value;
+        gint threshold_ms;
+
+        value = g_getenv (YTV_WATCHDOG_ENV);
+
+        if (value == NULL)
+        {
+                return FALSE;
+        }
+
+        threshold_ms = atoi (value);
+
+        if (threshold_ms <= 0)
+        {
+                threshold_ms = YTV_WATCHDOG_DEFAULT_THRESHOLD;
+        }
+
+        return ytv_watchdog_enable (threshold_ms);
+}
+
+/**
+ * ytv_watchdog_disable:
+ *
+ * Uninstalls the stall detector. The aggregated stalls are kept.
+ */
+void
+ytv_watchdog_disable (void)
+{
+        if (!ytv_watchdog_is_enabled ())
+        {
+                return;
+        }
+
+        ytv_trace_flags &= ~YTV_TRACE_WATCHDOG;
+
+        g_main_context_set_poll_func (NULL, orig_poll);
+        signal (SIGUSR2, SIG_DFL);
+
+        return;
+}
+
+/**
+ * ytv_watchdog_is_enabled:
+ *
+ * returns: %TRUE if the main loop is being watched
+ */
+gboolean
+ytv_watchdog_is_enabled (void)
+{
+        return (ytv_trace_flags & YTV_TRACE_WATCHDOG) != 0;
+}
+
+/**
+ * ytv_watchdog_dump:
+ * @fp: (not-null): the stream where to write
+ *
+ * Writes the stalls seen so far, sorted by the accumulated time.
+ */
+void
+ytv_watchdog_dump (FILE* fp)
+{
+        GPtrArray* sorted;
+        YtvStall* stall;
+        guint i;
+
+        g_assert (fp != NULL);
+
+        if (stalls == NULL)
+        {
+                return;
+        }
+
+        sorted = g_ptr_array_sized_new (g_hash_table_size (stalls));
+        g_hash_table_foreach (stalls, collect_stall, sorted);
+        g_ptr_array_sort (sorted, compare_stalls);
+
+        fprintf (fp, "main loop stalls over %" G_GINT64_FORMAT " ms:\n",
+                 threshold / 1000);
+        fprintf (fp, "%-40s %8s %10s %10s %10s\n",
+                 "label", "count", "total ms", "mean ms", "max ms");
+
+        for (i = 0; i < sorted->len; i++)
+        {
+                stall = g_ptr_array_index (sorted, i);
+                fprintf (fp, "%-40s %8u %10.1f %10.1f %10.1f\n",
+                         stall->label, stall->count,
+                         stall->total / 1000.0,
+                         stall->total / 1000.0 / stall->count,
+                         stall->max / 1000.0);
+        }
+
+        fflush (fp);
+        g_ptr_array_free (sorted, TRUE);
+
+        return;
+}
+
+/**
+ * ytv_watchdog_reset:
+ *
+ * Forgets the aggregated stalls.
+ */
+void
+ytv_watchdog_reset (void)
+{
+        if (stalls != NULL)
+        {
+                g_hash_table_remove_all (stalls);
+        }
+
+        return;
+}
+
+/**
+ * ytv_watchdog_span_begin:
+ * @cat: (not-null): the span category
+ * @name: (not-null): the span name
+ *
+ * Notifies the start of a span. It is called by ytv_trace_begin().
+ */
+void
+ytv_watchdog_span_begin (const gchar* cat, const gchar* name)
+{
+        GSource* source;
+        YtvSpan* span;
+
+        if (g_thread_self () != main_thread)
+        {
+                return;
+        }
+
+        if (depth < MAX_DEPTH)
+        {
+                span = &stack[depth];
+                span->cat = cat;
+                span->name = name;
+                span->start = now ();
+                span->children = 0;
+
+                source = g_main_current_source ();
+                span->source_id = source ? g_source_get_id (source) : 0;
+                span->priority = source ? g_source_get_priority (source) : 0;
+        }
+
+        depth++;
+
+        return;
+}
+
+/**
+ * ytv_watchdog_span_end:
+ * @cat: (not-null): the span category
+ * @name: (not-null): the span name
+ *
+ * Notifies the end of a span. It is called by ytv_trace_end().
+ */
+void
+ytv_watchdog_span_end (const gchar* cat, const gchar* name)
+{
+        YtvSpan* span;
+        gint64 elapsed;
+        gint64 own;
+
+        if (g_thread_self () != main_thread || depth == 0)
+        {
+                return;
+        }
+
+        depth--;
+
+        if (depth >= MAX_DEPTH)
+        {
+                return;
+        }
+
+        span = &stack[depth];
+        elapsed = now () - span->start;
+        own = elapsed - span->children;
+
+        if (depth > 0)
+        {
+                stack[depth - 1].children += elapsed;
+        }
+
+        if (own >= threshold)
+        {
+                record (span->cat, span->name, own,
+                        span->source_id, span->priority);
+                attributed = TRUE;
+        }
+
+        return;
+}
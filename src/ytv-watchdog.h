@@ -0,0 +1,46 @@
+/* -*- Mode: C; indent-tabs-mode: nil; c-basic-offset: 8; coding: utf-8 -*- */
+
+#ifndef _YTV_WATCHDOG_H_
+#define _YTV_WATCHDOG_H_
+
+/* ytv-watchdog.h - Main loop stall detector
+ * Copyright (C) 2008 Víctor Manuel Jáquez Leal <vjaquez@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with self library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <stdio.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define YTV_WATCHDOG_ENV "YTV_WATCHDOG"
+#define YTV_WATCHDOG_DEFAULT_THRESHOLD 16 /* ms, a frame at 60Hz */
+
+gboolean ytv_watchdog_enable (guint threshold_ms);
+gboolean ytv_watchdog_enable_from_env (void);
+void ytv_watchdog_disable (void);
+gboolean ytv_watchdog_is_enabled (void);
+void ytv_watchdog_dump (FILE* fp);
+void ytv_watchdog_reset (void);
+
+/* called by ytv-trace */
+void ytv_watchdog_span_begin (const gchar* cat, const gchar* name);
+void ytv_watchdog_span_end (const gchar* cat, const gchar* name);
+
+G_END_DECLS
+
+#endif /* _YTV_WATCHDOG_H_ */
@@ -63,7 +63,10 @@ enum _YtvYoutubeUriBuilderProp
         PROP_MAX_RESULTS,
         PROP_AUTHOR,
         PROP_ALT,
-        PROP_TIME
+        PROP_TIME,
+        PROP_BASE_URI,
+        PROP_THUMBNAIL_URI,
+        PROP_FIELDS
 };
 
 typedef struct _YtvYoutubeUriBuilderPriv YtvYoutubeUriBuilderPriv;
@@ -80,18 +83,34 @@ struct _YtvYoutubeUriBuilderPriv
         gchar* author;
         YtvYoutubeAlt alt;
         YtvYoutubeTime time;
+
+        gchar* baseuri;
+        gchar* imguri;
+
+        gchar* fields;
 };
 
 #define YTV_YOUTUBE_URI_BUILDER_GET_PRIVATE(obj)        \
         (G_TYPE_INSTANCE_GET_PRIVATE ((obj), YTV_TYPE_YOUTUBE_URI_BUILDER, YtvYoutubeUriBuilderPriv))
 
 #define BASEURL "http://gdata.youtube.com/feeds/api/"
-#define IMGURL  "http://img.youtube.com/vi/%s/default.jpg"
+#define IMGURL  "http://img.youtube.com/vi/"
+#define IMGFILE "/default.jpg"
 #define RESERVEDCHARS "/:?&=-#@+"
 
 
 typedef gchar* (*SetParam) (YtvYoutubeUriBuilder* self);
 
+static const gchar*
+get_base_uri (YtvUriBuilder* self)
+{
+        YtvYoutubeUriBuilderPriv* priv;
+
+        priv = YTV_YOUTUBE_URI_BUILDER_GET_PRIVATE (self);
+
+        return priv->baseuri;
+}
+
 static gchar*
 orderby_param (YtvYoutubeUriBuilder* self)
 {
@@ -246,6 +265,25 @@ time_param (YtvYoutubeUriBuilder* self)
         return retval;
 }
 
+static gchar*
+fields_param (YtvYoutubeUriBuilder* self)
+{
+        YtvYoutubeUriBuilderPriv* priv;
+        gchar* retval = NULL;
+
+        g_return_val_if_fail (YTV_IS_YOUTUBE_URI_BUILDER (self), NULL);
+
+        priv = YTV_YOUTUBE_URI_BUILDER_GET_PRIVATE (self);
+
+        /* the whole entry by default */
+        if (priv->fields != NULL && priv->fields[0] != '\0')
+        {
+                retval = g_strdup_printf ("fields=%s", priv->fields);
+        }
+
+        return retval;
+}
+
 static gchar*
 all_params (YtvYoutubeUriBuilder* self, gboolean time)
 {
@@ -260,6 +298,7 @@ all_params (YtvYoutubeUriBuilder* self, gboolean time)
                 author_param,
                 alt_param,
                 time_param,
+                fields_param,
                 NULL
         };
         
@@ -337,7 +376,8 @@ ytv_youtube_uri_builder_get_standard_feed_default (YtvUriBuilder* self,
                 return NULL;
         }
 
-        retval = g_strconcat (BASEURL, "standardfeeds/", feedtype, NULL);
+        retval = g_strconcat (get_base_uri (self), "standardfeeds/", feedtype,
+                              NULL);
 
         params = all_params (YTV_YOUTUBE_URI_BUILDER (self), TRUE);
         if (params != NULL)
@@ -403,7 +443,7 @@ ytv_youtube_uri_builder_search_feed_default (YtvUriBuilder* self,
                 p = q; /* good luck my friend */
         }
         
-        retval = g_strconcat (BASEURL, "videos?vq=", p, NULL);
+        retval = g_strconcat (get_base_uri (self), "videos?vq=", p, NULL);
 
         g_free (p);
 
@@ -452,7 +492,8 @@ ytv_youtube_uri_builder_get_user_feed_default (YtvUriBuilder* self,
         gchar* params;
         gchar *u = g_strstrip (g_strdup (user));
 
-        retval = g_strconcat (BASEURL, "users/", u, "/uploads", NULL);
+        retval = g_strconcat (get_base_uri (self), "users/", u, "/uploads",
+                              NULL);
         params = all_params (YTV_YOUTUBE_URI_BUILDER (self), FALSE);
         
         if (params != NULL)
@@ -496,7 +537,7 @@ ytv_youtube_uri_builder_get_keywords_feed_default (YtvUriBuilder* self,
         gchar* c = g_strstrip (g_strdup (category));
         gchar* k = g_strstrip (g_strdup (keywords));
 
-        retval = g_strconcat (BASEURL, "videos/-/", c, NULL);
+        retval = g_strconcat (get_base_uri (self), "videos/-/", c, NULL);
         params = all_params (YTV_YOUTUBE_URI_BUILDER (self), FALSE);
         
         if (params != NULL)
@@ -539,7 +580,8 @@ ytv_youtube_uri_builder_get_related_feed_default (YtvUriBuilder* self,
         gchar* params;
         gchar* id = g_strstrip (g_strdup (vid));
 
-        retval = g_strconcat (BASEURL, "videos/",  id, "/related", NULL);
+        retval = g_strconcat (get_base_uri (self), "videos/",  id, "/related",
+                              NULL);
         params = all_params (YTV_YOUTUBE_URI_BUILDER (self), FALSE);
         
         if (params != NULL)
@@ -577,7 +619,33 @@ static gchar*
 ytv_youtube_uri_builder_get_thumbnail_default (YtvUriBuilder* self,
                                                const gchar* vid)
 {
-        gchar* retval = g_strdup_printf (IMGURL, vid);        
+        YtvYoutubeUriBuilderPriv* priv;
+        gchar* retval;
+
+        priv = YTV_YOUTUBE_URI_BUILDER_GET_PRIVATE (self);
+        retval = g_strconcat (priv->imguri, vid, IMGFILE, NULL);
+
+        return retval;
+}
+
+/* indexed by YtvThumbnailVariant */
+static const gchar* imgfiles[YTV_THUMBNAIL_VARIANT_LAST] =
+{
+        IMGFILE,
+        "/mqdefault.jpg",
+        "/hqdefault.jpg"
+};
+
+static gchar*
+ytv_youtube_uri_builder_get_thumbnail_variant_default
+(YtvUriBuilder* self, const gchar* vid, YtvThumbnailVariant variant)
+{
+        YtvYoutubeUriBuilderPriv* priv;
+        gchar* retval;
+
+        priv = YTV_YOUTUBE_URI_BUILDER_GET_PRIVATE (self);
+        retval = g_strconcat (priv->imguri, vid, imgfiles[variant], NULL);
+
         return retval;
 }
 
@@ -625,6 +693,8 @@ ytv_uri_builder_init (YtvUriBuilderIface* klass)
         klass->get_related_feed = ytv_youtube_uri_builder_get_related_feed;
         klass->get_thumbnail = ytv_youtube_uri_builder_get_thumbnail;
         klass->get_current_feed = ytv_youtube_uri_builder_get_current_feed;
+        klass->get_thumbnail_variant =
+                ytv_youtube_uri_builder_get_thumbnail_variant;
 
         return;
 }
@@ -672,6 +742,18 @@ ytv_youtube_uri_builder_set_property (GObject* object, guint prop_id,
         case PROP_TIME:
                 priv->time = g_value_get_enum (value);
                 break;
+        case PROP_BASE_URI:
+                g_free (priv->baseuri);
+                priv->baseuri = g_value_dup_string (value);
+                break;
+        case PROP_THUMBNAIL_URI:
+                g_free (priv->imguri);
+                priv->imguri = g_value_dup_string (value);
+                break;
+        case PROP_FIELDS:
+                g_free (priv->fields);
+                priv->fields = g_value_dup_string (value);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -710,6 +792,15 @@ ytv_youtube_uri_builder_get_property (GObject* object, guint prop_id,
         case PROP_TIME:
                 g_value_set_enum (value, priv->time);
                 break;
+        case PROP_BASE_URI:
+                g_value_set_string (value, priv->baseuri);
+                break;
+        case PROP_THUMBNAIL_URI:
+                g_value_set_string (value, priv->imguri);
+                break;
+        case PROP_FIELDS:
+                g_value_set_string (value, priv->fields);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, spec);
                 break;
@@ -745,6 +836,13 @@ ytv_youtube_uri_builder_finalize (GObject* object)
                 priv->arg2 = NULL;
         }
 
+        g_free (priv->baseuri);
+        priv->baseuri = NULL;
+        g_free (priv->imguri);
+        priv->imguri = NULL;
+        g_free (priv->fields);
+        priv->fields = NULL;
+
         (*G_OBJECT_CLASS (ytv_youtube_uri_builder_parent_class)->finalize) (object);
 
         return;
@@ -771,6 +869,8 @@ ytv_youtube_uri_builder_class_init (YtvYoutubeUriBuilderClass* klass)
         klass->get_thumbnail = ytv_youtube_uri_builder_get_thumbnail_default;
         klass->get_current_feed =
                 ytv_youtube_uri_builder_get_current_feed_default;
+        klass->get_thumbnail_variant =
+                ytv_youtube_uri_builder_get_thumbnail_variant_default;
 
         g_object_class_install_property
                 (g_klass, PROP_ORDERBY,
@@ -815,6 +915,27 @@ ytv_youtube_uri_builder_class_init (YtvYoutubeUriBuilderClass* klass)
                   " within the specified time", YTV_TYPE_YOUTUBE_TIME,
                   YTV_YOUTUBE_TIME_ALL_TIME, G_PARAM_READWRITE));
 
+        g_object_class_install_property
+                (g_klass, PROP_BASE_URI,
+                 g_param_spec_string
+                 ("base-uri", "baseuri", "The URI prefix of the GData feeds, "
+                  "it can point to a local stand-in server", BASEURL,
+                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        g_object_class_install_property
+                (g_klass, PROP_THUMBNAIL_URI,
+                 g_param_spec_string
+                 ("thumbnail-uri", "thumbnailuri", "The URI prefix of the "
+                  "video thumbnails", IMGURL,
+                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+        g_object_class_install_property
+                (g_klass, PROP_FIELDS,
+                 g_param_spec_string
+                 ("fields", "fields", "Partial response expression which "
+                  "selects the elements of the feed to be returned", NULL,
+                  G_PARAM_READWRITE));
+
         return;
 }
 
@@ -836,6 +957,9 @@ ytv_youtube_uri_builder_init (YtvYoutubeUriBuilder* self)
         priv->author      = NULL;
         priv->alt         = YTV_YOUTUBE_ALT_JSON;
         priv->time        = YTV_YOUTUBE_TIME_ALL_TIME;
+        priv->baseuri     = NULL;
+        priv->imguri      = NULL;
+        priv->fields      = NULL;
 
         return;
 }
@@ -1013,6 +1137,35 @@ ytv_youtube_uri_builder_get_thumbnail (YtvUriBuilder* self, const gchar* vid)
         return retval;
 }
 
+/**
+ * ytv_youtube_uri_builder_get_thumbnail_variant:
+ * @self: a #YtvUriBuilder
+ * @vid: (not-null): the video id
+ * @variant: the #YtvThumbnailVariant size of the image
+ *
+ * Constructs an URI for the @vid entry's thumbnail in the size of @variant
+ *
+ * returns: (null-ok): (caller-owns): the URI string for the thumbnail.
+ * The string must be freed after use.
+ */
+gchar*
+ytv_youtube_uri_builder_get_thumbnail_variant (YtvUriBuilder* self,
+                                               const gchar* vid,
+                                               YtvThumbnailVariant variant)
+{
+        gchar* retval;
+
+        g_assert (vid != NULL);
+        g_assert (YTV_IS_YOUTUBE_URI_BUILDER (self));
+        g_assert (variant < YTV_THUMBNAIL_VARIANT_LAST);
+        g_assert (YTV_YOUTUBE_URI_BUILDER_GET_CLASS (self)->get_thumbnail_variant != NULL);
+
+        retval = YTV_YOUTUBE_URI_BUILDER_GET_CLASS (self)->get_thumbnail_variant
+                (self, vid, variant);
+
+        return retval;
+}
+
 /**
  * ytv_youtube_uri_builder_get_current_feed:
  * @self: a #YtvUriBuilder
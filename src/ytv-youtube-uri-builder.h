@@ -113,6 +113,8 @@ struct _YtvYoutubeUriBuilderClass
         gchar* (*get_related_feed) (YtvUriBuilder* self, const gchar* vid);
         gchar* (*get_thumbnail) (YtvUriBuilder* self, const gchar* vid);
         gchar* (*get_current_feed) (YtvUriBuilder* self);
+        gchar* (*get_thumbnail_variant) (YtvUriBuilder* self, const gchar* vid,
+                                         YtvThumbnailVariant variant);
 };
 
 GType ytv_youtube_order_get_type (void);
@@ -135,6 +137,8 @@ gchar* ytv_youtube_uri_builder_get_related_feed (YtvUriBuilder* self,
 gchar* ytv_youtube_uri_builder_get_thumbnail (YtvUriBuilder* self,
                                               const gchar* vid);
 gchar* ytv_youtube_uri_builder_get_current_feed (YtvUriBuilder* self);
+gchar* ytv_youtube_uri_builder_get_thumbnail_variant
+(YtvUriBuilder* self, const gchar* vid, YtvThumbnailVariant variant);
 
 G_END_DECLS
 